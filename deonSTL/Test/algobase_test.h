@@ -0,0 +1,176 @@
+//
+//  algobase_test.h
+//  deonSTL
+//
+//  algobase.h 与 numeric.h 在分段迭代器（deque 迭代器）上的结果：copy、move、copy_n、fill、fill_n、find、
+//  accumulate 在随机子区间上与 std 算法作用于 std::deque 的结果对比，区间的起止位置落在块内任意位置，
+//  覆盖平凡可复制类型（memmove / memset 内核）与 std::string（逐个赋值）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef algobase_test_h
+#define algobase_test_h
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "../algobase.h"
+#include "../numeric.h"
+#include "../deque.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace algobase_test{
+
+inline int         make_value(uint64_t r, int*)          { return static_cast<int>(r % 100000); }
+inline std::string make_value(uint64_t r, std::string*)  { return "s" + std::to_string(r % 1000) + "-padding-to-leave-sso"; }
+
+// 容器中不会出现的值
+inline int         missing_value(int*)                   { return -1; }
+inline std::string missing_value(std::string*)           { return "missing"; }
+
+// 容器与参照都由同样的 push_front / push_back 序列构造，使起点不在块的开头
+template <class Deque, class T>
+void build(Deque& d, std::deque<T>& ref, size_t n, uint64_t& x)
+{
+    for(size_t i = 0; i < n; ++i)
+    {
+        const T v = make_value(next_random(x), static_cast<T*>(nullptr));
+        if(i % 3 == 0)
+        {
+            d.push_front(v);
+            ref.push_front(v);
+        }
+        else
+        {
+            d.push_back(v);
+            ref.push_back(v);
+        }
+    }
+}
+
+template <class Deque, class T>
+void check_equal(const Deque& d, const std::deque<T>& ref)
+{
+    DEONSTL_CHECK(d.size() == ref.size());
+    for(size_t i = 0; i < ref.size(); ++i)
+        DEONSTL_CHECK(d[i] == ref[i]);
+}
+
+// 在 [0, n] 中随机取 first <= last
+inline void random_range(size_t n, uint64_t& x, size_t& first, size_t& last)
+{
+    first = next_random(x) % (n + 1);
+    last = next_random(x) % (n + 1);
+    if(first > last)
+        std::swap(first, last);
+}
+
+template <class Deque, class T>
+void algorithms(size_t n, size_t rounds)
+{
+    uint64_t x = 88172645463325252ull;
+    Deque d, other;
+    std::deque<T> ref, other_ref;
+    build(d, ref, n, x);
+    build(other, other_ref, n, x);
+    std::vector<T> buf(n);
+
+    for(size_t round = 0; round < rounds; ++round)
+    {
+        size_t f, l;
+        random_range(n, x, f, l);
+        const size_t len = l - f;
+        const T value = make_value(next_random(x), static_cast<T*>(nullptr));
+
+        // deque -> 指针
+        T* out = deonSTL::copy(d.begin() + f, d.begin() + l, buf.data());
+        DEONSTL_CHECK(out == buf.data() + len);
+        DEONSTL_CHECK(std::equal(buf.data(), out, ref.begin() + f));
+
+        // 指针 -> deque，deque -> deque（起点与块边界错开）
+        const size_t to = next_random(x) % (n - len + 1);
+        auto it = deonSTL::copy(buf.data(), buf.data() + len, other.begin() + to);
+        std::copy(buf.data(), buf.data() + len, other_ref.begin() + to);
+        DEONSTL_CHECK(it - other.begin() == static_cast<ptrdiff_t>(to + len));
+        it = deonSTL::copy_n(d.begin() + f, len, other.begin() + (n - len - to));
+        std::copy_n(ref.begin() + f, len, other_ref.begin() + (n - len - to));
+        DEONSTL_CHECK(it - other.begin() == static_cast<ptrdiff_t>(n - to));
+        check_equal(other, other_ref);
+
+        // move：源变为移走后的状态，只比较目的
+        Deque moved(d);
+        it = deonSTL::move(moved.begin() + f, moved.begin() + l, other.begin() + to);
+        std::copy(ref.begin() + f, ref.begin() + l, other_ref.begin() + to);
+        DEONSTL_CHECK(it - other.begin() == static_cast<ptrdiff_t>(to + len));
+        check_equal(other, other_ref);
+
+        // fill / fill_n
+        if(round % 2 == 0)
+        {
+            deonSTL::fill(d.begin() + f, d.begin() + l, value);
+            std::fill(ref.begin() + f, ref.begin() + l, value);
+        }
+        else
+        {
+            it = deonSTL::fill_n(d.begin() + f, len, value);
+            std::fill_n(ref.begin() + f, len, value);
+            DEONSTL_CHECK(it - d.begin() == static_cast<ptrdiff_t>(l));
+        }
+        check_equal(d, ref);
+
+        // find：找得到的值与找不到的值
+        random_range(n, x, f, l);
+        const T& target = ref[next_random(x) % n];
+        DEONSTL_CHECK(deonSTL::find(d.begin() + f, d.begin() + l, target) - d.begin() ==
+                      std::find(ref.begin() + f, ref.begin() + l, target) - ref.begin());
+        const T missing = missing_value(static_cast<T*>(nullptr));
+        DEONSTL_CHECK(deonSTL::find(d.begin() + f, d.begin() + l, missing) == d.begin() + l);
+    }
+}
+
+// accumulate 两个版本，随机子区间与 std::accumulate 对比
+template <class Deque>
+void accumulate_test(size_t n)
+{
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    Deque d;
+    std::deque<int> ref;
+    build(d, ref, n, x);
+    for(int round = 0; round < 500; ++round)
+    {
+        size_t f, l;
+        random_range(n, x, f, l);
+        DEONSTL_CHECK(deonSTL::accumulate(d.begin() + f, d.begin() + l, 0LL) ==
+                      std::accumulate(ref.begin() + f, ref.begin() + l, 0LL));
+        auto mix = [](uint64_t a, int b) { return a * 31 + static_cast<uint64_t>(b); };
+        DEONSTL_CHECK(deonSTL::accumulate(d.begin() + f, d.begin() + l, uint64_t(7), mix) ==
+                      std::accumulate(ref.begin() + f, ref.begin() + l, uint64_t(7), mix));
+    }
+}
+
+void algobase_test()
+{
+    algorithms<deonSTL::deque<int>, int>(5000, 300);
+    algorithms<deonSTL::deque<int, deonSTL::allocator<int>, 20>, int>(500, 300);  // 每块 5 个元素
+    algorithms<deonSTL::deque<std::string>, std::string>(700, 100);
+    accumulate_test<deonSTL::deque<int>>(5000);
+    accumulate_test<deonSTL::deque<int, deonSTL::allocator<int>, 12>>(300);
+    printf("algobase_test passed\n");
+}
+
+} // namespace algobase_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* algobase_test_h */
@@ -0,0 +1,135 @@
+//
+//  default_init_test.h
+//  deonSTL
+//
+//  default_init 构造与 resize_default_init 的行为：vector、deque、small_vector 的长度与已有元素
+//  与 std::vector 对比；非平凡类型的每个新元素都调用默认构造函数，缩小时析构多出的元素，
+//  构造抛出异常时已构造的元素被析构
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef default_init_test_h
+#define default_init_test_h
+
+#include <cstdio>
+#include <vector>
+#include "../construct.h"
+#include "../vector.h"
+#include "../deque.h"
+#include "../small_vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace default_init_test{
+
+// 记录存活对象数的类型，默认构造的值为 42；throw_after 次构造之后抛出异常（0 表示不抛出）
+struct counted
+{
+    static int& live()          { static int n = 0; return n; }
+    static int& throw_after()   { static int n = 0; return n; }
+
+    int value;
+
+    counted() : value(42) { enter(); }
+    counted(int v) : value(v) { enter(); }
+    counted(const counted& rhs) : value(rhs.value) { enter(); }
+    counted& operator=(const counted& rhs) { value = rhs.value; return *this; }
+    ~counted() { --live(); }
+
+    static void enter()
+    {
+        if(throw_after() != 0 && --throw_after() == 0)
+            throw 1;
+        ++live();
+    }
+};
+
+// 已有元素保持不变，新元素为默认构造的 42，缩小时多出的元素被析构
+template <class Container>
+void resize_test()
+{
+    {
+        Container c(5, deonSTL::default_init);
+        DEONSTL_CHECK(c.size() == 5 && counted::live() == 5);
+        for(size_t i = 0; i < c.size(); ++i)
+            DEONSTL_CHECK(c[i].value == 42);
+
+        std::vector<int> ref;
+        for(size_t i = 0; i < c.size(); ++i)
+        {
+            c[i].value = static_cast<int>(i);
+            ref.push_back(static_cast<int>(i));
+        }
+        const size_t sizes[] = {5, 700, 3, 0, 1500, 1500, 20};
+        for(size_t s : sizes)
+        {
+            c.resize_default_init(s);
+            ref.resize(s, 42);
+            DEONSTL_CHECK(c.size() == ref.size());
+            DEONSTL_CHECK(counted::live() == static_cast<int>(ref.size()));
+            for(size_t i = 0; i < ref.size(); ++i)
+                DEONSTL_CHECK(c[i].value == ref[i]);
+            for(size_t i = 0; i < ref.size(); ++i)
+                c[i].value = ref[i] = static_cast<int>(i * 3 + s);
+        }
+    }
+    DEONSTL_CHECK(counted::live() == 0);
+}
+
+// 平凡类型：长度正确，已有元素保持不变，新元素可写
+template <class Container>
+void trivial_test()
+{
+    Container c(1000, deonSTL::default_init);
+    DEONSTL_CHECK(c.size() == 1000);
+    for(size_t i = 0; i < c.size(); ++i)
+        c[i] = static_cast<double>(i);
+    c.resize_default_init(10);
+    c.resize_default_init(3000);
+    DEONSTL_CHECK(c.size() == 3000);
+    for(size_t i = 0; i < 10; ++i)
+        DEONSTL_CHECK(c[i] == static_cast<double>(i));
+    for(size_t i = 10; i < c.size(); ++i)
+        c[i] = -1.0;
+    DEONSTL_CHECK(c[2999] == -1.0);
+}
+
+// vector 构造时第 50 个元素抛出异常：已构造的元素被析构
+inline void throw_test()
+{
+    counted::throw_after() = 50;
+    bool thrown = false;
+    try {
+        deonSTL::vector<counted> v(100, deonSTL::default_init);
+    } catch (int) {
+        thrown = true;
+    }
+    counted::throw_after() = 0;
+    DEONSTL_CHECK(thrown);
+    DEONSTL_CHECK(counted::live() == 0);
+}
+
+void default_init_test()
+{
+    resize_test<deonSTL::vector<counted>>();
+    resize_test<deonSTL::deque<counted>>();
+    resize_test<deonSTL::small_vector<counted, 8>>();
+    trivial_test<deonSTL::vector<double>>();
+    trivial_test<deonSTL::deque<double>>();
+    trivial_test<deonSTL::small_vector<double, 16>>();
+    throw_test();
+    printf("default_init_test passed\n");
+}
+
+} // namespace default_init_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* default_init_test_h */
@@ -0,0 +1,343 @@
+//
+//  deque_test.h
+//  deonSTL
+//
+//  deque 迭代器运算的结果：随机的 +、-、+=、-=、[]、比较与 std::deque 对比，起点不在块的开头
+//  deque 块大小与空闲 buffer：不同 BufBytes 下随机操作与 std::deque 对比，两端来回 push / pop 与队列用法
+//                          稳定后不再申请 buffer，析构后申请的内存全部归还
+//  deque 随机访问性能：deque[i] 与 vector[i] 顺序下标、随机下标求和，以及 std::sort 的耗时对比
+//  deque 队列用法：push_back + pop_front，记录耗时与 deque 占用的内存（map 与 buffer），占用内存稳定后不再增长
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef deque_test_h
+#define deque_test_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include "../deque.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace deque_test{
+
+// 迭代器随机跳转：每一步的位置、解引用、下标、距离与比较都与 std::deque 相同
+template <class Deque>
+void iterator_test(size_t n)
+{
+    Deque d;
+    std::deque<int> ref;
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(i % 4 == 0)
+        {
+            d.push_front(static_cast<int>(i));
+            ref.push_front(static_cast<int>(i));
+        }
+        else
+        {
+            d.push_back(static_cast<int>(i));
+            ref.push_back(static_cast<int>(i));
+        }
+    }
+    for(size_t i = 0; i < n; ++i)
+        DEONSTL_CHECK(d[i] == ref[i]);
+    DEONSTL_CHECK(d.end() - d.begin() == static_cast<ptrdiff_t>(n));
+
+    uint64_t x = 88172645463325252ull;
+    auto it = d.begin();
+    ptrdiff_t pos = 0;
+    for(int step = 0; step < 100000; ++step)
+    {
+        const ptrdiff_t target = static_cast<ptrdiff_t>(next_random(x) % (n + 1));
+        const ptrdiff_t k = target - pos;
+        switch(step % 4)
+        {
+            case 0: it += k; break;
+            case 1: it -= -k; break;
+            case 2: it = it + k; break;
+            default: it = k + it; break;
+        }
+        pos = target;
+        DEONSTL_CHECK(it - d.begin() == pos);
+        DEONSTL_CHECK(d.end() - it == static_cast<ptrdiff_t>(n) - pos);
+        DEONSTL_CHECK(it == d.begin() + pos);
+        DEONSTL_CHECK((it < d.end()) == (pos < static_cast<ptrdiff_t>(n)));
+        if(pos < static_cast<ptrdiff_t>(n))
+        {
+            DEONSTL_CHECK(*it == ref[pos]);
+            const ptrdiff_t j = static_cast<ptrdiff_t>(next_random(x) % n) - pos;
+            DEONSTL_CHECK(it[j] == ref[pos + j]);
+            DEONSTL_CHECK(*(it + j) == ref[pos + j]);
+            DEONSTL_CHECK(*(it - (-j)) == ref[pos + j]);
+        }
+    }
+}
+
+// 按 idx 中的下标求和，idx 为空时顺序访问
+template <class Container>
+uint64_t index_sum(const Container& c, const deonSTL::vector<size_t>& idx, int rounds)
+{
+    uint64_t sum = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        if(idx.empty())
+            for(size_t i = 0; i < c.size(); ++i)
+                sum += c[i];
+        else
+            for(size_t i = 0; i < idx.size(); ++i)
+                sum += c[idx[i]];
+    }
+    return sum;
+}
+
+// 统计当前申请的字节数与累计的申请次数（map 与 buffer 都通过 rebind 得到的配置器申请）
+inline size_t& live_bytes()
+{
+    static size_t bytes = 0;
+    return bytes;
+}
+
+inline size_t& alloc_calls()
+{
+    static size_t calls = 0;
+    return calls;
+}
+
+template <class T>
+struct counting_allocator : public deonSTL::allocator<T>
+{
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator() noexcept {}
+    template <class U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        live_bytes() += n * sizeof(T);
+        ++alloc_calls();
+        return deonSTL::allocator<T>::allocate(n);
+    }
+    void deallocate(T* ptr, size_t n)
+    {
+        if(ptr == nullptr)
+            return;
+        live_bytes() -= n * sizeof(T);
+        deonSTL::allocator<T>::deallocate(ptr, n);
+    }
+};
+
+// 随机的两端插入删除、中间插入删除、clear、shrink_to_fit，每一步与 std::deque 对比
+template <class Deque>
+void random_ops(Deque& d, std::deque<uint64_t>& ref, int steps, uint64_t& x)
+{
+    for(int step = 0; step < steps; ++step)
+    {
+        const uint64_t v = next_random(x);
+        switch(v % 16)
+        {
+            case 0: case 1: case 2: d.push_back(v); ref.push_back(v); break;
+            case 3: case 4: case 5: d.push_front(v); ref.push_front(v); break;
+            case 6: case 7: if(!ref.empty()) { d.pop_back(); ref.pop_back(); } break;
+            case 8: case 9: if(!ref.empty()) { d.pop_front(); ref.pop_front(); } break;
+            case 10:
+            {
+                const size_t pos = ref.empty() ? 0 : v % (ref.size() + 1);
+                d.insert(d.begin() + pos, 3, v);
+                ref.insert(ref.begin() + pos, 3, v);
+                break;
+            }
+            case 11:
+                if(!ref.empty())
+                {
+                    const size_t pos = v % ref.size();
+                    d.erase(d.begin() + pos);
+                    ref.erase(ref.begin() + pos);
+                }
+                break;
+            case 12:
+                if(step % 64 == 12)
+                    d.shrink_to_fit();
+                break;
+            case 13:
+                if(step % 512 == 13)
+                {
+                    d.clear();
+                    ref.clear();
+                }
+                break;
+            default: break;
+        }
+        DEONSTL_CHECK(d.size() == ref.size());
+    }
+    for(size_t i = 0; i < ref.size(); ++i)
+        DEONSTL_CHECK(d[i] == ref[i]);
+}
+
+template <size_t BufBytes>
+void block_test()
+{
+    typedef deonSTL::deque<uint64_t, counting_allocator<uint64_t>, BufBytes> deque_type;
+    const size_t block = deque_type::iterator::buffer_size;
+    DEONSTL_CHECK(block == (BufBytes == 0 ? 4096 / sizeof(uint64_t) : BufBytes / sizeof(uint64_t)));
+    {
+        deque_type d;
+        std::deque<uint64_t> ref;
+        uint64_t x = 88172645463325252ull;
+        for(int round = 0; round < 20; ++round)
+            random_ops(d, ref, 2000, x);
+
+        // 尾部正好填满一个块后来回 push_back / pop_back：只在第一次跨块时申请
+        d.clear();
+        d.shrink_to_fit();
+        for(size_t i = 0; i < block * 3; ++i)
+            d.push_back(i);
+        size_t calls = alloc_calls();
+        for(int i = 0; i < 1000; ++i)
+        {
+            d.push_back(i);
+            d.pop_back();
+            d.push_front(i);
+            d.pop_front();
+        }
+        DEONSTL_CHECK(alloc_calls() - calls <= 2);
+
+        // 队列用法：预热几个块后不再申请 buffer，出队顺序与入队顺序相同
+        std::deque<uint64_t> fifo(d.begin(), d.end());
+        for(size_t i = 0; i < block * 8; ++i)
+        {
+            d.push_back(i);
+            d.pop_front();
+            fifo.push_back(i);
+            fifo.pop_front();
+        }
+        calls = alloc_calls();
+        for(size_t i = 0; i < block * 16; ++i)
+        {
+            d.push_back(i);
+            fifo.push_back(i);
+            DEONSTL_CHECK(d.front() == fifo.front());
+            d.pop_front();
+            fifo.pop_front();
+        }
+        DEONSTL_CHECK(alloc_calls() == calls);
+        DEONSTL_CHECK(d.size() == fifo.size());
+    }
+    DEONSTL_CHECK(live_bytes() == 0);
+}
+
+void deque_test(size_t n = 10000000, int rounds = 10)
+{
+    iterator_test<deonSTL::deque<int>>(10000);
+    iterator_test<deonSTL::deque<int, deonSTL::allocator<int>, 12>>(1000);  // 每块 3 个元素
+    block_test<0>();
+    block_test<8>();        // 每块 1 个元素
+    block_test<64>();
+    block_test<2 * 1024 * 1024>();
+
+    deonSTL::vector<uint32_t> v;
+    deonSTL::deque<uint32_t>  d;
+    deonSTL::vector<size_t>   seq;
+    deonSTL::vector<size_t>   rnd;
+    uint32_t x = 12345;
+    for(size_t i = 0; i < n; ++i)
+    {
+        x = x * 1103515245u + 12345u;
+        v.push_back(x >> 8);
+        d.push_back(x >> 8);
+        rnd.push_back((x >> 4) % n);
+    }
+
+    uint64_t s1 = 0, s2 = 0;
+    printf("n = %zu, rounds = %d\n", n, rounds);
+    printf("%-16s %14s %14s %8s\n", "", "vector(ms)", "deque(ms)", "ratio");
+
+    double tv = time_ms([&] { s1 = index_sum(v, seq, rounds); });
+    double td = time_ms([&] { s2 = index_sum(d, seq, rounds); });
+    DEONSTL_CHECK(s1 == s2);
+    printf("%-16s %14.2f %14.2f %8.2f\n", "c[i] sequential", tv, td, td / tv);
+
+    tv = time_ms([&] { s1 = index_sum(v, rnd, rounds); });
+    td = time_ms([&] { s2 = index_sum(d, rnd, rounds); });
+    DEONSTL_CHECK(s1 == s2);
+    printf("%-16s %14.2f %14.2f %8.2f\n", "c[i] random", tv, td, td / tv);
+
+    tv = time_ms([&] { std::sort(v.begin(), v.end()); });
+    td = time_ms([&] { std::sort(d.begin(), d.end()); });
+    DEONSTL_CHECK(std::equal(v.begin(), v.end(), d.begin()));
+    printf("%-16s %14.2f %14.2f %8.2f\n", "std::sort", tv, td, td / tv);
+}
+
+// 队列深度保持为 depth，共 ops 次 push_back + pop_front，每完成十分之一打印一次耗时与占用内存
+// map 在原地居中后，占用内存应在第一段之后保持不变
+// 缺省的 ops 几秒内完成，长时间运行（如 1e9）时显式传入
+void deque_fifo_test(size_t ops = 10000000, size_t depth = 1000)
+{
+    typedef deonSTL::deque<uint64_t, counting_allocator<uint64_t>> deque_type;
+    const size_t block = deque_type::iterator::buffer_size;
+    deque_type              d;
+    std::deque<uint64_t>    sd;
+    for(size_t i = 0; i < depth; ++i)
+    {
+        d.push_back(i);
+        sd.push_back(i);
+    }
+
+    printf("fifo: ops = %zu, depth = %zu\n", ops, depth);
+    printf("%-10s %14s %16s\n", "progress", "deque(ms)", "live bytes");
+    const size_t step = ops / 10 > 0 ? ops / 10 : 1;
+    uint64_t sum = 0;
+    double total = 0;
+    size_t steady_bytes = 0;
+    for(size_t done = 0; done < ops; done += step)
+    {
+        const size_t n = ops - done < step ? ops - done : step;
+        total += time_ms([&] {
+            for(size_t i = 0; i < n; ++i)
+            {
+                d.push_back(done + i);
+                sum += d.front();
+                d.pop_front();
+            }
+        });
+        if(done == 0)
+            steady_bytes = live_bytes();
+        else if(n >= 4 * (depth + block))   // 每段跨过足够多的块时，第一段之后占用内存不再增长
+            DEONSTL_CHECK(live_bytes() == steady_bytes);
+        printf("%9zu%% %14.2f %16zu\n", (done + n) * 100 / ops, total, live_bytes());
+    }
+    DEONSTL_CHECK(d.size() == depth);
+
+    uint64_t ssum = 0;
+    double ts = time_ms([&] {
+        for(size_t i = 0; i < ops; ++i)
+        {
+            sd.push_back(i);
+            ssum += sd.front();
+            sd.pop_front();
+        }
+    });
+    DEONSTL_CHECK(sum == ssum);
+    printf("%-10s %14.2f\n", "std::deque", ts);
+}
+
+} // namespace deque_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* deque_test_h */
@@ -0,0 +1,339 @@
+//
+//  flat_hash_map_test.h
+//  deonSTL
+//
+//  flat_hash_map（控制字节分组探测）与 hashtable（Robin Hood 线性探测）、std::unordered_map 的对比：
+//  负载系数 0.5 ~ 0.875 下的插入、查找命中、查找未命中，键为 uint64_t
+//  每个负载系数先把表预留到固定的桶数，再插入 负载系数 x 桶数 个键，插入过程中不扩容
+//  对比之前先以随机的插入、删除、查找与 std::unordered_map / std::unordered_set 逐步对比 flat_hash_map / flat_hash_set 的内容
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef flat_hash_map_test_h
+#define flat_hash_map_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "../flat_hash_map.h"
+#include "../flat_hash_set.h"
+#include "../hashtable.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace flat_hash_map_test{
+
+// 只有 16 个不同 hash 值的 hash 函数：同一个起始组里的键很多，探测跨过多个组
+struct bad_hash
+{
+    size_t operator()(uint64_t k) const noexcept { return static_cast<size_t>(k % 16); }
+};
+
+inline std::string item(uint64_t i)
+{ return "value-" + std::to_string(i) + "-long-enough-to-live-on-the-heap"; }
+
+template <class Map>
+void check_equal(const Map& m, const std::unordered_map<uint64_t, std::string>& ref)
+{
+    DEONSTL_CHECK(m.size() == ref.size());
+    size_t n = 0;
+    for(auto it = m.begin(); it != m.end(); ++it, ++n)
+    {
+        auto r = ref.find(it->first);
+        DEONSTL_CHECK(r != ref.end() && r->second == it->second);
+    }
+    DEONSTL_CHECK(n == ref.size());
+}
+
+// 随机的 insert / emplace / operator[] / erase / find / count / rehash，与 std::unordered_map 逐步对比
+template <class Hash>
+void behaviour_test(uint64_t key_space)
+{
+    typedef deonSTL::flat_hash_map<uint64_t, std::string, Hash> map;
+
+    map m;
+    std::unordered_map<uint64_t, std::string> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 30000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const uint64_t k = r % key_space;
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            {
+                auto res = m.insert(typename map::value_type(k, item(r)));
+                auto rr = ref.insert(std::make_pair(k, item(r)));
+                DEONSTL_CHECK(res.second == rr.second && res.first->second == rr.first->second);
+                break;
+            }
+            case 1:
+                DEONSTL_CHECK(m.emplace(k, item(r)).second == ref.emplace(k, item(r)).second);
+                break;
+            case 2:
+                m[k] = item(r);
+                ref[k] = item(r);
+                break;
+            case 3:
+            case 4:
+                DEONSTL_CHECK(m.erase(k) == ref.erase(k));
+                break;
+            case 5:
+            {
+                auto it = m.find(k);
+                DEONSTL_CHECK((it == m.end()) == (ref.count(k) == 0));
+                if(it != m.end())
+                {
+                    DEONSTL_CHECK(it->second == ref[k]);
+                    m.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            }
+            case 6:
+                DEONSTL_CHECK(m.count(k) == ref.count(k));
+                break;
+            default:
+                if(step % 700 == 7)
+                    m.rehash(static_cast<size_t>(r % 2048));
+                break;
+        }
+        if(step % 1000 == 0)
+            check_equal(m, ref);
+    }
+    check_equal(m, ref);
+
+    map copy(m);
+    check_equal(copy, ref);
+    map moved(std::move(copy));
+    check_equal(moved, ref);
+    map other;
+    other[key_space + 1] = item(0);
+    other.swap(moved);
+    check_equal(other, ref);
+    DEONSTL_CHECK(moved.size() == 1 && moved.count(key_space + 1) == 1);
+    other.clear();
+    DEONSTL_CHECK(other.empty() && other.begin() == other.end());
+}
+
+// 记录默认构造的次数
+struct counted_value
+{
+    static int& made() { static int n = 0; return n; }
+
+    int v;
+
+    counted_value() : v(0) { ++made(); }
+    counted_value(const counted_value&) = default;
+    counted_value& operator=(const counted_value&) = default;
+};
+
+// operator[] 只在键不存在时构造 mapped_type
+inline void subscript_test()
+{
+    deonSTL::flat_hash_map<uint64_t, counted_value> m;
+    for(uint64_t k = 0; k < 100; ++k)
+        m[k].v = static_cast<int>(k);
+    const int made = counted_value::made();
+    DEONSTL_CHECK(made >= 100);
+    for(uint64_t k = 0; k < 100; ++k)
+    {
+        DEONSTL_CHECK(m[k].v == static_cast<int>(k));
+        uint64_t key = k;
+        DEONSTL_CHECK(m[std::move(key)].v == static_cast<int>(k));
+    }
+    DEONSTL_CHECK(counted_value::made() == made);
+    DEONSTL_CHECK(m[1000].v == 0 && counted_value::made() > made && m.size() == 101);
+}
+
+template <class Set, class Ref>
+void check_set_equal(const Set& s, const Ref& ref)
+{
+    DEONSTL_CHECK(s.size() == ref.size());
+    DEONSTL_CHECK(s.empty() == ref.empty());
+    size_t n = 0;
+    for(auto it = s.begin(); it != s.end(); ++it, ++n)
+        DEONSTL_CHECK(ref.count(*it) == 1);
+    DEONSTL_CHECK(n == ref.size());
+    for(auto it = ref.begin(); it != ref.end(); ++it)
+        DEONSTL_CHECK(s.count(*it) == 1);
+}
+
+// 随机的 insert / emplace / erase(key) / erase(pos) / find / count / rehash，与 std::unordered_set 逐步对比
+template <class Key, class Hash, class MakeKey>
+void set_behaviour_test(uint64_t key_space, MakeKey make_key)
+{
+    typedef deonSTL::flat_hash_set<Key, Hash> set;
+
+    set s;
+    std::unordered_set<Key> ref;
+    uint64_t x = 0x2545f4914f6cdd1dull;
+    for(int step = 0; step < 30000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const Key k = make_key(r % key_space);
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            {
+                auto res = s.insert(k);
+                DEONSTL_CHECK(res.second == ref.insert(k).second && *res.first == k);
+                break;
+            }
+            case 2:
+                DEONSTL_CHECK(s.emplace(k).second == ref.emplace(k).second);
+                break;
+            case 3:
+                DEONSTL_CHECK(s.erase(k) == ref.erase(k));
+                break;
+            case 4:
+            {
+                auto it = s.find(k);
+                DEONSTL_CHECK((it == s.end()) == (ref.count(k) == 0));
+                if(it != s.end())
+                {
+                    s.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            }
+            case 5:
+            {
+                const set& cs = s;
+                DEONSTL_CHECK(cs.count(k) == ref.count(k));
+                DEONSTL_CHECK((cs.find(k) == cs.end()) == (ref.count(k) == 0));
+                break;
+            }
+            default:
+                if(step % 700 == 7)
+                    s.rehash(static_cast<size_t>(r % 2048));
+                break;
+        }
+        if(step % 1000 == 0)
+            check_set_equal(s, ref);
+        DEONSTL_CHECK(s.load_factor() <= s.max_load_factor());
+    }
+    check_set_equal(s, ref);
+
+    set copy(s);
+    DEONSTL_CHECK(copy == s);
+    check_set_equal(copy, ref);
+    copy.insert(make_key(key_space + 1));
+    DEONSTL_CHECK(copy != s);
+    set moved(std::move(copy));
+    DEONSTL_CHECK(moved.size() == ref.size() + 1);
+    set other;
+    other = s;
+    other.swap(moved);
+    DEONSTL_CHECK(moved == s && other.count(make_key(key_space + 1)) == 1);
+    moved.erase(moved.begin(), moved.end());
+    DEONSTL_CHECK(moved.empty() && moved.begin() == moved.end());
+}
+
+// 依次插入 keys、查找 keys、查找 misses，times 为三项每次操作的耗时（纳秒），返回校验和
+template <class Table>
+uint64_t run(Table& t, const deonSTL::vector<uint64_t>& keys,
+             const deonSTL::vector<uint64_t>& misses, double times[3])
+{
+    uint64_t check = 0;
+    const double n = static_cast<double>(keys.size());
+    times[0] = time_ms([&] {
+        for(size_t i = 0; i < keys.size(); ++i)
+            t[keys[i]] = i;
+    }) * 1e6 / n;
+    times[1] = time_ms([&] {
+        for(size_t i = 0; i < keys.size(); ++i)
+        {
+            auto it = t.find(keys[i]);
+            check += it != t.end() ? it->second : 0;
+        }
+    }) * 1e6 / n;
+    times[2] = time_ms([&] {
+        for(size_t i = 0; i < misses.size(); ++i)
+            check += t.find(misses[i]) != t.end() ? 1 : 0;
+    }) * 1e6 / n;
+    return check;
+}
+
+// hashtable 没有 operator[]，包装成同样的接口
+struct robin_hood_map
+{
+    typedef deonSTL::pair<const uint64_t, uint64_t>                                     value_type;
+    typedef deonSTL::hashtable<value_type, std::hash<uint64_t>, std::equal_to<uint64_t>> table;
+
+    table ht;
+
+    uint64_t& operator[](uint64_t key)
+    { return ht.try_emplace_unique(key, key, uint64_t()).first->second; }
+    table::iterator find(uint64_t key) { return ht.find(key); }
+    table::iterator end()              { return ht.end(); }
+};
+
+// buckets 取 2^k - 1，与 flat_hash_map 的容量一致
+void flat_hash_map_test(size_t buckets = (1u << 21) - 1)
+{
+    behaviour_test<deonSTL::hash<uint64_t>>(3000);
+    behaviour_test<bad_hash>(500);
+    subscript_test();
+    set_behaviour_test<std::string, deonSTL::hash<std::string>>(3000, item);
+    set_behaviour_test<uint64_t, bad_hash>(500, [](uint64_t k) { return k; });
+    printf("flat_hash_map behaviour_test passed\n");
+
+    const double factors[4] = {0.5, 0.625, 0.75, 0.875};
+    printf("uint64_t keys, %zu buckets (ns/op)\n", buckets);
+    printf("%-6s %-10s %14s %14s %20s\n", "load", "", "flat_hash_map", "hashtable", "std::unordered_map");
+    for(int f = 0; f < 4; ++f)
+    {
+        // 最大负载系数 7/8 时容量为 2^k - 1 的表最多放 (2^k) * 7/8 - 1 个元素
+        size_t n = static_cast<size_t>(factors[f] * static_cast<double>(buckets + 1));
+        if(n > buckets - (buckets + 1) / 8)
+            n = buckets - (buckets + 1) / 8;
+        deonSTL::vector<uint64_t> keys, misses;
+        uint64_t x = 88172645463325252ull;
+        for(size_t i = 0; i < n; ++i)
+            keys.push_back(next_random(x));
+        for(size_t i = 0; i < n; ++i)
+            misses.push_back(next_random(x));
+
+        double t[3][3];
+        uint64_t c[3];
+        {
+            deonSTL::flat_hash_map<uint64_t, uint64_t> m(buckets);
+            c[0] = run(m, keys, misses, t[0]);
+        }
+        {
+            robin_hood_map m;
+            m.ht.max_load_factor(0.95f);
+            m.ht.rehash(buckets);
+            c[1] = run(m, keys, misses, t[1]);
+        }
+        {
+            std::unordered_map<uint64_t, uint64_t> m;
+            m.reserve(n);
+            c[2] = run(m, keys, misses, t[2]);
+        }
+        const char* items[3] = {"insert", "find hit", "find miss"};
+        for(int i = 0; i < 3; ++i)
+            printf("%-6.3f %-10s %14.1f %14.1f %20.1f\n", factors[f], items[i],
+                   t[0][i], t[1][i], t[2][i]);
+        DEONSTL_CHECK(c[0] == c[1] && c[1] == c[2]);
+    }
+}
+
+} // namespace flat_hash_map_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* flat_hash_map_test_h */
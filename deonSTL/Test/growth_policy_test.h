@@ -0,0 +1,147 @@
+//
+//  growth_policy_test.h
+//  deonSTL
+//
+//  growth_factor_1_5 / growth_factor_2 / growth_size_class 的容量序列、max_n 处的截断，
+//  以及 vector 使用各策略时 push_back、insert 得到的容量（不再有 16 个元素的最小容量）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef growth_policy_test_h
+#define growth_policy_test_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "../growth_policy.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace growth_policy_test{
+
+// 从容量 0 开始，每次只多需要一个元素，依次得到的容量与 expect 相同
+template <class Growth>
+void check_sequence(size_t elem_size, const size_t* expect, size_t n)
+{
+    const size_t max_n = static_cast<size_t>(-1) / elem_size;
+    size_t cap = 0;
+    for(size_t i = 0; i < n; ++i)
+    {
+        cap = Growth::next_capacity(cap, cap + 1, max_n, elem_size);
+        DEONSTL_CHECK(cap == expect[i]);
+    }
+}
+
+inline void sequence_test()
+{
+    const size_t f15[] = { 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94 };
+    check_sequence<growth_factor_1_5>(8, f15, 12);
+
+    const size_t f2[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    check_sequence<growth_factor_2>(8, f2, 8);
+
+    // 8 字节元素：一页以内取 16 字节的倍数，超过一页（420 * 1.5 个元素）取整页
+    const size_t sc8[] = { 2, 4, 6, 10, 16, 24, 36, 54, 82, 124, 186, 280, 420, 1024 };
+    check_sequence<growth_size_class<>>(8, sc8, 14);
+
+    const size_t sc1[] = { 16, 32, 48, 80, 128, 192, 288, 432, 656, 992 };
+    check_sequence<growth_size_class<>>(1, sc1, 10);
+
+    // 24 字节元素 2 倍增长：256 个元素为 6144 字节，取整到两页后只放得下 341 个
+    const size_t sc24[] = { 1, 2, 4, 8, 16, 32, 64, 128, 341, 682 };
+    check_sequence<growth_size_class<growth_factor_2>>(24, sc24, 10);
+}
+
+// 需要的比增长后的多时直接取 need
+inline void need_test()
+{
+    DEONSTL_CHECK(growth_factor_1_5::next_capacity(4, 100, 1000, 8) == 100);
+    DEONSTL_CHECK(growth_factor_2::next_capacity(4, 100, 1000, 8) == 100);
+    DEONSTL_CHECK(growth_size_class<>::next_capacity(4, 100, 1000, 8) == 100);   // 800 字节恰为 16 的倍数
+    DEONSTL_CHECK(growth_size_class<>::next_capacity(4, 101, 1000, 8) == 102);
+}
+
+// 增长后超过 max_n 时截断为 max_n，包括 cap 接近 size_t 上限、乘法会溢出的情况
+inline void max_size_test()
+{
+    DEONSTL_CHECK(growth_factor_1_5::next_capacity(80, 81, 100, 8) == 100);
+    DEONSTL_CHECK(growth_factor_1_5::next_capacity(66, 67, 100, 8) == 99);
+    DEONSTL_CHECK(growth_factor_1_5::next_capacity(99, 100, 100, 8) == 100);
+    DEONSTL_CHECK(growth_factor_2::next_capacity(51, 52, 100, 8) == 100);
+    DEONSTL_CHECK(growth_factor_2::next_capacity(50, 51, 100, 8) == 100);
+    DEONSTL_CHECK(growth_factor_2::next_capacity(49, 50, 100, 8) == 98);
+
+    const size_t huge = static_cast<size_t>(-1);
+    DEONSTL_CHECK(growth_factor_1_5::next_capacity(huge - 1, huge, huge, 1) == huge);
+    DEONSTL_CHECK(growth_factor_2::next_capacity(huge / 2 + 1, huge / 2 + 2, huge, 1) == huge);
+
+    // 取整后超过 max_n 时截断
+    DEONSTL_CHECK(growth_size_class<>::next_capacity(6, 7, 9, 8) == 9);
+    DEONSTL_CHECK(growth_size_class<>::next_capacity(6, 7, 10, 8) == 10);
+    // 取整会让字节数溢出时保留 Base 的结果
+    const size_t max_n = huge / 8;
+    DEONSTL_CHECK(growth_size_class<>::next_capacity(max_n - 1, max_n, max_n, 8) == max_n);
+}
+
+// vector push_back 时依次出现的容量与策略的序列相同，第一次 push_back 只申请一个元素
+template <class Vector>
+void check_vector(const size_t* expect, size_t n)
+{
+    Vector v;
+    DEONSTL_CHECK(v.capacity() == 0);
+    size_t i = 0;
+    size_t cap = 0;
+    while(i < n)
+    {
+        v.push_back(typename Vector::value_type());
+        if(v.capacity() != cap)
+        {
+            cap = v.capacity();
+            DEONSTL_CHECK(cap == expect[i]);
+            ++i;
+        }
+    }
+}
+
+inline void vector_test()
+{
+    const size_t f15[] = { 1, 2, 3, 4, 6, 9, 13, 19, 28, 42, 63, 94 };
+    check_vector<deonSTL::vector<uint64_t>>(f15, 12);
+
+    const size_t f2[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    check_vector<deonSTL::vector<uint64_t, deonSTL::allocator<uint64_t>, growth_factor_2>>(f2, 8);
+
+    const size_t sc8[] = { 2, 4, 6, 10, 16, 24, 36, 54, 82, 124, 186, 280, 420, 1024 };
+    check_vector<deonSTL::vector<uint64_t, deonSTL::allocator<uint64_t>, growth_size_class<>>>(sc8, 14);
+
+    // 一次插入多个元素，增长后仍不够时容量恰为需要的大小
+    deonSTL::vector<int> v(4, 1);
+    DEONSTL_CHECK(v.capacity() == 4);
+    v.insert(v.end(), 10, 2);
+    DEONSTL_CHECK(v.size() == 14 && v.capacity() == 14);
+    v.push_back(3);
+    DEONSTL_CHECK(v.capacity() == 21);
+}
+
+void growth_policy_test()
+{
+    sequence_test();
+    need_test();
+    max_size_test();
+    vector_test();
+    printf("growth_policy_test passed\n");
+}
+
+} // namespace growth_policy_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* growth_policy_test_h */
@@ -0,0 +1,179 @@
+//
+//  hash_policy_test.h
+//  deonSTL
+//
+//  hashtable 求桶下标的三种策略的开销：
+//  index : 只计算桶下标（取模 / fastmod / 乘法移位），衡量每次查找多出的计算
+//  find  : 在放得进缓存的小表与放不进缓存的大表中查找命中，键为 uint64_t
+//  计时之前先检查每种策略的下标落在 [0, n) 中、fastmod 与取模的结果相同，
+//  以及以各策略实例化的 hashtable 在随机插入删除下与 std::unordered_set 内容一致
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef hash_policy_test_h
+#define hash_policy_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <unordered_set>
+#include "../hashtable.h"
+#include "../hash_policy.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace hash_policy_test{
+
+// 每张质数表中的桶数：fastmod 的下标等于 hash 值折叠到 32 位后取模；三种策略的下标都小于桶数
+inline void index_check()
+{
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for(size_t p = 0; p < PRIME_NUM; ++p)
+    {
+        const size_t n = ht_prime_list[p];
+        const ht_prime_mod mod(ht_prime_mod::next_bucket_count(n));
+        const ht_prime_fastmod fast(ht_prime_fastmod::next_bucket_count(n));
+        const ht_pow2_mix mix(ht_pow2_mix::next_bucket_count(n));
+        const size_t pow2 = ht_pow2_mix::next_bucket_count(n);
+        DEONSTL_CHECK(pow2 >= n || pow2 == ht_pow2_mix::max_bucket_count());
+        for(int i = 0; i < 2000; ++i)
+        {
+            const size_t h = static_cast<size_t>(i < 4 ? (i < 2 ? i : ~uint64_t(0) - i) : next_random(x));
+            DEONSTL_CHECK(mod.index(h) == h % n);
+            const size_t f = fast.index(h);
+            DEONSTL_CHECK(f < n);
+            if(static_cast<uint64_t>(n) <= 0xFFFFFFFFull)
+            {
+                const uint64_t a = static_cast<uint32_t>(static_cast<uint64_t>(h) ^ (static_cast<uint64_t>(h) >> 32));
+#if defined(__SIZEOF_INT128__)
+                DEONSTL_CHECK(f == a % n);
+#else
+                DEONSTL_CHECK(f == h % n);
+#endif
+            }
+            DEONSTL_CHECK(mix.index(h) < pow2);
+            DEONSTL_CHECK(ht_bucket_index(mix, h, std::true_type()) < pow2);
+        }
+    }
+}
+
+// 以 Policy 实例化的 hashtable：随机插入、删除、查找、rehash，与 std::unordered_set 对比
+template <class Policy>
+void table_check()
+{
+    typedef deonSTL::hashtable<uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                               deonSTL::allocator<uint64_t>, Policy> table;
+    table h;
+    std::unordered_set<uint64_t> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const uint64_t k = (r % 4000) << (r >> 60);     // 步长为 2 的幂的键
+        switch(r >> 32 & 3)
+        {
+            case 0:
+            case 1:
+                DEONSTL_CHECK(h.insert_unique(k).second == ref.insert(k).second);
+                break;
+            case 2:
+                DEONSTL_CHECK(h.erase_unique(k) == ref.erase(k));
+                break;
+            default:
+                DEONSTL_CHECK((h.find(k) != h.end()) == (ref.count(k) != 0));
+                if(step % 1000 == 3)
+                    h.rehash(static_cast<size_t>(r % 5000));
+                break;
+        }
+        DEONSTL_CHECK(h.size() == ref.size());
+    }
+    for(auto it = h.begin(); it != h.end(); ++it)
+        DEONSTL_CHECK(ref.count(*it) == 1);
+}
+
+// 每个 hash 值的桶下标依赖上一个结果，测的是延迟而不是吞吐量，与查找中的情形一致
+template <class Policy>
+double index_ns(const deonSTL::vector<uint64_t>& hashes, size_t buckets, int rounds, uint64_t& check)
+{
+    const Policy policy(Policy::next_bucket_count(buckets));
+    size_t prev = 0;
+    const double ms = time_ms([&] {
+        for(int r = 0; r < rounds; ++r)
+            for(size_t i = 0; i < hashes.size(); ++i)
+                prev = policy.index(hashes[i] ^ prev);
+    });
+    check += prev;
+    return ms * 1e6 / (static_cast<double>(hashes.size()) * rounds);
+}
+
+template <class Policy>
+double find_ns(const deonSTL::vector<uint64_t>& keys, int rounds, uint64_t& check)
+{
+    typedef deonSTL::hashtable<uint64_t, std::hash<uint64_t>, std::equal_to<uint64_t>,
+                               deonSTL::allocator<uint64_t>, Policy> table;
+    table h;
+    h.reserve(keys.size());
+    for(size_t i = 0; i < keys.size(); ++i)
+        h.insert_unique(keys[i]);
+    size_t hits = 0;
+    const double ms = time_ms([&] {
+        for(int r = 0; r < rounds; ++r)
+            for(size_t i = 0; i < keys.size(); ++i)
+                hits += h.find(keys[i]) != h.end() ? 1 : 0;
+    });
+    DEONSTL_CHECK(hits == h.size() * rounds);
+    check += hits;
+    return ms * 1e6 / (static_cast<double>(keys.size()) * rounds);
+}
+
+void hash_policy_test(size_t small = 4096, size_t large = 4000000)
+{
+    index_check();
+    table_check<ht_prime_mod>();
+    table_check<ht_prime_fastmod>();
+    table_check<ht_pow2_mix>();
+    printf("hash_policy checks passed\n");
+
+    uint64_t check = 0;
+    uint64_t x = 88172645463325252ull;
+    deonSTL::vector<uint64_t> hashes;
+    for(size_t i = 0; i < 1000000; ++i)
+        hashes.push_back(next_random(x));
+
+    printf("ns per operation\n");
+    printf("%-26s %14s %14s %14s\n", "", "prime_mod", "prime_fastmod", "pow2_mix");
+    printf("%-26s %14.2f %14.2f %14.2f\n", "index",
+           index_ns<ht_prime_mod>(hashes, 1000000, 20, check),
+           index_ns<ht_prime_fastmod>(hashes, 1000000, 20, check),
+           index_ns<ht_pow2_mix>(hashes, 1000000, 20, check));
+
+    const size_t sizes[2] = {small, large};
+    const int rounds[2] = {2000, 2};
+    for(int s = 0; s < 2; ++s)
+    {
+        deonSTL::vector<uint64_t> keys;
+        for(size_t i = 0; i < sizes[s]; ++i)
+            keys.push_back(next_random(x));
+        char name[64];
+        snprintf(name, sizeof(name), "find hit, n = %zu", sizes[s]);
+        printf("%-26s %14.2f %14.2f %14.2f\n", name,
+               find_ns<ht_prime_mod>(keys, rounds[s], check),
+               find_ns<ht_prime_fastmod>(keys, rounds[s], check),
+               find_ns<ht_pow2_mix>(keys, rounds[s], check));
+    }
+    printf("(check %llu)\n", static_cast<unsigned long long>(check));
+}
+
+} // namespace hash_policy_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* hash_policy_test_h */
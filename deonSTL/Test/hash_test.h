@@ -0,0 +1,321 @@
+//
+//  hash_test.h
+//  deonSTL
+//
+//  deonSTL::hash 与 std::hash 的对比：
+//  distribution : 顺序、等间隔、字符串三类键放进 2^16 个桶，分别取 hash 值的低位 / 高位作为桶下标，
+//                 给出卡方值 / 自由度（均匀分布时接近 1）与最满的桶中的键数
+//  avalanche    : 翻转输入的一位，每个输出位翻转的概率应为 1/2，给出所有（输入位，输出位）中偏离 1/2 的最大值与平均值
+//  throughput   : 不同长度的字节串的 hash 速度（GB/s）
+//  properties   : 与 std::unordered_set 对比不同的键得到不同的 hash 值，同一字节串在不同地址上 hash 值相同；
+//                 distribution 与 avalanche 中 deonSTL::hash 的结果必须接近均匀（超出统计误差时失败）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef hash_test_h
+#define hash_test_h
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include "../hash.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace hash_test{
+
+//***************************************************************************//
+//                                properties                                 //
+//***************************************************************************//
+
+// 不同的键得到不同的 hash 值：64 位 hash 值在这些键数下出现碰撞的概率可以忽略
+inline void collision_test()
+{
+    std::unordered_set<std::string> keys;
+    std::unordered_set<uint64_t> hashes;
+    deonSTL::hash<std::string> h;
+    uint64_t x = 88172645463325252ull;
+    std::string s;
+    for(size_t len = 0; len <= 600; ++len)      // 跨过 16 / 48 / 256 字节的分支
+    {
+        for(int i = 0; i < 40; ++i)
+        {
+            s.resize(len);
+            for(size_t j = 0; j < len; ++j)
+                s[j] = static_cast<char>(next_random(x) % 4);   // 字母表很小，不同长度的串常有相同前缀
+            if(keys.insert(s).second)
+                DEONSTL_CHECK(hashes.insert(h(s)).second);
+        }
+        s.assign(len, '\0');                    // 全零串只有长度不同
+        if(keys.insert(s).second)
+            DEONSTL_CHECK(hashes.insert(h(s)).second);
+    }
+    DEONSTL_CHECK(hashes.size() == keys.size());
+
+    std::unordered_set<uint64_t> ints;
+    deonSTL::hash<uint64_t> hi;
+    for(uint64_t i = 0; i < 100000; ++i)
+    {
+        DEONSTL_CHECK(ints.insert(hi(i)).second);
+        DEONSTL_CHECK(ints.insert(hi(i << 32 | 0xFFFFFFFFull)).second);
+    }
+}
+
+// hash 值只取决于内容：同一字节串放在不同对齐的地址上结果相同；改动任一字节结果改变
+inline void content_test()
+{
+    deonSTL::hash<std::string> h;
+    deonSTL::vector<char> buf(700 + 16);
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for(size_t i = 0; i < buf.size(); ++i)
+        buf[i] = static_cast<char>(next_random(x));
+    for(size_t len = 0; len <= 700; len += len < 80 ? 1 : 37)
+    {
+        const std::string base(&buf[0], len);
+        const size_t hb = h(base);
+        for(size_t off = 1; off < 16; ++off)
+        {
+            std::memmove(&buf[off], &buf[off - 1], len);
+            DEONSTL_CHECK(deonSTL::hash_bytes(&buf[off], len) == hb);
+        }
+        std::memmove(&buf[0], &buf[15], len);
+        for(size_t pos = 0; pos < len; pos += 1 + pos / 8)
+        {
+            std::string t(base);
+            t[pos] = static_cast<char>(t[pos] ^ 0x20);
+            DEONSTL_CHECK(h(t) != hb);
+        }
+    }
+
+    DEONSTL_CHECK(deonSTL::hash<double>()(0.0) == deonSTL::hash<double>()(-0.0));
+    DEONSTL_CHECK(deonSTL::hash<float>()(0.0f) == deonSTL::hash<float>()(-0.0f));
+    static_assert(deonSTL::is_avalanching<deonSTL::hash<std::string>>::value &&
+                  deonSTL::is_avalanching<deonSTL::hash<int>>::value &&
+                  !deonSTL::is_avalanching<std::hash<int>>::value, "is_avalanching");
+}
+
+//***************************************************************************//
+//                               distribution                                //
+//***************************************************************************//
+
+const unsigned bucket_bits = 16;
+
+// 打印 hash 值 hs 放进 2^bucket_bits 个桶的卡方值 / 自由度与最大桶，分别按低位、高位取桶下标，返回两者中较大的卡方值 / 自由度
+inline double print_distribution(const char* name, const deonSTL::vector<uint64_t>& hs)
+{
+    double worst = 0.0;
+    const size_t buckets = size_t(1) << bucket_bits;
+    const double expect = static_cast<double>(hs.size()) / buckets;
+    printf("%-28s", name);
+    for(int high = 0; high < 2; ++high)
+    {
+        deonSTL::vector<size_t> count(buckets, 0);
+        for(size_t i = 0; i < hs.size(); ++i)
+            ++count[high ? hs[i] >> (64 - bucket_bits) : hs[i] & (buckets - 1)];
+        double chi = 0.0;
+        size_t max_load = 0;
+        for(size_t b = 0; b < buckets; ++b)
+        {
+            const double d = static_cast<double>(count[b]) - expect;
+            chi += d * d / expect;
+            max_load = count[b] > max_load ? count[b] : max_load;
+        }
+        printf(" %12.2f %6zu", chi / (buckets - 1), max_load);
+        worst = chi / (buckets - 1) > worst ? chi / (buckets - 1) : worst;
+    }
+    printf("\n");
+    return worst;
+}
+
+// 同一组键分别用 deonSTL::hash 与 std::hash 计算（size_t 为 32 位时高位为 0，只看低位），返回 deonSTL::hash 的卡方值 / 自由度
+template <class Key>
+double distribution(const char* name, const deonSTL::vector<Key>& keys)
+{
+    deonSTL::vector<uint64_t> ours, theirs;
+    for(size_t i = 0; i < keys.size(); ++i)
+    {
+        ours.push_back(deonSTL::hash<Key>()(keys[i]));
+        theirs.push_back(std::hash<Key>()(keys[i]));
+    }
+    char label[64];
+    snprintf(label, sizeof(label), "%s deonSTL", name);
+    const double worst = print_distribution(label, ours);
+    snprintf(label, sizeof(label), "%s std", name);
+    print_distribution(label, theirs);
+    return worst;
+}
+
+inline void distribution_test(size_t n)
+{
+    printf("distribution: %zu keys, %zu buckets (chi2/df ~ 1 is uniform)\n", n, size_t(1) << bucket_bits);
+    printf("%-28s %12s %6s %12s %6s\n", "", "low chi2/df", "max", "high chi2/df", "max");
+    deonSTL::vector<uint64_t> seq, stride;
+    deonSTL::vector<std::string> strs;
+    for(size_t i = 0; i < n; ++i)
+    {
+        seq.push_back(i);
+        stride.push_back(i << 12);
+        strs.push_back("user:" + std::to_string(i));
+    }
+    // 均匀分布时卡方值 / 自由度的标准差约为 sqrt(2 / 自由度) = 0.0055
+    const double bound = n >= (size_t(1) << bucket_bits) ? 1.1 : 2.0;
+    DEONSTL_CHECK(distribution("sequential", seq) < bound);
+    DEONSTL_CHECK(distribution("stride 4096", stride) < bound);
+    DEONSTL_CHECK(distribution("string", strs) < bound);
+}
+
+//***************************************************************************//
+//                                avalanche                                  //
+//***************************************************************************//
+
+// 对 trials 个随机输入，翻转 bits 个位置中的每一位，统计 64 个输出位各自翻转的次数
+// key 提供随机输入，flip_bit 翻转其中一位，h 计算 hash 值；返回偏离 1/2 的最大值
+template <class Key, class FlipBit, class Hash>
+double avalanche(const char* name, Key key, size_t bits, FlipBit flip_bit, Hash h, size_t trials)
+{
+    deonSTL::vector<uint32_t> flips(bits * 64, 0);
+    uint64_t x = 88172645463325252ull;
+    for(size_t t = 0; t < trials; ++t)
+    {
+        key.randomize(x);
+        const uint64_t base = h(key.value);
+        for(size_t b = 0; b < bits; ++b)
+        {
+            flip_bit(key.value, b);
+            uint64_t diff = base ^ h(key.value);
+            flip_bit(key.value, b);
+            for(size_t o = 0; diff != 0; ++o, diff >>= 1)
+                flips[b * 64 + o] += static_cast<uint32_t>(diff & 1);
+        }
+    }
+    double worst = 0.0, mean = 0.0;
+    for(size_t i = 0; i < flips.size(); ++i)
+    {
+        const double bias = std::fabs(static_cast<double>(flips[i]) / trials - 0.5);
+        worst = bias > worst ? bias : worst;
+        mean += bias;
+    }
+    printf("%-28s %12.4f %12.4f\n", name, worst, mean / flips.size());
+    return worst;
+}
+
+struct int_key
+{
+    uint64_t value;
+    void randomize(uint64_t& x) { value = next_random(x); }
+};
+
+template <size_t N>
+struct string_key
+{
+    std::string value;
+    string_key() : value(N, '\0') {}
+    void randomize(uint64_t& x)
+    {
+        for(size_t i = 0; i < N; ++i)
+            value[i] = static_cast<char>(next_random(x));
+    }
+};
+
+inline void flip_int(uint64_t& v, size_t b) { v ^= uint64_t(1) << b; }
+
+// 长字符串只翻转开头、中间、结尾的各 64 位
+template <size_t N>
+void flip_string(std::string& s, size_t b)
+{
+    size_t pos = b;
+    if(N * 8 > 192)
+        pos = b < 64 ? b : b < 128 ? N * 4 + b - 64 : N * 8 - 192 + b;
+    s[pos / 8] = static_cast<char>(s[pos / 8] ^ (1 << (pos % 8)));
+}
+
+inline void avalanche_test(size_t trials)
+{
+    printf("avalanche: %zu trials per input bit (ideal bias 0)\n", trials);
+    printf("%-28s %12s %12s\n", "", "worst bias", "mean bias");
+    // 每个（输入位，输出位）翻转比例的标准差为 0.5 / sqrt(trials)，在几千个组合中取最大值，允许 8 倍标准差
+    const double bound = 4.0 / std::sqrt(static_cast<double>(trials));
+    DEONSTL_CHECK(avalanche("uint64_t deonSTL", int_key(), 64, flip_int, deonSTL::hash<uint64_t>(), trials) < bound);
+    avalanche("uint64_t std", int_key(), 64, flip_int, std::hash<uint64_t>(), trials);
+    DEONSTL_CHECK(avalanche("string(8) deonSTL", string_key<8>(), 64, flip_string<8>,
+                            deonSTL::hash<std::string>(), trials) < bound);
+    avalanche("string(8) std", string_key<8>(), 64, flip_string<8>, std::hash<std::string>(), trials);
+    DEONSTL_CHECK(avalanche("string(24) deonSTL", string_key<24>(), 192, flip_string<24>,
+                            deonSTL::hash<std::string>(), trials) < bound);
+    avalanche("string(24) std", string_key<24>(), 192, flip_string<24>, std::hash<std::string>(), trials);
+    DEONSTL_CHECK(avalanche("string(1000) deonSTL", string_key<1000>(), 192, flip_string<1000>,
+                            deonSTL::hash<std::string>(), trials) < bound);
+    avalanche("string(1000) std", string_key<1000>(), 192, flip_string<1000>, std::hash<std::string>(), trials);
+}
+
+//***************************************************************************//
+//                                throughput                                 //
+//***************************************************************************//
+
+// 事先从随机字节的不同偏移处取 64 个长度为 len 的字符串，轮流计算；上一次的结果决定下一个字符串，防止被优化掉或并行执行
+template <class Hash>
+double gbps(const deonSTL::vector<std::string>& strs, size_t total, Hash h, uint64_t& check)
+{
+    const size_t len = strs[0].size();
+    const size_t count = total / len + 1;
+    uint64_t acc = 0;
+    const double ms = time_ms([&] {
+        for(size_t i = 0; i < count; ++i)
+            acc += h(strs[(i + acc) & 63]);
+    });
+    check += acc;
+    return static_cast<double>(count) * len / (ms * 1e6);
+}
+
+inline void throughput_test(size_t total)
+{
+    const size_t sizes[] = {8, 16, 32, 64, 128, 256, 1024, 4096, 65536};
+    deonSTL::vector<char> buf(65536 + 64);
+    uint64_t x = 88172645463325252ull;
+    for(size_t i = 0; i < buf.size(); ++i)
+        buf[i] = static_cast<char>(next_random(x));
+
+    uint64_t check = 0;
+    printf("throughput: GB/s\n");
+    printf("%-28s %12s %12s\n", "", "deonSTL", "std");
+    for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        deonSTL::vector<std::string> strs;
+        for(size_t i = 0; i < 64; ++i)
+            strs.push_back(std::string(&buf[i], sizes[s]));
+        char name[32];
+        snprintf(name, sizeof(name), "string(%zu)", sizes[s]);
+        printf("%-28s %12.2f %12.2f\n", name,
+               gbps(strs, total, deonSTL::hash<std::string>(), check),
+               gbps(strs, total, std::hash<std::string>(), check));
+    }
+    printf("(check %llu)\n", static_cast<unsigned long long>(check));
+}
+
+void hash_test(size_t keys = 1 << 20, size_t trials = 20000, size_t total = size_t(1) << 30)
+{
+    collision_test();
+    content_test();
+    printf("hash properties passed\n");
+    distribution_test(keys);
+    avalanche_test(trials);
+    throughput_test(total);
+}
+
+} // namespace hash_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* hash_test_h */
@@ -0,0 +1,294 @@
+//
+//  hashtable_test.h
+//  deonSTL
+//
+//  hashtable（开放定址）的行为与吞吐量：随机的插入、删除、查找与 std::unordered_map / std::unordered_multiset
+//  逐步对比（含大量 hash 冲突的情形）；与 std::unordered_map（分离链接）的吞吐量对比：
+//  n 个随机键的插入、查找命中、查找未命中、删除，键为 uint64_t 与长度 24 的字符串两种
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef hashtable_test_h
+#define hashtable_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "../hashtable.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace hashtable_test{
+
+// 只有 8 个不同 hash 值的 hash 函数：探测序列很长，插入与删除时大量搬移槽
+struct bad_hash
+{
+    size_t operator()(uint64_t k) const noexcept { return static_cast<size_t>(k % 8); }
+};
+
+template <class Table, class Ref>
+void check_unique(const Table& h, const Ref& ref)
+{
+    DEONSTL_CHECK(h.size() == ref.size());
+    size_t n = 0;
+    for(auto it = h.begin(); it != h.end(); ++it, ++n)
+    {
+        auto r = ref.find(it->first);
+        DEONSTL_CHECK(r != ref.end() && r->second == it->second);
+    }
+    DEONSTL_CHECK(n == ref.size());
+}
+
+// insert_unique / emplace_unique / erase_unique / erase(pos) / find / count_unique 与 std::unordered_map 对比
+template <class Hash>
+void unique_test(uint64_t key_space)
+{
+    typedef deonSTL::pair<const uint64_t, uint64_t>                         value_type;
+    typedef deonSTL::hashtable<value_type, Hash, std::equal_to<uint64_t>>   table;
+
+    table h;
+    std::unordered_map<uint64_t, uint64_t> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const uint64_t k = r % key_space;
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            {
+                auto res = h.insert_unique(value_type(k, r));
+                auto rr = ref.insert(std::make_pair(k, r));
+                DEONSTL_CHECK(res.second == rr.second);
+                DEONSTL_CHECK(res.first->first == k && res.first->second == rr.first->second);
+                break;
+            }
+            case 2:
+            {
+                auto res = h.emplace_unique(k, r + 1);
+                DEONSTL_CHECK(res.second == ref.emplace(k, r + 1).second);
+                break;
+            }
+            case 3:
+            case 4:
+                DEONSTL_CHECK(h.erase_unique(k) == ref.erase(k));
+                break;
+            case 5:
+            {
+                auto it = h.find(k);
+                DEONSTL_CHECK((it == h.end()) == (ref.count(k) == 0));
+                if(it != h.end())
+                {
+                    h.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            }
+            case 6:
+                DEONSTL_CHECK(h.count_unique(k) == ref.count(k));
+                break;
+            default:
+                if(step % 500 == 7)
+                    h.rehash(r % 3 == 0 ? 0 : static_cast<size_t>(r % 4096));
+                break;
+        }
+        if(step % 1000 == 0)
+            check_unique(h, ref);
+    }
+    check_unique(h, ref);
+
+    // 复制、移动、交换
+    table copy(h);
+    check_unique(copy, ref);
+    DEONSTL_CHECK(copy.equal_to_unique(h));
+    table moved(std::move(copy));
+    check_unique(moved, ref);
+    DEONSTL_CHECK(copy.empty());
+    table other;
+    other.insert_unique(value_type(key_space + 1, 0));
+    other.swap(moved);
+    check_unique(other, ref);
+    DEONSTL_CHECK(moved.size() == 1 && moved.find(key_space + 1) != moved.end());
+    other.clear();
+    DEONSTL_CHECK(other.empty() && other.begin() == other.end());
+}
+
+// insert_multi / erase_multi / count_multi / equal_range_multi 与 std::unordered_multiset 对比
+template <class Hash>
+void multi_test(uint64_t key_space)
+{
+    typedef deonSTL::hashtable<uint64_t, Hash, std::equal_to<uint64_t>>    table;
+
+    table h;
+    std::unordered_multiset<uint64_t> ref;
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const uint64_t k = r % key_space;
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            case 2:
+                DEONSTL_CHECK(*h.insert_multi(k) == k);
+                ref.insert(k);
+                break;
+            case 3:
+                DEONSTL_CHECK(h.erase_multi(k) == ref.erase(k));
+                break;
+            case 4:
+            {
+                auto it = h.find(k);
+                DEONSTL_CHECK((it == h.end()) == (ref.count(k) == 0));
+                if(it != h.end())
+                {
+                    h.erase(it);
+                    ref.erase(ref.find(k));
+                }
+                break;
+            }
+            case 5:
+            {
+                auto range = h.equal_range_multi(k);
+                size_t n = 0;
+                for(auto it = range.first; it != range.second; ++it, ++n)
+                    DEONSTL_CHECK(*it == k);
+                DEONSTL_CHECK(n == ref.count(k));
+                break;
+            }
+            case 6:
+                DEONSTL_CHECK(h.count_multi(k) == ref.count(k));
+                break;
+            default:
+                if(step % 500 == 7)
+                    h.rehash(static_cast<size_t>(r % 4096));
+                break;
+        }
+        DEONSTL_CHECK(h.size() == ref.size());
+    }
+    for(uint64_t k = 0; k < key_space; ++k)
+        DEONSTL_CHECK(h.count_multi(k) == ref.count(k));
+    table copy(h);
+    DEONSTL_CHECK(copy.equal_to_multi(h));
+}
+
+inline void behaviour_test()
+{
+    unique_test<std::hash<uint64_t>>(3000);
+    unique_test<bad_hash>(600);
+    multi_test<std::hash<uint64_t>>(500);
+    multi_test<bad_hash>(200);
+    printf("hashtable behaviour_test passed\n");
+}
+
+inline void make_keys(deonSTL::vector<uint64_t>& keys, size_t n, uint64_t seed)
+{
+    keys.clear();
+    for(size_t i = 0; i < n; ++i)
+        keys.push_back(next_random(seed));
+}
+
+inline void make_keys(deonSTL::vector<std::string>& keys, size_t n, uint64_t seed)
+{
+    keys.clear();
+    char buf[32];
+    for(size_t i = 0; i < n; ++i)
+    {
+        snprintf(buf, sizeof(buf), "key-%020llu", static_cast<unsigned long long>(next_random(seed)));
+        keys.push_back(std::string(buf));
+    }
+}
+
+// 依次插入 keys、查找 keys、查找 misses、删除 keys，times 为四项的耗时（毫秒），返回校验和
+template <class Key, class Insert, class Find, class Erase>
+uint64_t run(const deonSTL::vector<Key>& keys, const deonSTL::vector<Key>& misses,
+             Insert insert, Find find, Erase erase, double times[4])
+{
+    uint64_t check = 0;
+    times[0] = time_ms([&] {
+        for(size_t i = 0; i < keys.size(); ++i)
+            insert(keys[i], i);
+    });
+    times[1] = time_ms([&] {
+        for(size_t i = 0; i < keys.size(); ++i)
+            check += find(keys[i]);
+    });
+    times[2] = time_ms([&] {
+        for(size_t i = 0; i < misses.size(); ++i)
+            check += find(misses[i]);
+    });
+    times[3] = time_ms([&] {
+        for(size_t i = 0; i < keys.size(); ++i)
+            check += erase(keys[i]);
+    });
+    return check;
+}
+
+template <class Key>
+void compare(const char* name, size_t n)
+{
+    typedef deonSTL::pair<const Key, uint64_t>                                  value_type;
+    typedef deonSTL::hashtable<value_type, std::hash<Key>, std::equal_to<Key>>  table;
+    typedef std::unordered_map<Key, uint64_t>                                   std_table;
+
+    deonSTL::vector<Key> keys, misses;
+    make_keys(keys, n, 88172645463325252ull);
+    make_keys(misses, n, 1234567890123456789ull);
+
+    double t1[4], t2[4];
+    uint64_t c1, c2;
+    {
+        table h;
+        c1 = run(keys, misses,
+                 [&](const Key& k, uint64_t v) { h.insert_unique(value_type(k, v)); },
+                 [&](const Key& k) -> uint64_t {
+                     auto it = h.find(k);
+                     return it != h.end() ? it->second : 0;
+                 },
+                 [&](const Key& k) -> uint64_t { return h.erase_unique(k); },
+                 t1);
+    }
+    {
+        std_table h;
+        c2 = run(keys, misses,
+                 [&](const Key& k, uint64_t v) { h.insert(std::make_pair(k, v)); },
+                 [&](const Key& k) -> uint64_t {
+                     auto it = h.find(k);
+                     return it != h.end() ? it->second : 0;
+                 },
+                 [&](const Key& k) -> uint64_t { return h.erase(k); },
+                 t2);
+    }
+    const char* items[4] = {"insert", "find hit", "find miss", "erase"};
+    printf("%s, n = %zu (ns/op)\n", name, n);
+    printf("%-12s %14s %18s\n", "", "hashtable", "std::unordered_map");
+    for(int i = 0; i < 4; ++i)
+        printf("%-12s %14.1f %18.1f\n", items[i], t1[i] * 1e6 / n, t2[i] * 1e6 / n);
+    DEONSTL_CHECK(c1 == c2);
+}
+
+void hashtable_test(size_t n = 1000000)
+{
+    behaviour_test();
+    compare<uint64_t>("uint64_t", n);
+    compare<std::string>("string(24)", n);
+}
+
+} // namespace hashtable_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* hashtable_test_h */
@@ -0,0 +1,275 @@
+//
+//  incremental_hashtable_test.h
+//  deonSTL
+//
+//  逐个插入随机 uint64_t 键，记录每次插入的耗时，对比 hashtable（一次性扩容）与 incremental_hashtable（增量扩容）
+//  的 p50 / p99 / p99.9 / p99.99 / 最大单次耗时与总耗时
+//  计时之前先检查行为：随机操作与 std::unordered_set 对比，扩容中边遍历边删除，
+//  以及参数引用表中元素（insert_unique(*begin())、find(*it)）时移动桶不影响结果；
+//  扩容中 find 不改变 end()，最大负载系数很小时下一次扩容前 old_ 也已移空
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef incremental_hashtable_test_h
+#define incremental_hashtable_test_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include "../hashtable.h"
+#include "../incremental_hashtable.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace incremental_hashtable_test{
+
+typedef deonSTL::incremental_hashtable<uint64_t, deonSTL::hash<uint64_t>,
+                                       std::equal_to<uint64_t>>         int_table;
+typedef deonSTL::incremental_hashtable<std::string, deonSTL::hash<std::string>,
+                                       std::equal_to<std::string>>      string_table;
+
+// 随机的插入、删除、查找与 std::unordered_set 对比，键的范围使表反复扩容，大部分操作发生在扩容中
+inline void behaviour_test()
+{
+    int_table t;
+    std::unordered_set<uint64_t> ref;
+    uint64_t x = 88172645463325252ull;
+    size_t migrating = 0;
+    for(int i = 0; i < 200000; ++i)
+    {
+        const uint64_t k = next_random(x) % 100000;
+        switch(i % 5)
+        {
+            case 0:
+            case 1:
+            case 2:
+            {
+                auto res = t.insert_unique(k);
+                DEONSTL_CHECK(res.second == ref.insert(k).second);
+                DEONSTL_CHECK(*res.first == k);
+                break;
+            }
+            case 3:
+                DEONSTL_CHECK(t.erase_unique(k) == ref.erase(k));
+                break;
+            default:
+            {
+                auto it = t.find(k);
+                DEONSTL_CHECK((it != t.end()) == (ref.count(k) != 0));
+                if(it != t.end())
+                    DEONSTL_CHECK(*it == k);
+                DEONSTL_CHECK(t.count_unique(k) == ref.count(k));
+                break;
+            }
+        }
+        migrating += t.migrating() ? 1 : 0;
+        DEONSTL_CHECK(t.size() == ref.size());
+        if(i % 9973 == 0)
+        {
+            size_t n = 0;
+            for(auto it = t.begin(); it != t.end(); ++it, ++n)
+                DEONSTL_CHECK(ref.count(*it) == 1);
+            DEONSTL_CHECK(n == ref.size());
+        }
+    }
+    DEONSTL_CHECK(migrating > 0);
+}
+
+// 扩容中 erase(pos) 不移动桶，边遍历边删除能访问到每个元素；复制、移动、clear
+inline void erase_test()
+{
+    int_table t;
+    for(uint64_t i = 0; i < 100000; ++i)
+        t.insert_unique(i);
+    while(!t.migrating())
+        t.insert_unique(1000000 + t.size());
+    std::unordered_set<uint64_t> ref;
+    for(auto it = t.begin(); it != t.end(); ++it)
+        ref.insert(*it);
+    DEONSTL_CHECK(ref.size() == t.size());
+
+    for(auto it = t.begin(); it != t.end(); )
+    {
+        if(*it % 2 != 0)
+        {
+            ref.erase(*it);
+            it = t.erase(it);
+        }
+        else
+            ++it;
+    }
+    DEONSTL_CHECK(t.size() == ref.size());
+    for(auto it = t.begin(); it != t.end(); ++it)
+        DEONSTL_CHECK(*it % 2 == 0 && ref.count(*it) == 1);
+
+    int_table copy(t);
+    DEONSTL_CHECK(copy.size() == ref.size());
+    int_table moved(std::move(copy));
+    DEONSTL_CHECK(moved.size() == ref.size());
+    for(auto it = ref.begin(); it != ref.end(); ++it)
+        DEONSTL_CHECK(moved.count_unique(*it) == 1);
+    t.clear();
+    DEONSTL_CHECK(t.empty() && t.begin() == t.end());
+}
+
+// 参数引用表中的元素：操作完成之后才移动桶，返回的迭代器指向移动后的位置
+// begin() 在 old_ 中，最后一个元素在 cur_ 中，两种位置都检查
+inline void alias_test()
+{
+    string_table t;
+    int k = 0;
+    do
+        t.insert_unique(std::to_string(k++));
+    while(!(t.migrating() && k > 1000));
+    const size_t size = t.size();
+    for(int j = 0; j < 200 && t.migrating(); ++j)
+    {
+        auto r = t.insert_unique(*t.begin());
+        DEONSTL_CHECK(!r.second && t.size() == size);
+        auto f = t.find(*t.begin());
+        DEONSTL_CHECK(f != t.end() && f == t.begin());
+
+        auto last = t.begin();
+        for(auto it = t.begin(); it != t.end(); ++it)
+            last = it;
+        const std::string key = *last;
+        r = t.insert_unique(*last);
+        DEONSTL_CHECK(!r.second && *r.first == key);
+        f = t.find(*r.first);
+        DEONSTL_CHECK(f != t.end() && *f == key);
+        DEONSTL_CHECK(t.size() == size);
+    }
+    for(int i = 0; i < k; ++i)
+        DEONSTL_CHECK(*t.find(std::to_string(i)) == std::to_string(i));
+}
+
+// 所有键的 hash 值相同：元素聚成一段，这个桶移入 cur_ 时段的末尾常常超出槽数组，要扩充溢出槽（重新分配槽数组）
+struct constant_hash
+{
+    size_t operator()(uint64_t) const noexcept { return static_cast<size_t>(0x9E3779B97F4A7C15ull); }
+};
+
+// 扩容中先求 end() 再 find：find 不移动桶，end() 不变，找不到时返回的正是先求出的 end()
+inline void find_end_test()
+{
+    typedef deonSTL::incremental_hashtable<uint64_t, constant_hash, std::equal_to<uint64_t>> table;
+    table t;
+    std::unordered_set<uint64_t> ref;
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    size_t checked = 0;
+    for(int i = 0; i < 3000; ++i)
+    {
+        const uint64_t k = next_random(x) % 2000;
+        if(i % 3 != 2)
+        {
+            t.insert_unique(k);
+            ref.insert(k);
+        }
+        else
+            DEONSTL_CHECK(t.erase_unique(k) == ref.erase(k));
+        for(int j = 0; j < 4 && t.migrating(); ++j, ++checked)
+        {
+            const uint64_t q = next_random(x) % 2000;
+            const table::iterator e = t.end();
+            const table::iterator it = t.find(q);
+            DEONSTL_CHECK(t.end() == e);
+            DEONSTL_CHECK((it != e) == (ref.count(q) != 0));
+            if(it != e)
+                DEONSTL_CHECK(*it == q);
+        }
+        DEONSTL_CHECK(t.size() == ref.size());
+    }
+    DEONSTL_CHECK(checked > 0);
+}
+
+// 每次插入移动的桶数随最大负载系数增大：扩容发生时 old_ 已经移空，不需要在一次插入中移完剩下的桶
+inline void load_factor_test()
+{
+    const float factors[] = {0.05f, 0.1f, 0.2f, 0.5f, 0.9f};
+    for(float mlf : factors)
+    {
+        int_table t;
+        t.max_load_factor(mlf);
+        uint64_t x = 88172645463325252ull;
+        size_t grows = 0;
+        for(int i = 0; i < 50000; ++i)
+        {
+            const bool was_migrating = t.migrating();
+            const size_t buckets = t.bucket_count();
+            t.insert_unique(next_random(x));
+            if(t.bucket_count() != buckets)
+            {
+                DEONSTL_CHECK(!was_migrating);
+                ++grows;
+            }
+            DEONSTL_CHECK(t.load_factor() <= mlf);
+        }
+        DEONSTL_CHECK(grows > 3);
+    }
+}
+
+// 插入 keys，ns[i] 为第 i 次插入的纳秒数
+template <class Table>
+void insert_latency(const deonSTL::vector<uint64_t>& keys, deonSTL::vector<double>& ns, uint64_t& check)
+{
+    Table t;
+    ns.clear();
+    for(size_t i = 0; i < keys.size(); ++i)
+        ns.push_back(time_ms([&] { t.insert_unique(keys[i]); }) * 1e6);
+    check += t.size();
+}
+
+inline void print_latency(const char* name, deonSTL::vector<double>& ns)
+{
+    double total = 0.0;
+    for(size_t i = 0; i < ns.size(); ++i)
+        total += ns[i];
+    std::sort(ns.begin(), ns.end());
+    const size_t n = ns.size();
+    printf("%-24s %10.0f %10.0f %10.0f %10.0f %12.0f %10.1f\n", name,
+           ns[n / 2], ns[n * 99 / 100], ns[n * 999 / 1000], ns[n * 9999 / 10000], ns[n - 1], total / 1e6);
+}
+
+void incremental_hashtable_test(size_t n = 4000000)
+{
+    behaviour_test();
+    erase_test();
+    alias_test();
+    find_end_test();
+    load_factor_test();
+    printf("incremental_hashtable behaviour_test passed\n");
+
+    typedef deonSTL::hashtable<uint64_t, deonSTL::hash<uint64_t>, std::equal_to<uint64_t>>  full;
+
+    deonSTL::vector<uint64_t> keys;
+    uint64_t x = 88172645463325252ull;
+    for(size_t i = 0; i < n; ++i)
+        keys.push_back(next_random(x));
+
+    uint64_t check = 0;
+    deonSTL::vector<double> ns;
+    printf("insert %zu uint64_t keys one by one, latency (ns), total (ms)\n", n);
+    printf("%-24s %10s %10s %10s %10s %12s %10s\n", "", "p50", "p99", "p99.9", "p99.99", "max", "total");
+    insert_latency<full>(keys, ns, check);
+    print_latency("hashtable", ns);
+    insert_latency<int_table>(keys, ns, check);
+    print_latency("incremental_hashtable", ns);
+    printf("(check %llu)\n", static_cast<unsigned long long>(check));
+}
+
+} // namespace incremental_hashtable_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* incremental_hashtable_test_h */
@@ -0,0 +1,156 @@
+//
+//  lock_free_stack_test.h
+//  deonSTL
+//
+//  lock_free_stack 作为对象池空闲链表的吞吐量：threads 个线程共享一个预先放入 pool_size 个对象的栈，
+//  每个线程反复 pop 一个对象、再 push 回去，线程数从 1 增加到 max_threads，与互斥锁保护的 stack 对比
+//  单线程时与 std::vector 作栈对比：节点跨过多个块（每块大小翻倍）时先进后出的顺序不变，弹出的节点被复用
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef lock_free_stack_test_h
+#define lock_free_stack_test_h
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../lock_free_stack.h"
+#include "../stack.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace lock_free_stack_test{
+
+// 互斥锁保护的 stack，接口与 lock_free_stack 相同
+template <class T>
+class locked_stack
+{
+public:
+    void push(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        s_.push(value);
+    }
+
+    bool pop(T& value)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if(s_.empty())
+            return false;
+        value = s_.top();
+        s_.pop();
+        return true;
+    }
+
+private:
+    std::mutex                  mtx_;
+    deonSTL::stack<T>           s_;
+};
+
+// 单线程随机 push / pop，节点数达到 ~2^17，覆盖前 11 块与块之间的边界
+inline void sequential_test()
+{
+    lock_free_stack<std::string> s;
+    std::vector<std::string> ref;
+    std::string v;
+    DEONSTL_CHECK(s.empty_approx() && !s.pop(v));
+    uint64_t x = 88172645463325252ull;
+    for(int round = 0; round < 4; ++round)
+    {
+        const size_t target = size_t(1) << (14 + round);
+        while(ref.size() < target)
+        {
+            const uint64_t r = next_random(x);
+            if(r % 4 != 0 || ref.empty())
+            {
+                s.push(std::to_string(r));
+                ref.push_back(std::to_string(r));
+            }
+            else
+            {
+                DEONSTL_CHECK(s.pop(v) && v == ref.back());
+                ref.pop_back();
+            }
+        }
+        while(ref.size() > target / 3)
+        {
+            DEONSTL_CHECK(s.pop(v) && v == ref.back());
+            ref.pop_back();
+        }
+    }
+    while(!ref.empty())
+    {
+        DEONSTL_CHECK(s.pop(v) && v == ref.back());
+        ref.pop_back();
+    }
+    DEONSTL_CHECK(s.empty_approx() && !s.pop(v));
+}
+
+// 放入 0..pool_size-1，threads 个线程各做 per 次 pop + push，返回耗时（毫秒），
+// 结束后取出全部对象求和，与放入时相同说明没有丢失或重复
+template <class Stack>
+double run(Stack& s, size_t pool_size, size_t per, unsigned threads, bool& ok)
+{
+    for(size_t i = 0; i < pool_size; ++i)
+        s.push(static_cast<uint64_t>(i));
+    deonSTL::vector<std::thread> workers;
+    const double ms = time_ms([&] {
+        for(unsigned t = 0; t < threads; ++t)
+            workers.push_back(std::thread([&s, per] {
+                uint64_t v;
+                for(size_t i = 0; i < per; ++i)
+                    if(s.pop(v))
+                        s.push(v);
+            }));
+        for(size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+    });
+
+    uint64_t sum = 0, v;
+    size_t count = 0;
+    while(s.pop(v))
+    {
+        sum += v;
+        ++count;
+    }
+    ok = count == pool_size && sum == static_cast<uint64_t>(pool_size) * (pool_size - 1) / 2;
+    return ms;
+}
+
+void lock_free_stack_test(size_t n = 10000000, size_t pool_size = 1024, unsigned max_threads = 32)
+{
+    sequential_test();
+    printf("n = %zu pop + push, pool size = %zu, hardware threads = %u\n",
+           n, pool_size, std::thread::hardware_concurrency());
+    printf("%-10s %20s %20s\n", "threads", "lock_free(Mops/s)", "mutex(Mops/s)");
+    for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const size_t per = n / threads;
+        bool ok1 = false, ok2 = false;
+        lock_free_stack<uint64_t> s1;
+        locked_stack<uint64_t> s2;
+        const double t1 = run(s1, pool_size, per, threads, ok1);
+        const double t2 = run(s2, pool_size, per, threads, ok2);
+        DEONSTL_CHECK(ok1 && ok2);
+        printf("%-10u %20.2f %20.2f\n", threads, per * threads / t1 / 1000.0,
+               per * threads / t2 / 1000.0);
+    }
+}
+
+} // namespace lock_free_stack_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* lock_free_stack_test_h */
@@ -0,0 +1,170 @@
+//
+//  memory_resource_test.h
+//  deonSTL
+//
+//  monotonic_buffer_resource 的行为：对齐、初始缓冲区、块增长与 release、超大请求抛出 bad_alloc，
+//  以及 polymorphic_allocator / monotonic_allocator 作为容器配置器时的结果（与 std::set / std::vector 对比）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef memory_resource_test_h
+#define memory_resource_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <set>
+#include <vector>
+#include "../memory_resource.h"
+#include "../set.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace memory_resource_test{
+
+inline bool aligned(void* p, size_t align)
+{ return reinterpret_cast<uintptr_t>(p) % align == 0; }
+
+// 不同大小、不同对齐的请求：地址对齐，写入的内容互不覆盖
+inline void bump_test()
+{
+    deonSTL::monotonic_buffer_resource arena;
+    const size_t aligns[] = {1, 2, 4, 8, 16, 64, 256};
+    std::vector<unsigned char*> ptrs;
+    std::vector<size_t> sizes;
+    for(size_t i = 0; i < 2000; ++i)
+    {
+        const size_t align = aligns[i % 7];
+        const size_t bytes = 1 + (i * 37) % 300;
+        unsigned char* p = static_cast<unsigned char*>(arena.allocate(bytes, align));
+        DEONSTL_CHECK(aligned(p, align));
+        std::memset(p, static_cast<int>(i & 0xff), bytes);
+        ptrs.push_back(p);
+        sizes.push_back(bytes);
+    }
+    for(size_t i = 0; i < ptrs.size(); ++i)
+        for(size_t j = 0; j < sizes[i]; ++j)
+            DEONSTL_CHECK(ptrs[i][j] == static_cast<unsigned char>(i & 0xff));
+}
+
+// 先用初始缓冲区，用完后向上游申请；release 之后又从初始缓冲区开始
+inline void initial_buffer_test()
+{
+    alignas(16) unsigned char buf[256];
+    deonSTL::monotonic_buffer_resource arena(buf, sizeof(buf));
+    void* first = arena.allocate(64, 16);
+    DEONSTL_CHECK(first == buf);
+    arena.allocate(128, 16);
+    unsigned char* outside = static_cast<unsigned char*>(arena.allocate(128, 16));
+    DEONSTL_CHECK(outside < buf || outside >= buf + sizeof(buf));
+    for(int i = 0; i < 1000; ++i)
+        arena.allocate(100, 8);
+    arena.release();
+    DEONSTL_CHECK(arena.allocate(64, 16) == buf);
+}
+
+// 上游资源：超过 limit 字节的请求抛出 bad_alloc，其余交给 new_delete_resource
+class limited_resource : public deonSTL::memory_resource
+{
+public:
+    explicit limited_resource(size_t limit) : limit_(limit) {}
+
+private:
+    size_t limit_;
+
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        if(bytes > limit_)
+            throw std::bad_alloc();
+        return deonSTL::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void  do_deallocate(void* ptr, size_t bytes, size_t align) override
+    { deonSTL::new_delete_resource()->deallocate(ptr, bytes, align); }
+
+    bool  do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+};
+
+// 请求接近 size_t 的上限：快速路径不能因 p + bytes 回绕而成功，慢速路径不能死循环，都抛出 bad_alloc
+inline void huge_request_test()
+{
+    limited_resource upstream(size_t(1) << 30);
+    const size_t huge[] = {static_cast<size_t>(-1), static_cast<size_t>(-1) - 64,
+                           static_cast<size_t>(-1) / 2 + 1};
+    for(size_t i = 0; i < sizeof(huge) / sizeof(huge[0]); ++i)
+    {
+        alignas(16) unsigned char buf[256];
+        deonSTL::monotonic_buffer_resource arena(buf, sizeof(buf), &upstream);
+        bool thrown = false;
+        try {
+            arena.allocate(huge[i], 16);
+        } catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        DEONSTL_CHECK(thrown);
+        DEONSTL_CHECK(arena.allocate(16, 16) == buf);   // 失败的请求不改变 arena
+    }
+}
+
+// 作为容器配置器：结果与 std 容器相同
+inline void container_test()
+{
+    deonSTL::monotonic_buffer_resource arena;
+    {
+        const deonSTL::monotonic_allocator<int> alloc(&arena);
+        deonSTL::set<int, std::less<int>, deonSTL::monotonic_allocator<int>> s(alloc);
+        std::set<int> ref;
+        uint64_t x = 88172645463325252ull;
+        for(int i = 0; i < 20000; ++i)
+        {
+            const int key = static_cast<int>(next_random(x) % 5000);
+            if(i % 3 == 2)
+                DEONSTL_CHECK(s.erase(key) == ref.erase(key));
+            else
+                DEONSTL_CHECK(s.insert(key).second == ref.insert(key).second);
+        }
+        DEONSTL_CHECK(s.size() == ref.size());
+        std::set<int>::const_iterator r = ref.begin();
+        for(auto it = s.begin(); it != s.end(); ++it, ++r)
+            DEONSTL_CHECK(*it == *r);
+    }
+    {
+        deonSTL::vector<int, deonSTL::polymorphic_allocator<int>> v(&arena);
+        std::vector<int> ref;
+        for(int i = 0; i < 10000; ++i)
+        {
+            v.push_back(i * 7);
+            ref.push_back(i * 7);
+        }
+        DEONSTL_CHECK(v.size() == ref.size());
+        for(size_t i = 0; i < ref.size(); ++i)
+            DEONSTL_CHECK(v[i] == ref[i]);
+    }
+    arena.release();
+}
+
+void memory_resource_test()
+{
+    bump_test();
+    initial_buffer_test();
+    huge_request_test();
+    container_test();
+    printf("memory_resource_test passed\n");
+}
+
+} // namespace memory_resource_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* memory_resource_test_h */
@@ -0,0 +1,222 @@
+//
+//  mpmc_queue_test.h
+//  deonSTL
+//
+//  mpmc_queue 的可扩展性：生产者、消费者线程数从 1 增加到 max_threads（两者相同），
+//  共传递 n 个整数的吞吐量，与互斥锁保护的 deque 对比
+//  元素构造抛出异常时队列不受影响：之后放入的元素仍然能按顺序取出，消费者不会卡住
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef mpmc_queue_test_h
+#define mpmc_queue_test_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "../mpmc_queue.h"
+#include "../deque.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace mpmc_queue_test{
+
+// 互斥锁保护的有界 deque，接口与 mpmc_queue 的阻塞版本相同
+template <class T>
+class locked_deque
+{
+public:
+    explicit locked_deque(size_t capacity) : capacity_(capacity) {}
+
+    void push(const T& value)
+    {
+        for(;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if(d_.size() < capacity_)
+                {
+                    d_.push_back(value);
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void pop(T& value)
+    {
+        for(;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                if(!d_.empty())
+                {
+                    value = d_.front();
+                    d_.pop_front();
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    std::mutex                  mtx_;
+    deonSTL::deque<T>           d_;
+    size_t                      capacity_;
+};
+
+// threads 个生产者各放入 n / threads 个数，threads 个消费者各取出同样多个，返回耗时（毫秒）
+template <class Queue>
+double run(Queue& q, size_t n, unsigned threads, uint64_t& sum)
+{
+    const size_t per = n / threads;
+    std::atomic<uint64_t> total(0);
+    deonSTL::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&q, per, t] {
+            for(size_t i = 0; i < per; ++i)
+                q.push(static_cast<uint64_t>(t) * per + i);
+        }));
+        workers.push_back(std::thread([&q, per, &total] {
+            uint64_t local = 0, v;
+            for(size_t i = 0; i < per; ++i)
+            {
+                q.pop(v);
+                local += v;
+            }
+            total += local;
+        }));
+    }
+    for(size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+    auto finish = std::chrono::steady_clock::now();
+    sum = total;
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+// 由 int 构造，值为负数时抛出异常；移动构造不抛出异常
+struct picky
+{
+    int value;
+
+    picky() noexcept : value(0) {}
+    picky(int v) : value(v)
+    {
+        if(v < 0)
+            throw v;
+    }
+    picky(picky&& rhs) noexcept : value(rhs.value) {}
+    picky& operator=(picky&& rhs) noexcept { value = rhs.value; return *this; }
+};
+
+// 构造抛出异常的 try_emplace / emplace 不占用位置，后面的元素照常取出
+inline void throw_test()
+{
+    mpmc_queue<picky> q(4);
+    bool thrown = false;
+    try {
+        q.try_emplace(-1);
+    } catch (int) {
+        thrown = true;
+    }
+    DEONSTL_CHECK(thrown);
+    DEONSTL_CHECK(q.size_approx() == 0);
+    DEONSTL_CHECK(q.try_emplace(1));
+    thrown = false;
+    try {
+        q.emplace(-2);
+    } catch (int) {
+        thrown = true;
+    }
+    DEONSTL_CHECK(thrown);
+    q.emplace(2);
+    picky v;
+    DEONSTL_CHECK(q.try_pop(v) && v.value == 1);
+    DEONSTL_CHECK(q.try_pop(v) && v.value == 2);
+    DEONSTL_CHECK(!q.try_pop(v));
+
+    // 2 个生产者每隔几个元素就构造失败一次，2 个消费者同时取出，生产者结束后取完剩下的元素
+    const int per = 20000;
+    mpmc_queue<picky> mq(64);
+    std::atomic<long long> pushed(0), popped(0);
+    std::atomic<bool> done(false);
+    deonSTL::vector<std::thread> producers, consumers;
+    for(int t = 0; t < 2; ++t)
+    {
+        producers.push_back(std::thread([&mq, &pushed, t, per] {
+            for(int i = 1; i <= per; ++i)
+            {
+                const int v = i % 7 == 0 ? -i : t * per + i;
+                try {
+                    mq.emplace(v);
+                    pushed += v;
+                } catch (int) {
+                }
+            }
+        }));
+        consumers.push_back(std::thread([&mq, &popped, &done] {
+            picky x;
+            for(;;)
+            {
+                if(mq.try_pop(x))
+                    popped += x.value;
+                else if(done.load())
+                {
+                    while(mq.try_pop(x))
+                        popped += x.value;
+                    return;
+                }
+            }
+        }));
+    }
+    for(size_t i = 0; i < producers.size(); ++i)
+        producers[i].join();
+    done = true;
+    for(size_t i = 0; i < consumers.size(); ++i)
+        consumers[i].join();
+    DEONSTL_CHECK(popped == pushed);
+}
+
+void mpmc_queue_test(size_t n = 10000000, size_t capacity = 4096, unsigned max_threads = 0)
+{
+    throw_test();
+
+    if(max_threads == 0)
+        max_threads = std::thread::hardware_concurrency() / 2 > 0
+                    ? std::thread::hardware_concurrency() / 2 : 1;
+    printf("n = %zu, capacity = %zu\n", n, capacity);
+    printf("%-10s %16s %16s\n", "threads", "mpmc(Mitems/s)", "mutex(Mitems/s)");
+    for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const size_t m = n / threads * threads;
+        const uint64_t expect = static_cast<uint64_t>(m) * (m - 1) / 2;
+        uint64_t s1 = 0, s2 = 0;
+        mpmc_queue<uint64_t> q(capacity);
+        locked_deque<uint64_t> d(capacity);
+        const double t1 = run(q, m, threads, s1);
+        const double t2 = run(d, m, threads, s2);
+        DEONSTL_CHECK(s1 == expect && s2 == expect);
+        printf("%4ux%-5u %16.2f %16.2f\n", threads, threads, m / t1 / 1000.0, m / t2 / 1000.0);
+    }
+}
+
+} // namespace mpmc_queue_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* mpmc_queue_test_h */
@@ -0,0 +1,259 @@
+//
+//  pool_allocator_test.h
+//  deonSTL
+//
+//  pool_alloc / pool_allocator 的正确性测试：各大小分级的申请、写入、校验、释放与复用，
+//  跨线程释放；以及 set<int> 插入/删除交替（churn）性能：allocator 与 pool_allocator 对比
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef pool_allocator_test_h
+#define pool_allocator_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+#include "../set.h"
+#include "../pool_allocator.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace pool_allocator_test{
+
+// 用 seed 决定的字节填满 [p, p + n)
+inline void fill(void* p, size_t n, unsigned seed)
+{
+    unsigned char* bytes = static_cast<unsigned char*>(p);
+    for(size_t i = 0; i < n; ++i)
+        bytes[i] = static_cast<unsigned char>(seed * 31u + i);
+}
+
+inline bool intact(const void* p, size_t n, unsigned seed)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(p);
+    for(size_t i = 0; i < n; ++i)
+        if(bytes[i] != static_cast<unsigned char>(seed * 31u + i))
+            return false;
+    return true;
+}
+
+struct block
+{
+    void*  ptr;
+    size_t bytes;
+};
+
+// 每个大小（含超过 MAX_BYTES 直接走 operator new 的）申请若干块，全部写入后再校验，
+// 块之间互不覆盖且按 ALIGN 对齐；释放后同一线程再申请同样大小，优先复用刚归还的块
+void round_trip_test()
+{
+    const size_t max_bytes = static_cast<size_t>(pool_alloc::MAX_BYTES) + 64;
+    std::vector<block> blocks;
+    for(size_t n = 1; n <= max_bytes; ++n)
+    {
+        for(int k = 0; k < 3; ++k)
+        {
+            void* p = pool_alloc::allocate(n);
+            DEONSTL_CHECK(p != nullptr);
+            DEONSTL_CHECK(reinterpret_cast<uintptr_t>(p) % pool_alloc::ALIGN == 0);
+            fill(p, n, static_cast<unsigned>(blocks.size()));
+            blocks.push_back(block{ p, n });
+        }
+    }
+    for(size_t i = 0; i < blocks.size(); ++i)
+        DEONSTL_CHECK(intact(blocks[i].ptr, blocks[i].bytes, static_cast<unsigned>(i)));
+    for(size_t i = 0; i < blocks.size(); ++i)
+        pool_alloc::deallocate(blocks[i].ptr, blocks[i].bytes);
+
+    for(size_t n = 1; n <= static_cast<size_t>(pool_alloc::MAX_BYTES); n += 7)
+    {
+        void* p = pool_alloc::allocate(n);
+        pool_alloc::deallocate(p, n);
+        DEONSTL_CHECK(pool_alloc::allocate(n) == p);
+        pool_alloc::deallocate(p, n);
+    }
+}
+
+struct alignas(64) over_aligned
+{
+    char data[64];
+};
+
+// pool_allocator<T>：数组申请、对齐超过 ALIGN 的类型不进内存池但仍满足对齐，allocate(0) 返回 nullptr
+void typed_test()
+{
+    typedef deonSTL::pool_allocator<int> int_alloc;
+    int* p = int_alloc::allocate(100);
+    for(int i = 0; i < 100; ++i)
+        int_alloc::construct(p + i, i * i);
+    for(int i = 0; i < 100; ++i)
+        DEONSTL_CHECK(p[i] == i * i);
+    int_alloc::destroy(p, p + 100);
+    int_alloc::deallocate(p, 100);
+
+    DEONSTL_CHECK(int_alloc::allocate(0) == nullptr);
+    int_alloc::deallocate(nullptr, 0);
+
+    typedef deonSTL::pool_allocator<over_aligned> aligned_alloc;
+    std::vector<over_aligned*> v;
+    for(int i = 0; i < 16; ++i)
+    {
+        over_aligned* q = aligned_alloc::allocate(1);
+        DEONSTL_CHECK(reinterpret_cast<uintptr_t>(q) % alignof(over_aligned) == 0);
+        fill(q->data, sizeof(q->data), static_cast<unsigned>(i));
+        v.push_back(q);
+    }
+    for(size_t i = 0; i < v.size(); ++i)
+    {
+        DEONSTL_CHECK(intact(v[i]->data, sizeof(v[i]->data), static_cast<unsigned>(i)));
+        aligned_alloc::deallocate(v[i], 1);
+    }
+}
+
+// 生产线程申请并写入，消费线程校验后释放（块进入消费线程的缓存，超过 CACHE_LIMIT 归还中心池），
+// 生产线程退出时缓存归还中心池；之后主线程再申请，拿到的块互不重叠且可正常读写
+void cross_thread_test(int n)
+{
+    const size_t bytes = 48;
+    std::vector<void*> ptrs(n);
+    std::thread producer([&]{
+        for(int i = 0; i < n; ++i)
+        {
+            ptrs[i] = pool_alloc::allocate(bytes);
+            fill(ptrs[i], bytes, static_cast<unsigned>(i));
+        }
+    });
+    producer.join();
+    std::thread consumer([&]{
+        for(int i = 0; i < n; ++i)
+        {
+            DEONSTL_CHECK(intact(ptrs[i], bytes, static_cast<unsigned>(i)));
+            pool_alloc::deallocate(ptrs[i], bytes);
+        }
+    });
+    consumer.join();
+
+    std::set<void*> seen;
+    for(int i = 0; i < n; ++i)
+    {
+        ptrs[i] = pool_alloc::allocate(bytes);
+        DEONSTL_CHECK(seen.insert(ptrs[i]).second);
+        fill(ptrs[i], bytes, static_cast<unsigned>(i) + 7u);
+    }
+    for(int i = 0; i < n; ++i)
+    {
+        DEONSTL_CHECK(intact(ptrs[i], bytes, static_cast<unsigned>(i) + 7u));
+        pool_alloc::deallocate(ptrs[i], bytes);
+    }
+}
+
+// 两个线程同时申请、释放不同大小的块，各自的块在释放前保持完整
+void concurrent_test(int n)
+{
+    auto work = [n](unsigned seed){
+        std::vector<block> live;
+        uint64_t x = 0x9E3779B97F4A7C15ULL + seed;
+        for(int i = 0; i < n; ++i)
+        {
+            if(!live.empty() && next_random(x) % 3 == 0)
+            {
+                block b = live.back();
+                live.pop_back();
+                DEONSTL_CHECK(intact(b.ptr, b.bytes, seed + static_cast<unsigned>(live.size())));
+                pool_alloc::deallocate(b.ptr, b.bytes);
+                continue;
+            }
+            const size_t bytes = 1 + static_cast<size_t>(next_random(x) % pool_alloc::MAX_BYTES);
+            void* p = pool_alloc::allocate(bytes);
+            fill(p, bytes, seed + static_cast<unsigned>(live.size()));
+            live.push_back(block{ p, bytes });
+        }
+        while(!live.empty())
+        {
+            block b = live.back();
+            live.pop_back();
+            DEONSTL_CHECK(intact(b.ptr, b.bytes, seed + static_cast<unsigned>(live.size())));
+            pool_alloc::deallocate(b.ptr, b.bytes);
+        }
+    };
+    std::thread t1(work, 1u);
+    std::thread t2(work, 1000u);
+    t1.join();
+    t2.join();
+}
+
+// 先插入 n 个元素，然后每轮删除一半、再插回
+template <class Set>
+void set_churn(Set& s, int n, int rounds)
+{
+    unsigned x = 12345;
+    for(int i = 0; i < n; ++i)
+    {
+        x = x * 1103515245u + 12345u;
+        s.insert(static_cast<int>(x % (4u * n)));
+    }
+    for(int r = 0; r < rounds; ++r)
+    {
+        for(int i = 0; i < n; ++i)
+        {
+            x = x * 1103515245u + 12345u;
+            const int key = static_cast<int>(x % (4u * n));
+            if(i & 1) s.erase(key);
+            else      s.insert(key);
+        }
+    }
+}
+
+// n 为 churn 对比的最大元素个数
+void pool_allocator_test(int n = 1000000)
+{
+    round_trip_test();
+    typed_test();
+    cross_thread_test(4 * pool_alloc::CACHE_LIMIT + 5);
+    concurrent_test(100000);
+
+    typedef deonSTL::set<int, std::less<int>, deonSTL::allocator<int>>      default_set;
+    typedef deonSTL::set<int, std::less<int>, deonSTL::pool_allocator<int>> pool_set;
+
+    printf("%-10s %-8s %14s %14s\n", "n", "rounds", "allocator(ms)", "pool(ms)");
+    const int sizes[] = { 1000, 100000, 1000000 };
+    for(int size : sizes)
+    {
+        if(size > n) break;
+        const int rounds = 10000000 / size + 1;
+        default_set s1;
+        pool_set s2;
+        std::set<int> expect;
+        double t1 = time_ms([&]{ set_churn(s1, size, rounds); });
+        double t2 = time_ms([&]{ set_churn(s2, size, rounds); });
+        set_churn(expect, size, rounds);
+        DEONSTL_CHECK(s1.size() == expect.size() && s2.size() == expect.size());
+        auto it1 = s1.begin();
+        auto it2 = s2.begin();
+        for(int v : expect)
+        {
+            DEONSTL_CHECK(*it1 == v && *it2 == v);
+            ++it1;
+            ++it2;
+        }
+        printf("%-10d %-8d %14.2f %14.2f\n", size, rounds, t1, t2);
+    }
+    printf("pool_allocator_test passed\n");
+}
+
+} // namespace pool_allocator_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* pool_allocator_test_h */
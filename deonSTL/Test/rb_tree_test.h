@@ -2,6 +2,9 @@
 //  rb_tree_test.h
 //  deonSTL
 //
+//  rb_tree 及 set / multiset / map / multimap（使用 pool_allocator）与 std 容器对照的随机测试，
+//  每步操作后检查红黑树的性质
+//
 //  Created by 郭松楠 on 2020/4/16.
 //  Copyright © 2020 郭松楠. All rights reserved.
 //
@@ -9,39 +12,377 @@
 #ifndef rb_tree_test_h
 #define rb_tree_test_h
 
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include "test_util.h"
 #include "../rb_tree.h"
+#include "../set.h"
+#include "../map.h"
+#include "../pool_allocator.h"
 
 namespace deonSTL{
-    
+
 namespace test{
 
 namespace rb_tree_test{
 
-
-
-void rb_tree_test()
+// 检查以 x 为根的子树：父指针、键序、红节点没有红孩子，返回黑高（空节点计 1），count 累计节点数
+template <class Tree>
+int check_subtree(const Tree& tree, typename Tree::node_ptr x, size_t& count)
 {
-    
+    typedef typename Tree::value_traits value_traits;
+    if(x == nullptr) return 1;
+    ++count;
+    auto comp = tree.key_comp();
+    if(x->left != nullptr)
+    {
+        DEONSTL_CHECK(x->left->parent == x);
+        DEONSTL_CHECK(!comp(value_traits::get_key(x->value), value_traits::get_key(x->left->value)));
+    }
+    if(x->right != nullptr)
+    {
+        DEONSTL_CHECK(x->right->parent == x);
+        DEONSTL_CHECK(!comp(value_traits::get_key(x->right->value), value_traits::get_key(x->value)));
+    }
+    if(rb_tree_is_red(x))
+    {
+        DEONSTL_CHECK(x->left  == nullptr || !rb_tree_is_red(x->left));
+        DEONSTL_CHECK(x->right == nullptr || !rb_tree_is_red(x->right));
+    }
+    const int lh = check_subtree(tree, x->left, count);
+    const int rh = check_subtree(tree, x->right, count);
+    DEONSTL_CHECK(lh == rh);
+    return lh + (rb_tree_is_red(x) ? 0 : 1);
 }
 
+// 根为黑色、各路径黑高相同、节点数等于 size()，header 的左右指向最小、最大节点
+template <class Tree>
+void check_invariants(Tree& tree)
+{
+    auto root = tree.getRootNode();
+    size_t count = 0;
+    if(root != nullptr)
+    {
+        DEONSTL_CHECK(!rb_tree_is_red(root));
+        DEONSTL_CHECK(root->parent->parent == root);    // header 与根互为父节点
+        DEONSTL_CHECK(tree.begin().node == rb_tree_min(root));
+        auto last = tree.end();
+        --last;
+        DEONSTL_CHECK(last.node == rb_tree_max(root));
+    }
+    else
+    {
+        DEONSTL_CHECK(tree.begin() == tree.end());
+    }
+    check_subtree(tree, root, count);
+    DEONSTL_CHECK(count == tree.size());
+}
 
+// map / multimap 的元素与 std::map / std::multimap 的元素比较
+template <class K1, class K2, class V>
+bool operator==(const deonSTL::pair<K1, V>& lhs, const std::pair<K2, V>& rhs)
+{ return lhs.first == rhs.first && lhs.second == rhs.second; }
 
+// 正向（前置、后置 ++）与反向（后置 --）遍历都与 expect 一致
+template <class Container, class Expect>
+void check_same(const Container& c, const Expect& expect)
+{
+    DEONSTL_CHECK(c.size() == expect.size());
+    DEONSTL_CHECK(c.empty() == expect.empty());
+    auto e = expect.begin();
+    for(auto it = c.begin(); it != c.end(); ++it, ++e)
+        DEONSTL_CHECK(e != expect.end() && *it == *e);
+    DEONSTL_CHECK(e == expect.end());
+    e = expect.begin();
+    for(auto it = c.begin(); it != c.end(); ++e)
+        DEONSTL_CHECK(*it++ == *e);
+    auto re = expect.end();
+    for(auto it = c.end(); it != c.begin(); )
+    {
+        it--;
+        --re;
+        DEONSTL_CHECK(*it == *re);
+    }
+}
 
+//***************************************************************************//
+//                                 rb_tree                                   //
+//***************************************************************************//
 
+// insert_unique / erase_unique / erase(pos) 与 std::set 对照，每步检查红黑树性质
+void unique_tree_test(int ops)
+{
+    typedef deonSTL::rb_tree<int, std::less<int>, deonSTL::pool_allocator<int>> tree_type;
+    tree_type tree;
+    std::set<int> expect;
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 512);
+        switch(next_random(x) % 4)
+        {
+        case 0:
+        case 1:
+        {
+            auto r = tree.insert_unique(key);
+            const bool inserted = expect.insert(key).second;
+            DEONSTL_CHECK(r.second == inserted && *r.first == key);
+            break;
+        }
+        case 2:
+            DEONSTL_CHECK(tree.erase_unique(key) == expect.erase(key));
+            break;
+        default:
+        {
+            auto it = tree.find(key);
+            DEONSTL_CHECK((it != tree.end()) == (expect.count(key) == 1));
+            if(it != tree.end())
+            {
+                tree.erase(it);
+                expect.erase(key);
+            }
+            break;
+        }
+        }
+        check_invariants(tree);
+    }
+    check_same(tree, expect);
+    // 复制得到的树的根节点挂在自己的 header_ 下
+    tree_type copy(tree);
+    check_invariants(copy);
+    tree_type assigned;
+    assigned.insert_unique(-1);
+    assigned = tree;
+    check_invariants(assigned);
+    DEONSTL_CHECK(copy == tree && assigned == tree);
+    tree.clear();
+    check_invariants(tree);
+    check_same(copy, expect);
+}
 
+// insert_multi / erase_multi 与 std::multiset 对照，每步检查红黑树性质
+void multi_tree_test(int ops)
+{
+    typedef deonSTL::rb_tree<int, std::less<int>, deonSTL::pool_allocator<int>> tree_type;
+    tree_type tree;
+    std::multiset<int> expect;
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 64);
+        if(next_random(x) % 3 != 0)
+        {
+            DEONSTL_CHECK(*tree.insert_multi(key) == key);
+            expect.insert(key);
+        }
+        else
+        {
+            DEONSTL_CHECK(tree.erase_multi(key) == expect.erase(key));
+        }
+        DEONSTL_CHECK(tree.count_multi(key) == expect.count(key));
+        check_invariants(tree);
+    }
+    check_same(tree, expect);
+}
 
+//***************************************************************************//
+//                    set / multiset / map / multimap                        //
+//***************************************************************************//
 
+// 查找类接口：find（含 const 版本）、count、lower_bound、upper_bound、equal_range
+template <class Container, class Expect>
+void check_lookup(const Container& c, const Expect& expect, int key)
+{
+    DEONSTL_CHECK(c.count(key) == expect.count(key));
+    auto it = c.find(key);
+    DEONSTL_CHECK((it == c.end()) == (expect.find(key) == expect.end()));
+    if(it != c.end())
+        DEONSTL_CHECK(*it == *expect.find(key));
+    auto lb = c.lower_bound(key);
+    auto elb = expect.lower_bound(key);
+    DEONSTL_CHECK((lb == c.end()) == (elb == expect.end()));
+    if(lb != c.end())
+        DEONSTL_CHECK(*lb == *elb);
+    auto ub = c.upper_bound(key);
+    auto eub = expect.upper_bound(key);
+    DEONSTL_CHECK((ub == c.end()) == (eub == expect.end()));
+    if(ub != c.end())
+        DEONSTL_CHECK(*ub == *eub);
+    auto range = c.equal_range(key);
+    DEONSTL_CHECK(range.first == lb && range.second == ub);
+}
 
+// 复制、移动、交换之后内容不变
+template <class Container, class Expect>
+void check_copy_move_swap(Container& c, const Expect& expect)
+{
+    Container copy(c);
+    DEONSTL_CHECK(copy == c);
+    check_same(copy, expect);
+    Container moved(std::move(copy));
+    check_same(moved, expect);
+    Container other;
+    other = moved;
+    DEONSTL_CHECK(!(other != c));
+    other.swap(c);
+    check_same(other, expect);
+    check_same(c, expect);
+    Container empty;
+    empty.swap(c);
+    DEONSTL_CHECK(c.empty());
+    c = std::move(empty);
+    check_same(c, expect);
+}
 
+void set_test(int ops)
+{
+    typedef deonSTL::set<int, std::less<int>, deonSTL::pool_allocator<int>> set_type;
+    set_type s;
+    std::set<int> expect;
+    uint64_t x = 0xD1B54A32D192ED03ULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 256);
+        switch(next_random(x) % 4)
+        {
+        case 0:
+            DEONSTL_CHECK(s.insert(key).second == expect.insert(key).second);
+            break;
+        case 1:
+            DEONSTL_CHECK(s.emplace(key).second == expect.emplace(key).second);
+            break;
+        case 2:
+            DEONSTL_CHECK(s.erase(key) == expect.erase(key));
+            break;
+        default:
+            check_lookup(s, expect, key);
+            break;
+        }
+    }
+    check_same(s, expect);
+    check_copy_move_swap(s, expect);
+    // 区间删除
+    s.erase(s.lower_bound(64), s.upper_bound(191));
+    expect.erase(expect.lower_bound(64), expect.upper_bound(191));
+    check_same(s, expect);
+}
 
+void multiset_test(int ops)
+{
+    typedef deonSTL::multiset<int, std::less<int>, deonSTL::pool_allocator<int>> set_type;
+    set_type s;
+    std::multiset<int> expect;
+    uint64_t x = 0xA0761D6478BD642FULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 64);
+        switch(next_random(x) % 4)
+        {
+        case 0:
+        case 1:
+            DEONSTL_CHECK(*s.insert(key) == key);
+            expect.insert(key);
+            break;
+        case 2:
+            DEONSTL_CHECK(s.erase(key) == expect.erase(key));
+            break;
+        default:
+            check_lookup(s, expect, key);
+            break;
+        }
+    }
+    check_same(s, expect);
+    check_copy_move_swap(s, expect);
+    const int keys[] = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 };
+    set_type ranged(keys, keys + 11);
+    check_same(ranged, std::multiset<int>(keys, keys + 11));
+}
 
+void map_test(int ops)
+{
+    typedef deonSTL::pair<int, int> value_type;
+    typedef deonSTL::map<int, int, std::less<int>, deonSTL::pool_allocator<value_type>> map_type;
+    map_type m;
+    std::map<int, int> expect;
+    uint64_t x = 0xE7037ED1A0B428DBULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 256);
+        const int value = static_cast<int>(next_random(x) % 1000);
+        switch(next_random(x) % 5)
+        {
+        case 0:
+            DEONSTL_CHECK(m.insert(value_type(key, value)).second
+                          == expect.insert(std::make_pair(key, value)).second);
+            break;
+        case 1:
+            m[key] += value;
+            expect[key] += value;
+            break;
+        case 2:
+            DEONSTL_CHECK(m.erase(key) == expect.erase(key));
+            break;
+        case 3:
+        {
+            auto it = m.find(key);
+            if(it != m.end())
+            {
+                it->second = value;     // 通过迭代器修改 mapped_type
+                expect[key] = value;
+            }
+            break;
+        }
+        default:
+            check_lookup(m, expect, key);
+            break;
+        }
+    }
+    check_same(m, expect);
+    check_copy_move_swap(m, expect);
+}
 
+void multimap_test(int ops)
+{
+    typedef deonSTL::pair<const int, int> value_type;
+    typedef deonSTL::multimap<int, int, std::less<int>, deonSTL::pool_allocator<value_type>> map_type;
+    map_type m;
+    std::multimap<int, int> expect;
+    uint64_t x = 0x8EBC6AF09C88C6E3ULL;
+    for(int i = 0; i < ops; ++i)
+    {
+        const int key = static_cast<int>(next_random(x) % 64);
+        switch(next_random(x) % 3)
+        {
+        case 0:
+        case 1:
+            // 相同 key 的元素按插入顺序排列，value 取插入次序便于与 std::multimap 对照
+            DEONSTL_CHECK(m.insert(value_type(key, i))->first == key);
+            expect.insert(std::make_pair(key, i));
+            break;
+        default:
+            DEONSTL_CHECK(m.erase(key) == expect.erase(key));
+            break;
+        }
+        DEONSTL_CHECK(m.count(key) == expect.count(key));
+    }
+    check_same(m, expect);
+    check_copy_move_swap(m, expect);
+}
 
-
-
-
-
-
+void rb_tree_test(int ops = 20000)
+{
+    unique_tree_test(ops);
+    multi_tree_test(ops);
+    set_test(ops);
+    multiset_test(ops);
+    map_test(ops);
+    multimap_test(ops);
+    printf("rb_tree_test passed\n");
+}
 
 } // namespace rb_tree_test
 
@@ -0,0 +1,268 @@
+//
+//  ring_buffer_test.h
+//  deonSTL
+//
+//  ring_buffer 与 circular_buffer 的行为（与 std::deque 对比）：下标回绕、满时批量插入只放入装得下的部分、
+//  circular_buffer 满时覆盖另一端的元素、跨回绕点的 reserve，以及 reserve 中移动抛出异常时不泄漏
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef ring_buffer_test_h
+#define ring_buffer_test_h
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+#include "../ring_buffer.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace ring_buffer_test{
+
+inline std::string item(uint64_t i)
+{ return "item-" + std::to_string(i) + "-long-enough-to-live-on-the-heap"; }
+
+template <class Buffer, class T>
+void check_equal(const Buffer& b, const std::deque<T>& ref)
+{
+    DEONSTL_CHECK(b.size() == ref.size());
+    DEONSTL_CHECK(b.end() - b.begin() == static_cast<ptrdiff_t>(ref.size()));
+    for(size_t i = 0; i < ref.size(); ++i)
+        DEONSTL_CHECK(b[i] == ref[i]);
+    DEONSTL_CHECK(std::equal(b.begin(), b.end(), ref.begin()));
+    if(!ref.empty())
+        DEONSTL_CHECK(b.front() == ref.front() && b.back() == ref.back());
+}
+
+// ring_buffer：随机的单个与批量插入删除，头尾位置不断回绕；满时批量插入只放入装得下的部分
+inline void wraparound_test()
+{
+    deonSTL::ring_buffer<std::string> b(13);
+    DEONSTL_CHECK(b.capacity() == 16 && b.empty());
+    std::deque<std::string> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        switch(r % 6)
+        {
+            case 0:
+                if(!b.full()) { b.push_back(item(r)); ref.push_back(item(r)); }
+                break;
+            case 1:
+                if(!b.full()) { b.push_front(item(r)); ref.push_front(item(r)); }
+                break;
+            case 2:
+                if(!ref.empty()) { b.pop_front(); ref.pop_front(); }
+                break;
+            case 3:
+                if(!ref.empty()) { b.pop_back(); ref.pop_back(); }
+                break;
+            case 4:
+            {
+                std::string src[7];
+                const size_t n = r % 8;
+                for(size_t i = 0; i < n; ++i)
+                    src[i] = item(r + i);
+                const size_t room = b.capacity() - b.size();
+                const size_t pushed = b.push_back(src, src + n);
+                DEONSTL_CHECK(pushed == std::min(n, room));
+                ref.insert(ref.end(), src, src + pushed);
+                break;
+            }
+            default:
+            {
+                const size_t n = r % 8;
+                std::vector<std::string> out(n);
+                const size_t expect = std::min(n, ref.size());
+                DEONSTL_CHECK(b.pop_front(n, out.begin()) - out.begin() ==
+                              static_cast<ptrdiff_t>(expect));
+                for(size_t i = 0; i < expect; ++i)
+                {
+                    DEONSTL_CHECK(out[i] == ref.front());
+                    ref.pop_front();
+                }
+                break;
+            }
+        }
+        DEONSTL_CHECK(b.full() == (ref.size() == b.capacity()));
+        check_equal(b, ref);
+    }
+
+    // 复制、移动、交换保持元素顺序
+    deonSTL::ring_buffer<std::string> copy(b);
+    check_equal(copy, ref);
+    DEONSTL_CHECK(copy == b);
+    deonSTL::ring_buffer<std::string> moved(std::move(copy));
+    check_equal(moved, ref);
+    deonSTL::ring_buffer<std::string> other(4);
+    other.push_back(item(1));
+    other.swap(moved);
+    check_equal(other, ref);
+    DEONSTL_CHECK(moved.size() == 1 && moved.front() == item(1));
+}
+
+// circular_buffer：满时 push_back 丢弃头部，push_front 丢弃尾部，批量插入只保留最后 capacity() 个
+inline void overwrite_test()
+{
+    deonSTL::circular_buffer<int> b(8);
+    std::deque<int> ref;
+    for(int i = 0; i < 100; ++i)
+    {
+        b.push_back(i);
+        ref.push_back(i);
+        if(ref.size() > 8)
+            ref.pop_front();
+        check_equal(b, ref);
+    }
+    for(int i = 0; i < 20; ++i)
+    {
+        b.push_front(-i);
+        ref.push_front(-i);
+        ref.pop_back();
+        check_equal(b, ref);
+    }
+
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for(int round = 0; round < 500; ++round)
+    {
+        int src[20];
+        const size_t n = next_random(x) % 21;
+        for(size_t i = 0; i < n; ++i)
+            src[i] = static_cast<int>(next_random(x) % 1000);
+        DEONSTL_CHECK(b.push_back(src, src + n) == n);
+        ref.insert(ref.end(), src, src + n);
+        while(ref.size() > 8)
+            ref.pop_front();
+        check_equal(b, ref);
+        const size_t popped = b.pop_front(next_random(x) % 4);
+        for(size_t i = 0; i < popped; ++i)
+            ref.pop_front();
+        check_equal(b, ref);
+    }
+}
+
+// reserve：元素跨过回绕点时，扩容后按顺序排在新空间的开头，之后继续回绕
+inline void reserve_test()
+{
+    for(size_t shift = 0; shift < 8; ++shift)
+    {
+        deonSTL::ring_buffer<std::string> b(8);
+        std::deque<std::string> ref;
+        for(size_t i = 0; i < shift; ++i)        // 把头部推到第 shift 个位置
+        {
+            b.push_back(item(i));
+            b.pop_front();
+        }
+        for(uint64_t i = 0; i < 8; ++i)
+        {
+            b.push_back(item(i));
+            ref.push_back(item(i));
+        }
+        DEONSTL_CHECK(b.full());
+        b.reserve(4);                            // 容量足够时不变
+        DEONSTL_CHECK(b.capacity() == 8);
+        b.reserve(20);
+        DEONSTL_CHECK(b.capacity() == 32);
+        check_equal(b, ref);
+        for(uint64_t i = 0; i < 100; ++i)
+        {
+            b.push_back(item(100 + i));
+            ref.push_back(item(100 + i));
+            if(ref.size() > 30)
+            {
+                b.pop_front();
+                ref.pop_front();
+            }
+            check_equal(b, ref);
+        }
+    }
+
+    deonSTL::ring_buffer<int> empty;
+    empty.reserve(3);
+    DEONSTL_CHECK(empty.capacity() == 4 && empty.empty());
+    empty.push_back(5);
+    DEONSTL_CHECK(empty.front() == 5);
+}
+
+// 移动构造第 throw_after 次时抛出异常的类型，live 记录存活的对象个数
+struct fragile
+{
+    static int& live()          { static int n = 0; return n; }
+    static int& throw_after()   { static int n = 0; return n; }
+
+    int value;
+
+    explicit fragile(int v) : value(v) { ++live(); }
+    fragile(const fragile& rhs) : value(rhs.value) { ++live(); }
+    fragile(fragile&& rhs) : value(rhs.value)
+    {
+        if(throw_after() != 0 && --throw_after() == 0)
+            throw 1;
+        ++live();
+    }
+    ~fragile() { --live(); }
+};
+
+// reserve 移动到新空间时抛出异常：新空间中已构造的元素被析构、新空间被释放，原队列的元素个数与顺序不变
+inline void reserve_throw_test()
+{
+    for(int at = 1; at <= 8; ++at)
+    {
+        {
+            deonSTL::ring_buffer<fragile> b(8);
+            for(int i = 0; i < 5; ++i)           // 头部在第 5 个位置，元素跨过回绕点
+            {
+                b.emplace_back(-1);
+                b.pop_front();
+            }
+            for(int i = 0; i < 8; ++i)
+                b.emplace_back(i);
+            DEONSTL_CHECK(fragile::live() == 8);
+
+            fragile::throw_after() = at;
+            bool thrown = false;
+            try {
+                b.reserve(16);
+            } catch (int) {
+                thrown = true;
+            }
+            fragile::throw_after() = 0;
+            DEONSTL_CHECK(thrown);
+            DEONSTL_CHECK(fragile::live() == 8);
+            DEONSTL_CHECK(b.capacity() == 8 && b.size() == 8);
+            for(int i = 0; i < 8; ++i)
+                DEONSTL_CHECK(b[i].value == i);  // int 成员的移动就是复制
+
+            b.reserve(16);
+            DEONSTL_CHECK(b.capacity() == 16 && fragile::live() == 8);
+            for(int i = 0; i < 8; ++i)
+                DEONSTL_CHECK(b[i].value == i);
+        }
+        DEONSTL_CHECK(fragile::live() == 0);
+    }
+}
+
+void ring_buffer_test()
+{
+    wraparound_test();
+    overwrite_test();
+    reserve_test();
+    reserve_throw_test();
+    printf("ring_buffer_test passed\n");
+}
+
+} // namespace ring_buffer_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* ring_buffer_test_h */
@@ -0,0 +1,224 @@
+//
+//  small_vector_test.h
+//  deonSTL
+//
+//  small_vector 的行为（与 std::vector 对比）：不超过 N 个元素时留在内嵌缓冲区，超过后搬到堆上，
+//  shrink_to_fit 搬回缓冲区；复制、移动、交换覆盖内嵌 / 堆上两种状态的全部组合
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef small_vector_test_h
+#define small_vector_test_h
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../small_vector.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace small_vector_test{
+
+// 不允许转换成 vector 的引用：vector 的 swap、移动赋值、shrink_to_fit 会把内嵌缓冲区当作堆空间
+static_assert(!std::is_convertible<deonSTL::small_vector<int, 4>*, deonSTL::vector<int,
+              deonSTL::inline_buffer_allocator<int, 4>>*>::value,
+              "small_vector must not convert to vector");
+
+typedef deonSTL::small_vector<std::string, 4> svec;
+
+inline std::string item(int i)
+{ return "element-" + std::to_string(i) + "-long-enough-to-live-on-the-heap"; }
+
+// 长度为 n 的 small_vector 与对应的 std::vector
+inline svec make(int n, int base, std::vector<std::string>& ref)
+{
+    svec v;
+    ref.clear();
+    for(int i = 0; i < n; ++i)
+    {
+        v.push_back(item(base + i));
+        ref.push_back(item(base + i));
+    }
+    return v;
+}
+
+inline void check_equal(const svec& v, const std::vector<std::string>& ref)
+{
+    DEONSTL_CHECK(v.size() == ref.size());
+    for(size_t i = 0; i < ref.size(); ++i)
+        DEONSTL_CHECK(v[i] == ref[i]);
+}
+
+// 逐个插入：前 N 个在缓冲区，之后搬到堆上；删除后 shrink_to_fit 搬回缓冲区
+inline void transition_test()
+{
+    svec v;
+    std::vector<std::string> ref;
+    DEONSTL_CHECK(v.is_inline() && v.capacity() == 4);
+    for(int i = 0; i < 40; ++i)
+    {
+        v.push_back(item(i));
+        ref.push_back(item(i));
+        DEONSTL_CHECK(v.is_inline() == (i < 4));
+        check_equal(v, ref);
+    }
+    v.insert(v.begin() + 3, item(100));
+    ref.insert(ref.begin() + 3, item(100));
+    v.erase(v.begin() + 10, v.begin() + 20);
+    ref.erase(ref.begin() + 10, ref.begin() + 20);
+    check_equal(v, ref);
+
+    v.shrink_to_fit();                  // 超过 N 个元素，仍在堆上
+    DEONSTL_CHECK(!v.is_inline() && v.capacity() == v.size());
+    check_equal(v, ref);
+
+    v.erase(v.begin() + 3, v.end());
+    ref.erase(ref.begin() + 3, ref.end());
+    DEONSTL_CHECK(!v.is_inline());
+    v.shrink_to_fit();                  // 搬回缓冲区
+    DEONSTL_CHECK(v.is_inline());
+    check_equal(v, ref);
+
+    v.clear();
+    v.shrink_to_fit();
+    DEONSTL_CHECK(v.is_inline() && v.empty());
+}
+
+// 复制、移动构造与赋值：源在缓冲区时逐个移动，源在堆上时接管空间，移动后源为空并回到缓冲区
+inline void copy_move_test()
+{
+    const int sizes[] = {0, 2, 4, 5, 17};
+    for(int a : sizes)
+        for(int b : sizes)
+        {
+            std::vector<std::string> ra, rb;
+            svec va = make(a, 0, ra);
+            svec vb = make(b, 1000, rb);
+
+            svec copy(va);
+            check_equal(copy, ra);
+            copy = vb;
+            check_equal(copy, rb);
+            check_equal(vb, rb);
+
+            svec moved(std::move(copy));
+            check_equal(moved, rb);
+            DEONSTL_CHECK(copy.empty() && copy.is_inline());
+
+            moved = std::move(va);
+            check_equal(moved, ra);
+            DEONSTL_CHECK(va.empty() && va.is_inline());
+
+            va.push_back(item(7));          // 移动后的源仍然可用
+            DEONSTL_CHECK(va.size() == 1 && va[0] == item(7));
+
+            moved = std::move(moved);       // 自赋值不改变内容
+            check_equal(moved, ra);
+        }
+}
+
+// swap：内嵌 / 内嵌、内嵌 / 堆、堆 / 堆，两个方向
+inline void swap_test()
+{
+    const int sizes[] = {0, 3, 4, 5, 20};
+    for(int a : sizes)
+        for(int b : sizes)
+        {
+            std::vector<std::string> ra, rb;
+            svec va = make(a, 0, ra);
+            svec vb = make(b, 1000, rb);
+            const bool heap_a = !va.is_inline(), heap_b = !vb.is_inline();
+            const std::string* data_a = va.begin();
+            va.swap(vb);
+            check_equal(va, rb);
+            check_equal(vb, ra);
+            if(heap_a && heap_b)            // 两边都在堆上时只交换指针
+                DEONSTL_CHECK(vb.begin() == data_a);
+            deonSTL::swap(va, vb);
+            check_equal(va, ra);
+            check_equal(vb, rb);
+            va.swap(va);
+            check_equal(va, ra);
+
+            va.push_back(item(-1));         // 交换后两边都能继续增长
+            ra.push_back(item(-1));
+            vb.push_back(item(-2));
+            rb.push_back(item(-2));
+            check_equal(va, ra);
+            check_equal(vb, rb);
+            DEONSTL_CHECK((va == vb) == (ra == rb));
+        }
+}
+
+// 随机操作序列，与 std::vector 逐步对比
+inline void random_test()
+{
+    deonSTL::small_vector<int, 8> v;
+    std::vector<int> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int i = 0; i < 20000; ++i)
+    {
+        const int op = static_cast<int>(next_random(x) % 6);
+        const int value = static_cast<int>(next_random(x) % 1000);
+        if(op <= 1)
+        {
+            v.push_back(value);
+            ref.push_back(value);
+        }
+        else if(op == 2 && !ref.empty())
+        {
+            v.pop_back();
+            ref.pop_back();
+        }
+        else if(op == 3)
+        {
+            const size_t pos = ref.empty() ? 0 : next_random(x) % (ref.size() + 1);
+            v.insert(v.begin() + pos, value);
+            ref.insert(ref.begin() + pos, value);
+        }
+        else if(op == 4 && !ref.empty())
+        {
+            const size_t pos = next_random(x) % ref.size();
+            v.erase(v.begin() + pos);
+            ref.erase(ref.begin() + pos);
+        }
+        else if(op == 5 && i % 64 == 5)
+        {
+            if(ref.size() > 20)
+            {
+                v.resize(3);
+                ref.resize(3);
+            }
+            v.shrink_to_fit();
+            DEONSTL_CHECK(v.is_inline() == (ref.size() <= 8));
+        }
+        DEONSTL_CHECK(v.size() == ref.size());
+    }
+    for(size_t i = 0; i < ref.size(); ++i)
+        DEONSTL_CHECK(v[i] == ref[i]);
+}
+
+void small_vector_test()
+{
+    transition_test();
+    copy_move_test();
+    swap_test();
+    random_test();
+    printf("small_vector_test passed\n");
+}
+
+} // namespace small_vector_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* small_vector_test_h */
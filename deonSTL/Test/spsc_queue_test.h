@@ -0,0 +1,347 @@
+//
+//  spsc_queue_test.h
+//  deonSTL
+//
+//  两个线程通过队列传递 n 个整数的吞吐量：spsc_queue 逐个、批量，与互斥锁保护的 deque 对比
+//  以及两个 spsc_queue 往返传递一个整数（ping-pong）的单程延迟
+//  Linux 下两个线程分别绑定到 cpu0、cpu1 两个核上
+//  计时之前先检查行为：单线程下随机的逐个 / 批量放入取出与 std::deque 对比（下标多次回绕、满与空的边界），
+//  队列析构时剩下的元素被析构，两个线程传递 std::string 时消费者按顺序收到每一个元素
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef spsc_queue_test_h
+#define spsc_queue_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>    // pthread_setaffinity_np
+#endif
+#include "../spsc_queue.h"
+#include "../deque.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace spsc_queue_test{
+
+inline std::string item(uint64_t i)
+{ return "item-" + std::to_string(i) + "-long-enough-to-live-on-the-heap"; }
+
+// 单线程：随机的 try_push / try_emplace / 批量 try_push / try_pop / 批量 try_pop 与 std::deque 对比
+// 容量为 8，两万步中下标回绕几千次；满时放入返回 false 或只放入装得下的部分，空时取出返回 false
+inline void sequential_test()
+{
+    spsc_queue<std::string> q(5);
+    DEONSTL_CHECK(q.capacity() == 8 && q.empty_approx());
+    std::deque<std::string> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        switch(r % 5)
+        {
+            case 0:
+            {
+                const bool pushed = q.try_push(item(r));
+                DEONSTL_CHECK(pushed == (ref.size() < q.capacity()));
+                if(pushed)
+                    ref.push_back(item(r));
+                break;
+            }
+            case 1:
+            {
+                const bool pushed = q.try_emplace(5, 'a' + static_cast<char>(r % 26));
+                DEONSTL_CHECK(pushed == (ref.size() < q.capacity()));
+                if(pushed)
+                    ref.push_back(std::string(5, 'a' + static_cast<char>(r % 26)));
+                break;
+            }
+            case 2:
+            {
+                std::string src[10];
+                const size_t n = (r >> 8) % 11;
+                for(size_t i = 0; i < n; ++i)
+                    src[i] = item(r + i);
+                const size_t expect = std::min(n, q.capacity() - ref.size());
+                DEONSTL_CHECK(q.try_push(src, src + n) == expect);
+                ref.insert(ref.end(), src, src + expect);
+                break;
+            }
+            case 3:
+            {
+                std::string v = "unchanged";
+                const bool popped = q.try_pop(v);
+                DEONSTL_CHECK(popped == !ref.empty());
+                if(popped)
+                {
+                    DEONSTL_CHECK(v == ref.front());
+                    ref.pop_front();
+                }
+                else
+                    DEONSTL_CHECK(v == "unchanged");
+                break;
+            }
+            default:
+            {
+                std::vector<std::string> out(10);
+                const size_t n = (r >> 8) % 11;
+                const size_t expect = std::min(n, ref.size());
+                DEONSTL_CHECK(q.try_pop(out.begin(), n) == expect);
+                for(size_t i = 0; i < expect; ++i)
+                {
+                    DEONSTL_CHECK(out[i] == ref.front());
+                    ref.pop_front();
+                }
+                break;
+            }
+        }
+        DEONSTL_CHECK(q.size_approx() == ref.size());
+    }
+}
+
+// 记录存活对象数的类型
+struct counted
+{
+    static int& live() { static int n = 0; return n; }
+
+    uint64_t value;
+
+    counted(uint64_t v = 0) : value(v) { ++live(); }
+    counted(const counted& rhs) : value(rhs.value) { ++live(); }
+    counted& operator=(const counted& rhs) { value = rhs.value; return *this; }
+    ~counted() { --live(); }
+};
+
+// 队列析构时析构剩下的元素，元素跨过回绕点时也一样；取出的元素在队列中的副本被析构
+inline void destroy_test()
+{
+    for(size_t left = 0; left <= 16; ++left)
+    {
+        {
+            spsc_queue<counted> q(16);
+            counted v;
+            for(uint64_t i = 0; i < 11; ++i)     // 头部移到第 11 个位置
+            {
+                DEONSTL_CHECK(q.try_push(counted(i)));
+                DEONSTL_CHECK(q.try_pop(v) && v.value == i);
+            }
+            DEONSTL_CHECK(counted::live() == 1);
+            counted src[16];
+            for(uint64_t i = 0; i < 16; ++i)
+                src[i].value = i;
+            DEONSTL_CHECK(q.try_push(src, src + left) == left);
+            DEONSTL_CHECK(counted::live() == static_cast<int>(17 + left));
+        }
+        DEONSTL_CHECK(counted::live() == 0);
+    }
+}
+
+// 两个线程传递 std::string：生产者逐个与批量交替放入，消费者逐个与批量交替取出，收到的顺序与放入的顺序相同
+inline void order_test(size_t n)
+{
+    spsc_queue<std::string> q(64);
+    std::thread consumer([&] {
+        std::string buf[16];
+        uint64_t expect = 0;
+        while(expect < n)
+        {
+            if(expect % 2 == 0)
+            {
+                if(q.try_pop(buf[0]))
+                    DEONSTL_CHECK(buf[0] == item(expect++));
+            }
+            else
+            {
+                const size_t k = q.try_pop(buf, 16);
+                for(size_t i = 0; i < k; ++i)
+                    DEONSTL_CHECK(buf[i] == item(expect++));
+            }
+        }
+    });
+    std::string src[16];
+    for(uint64_t i = 0; i < n; )
+    {
+        if(i % 3 == 0)
+        {
+            if(q.try_push(item(i)))
+                ++i;
+            continue;
+        }
+        const size_t k = n - i < 16 ? n - i : 16;
+        for(size_t j = 0; j < k; ++j)
+            src[j] = item(i + j);
+        size_t done = 0;
+        while(done < k)
+            done += q.try_push(src + done, src + k);
+        i += k;
+    }
+    consumer.join();
+    DEONSTL_CHECK(q.empty_approx());
+}
+
+// 把当前线程绑定到 cpu 上，其他平台什么都不做
+inline void pin_to_cpu(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// 生产者、消费者分别在 cpu0、cpu1 上运行，返回耗时（毫秒）
+template <class Producer, class Consumer>
+double run_pair(int cpu0, int cpu1, Producer producer, Consumer consumer)
+{
+    return time_ms([&] {
+        std::thread t([&] { pin_to_cpu(cpu1); consumer(); });
+        pin_to_cpu(cpu0);
+        producer();
+        t.join();
+    });
+}
+
+// 打印耗时与吞吐量，消费者收到的数之和 sum 必须为 0 + 1 + ... + (n-1)
+inline void print_line(const char* name, size_t n, double ms, uint64_t sum)
+{
+    printf("%-22s %12.1f %12.1f\n", name, ms, n / ms / 1000.0);
+    DEONSTL_CHECK(sum == static_cast<uint64_t>(n) * (n - 1) / 2);
+}
+
+void spsc_queue_test(size_t n = 100000000, size_t capacity = 4096,
+                     int cpu0 = 0, int cpu1 = 1)
+{
+    sequential_test();
+    destroy_test();
+    order_test(200000);
+    printf("spsc_queue behaviour_test passed\n");
+
+    printf("n = %zu, capacity = %zu\n", n, capacity);
+    if(std::thread::hardware_concurrency() < 2)
+        printf("warning: fewer than 2 cpus, the spinning threads share one core\n");
+    printf("%-22s %12s %12s\n", "", "time(ms)", "Mitems/s");
+
+    {// 逐个
+        spsc_queue<uint64_t> q(capacity);
+        uint64_t sum = 0;
+        double ms = run_pair(cpu0, cpu1,
+            [&] { for(uint64_t i = 0; i < n; ++i) while(!q.try_push(i)) {} },
+            [&] {
+                uint64_t v;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    while(!q.try_pop(v)) {}
+                    DEONSTL_CHECK(v == i);
+                    sum += v;
+                }
+            });
+        print_line("spsc_queue", n, ms, sum);
+    }
+
+    {// 每次最多 64 个
+        const size_t batch = 64;
+        spsc_queue<uint64_t> q(capacity);
+        uint64_t sum = 0;
+        double ms = run_pair(cpu0, cpu1,
+            [&] {
+                uint64_t buf[batch];
+                for(uint64_t i = 0; i < n; )
+                {
+                    const size_t k = n - i < batch ? n - i : batch;
+                    for(size_t j = 0; j < k; ++j)
+                        buf[j] = i + j;
+                    size_t done = 0;
+                    while(done < k)
+                        done += q.try_push(buf + done, buf + k);
+                    i += k;
+                }
+            },
+            [&] {
+                uint64_t buf[batch];
+                for(size_t got = 0; got < n; )
+                {
+                    const size_t k = q.try_pop(buf, batch);
+                    for(size_t j = 0; j < k; ++j)
+                        sum += buf[j];
+                    got += k;
+                }
+            });
+        print_line("spsc_queue batch 64", n, ms, sum);
+    }
+
+    {// 互斥锁 + deque，元素个数取十分之一
+        const size_t m = n / 10;
+        deonSTL::deque<uint64_t> d;
+        std::mutex mtx;
+        uint64_t sum = 0;
+        double ms = run_pair(cpu0, cpu1,
+            [&] {
+                for(uint64_t i = 0; i < m; )
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(d.size() < capacity)
+                        d.push_back(i++);
+                }
+            },
+            [&] {
+                for(size_t got = 0; got < m; )
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(!d.empty())
+                    {
+                        sum += d.front();
+                        d.pop_front();
+                        ++got;
+                    }
+                }
+            });
+        print_line("mutex + deque (n/10)", m, ms, sum);
+    }
+
+    {// ping-pong：一个整数来回传递，单程延迟为往返时间的一半
+        const size_t rounds = n / 100;
+        spsc_queue<uint64_t> ping(capacity), pong(capacity);
+        double ms = run_pair(cpu0, cpu1,
+            [&] {
+                uint64_t v;
+                for(uint64_t i = 0; i < rounds; ++i)
+                {
+                    while(!ping.try_push(i)) {}
+                    while(!pong.try_pop(v)) {}
+                    DEONSTL_CHECK(v == i);
+                }
+            },
+            [&] {
+                uint64_t v;
+                for(size_t i = 0; i < rounds; ++i)
+                {
+                    while(!ping.try_pop(v)) {}
+                    while(!pong.try_push(v)) {}
+                }
+            });
+        printf("ping-pong: %zu round trips, one-way latency %.1f ns\n",
+               rounds, ms * 1e6 / rounds / 2);
+    }
+}
+
+} // namespace spsc_queue_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* spsc_queue_test_h */
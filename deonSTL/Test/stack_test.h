@@ -0,0 +1,217 @@
+//
+//  stack_test.h
+//  deonSTL
+//
+//  stack 的行为：各底层容器上随机 push / emplace / pop、复制、移动、交换、比较，与 std::stack 对比
+//  stack 用于 DFS 的性能：以显式栈先序遍历树并对节点值求和，比较不同底层容器
+//  big   : 一棵 n 个节点的随机树（父节点在前面的节点中随机选），只遍历一次，栈由一次遍历反复 push / pop
+//  small : trees 棵 63 个节点的完全二叉树，每棵树新建一个栈遍历，栈的构造、扩容占主要开销
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef stack_test_h
+#define stack_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <stack>
+#include <string>
+#include "../stack.h"
+#include "../deque.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace stack_test{
+
+// 逐个弹出比较，不改变参数
+template <class Stack>
+bool same(Stack s, std::stack<std::string> ref)
+{
+    if(s.size() != ref.size())
+        return false;
+    for(; !ref.empty(); s.pop(), ref.pop())
+        if(s.top() != ref.top())
+            return false;
+    return s.empty();
+}
+
+template <class Stack>
+void behaviour_test()
+{
+    Stack s;
+    std::stack<std::string> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        // 前半段栈逐渐变深（跨过 inline_stack 的内嵌容量），后半段逐渐变浅
+        if(r % 16 < (step < 10000 ? 10u : 6u) || ref.empty())
+        {
+            const std::string v = "value-" + std::to_string(r % 100000) + "-on-the-heap";
+            if(r % 2 == 0)
+                s.push(v);
+            else
+                s.emplace(v);
+            ref.push(v);
+        }
+        else
+        {
+            DEONSTL_CHECK(s.top() == ref.top());
+            s.pop();
+            ref.pop();
+        }
+        DEONSTL_CHECK(s.size() == ref.size() && s.empty() == ref.empty());
+        if(step % 2000 == 0)
+        {
+            Stack copy(s);
+            DEONSTL_CHECK(copy == s && same(copy, ref));
+            Stack other;
+            other.push("other");
+            other.swap(copy);
+            DEONSTL_CHECK(same(other, ref) && copy.size() == 1 && copy.top() == "other");
+            DEONSTL_CHECK(copy != s || ref.size() == 1);
+            Stack moved(std::move(other));
+            DEONSTL_CHECK(same(moved, ref));
+            copy = std::move(moved);
+            DEONSTL_CHECK(same(copy, ref));
+        }
+    }
+    DEONSTL_CHECK(same(s, ref));
+    s.clear();
+    DEONSTL_CHECK(s.empty());
+}
+
+// 以数组形式存放的树：节点 i 的孩子为 child[first[i]] .. child[first[i + 1] - 1]
+struct tree
+{
+    deonSTL::vector<uint32_t>   first;
+    deonSTL::vector<uint32_t>   child;
+    deonSTL::vector<uint64_t>   value;
+};
+
+// 由每个节点的父节点建树，parent[i] == i 的节点为根
+inline void build(tree& t, const deonSTL::vector<uint32_t>& parent)
+{
+    const size_t n = parent.size();
+    t.first = deonSTL::vector<uint32_t>(n + 1, 0);
+    for(size_t i = 0; i < n; ++i)
+        if(parent[i] != i)
+            ++t.first[parent[i] + 1];
+    for(size_t i = 0; i < n; ++i)
+        t.first[i + 1] += t.first[i];
+    t.child.resize(t.first[n]);
+    deonSTL::vector<uint32_t> pos(t.first.begin(), t.first.end() - 1);
+    for(size_t i = 0; i < n; ++i)
+        if(parent[i] != i)
+            t.child[pos[parent[i]]++] = static_cast<uint32_t>(i);
+    t.value.resize(n);
+    for(size_t i = 0; i < n; ++i)
+        t.value[i] = i;
+}
+
+typedef deonSTL::stack<uint32_t, deonSTL::deque<uint32_t>>  deque_stack;
+typedef deonSTL::stack<uint32_t>                            vector_stack;
+typedef deonSTL::inline_stack<uint32_t, 64>                 small_stack;
+typedef std::stack<uint32_t>                                std_stack;
+
+// 预留空间，deque 与 std::stack 没有 reserve
+template <class Stack>
+void prepare(Stack& s, size_t n) { if(n != 0) s.reserve(n); }
+inline void prepare(deque_stack&, size_t) {}
+inline void prepare(std_stack&, size_t) {}
+
+// 用新建的栈先序遍历以 root 为根的子树，reserve 不为 0 时先预留空间
+template <class Stack>
+uint64_t dfs_sum(const tree& t, uint32_t root, size_t reserve = 0)
+{
+    Stack s;
+    prepare(s, reserve);
+    s.push(root);
+    uint64_t sum = 0;
+    while(!s.empty())
+    {
+        const uint32_t v = s.top();
+        s.pop();
+        sum += t.value[v];
+        for(uint32_t k = t.first[v + 1]; k != t.first[v]; --k)
+            s.push(t.child[k - 1]);
+    }
+    return sum;
+}
+
+void stack_test(size_t n = 10000000, size_t trees = 1000000, int rounds = 5)
+{
+    behaviour_test<deonSTL::stack<std::string>>();
+    behaviour_test<deonSTL::stack<std::string, deonSTL::deque<std::string>>>();
+    behaviour_test<deonSTL::inline_stack<std::string, 8>>();
+
+    // big：随机树
+    deonSTL::vector<uint32_t> parent(n);
+    uint64_t x = 88172645463325252ull;
+    for(size_t i = 1; i < n; ++i)
+        parent[i] = static_cast<uint32_t>(next_random(x) % i);
+    tree big;
+    build(big, parent);     // parent[0] == 0，0 号为根
+
+    // small：trees 棵 63 个节点的完全二叉树组成的森林，第 r 棵树的根为 63r
+    const size_t m = 63;
+    parent.resize(trees * m);
+    for(size_t r = 0; r < trees; ++r)
+    {
+        parent[r * m] = static_cast<uint32_t>(r * m);
+        for(size_t i = 1; i < m; ++i)
+            parent[r * m + i] = static_cast<uint32_t>(r * m + (i - 1) / 2);
+    }
+    tree forest;
+    build(forest, parent);
+
+    uint64_t s[5] = {0, 0, 0, 0, 0};
+    printf("big: random tree of %zu nodes, %d rounds\n", n, rounds);
+    printf("%-28s %12s\n", "stack", "time(ms)");
+    const double b0 = time_ms([&] { for(int r = 0; r < rounds; ++r) s[0] += dfs_sum<deque_stack>(big, 0); });
+    const double b1 = time_ms([&] { for(int r = 0; r < rounds; ++r) s[1] += dfs_sum<vector_stack>(big, 0); });
+    const double b2 = time_ms([&] { for(int r = 0; r < rounds; ++r) s[2] += dfs_sum<vector_stack>(big, 0, 1024); });
+    const double b3 = time_ms([&] { for(int r = 0; r < rounds; ++r) s[3] += dfs_sum<small_stack>(big, 0); });
+    const double b4 = time_ms([&] { for(int r = 0; r < rounds; ++r) s[4] += dfs_sum<std_stack>(big, 0); });
+    printf("%-28s %12.1f\n", "stack<deque>", b0);
+    printf("%-28s %12.1f\n", "stack<vector>", b1);
+    printf("%-28s %12.1f\n", "stack<vector> + reserve", b2);
+    printf("%-28s %12.1f\n", "inline_stack<64>", b3);
+    printf("%-28s %12.1f\n", "std::stack", b4);
+    // 节点值为 0..n-1，每轮遍历全部节点
+    const uint64_t big_expect = static_cast<uint64_t>(n) * (n - 1) / 2 * rounds;
+    DEONSTL_CHECK(s[0] == big_expect && s[1] == big_expect && s[2] == big_expect &&
+                  s[3] == big_expect && s[4] == big_expect);
+
+    for(int i = 0; i < 5; ++i)
+        s[i] = 0;
+    printf("small: %zu trees of %zu nodes, a new stack per tree\n", trees, m);
+    printf("%-28s %12s\n", "stack", "time(ms)");
+    const double t0 = time_ms([&] { for(size_t r = 0; r < trees; ++r) s[0] += dfs_sum<deque_stack>(forest, static_cast<uint32_t>(r * m)); });
+    const double t1 = time_ms([&] { for(size_t r = 0; r < trees; ++r) s[1] += dfs_sum<vector_stack>(forest, static_cast<uint32_t>(r * m)); });
+    const double t2 = time_ms([&] { for(size_t r = 0; r < trees; ++r) s[2] += dfs_sum<vector_stack>(forest, static_cast<uint32_t>(r * m), 64); });
+    const double t3 = time_ms([&] { for(size_t r = 0; r < trees; ++r) s[3] += dfs_sum<small_stack>(forest, static_cast<uint32_t>(r * m)); });
+    const double t4 = time_ms([&] { for(size_t r = 0; r < trees; ++r) s[4] += dfs_sum<std_stack>(forest, static_cast<uint32_t>(r * m)); });
+    printf("%-28s %12.1f\n", "stack<deque>", t0);
+    printf("%-28s %12.1f\n", "stack<vector>", t1);
+    printf("%-28s %12.1f\n", "stack<vector> + reserve", t2);
+    printf("%-28s %12.1f\n", "inline_stack<64>", t3);
+    printf("%-28s %12.1f\n", "std::stack", t4);
+    const uint64_t small_expect = static_cast<uint64_t>(trees * m) * (trees * m - 1) / 2;
+    DEONSTL_CHECK(s[0] == small_expect && s[1] == small_expect && s[2] == small_expect &&
+                  s[3] == small_expect && s[4] == small_expect);
+}
+
+} // namespace stack_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* stack_test_h */
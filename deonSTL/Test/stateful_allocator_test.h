@@ -0,0 +1,203 @@
+//
+//  stateful_allocator_test.h
+//  deonSTL
+//
+//  有状态的配置器：arena_allocator 持有一个 arena 指针，每块内存登记申请它的 arena，
+//  释放时检查是否由同一个 arena 申请、大小是否一致
+//  vector / deque / rb_tree 在复制、移动、交换后持有的配置器，以及所有内存都归还给申请它的 arena
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef stateful_allocator_test_h
+#define stateful_allocator_test_h
+
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <new>
+#include <utility>
+#include "../vector.h"
+#include "../deque.h"
+#include "../rb_tree.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace stateful_allocator_test{
+
+struct arena
+{
+    int  id;
+    long live;      // 尚未归还的块数
+    long allocs;    // 申请的次数
+
+    explicit arena(int i) : id(i), live(0), allocs(0) {}
+};
+
+// 每块内存的（申请它的 arena 的 id，字节数）
+inline std::map<void*, std::pair<int, size_t>>& owners()
+{
+    static std::map<void*, std::pair<int, size_t>> m;
+    return m;
+}
+
+template <class T>
+class arena_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef arena_allocator<U> other;
+    };
+
+public:
+    explicit arena_allocator(arena* a) noexcept : arena_(a) {}
+    template <class U>
+    arena_allocator(const arena_allocator<U>& rhs) noexcept : arena_(rhs.get_arena()) {}
+
+    T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        void* p = ::operator new(n * sizeof(T));
+        owners()[p] = std::make_pair(arena_->id, n * sizeof(T));
+        ++arena_->live;
+        ++arena_->allocs;
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        if(ptr == nullptr) return;
+        auto it = owners().find(ptr);
+        DEONSTL_CHECK(it != owners().end());
+        DEONSTL_CHECK(it->second.first == arena_->id);      // 归还给申请它的 arena
+        DEONSTL_CHECK(it->second.second == n * sizeof(T));
+        owners().erase(it);
+        --arena_->live;
+        ::operator delete(ptr);
+    }
+
+    arena* get_arena() const noexcept { return arena_; }
+
+private:
+    arena* arena_;
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+{ return lhs.get_arena() == rhs.get_arena(); }
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+{ return !(lhs == rhs); }
+
+typedef deonSTL::vector<int, arena_allocator<int>>                  vector_type;
+typedef deonSTL::deque<int, arena_allocator<int>>                   deque_type;
+typedef deonSTL::rb_tree<int, std::less<int>, arena_allocator<int>> tree_type;
+
+// 各容器统一的构造、追加元素接口
+inline vector_type make(vector_type*, arena& a) { return vector_type(arena_allocator<int>(&a)); }
+inline deque_type  make(deque_type*, arena& a)  { return deque_type(arena_allocator<int>(&a)); }
+inline tree_type   make(tree_type*, arena& a)   { return tree_type(std::less<int>(), arena_allocator<int>(&a)); }
+
+inline void append(vector_type& c, int first, int n) { for(int i = 0; i < n; ++i) c.push_back(first + i); }
+inline void append(deque_type& c, int first, int n)  { for(int i = 0; i < n; ++i) c.push_back(first + i); }
+inline void append(tree_type& c, int first, int n)   { for(int i = 0; i < n; ++i) c.insert_unique(first + i); }
+
+template <class C>
+arena* arena_of(const C& c) { return c.get_allocator().get_arena(); }
+
+// 元素依次为 first, first + 1, ..., first + n - 1
+template <class C>
+bool holds(const C& c, int first, int n)
+{
+    if(static_cast<int>(c.size()) != n) return false;
+    int i = first;
+    for(auto it = c.begin(); it != c.end(); ++it, ++i)
+        if(*it != i) return false;
+    return true;
+}
+
+template <class C>
+void container_test()
+{
+    C* tag = nullptr;
+    arena a(1), b(2), c(3), d(4);
+    {
+        C x = make(tag, a);
+        append(x, 0, 1000);
+        DEONSTL_CHECK(arena_of(x) == &a && a.live > 0);
+
+        // 复制构造：复制配置器
+        C copied(x);
+        DEONSTL_CHECK(arena_of(copied) == &a && holds(copied, 0, 1000));
+
+        // 复制赋值：保留自己的配置器，新空间由自己的 arena 申请
+        C assigned = make(tag, b);
+        append(assigned, 5000, 10);
+        const long b_allocs = b.allocs;
+        assigned = x;
+        DEONSTL_CHECK(arena_of(assigned) == &b && holds(assigned, 0, 1000));
+        DEONSTL_CHECK(b.allocs > b_allocs);
+
+        // 移动构造：连同配置器一起移动，元素所在的空间不变
+        const long a_allocs = a.allocs;
+        C moved(std::move(copied));
+        DEONSTL_CHECK(arena_of(moved) == &a && holds(moved, 0, 1000) && a.allocs == a_allocs);
+
+        // 移动赋值：旧空间归还给原来的 arena，之后使用 rhs 的 arena
+        C target = make(tag, c);
+        append(target, 7000, 100);
+        DEONSTL_CHECK(c.live > 0);
+        target = std::move(moved);
+        DEONSTL_CHECK(arena_of(target) == &a && holds(target, 0, 1000) && c.live == 0);
+        append(target, 1000, 1000);
+        DEONSTL_CHECK(holds(target, 0, 2000) && c.live == 0);
+
+        // 交换：连同配置器一起交换，之后的增长仍由各自原来的 arena 负责
+        C other = make(tag, d);
+        append(other, 9000, 50);
+        other.swap(assigned);
+        DEONSTL_CHECK(arena_of(other) == &b && holds(other, 0, 1000));
+        DEONSTL_CHECK(arena_of(assigned) == &d && holds(assigned, 9000, 50));
+        const long d_allocs = d.allocs;
+        append(assigned, 9050, 2000);
+        append(other, 1000, 2000);
+        DEONSTL_CHECK(d.allocs > d_allocs && holds(assigned, 9000, 2050) && holds(other, 0, 3000));
+        assigned.clear();
+        other.clear();
+    }
+    // 全部内存都已归还，并且每块都是归还给申请它的 arena（deallocate 中检查）
+    DEONSTL_CHECK(a.live == 0 && b.live == 0 && c.live == 0 && d.live == 0);
+    DEONSTL_CHECK(owners().empty());
+}
+
+void stateful_allocator_test()
+{
+    container_test<vector_type>();
+    container_test<deque_type>();
+    container_test<tree_type>();
+    printf("stateful_allocator_test passed\n");
+}
+
+} // namespace stateful_allocator_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* stateful_allocator_test_h */
@@ -0,0 +1,56 @@
+//
+//  test_util.h
+//  deonSTL
+//
+//  Test 目录下各测试共用的工具
+//  DEONSTL_CHECK(expr) : expr 不成立时打印所在的文件、行号与表达式，然后终止程序
+//  time_ms(f)          : 执行 f 的耗时（毫秒）
+//  next_random(x)      : xorshift64 伪随机数，x 为非零的状态
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef test_util_h
+#define test_util_h
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace deonSTL{
+
+namespace test{
+
+inline void check_failed(const char* expr, const char* file, int line)
+{
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+    std::abort();
+}
+
+#define DEONSTL_CHECK(expr) \
+    ((expr) ? static_cast<void>(0) : deonSTL::test::check_failed(#expr, __FILE__, __LINE__))
+
+template <class F>
+double time_ms(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+inline uint64_t next_random(uint64_t& x)
+{
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* test_util_h */
@@ -0,0 +1,169 @@
+//
+//  uninitialized_test.h
+//  deonSTL
+//
+//  uninitialized_fill / copy / move 经过 memory_kernel.h 的结果：各种长度与起始地址下逐个元素与期望值对比，
+//  并检查写入范围之外的元素没有被改动；填充覆盖 memset、SIMD 广播、非临时写入三条路径
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef uninitialized_test_h
+#define uninitialized_test_h
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "../uninitialized.h"
+#include "../memory_kernel.h"
+#include "../deque.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace uninitialized_test{
+
+// 3 字节的类型：走 std::fill_n，不走 SIMD
+struct rgb
+{
+    unsigned char r, g, b;
+};
+
+inline bool operator==(const rgb& lhs, const rgb& rhs)
+{ return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b; }
+
+// 在 buf 的第 offset 个元素开始填充 n 个 value，其余元素必须仍为 guard
+template <class T>
+void check_fill(const T& value, const T& guard, size_t offset, size_t n)
+{
+    std::vector<T> buf(offset + n + 8, guard);
+    T* first = buf.data() + offset;
+    T* last = deonSTL::uninitialized_fill_n(first, n, value);
+    DEONSTL_CHECK(last == first + n);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? value : guard));
+
+    std::fill(buf.begin(), buf.end(), guard);
+    deonSTL::uninitialized_fill(first, first + n, value);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? value : guard));
+}
+
+// 各种长度、各种起始偏移：覆盖 SIMD 循环前后的标量部分
+template <class T>
+void fill_sizes(const T& value, const T& guard)
+{
+    for(size_t offset = 0; offset < 9; ++offset)
+        for(size_t n = 0; n < 80; ++n)
+            check_fill(value, guard, offset, n);
+}
+
+inline void fill_test()
+{
+    fill_sizes<int>(0, 7);                       // memset
+    fill_sizes<int>(-1, 7);                      // memset
+    fill_sizes<char>('x', 'y');                  // memset
+    fill_sizes<int>(0x12345678, 7);              // 4 字节广播
+    fill_sizes<float>(1.5f, 0.0f);
+    fill_sizes<uint64_t>(0x0102030405060708ull, 9);   // 8 字节广播
+    fill_sizes<double>(-3.25, 0.0);
+    fill_sizes<rgb>(rgb{1, 2, 3}, rgb{0, 0, 0});
+
+    // 超过 __nt_store_threshold：非临时写入，起始地址不在 SIMD 边界上
+    const size_t big4 = deonSTL::__nt_store_threshold / sizeof(uint32_t) + 37;
+    check_fill<uint32_t>(0xdeadbeefu, 1u, 3, big4);
+    const size_t big8 = deonSTL::__nt_store_threshold / sizeof(double) + 11;
+    check_fill<double>(2.5, 0.0, 1, big8);
+}
+
+// 复制、移动到未初始化空间：与源逐个相同，目的范围之外不变
+template <class T>
+void check_copy(const std::vector<T>& src, size_t offset, const T& guard)
+{
+    const size_t n = src.size();
+    const T* s = n == 0 ? nullptr : src.data();
+    std::vector<T> buf(offset + n + 8, guard);
+    T* first = buf.data() + offset;
+
+    DEONSTL_CHECK(deonSTL::uninitialized_copy(s, s + n, first) == first + n);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? src[i - offset] : guard));
+
+    std::fill(buf.begin(), buf.end(), guard);
+    DEONSTL_CHECK(deonSTL::uninitialized_copy_n(s, n, first) == first + n);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? src[i - offset] : guard));
+
+    std::vector<T> tmp(src);
+    T* t = n == 0 ? nullptr : tmp.data();
+    std::fill(buf.begin(), buf.end(), guard);
+    DEONSTL_CHECK(deonSTL::uninitialized_move(t, t + n, first) == first + n);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? src[i - offset] : guard));
+
+    std::fill(buf.begin(), buf.end(), guard);
+    DEONSTL_CHECK(deonSTL::uninitialized_move_n(t, n, first) == first + n);
+    for(size_t i = 0; i < buf.size(); ++i)
+        DEONSTL_CHECK(buf[i] == (i >= offset && i < offset + n ? src[i - offset] : guard));
+}
+
+inline void copy_test()
+{
+    uint64_t x = 88172645463325252ull;
+    for(size_t n = 0; n < 70; ++n)
+    {
+        std::vector<int> ints;
+        std::vector<double> doubles;
+        for(size_t i = 0; i < n; ++i)
+        {
+            ints.push_back(static_cast<int>(next_random(x)));
+            doubles.push_back(static_cast<double>(next_random(x) % 1000) / 8);
+        }
+        for(size_t offset = 0; offset < 5; ++offset)
+        {
+            check_copy(ints, offset, -7);
+            check_copy(doubles, offset, -7.0);
+        }
+    }
+}
+
+// 迭代器不是指针时走 std::fill / std::copy，结果相同
+inline void iterator_test()
+{
+    deonSTL::deque<int> d(100, 0);
+    deonSTL::uninitialized_fill(d.begin() + 10, d.begin() + 90, 0x11223344);
+    for(size_t i = 0; i < d.size(); ++i)
+        DEONSTL_CHECK(d[i] == (i >= 10 && i < 90 ? 0x11223344 : 0));
+
+    int src[50];
+    for(int i = 0; i < 50; ++i)
+        src[i] = i * i;
+    deonSTL::uninitialized_copy(src, src + 50, d.begin() + 25);
+    for(size_t i = 0; i < 50; ++i)
+        DEONSTL_CHECK(d[25 + i] == src[i]);
+
+    int out[50];
+    deonSTL::uninitialized_copy(d.begin() + 25, d.begin() + 75, out);
+    DEONSTL_CHECK(std::memcmp(out, src, sizeof(src)) == 0);
+}
+
+void uninitialized_test()
+{
+    fill_test();
+    copy_test();
+    iterator_test();
+    printf("uninitialized_test passed\n");
+}
+
+} // namespace uninitialized_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* uninitialized_test_h */
@@ -0,0 +1,441 @@
+//
+//  unordered_map_test.h
+//  deonSTL
+//
+//  查找命中的耗时：map（红黑树）、unordered_map（开放定址 + deonSTL::hash）与 std::unordered_map
+//  键为 uint64_t 与长度 24 的字符串，元素个数从放得进 L1 缓存到放不进末级缓存
+//  计时之前先以随机操作与 std::unordered_map / std::unordered_multimap 逐步对比 unordered_map / unordered_multimap 的内容，
+//  unordered_set / unordered_multiset 同样与 std::unordered_set / std::unordered_multiset 对比
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef unordered_map_test_h
+#define unordered_map_test_h
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "../map.h"
+#include "../unordered_map.h"
+#include "../unordered_set.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace unordered_map_test{
+
+//***************************************************************************//
+//                                 behaviour                                 //
+//***************************************************************************//
+
+inline std::string key_of(uint64_t k)   { return "key-" + std::to_string(k) + "-long-enough-to-live-on-the-heap"; }
+inline std::string value_of(uint64_t v) { return "value-" + std::to_string(v); }
+
+// 内容相同，且每个元素都能从它所在的桶的局部迭代器中找到
+template <class Map, class Ref>
+void check_equal(const Map& m, const Ref& ref)
+{
+    DEONSTL_CHECK(m.size() == ref.size());
+    size_t n = 0;
+    for(auto it = m.begin(); it != m.end(); ++it, ++n)
+        DEONSTL_CHECK(m.count(it->first) == ref.count(it->first));
+    DEONSTL_CHECK(n == ref.size());
+    for(auto it = ref.begin(); it != ref.end(); ++it)
+    {
+        const size_t b = m.bucket(it->first);
+        bool found = false;
+        for(auto lit = m.begin(b); lit != m.end(b) && !found; ++lit)
+            found = lit->first == it->first && lit->second == it->second;
+        DEONSTL_CHECK(found);
+    }
+    size_t total = 0;
+    for(size_t b = 0; b < m.bucket_count(); ++b)
+        total += m.bucket_size(b);
+    DEONSTL_CHECK(total == ref.size());
+}
+
+// operator[] / try_emplace / insert_or_assign / insert / erase / find / count / rehash 与 std::unordered_map 对比
+inline void map_test()
+{
+    typedef deonSTL::unordered_map<std::string, std::string> map;
+    map m;
+    std::unordered_map<std::string, std::string> ref;
+    uint64_t x = 88172645463325252ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const std::string k = key_of(r % 1500);
+        switch(r >> 32 & 7)
+        {
+            case 0:
+                m[k] = value_of(r);
+                ref[k] = value_of(r);
+                break;
+            case 1:
+            {
+                auto res = m.try_emplace(k, value_of(r));
+                auto rr = ref.emplace(k, value_of(r));
+                DEONSTL_CHECK(res.second == rr.second && res.first->second == rr.first->second);
+                break;
+            }
+            case 2:
+            {
+                const bool inserted = ref.count(k) == 0;
+                ref[k] = value_of(r);
+                DEONSTL_CHECK(m.insert_or_assign(k, value_of(r)).second == inserted);
+                break;
+            }
+            case 3:
+                DEONSTL_CHECK(m.insert(map::value_type(k, value_of(r))).second ==
+                              ref.insert(std::make_pair(k, value_of(r))).second);
+                break;
+            case 4:
+            case 5:
+                DEONSTL_CHECK(m.erase(k) == ref.erase(k));
+                break;
+            case 6:
+            {
+                auto it = m.find(k);
+                auto rit = ref.find(k);
+                DEONSTL_CHECK((it == m.end()) == (rit == ref.end()));
+                if(it != m.end())
+                    DEONSTL_CHECK(it->second == rit->second);
+                break;
+            }
+            default:
+                if(step % 800 == 7)
+                    m.rehash(static_cast<size_t>(r % 3000));
+                break;
+        }
+        if(step % 2000 == 0)
+            check_equal(m, ref);
+    }
+    check_equal(m, ref);
+
+    map copy(m);
+    DEONSTL_CHECK(copy == m);
+    copy[key_of(99999)] = value_of(0);
+    DEONSTL_CHECK(copy != m);
+    map other;
+    other.swap(copy);
+    DEONSTL_CHECK(copy.empty() && other.size() == ref.size() + 1);
+    other = std::move(m);
+    check_equal(other, ref);
+}
+
+// insert / erase / count / equal_range 与 std::unordered_multimap 对比
+inline void multimap_test()
+{
+    typedef deonSTL::unordered_multimap<std::string, std::string> map;
+    map m;
+    std::unordered_multimap<std::string, std::string> ref;
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const std::string k = key_of(r % 300);
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            case 2:
+                DEONSTL_CHECK(m.insert(map::value_type(k, value_of(r % 7)))->first == k);
+                ref.insert(std::make_pair(k, value_of(r % 7)));
+                break;
+            case 3:
+                DEONSTL_CHECK(m.erase(k) == ref.erase(k));
+                break;
+            case 4:
+            {
+                auto it = m.find(k);
+                DEONSTL_CHECK((it == m.end()) == (ref.count(k) == 0));
+                if(it != m.end())               // 删除一个键与值都相同的元素
+                {
+                    auto range = ref.equal_range(k);
+                    while(range.first->second != it->second)
+                        ++range.first;
+                    ref.erase(range.first);
+                    m.erase(it);
+                }
+                break;
+            }
+            case 5:
+            {
+                auto range = m.equal_range(k);
+                size_t n = 0;
+                for(; range.first != range.second; ++range.first, ++n)
+                    DEONSTL_CHECK(range.first->first == k);
+                DEONSTL_CHECK(n == ref.count(k));
+                break;
+            }
+            case 6:
+                DEONSTL_CHECK(m.count(k) == ref.count(k));
+                break;
+            default:
+                if(step % 800 == 7)
+                    m.rehash(static_cast<size_t>(r % 3000));
+                break;
+        }
+        DEONSTL_CHECK(m.size() == ref.size());
+    }
+    check_equal(m, ref);
+    map copy(m);
+    DEONSTL_CHECK(copy == m);
+}
+
+// 集合版本的 check_equal：逐个元素比较出现次数，并能在所在桶的局部迭代器中找到
+template <class Set, class Ref>
+void check_set_equal(const Set& s, const Ref& ref)
+{
+    DEONSTL_CHECK(s.size() == ref.size());
+    DEONSTL_CHECK(s.empty() == ref.empty());
+    size_t n = 0;
+    for(auto it = s.begin(); it != s.end(); ++it, ++n)
+        DEONSTL_CHECK(s.count(*it) == ref.count(*it));
+    DEONSTL_CHECK(n == ref.size());
+    for(auto it = ref.begin(); it != ref.end(); ++it)
+    {
+        const size_t b = s.bucket(*it);
+        DEONSTL_CHECK(b < s.bucket_count());
+        size_t in_bucket = 0;
+        for(auto lit = s.begin(b); lit != s.end(b); ++lit)
+            in_bucket += *lit == *it;
+        DEONSTL_CHECK(in_bucket == ref.count(*it));
+    }
+    size_t total = 0;
+    for(size_t b = 0; b < s.bucket_count(); ++b)
+        total += s.bucket_size(b);
+    DEONSTL_CHECK(total == ref.size());
+    DEONSTL_CHECK(s.load_factor() <= s.max_load_factor());
+}
+
+// insert / emplace / erase(key) / erase(pos) / find / count / equal_range / rehash 与 std::unordered_set 对比
+inline void set_test()
+{
+    typedef deonSTL::unordered_set<std::string> set;
+    set s;
+    std::unordered_set<std::string> ref;
+    uint64_t x = 0x2545f4914f6cdd1dull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const std::string k = key_of(r % 1500);
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            {
+                auto res = s.insert(k);
+                DEONSTL_CHECK(res.second == ref.insert(k).second && *res.first == k);
+                break;
+            }
+            case 2:
+                DEONSTL_CHECK(s.emplace(k).second == ref.emplace(k).second);
+                break;
+            case 3:
+                DEONSTL_CHECK(s.erase(k) == ref.erase(k));
+                break;
+            case 4:
+            {
+                auto it = s.find(k);
+                DEONSTL_CHECK((it == s.end()) == (ref.count(k) == 0));
+                if(it != s.end())
+                {
+                    s.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            }
+            case 5:
+            {
+                const set& cs = s;
+                auto range = cs.equal_range(k);
+                size_t n = 0;
+                for(; range.first != range.second; ++range.first, ++n)
+                    DEONSTL_CHECK(*range.first == k);
+                DEONSTL_CHECK(n == ref.count(k) && cs.count(k) == n);
+                break;
+            }
+            default:
+                if(step % 800 == 7)
+                    s.rehash(static_cast<size_t>(r % 3000));
+                break;
+        }
+        if(step % 2000 == 0)
+            check_set_equal(s, ref);
+    }
+    check_set_equal(s, ref);
+
+    set copy(s);
+    DEONSTL_CHECK(copy == s);
+    check_set_equal(copy, ref);
+    copy.insert(key_of(99999));
+    DEONSTL_CHECK(copy != s);
+    set other;
+    other.swap(copy);
+    DEONSTL_CHECK(copy.empty() && other.size() == ref.size() + 1);
+    other = s;
+    DEONSTL_CHECK(other == s);
+    set moved(std::move(other));
+    check_set_equal(moved, ref);
+    moved.erase(moved.begin(), moved.end());
+    DEONSTL_CHECK(moved.empty() && moved.begin() == moved.end());
+    moved.clear();
+    DEONSTL_CHECK(moved.empty());
+}
+
+// insert / erase(key) / erase(pos) / count / equal_range / rehash 与 std::unordered_multiset 对比
+inline void multiset_test()
+{
+    typedef deonSTL::unordered_multiset<std::string> set;
+    set s;
+    std::unordered_multiset<std::string> ref;
+    uint64_t x = 0xd1b54a32d192ed03ull;
+    for(int step = 0; step < 20000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        const std::string k = key_of(r % 300);
+        switch(r >> 32 & 7)
+        {
+            case 0:
+            case 1:
+            case 2:
+                DEONSTL_CHECK(*s.insert(k) == k);
+                ref.insert(k);
+                break;
+            case 3:
+                DEONSTL_CHECK(s.erase(k) == ref.erase(k));
+                break;
+            case 4:
+            {
+                auto it = s.find(k);
+                DEONSTL_CHECK((it == s.end()) == (ref.count(k) == 0));
+                if(it != s.end())               // 只删除一个
+                {
+                    s.erase(it);
+                    ref.erase(ref.find(k));
+                }
+                break;
+            }
+            case 5:
+            {
+                auto range = s.equal_range(k);
+                size_t n = 0;
+                for(; range.first != range.second; ++range.first, ++n)
+                    DEONSTL_CHECK(*range.first == k);
+                DEONSTL_CHECK(n == ref.count(k));
+                break;
+            }
+            case 6:
+                DEONSTL_CHECK(s.count(k) == ref.count(k));
+                break;
+            default:
+                if(step % 800 == 7)
+                    s.rehash(static_cast<size_t>(r % 3000));
+                break;
+        }
+        DEONSTL_CHECK(s.size() == ref.size());
+    }
+    check_set_equal(s, ref);
+
+    set copy(s);
+    DEONSTL_CHECK(copy == s);
+    copy.insert(key_of(0));                     // 多一个重复元素，元素个数不同
+    DEONSTL_CHECK(copy != s);
+    set other;
+    swap(other, copy);
+    DEONSTL_CHECK(copy.empty() && other.size() == ref.size() + 1);
+    other = std::move(s);
+    check_set_equal(other, ref);
+}
+
+//***************************************************************************//
+//                                  find hit                                 //
+//***************************************************************************//
+
+inline void make_keys(deonSTL::vector<uint64_t>& keys, size_t n, uint64_t seed)
+{
+    keys.clear();
+    for(size_t i = 0; i < n; ++i)
+        keys.push_back(next_random(seed));
+}
+
+inline void make_keys(deonSTL::vector<std::string>& keys, size_t n, uint64_t seed)
+{
+    keys.clear();
+    char buf[32];
+    for(size_t i = 0; i < n; ++i)
+    {
+        snprintf(buf, sizeof(buf), "key-%020llu", static_cast<unsigned long long>(next_random(seed)));
+        keys.push_back(std::string(buf));
+    }
+}
+
+// 插入 keys 后按打乱的顺序查找，共查找 lookups 次，返回每次查找的纳秒数
+template <class Table, class Key>
+double find_ns(const deonSTL::vector<Key>& keys, const deonSTL::vector<size_t>& order,
+               size_t lookups, uint64_t& check)
+{
+    Table t;
+    for(size_t i = 0; i < keys.size(); ++i)
+        t[keys[i]] = i;
+    const size_t rounds = lookups / order.size() + 1;
+    const double ms = time_ms([&] {
+        for(size_t r = 0; r < rounds; ++r)
+            for(size_t i = 0; i < order.size(); ++i)
+                check += t.find(keys[order[i]])->second;
+    });
+    return ms * 1e6 / (static_cast<double>(rounds) * order.size());
+}
+
+template <class Key>
+void run(const char* name, size_t lookups)
+{
+    const size_t sizes[4] = {1000, 30000, 1000000, 4000000};
+    uint64_t check = 0;
+    printf("%s keys, find hit (ns/op)\n", name);
+    printf("%-10s %12s %16s %20s\n", "n", "map", "unordered_map", "std::unordered_map");
+    for(int s = 0; s < 4; ++s)
+    {
+        uint64_t c[3] = {0, 0, 0};
+        deonSTL::vector<Key> keys;
+        make_keys(keys, sizes[s], 88172645463325252ull);
+        deonSTL::vector<size_t> order;
+        uint64_t x = 2463534242ull;
+        for(size_t i = 0; i < sizes[s]; ++i)
+            order.push_back(static_cast<size_t>(next_random(x) % sizes[s]));
+        printf("%-10zu %12.1f %16.1f %20.1f\n", sizes[s],
+               find_ns<deonSTL::map<Key, size_t>>(keys, order, lookups, c[0]),
+               find_ns<deonSTL::unordered_map<Key, size_t>>(keys, order, lookups, c[1]),
+               find_ns<std::unordered_map<Key, size_t>>(keys, order, lookups, c[2]));
+        DEONSTL_CHECK(c[0] == c[1] && c[1] == c[2]);
+        check += c[0];
+    }
+    printf("(check %llu)\n", static_cast<unsigned long long>(check));
+}
+
+void unordered_map_test(size_t lookups = 4000000)
+{
+    map_test();
+    multimap_test();
+    set_test();
+    multiset_test();
+    printf("unordered_map behaviour_test passed\n");
+    run<uint64_t>("uint64_t", lookups);
+    run<std::string>("string(24)", lookups);
+}
+
+} // namespace unordered_map_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* unordered_map_test_h */
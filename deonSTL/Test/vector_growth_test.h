@@ -0,0 +1,89 @@
+//
+//  vector_growth_test.h
+//  deonSTL
+//
+//  vector<uint64_t> push_back 到 n 个元素的耗时与峰值内存：allocator 与 realloc_allocator 对比
+//  每种配置器在单独的子进程中运行，峰值内存（ru_maxrss）互不影响
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef vector_growth_test_h
+#define vector_growth_test_h
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <sys/resource.h>   // getrusage
+#include <sys/wait.h>       // waitpid
+#include <unistd.h>         // fork, _exit
+#include "../vector.h"
+#include "../realloc_allocator.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace vector_growth_test{
+
+// 峰值常驻内存（MB），Linux 下 ru_maxrss 单位为 KB，macOS 下为字节
+inline double peak_rss_mb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+// 在子进程中 push_back n 个元素，打印耗时与峰值内存
+template <class Vector>
+void run_in_child(const char* name, size_t n)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Vector v;
+        for(size_t i = 0; i < n; ++i)
+            v.push_back(static_cast<uint64_t>(i));
+        auto finish = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+        const double data_mb = n * sizeof(uint64_t) / (1024.0 * 1024.0);
+        printf("%-20s %14.1f %14.1f %14.1f\n", name, ms, peak_rss_mb(), data_mb);
+        fflush(stdout);
+        bool ok = v.size() == n;
+        for(size_t i = 0; ok && i < n; ++i)
+            ok = v[i] == i;
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    DEONSTL_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);   // 内容不对，或内存不足
+}
+
+// n 缺省为 1e7 个元素（80MB 数据），几秒内完成
+// 大块内存下 mremap 的优势更明显，传入 1e9（8GB 数据）复现完整的测量
+void vector_growth_test(size_t n = 10000000)
+{
+    typedef deonSTL::vector<uint64_t>                                        default_vector;
+    typedef deonSTL::vector<uint64_t, deonSTL::realloc_allocator<uint64_t>>  realloc_vector;
+
+    printf("push_back %zu x uint64_t\n", n);
+    printf("%-20s %14s %14s %14s\n", "Alloc", "time(ms)", "peak rss(MB)", "data(MB)");
+    run_in_child<default_vector>("allocator", n);
+    run_in_child<realloc_vector>("realloc_allocator", n);
+}
+
+} // namespace vector_growth_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* vector_growth_test_h */
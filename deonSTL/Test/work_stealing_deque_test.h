@@ -0,0 +1,349 @@
+//
+//  work_stealing_deque_test.h
+//  deonSTL
+//
+//  work_stealing_deque 的单线程行为、压力测试与 fork-join 性能测试
+//  sequential_test            : 单线程随机 push / pop / steal，与 std::deque 对比（pop 取底部，steal 取顶部），覆盖扩容
+//  work_stealing_deque_stress : 拥有者随机 push / pop，多个窃取者同时 steal，检查每个元素恰好被取出一次
+//  work_stealing_deque_test   : 以 work_stealing_deque 为每个工作线程的任务队列实现一个简单的 fork-join 线程池，
+//                               比较并行 fib、二叉树求和在 1..threads 个线程下的耗时
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef work_stealing_deque_test_h
+#define work_stealing_deque_test_h
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include "../work_stealing_deque.h"
+#include "../vector.h"
+#include "test_util.h"
+
+namespace deonSTL{
+
+namespace test{
+
+namespace work_stealing_deque_test{
+
+//***************************************************************************//
+//                                 单线程                                     //
+//***************************************************************************//
+
+// 没有其他线程时，work_stealing_deque 就是一个底部进出、顶部也能取出的双端队列
+inline void sequential_test()
+{
+    work_stealing_deque<uint64_t> q(2);
+    std::deque<uint64_t> ref;
+    uint64_t x = 88172645463325252ull, v = 0;
+    DEONSTL_CHECK(!q.pop(v) && !q.steal(v));
+    for(int step = 0; step < 200000; ++step)
+    {
+        const uint64_t r = next_random(x);
+        // 前半段以 push 为主，使队列增长、扩容；后半段以取出为主
+        const unsigned op = static_cast<unsigned>(r % 8) + (step < 100000 ? 0 : 3);
+        if(op < 5)
+        {
+            q.push(r);
+            ref.push_back(r);
+        }
+        else if(op < 8)
+        {
+            const bool got = q.pop(v);
+            DEONSTL_CHECK(got == !ref.empty());
+            if(got)
+            {
+                DEONSTL_CHECK(v == ref.back());
+                ref.pop_back();
+            }
+        }
+        else
+        {
+            const bool got = q.steal(v);
+            DEONSTL_CHECK(got == !ref.empty());
+            if(got)
+            {
+                DEONSTL_CHECK(v == ref.front());
+                ref.pop_front();
+            }
+        }
+        DEONSTL_CHECK(q.empty_approx() == ref.empty());
+    }
+    while(q.pop(v))
+    {
+        DEONSTL_CHECK(v == ref.back());
+        ref.pop_back();
+    }
+    DEONSTL_CHECK(ref.empty());
+}
+
+//***************************************************************************//
+//                                 压力测试                                   //
+//***************************************************************************//
+
+// 拥有者放入 0..n-1，每放入几个随机 pop 几个，thieves 个线程一直 steal，返回是否每个数恰好被取出一次
+bool work_stealing_deque_stress(size_t n = 10000000, unsigned thieves = 3)
+{
+    work_stealing_deque<uint64_t> q(2);     // 从很小的容量开始，覆盖扩容
+    std::atomic<uint8_t>* seen = new std::atomic<uint8_t>[n];
+    for(size_t i = 0; i < n; ++i)
+        seen[i].store(0, std::memory_order_relaxed);
+    std::atomic<size_t> taken(0);
+    std::atomic<bool>   done(false);
+
+    deonSTL::vector<std::thread> workers;
+    for(unsigned k = 0; k < thieves; ++k)
+        workers.push_back(std::thread([&] {
+            uint64_t v;
+            while(!done.load(std::memory_order_acquire))
+                if(q.steal(v))
+                {
+                    seen[v].fetch_add(1, std::memory_order_relaxed);
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                }
+        }));
+
+    uint32_t x = 12345;
+    uint64_t v;
+    for(size_t i = 0; i < n; ++i)
+    {
+        q.push(i);
+        x = x * 1103515245u + 12345u;
+        for(unsigned k = (x >> 16) % 3; k > 0 && q.pop(v); --k)
+        {
+            seen[v].fetch_add(1, std::memory_order_relaxed);
+            taken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while(q.pop(v))
+    {
+        seen[v].fetch_add(1, std::memory_order_relaxed);
+        taken.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 拥有者看到空时窃取者可能刚刚取走最后几个，等计数追上（丢失元素时不会追上，最多等一会儿）
+    for(int spin = 0; taken.load(std::memory_order_acquire) < n && spin < 1000000; ++spin)
+        std::this_thread::yield();
+    done.store(true, std::memory_order_release);
+    for(size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+
+    bool ok = taken.load() == n;
+    for(size_t i = 0; i < n && ok; ++i)
+        ok = seen[i].load(std::memory_order_relaxed) == 1;
+    delete[] seen;
+    printf("stress: n = %zu, thieves = %u, capacity = %zu : %s\n",
+           n, thieves, q.capacity(), ok ? "ok" : "FAILED");
+    DEONSTL_CHECK(ok);
+    return ok;
+}
+
+//***************************************************************************//
+//                              fork-join 线程池                              //
+//***************************************************************************//
+
+class pool;
+
+// 任务：执行完后把父任务的计数减一
+struct task
+{
+    std::atomic<int>* pending = nullptr;
+
+    virtual ~task() {}
+    virtual void execute(pool& p, unsigned self) = 0;
+
+    void run(pool& p, unsigned self)
+    {
+        execute(p, self);
+        if(pending != nullptr)
+            pending->fetch_sub(1, std::memory_order_release);
+    }
+};
+
+// 每个工作线程一个 work_stealing_deque，0 号为调用 invoke 的线程
+class pool
+{
+public:
+    explicit pool(unsigned threads)
+    : stop_(false)
+    {
+        for(unsigned i = 0; i < threads; ++i)
+            queues_.push_back(new work_stealing_deque<task*>(256));
+        for(unsigned i = 1; i < threads; ++i)
+            workers_.push_back(std::thread([this, i] { worker_loop(i); }));
+    }
+
+    ~pool()
+    {
+        stop_.store(true, std::memory_order_release);
+        for(size_t i = 0; i < workers_.size(); ++i)
+            workers_[i].join();
+        for(size_t i = 0; i < queues_.size(); ++i)
+            delete queues_[i];
+    }
+
+    // 在 0 号线程上执行根任务，返回时全部子任务都已完成
+    void invoke(task& root)
+    { root.run(*this, 0); }
+
+    // 把 t 放入自己的队列，完成时 pending 减一
+    void spawn(unsigned self, task& t, std::atomic<int>& pending)
+    {
+        t.pending = &pending;
+        queues_[self]->push(&t);
+    }
+
+    // 等待 pending 变为 0，期间执行自己队列中的或者偷来的任务
+    void wait(unsigned self, std::atomic<int>& pending)
+    {
+        while(pending.load(std::memory_order_acquire) != 0)
+        {
+            task* t;
+            if(find_task(self, t))
+                t->run(*this, self);
+        }
+    }
+
+private:
+    bool find_task(unsigned self, task*& t)
+    {
+        if(queues_[self]->pop(t))
+            return true;
+        const size_t n = queues_.size();
+        for(size_t k = 1; k < n; ++k)
+            if(queues_[(self + k) % n]->steal(t))
+                return true;
+        return false;
+    }
+
+    void worker_loop(unsigned self)
+    {
+        unsigned idle = 0;
+        while(!stop_.load(std::memory_order_acquire))
+        {
+            task* t;
+            if(find_task(self, t))
+            {
+                t->run(*this, self);
+                idle = 0;
+            }
+            else if(++idle > 64)
+                std::this_thread::yield();
+        }
+    }
+
+    deonSTL::vector<work_stealing_deque<task*>*>    queues_;
+    deonSTL::vector<std::thread>                    workers_;
+    std::atomic<bool>                               stop_;
+};
+
+//***************************************************************************//
+//                             fib 与二叉树求和                                //
+//***************************************************************************//
+
+inline uint64_t fib_serial(int n)
+{ return n < 2 ? static_cast<uint64_t>(n) : fib_serial(n - 1) + fib_serial(n - 2); }
+
+// n 小于 cutoff 时不再拆分
+struct fib_task : public task
+{
+    int         n;
+    int         cutoff;
+    uint64_t    result;
+
+    fib_task(int n_, int cutoff_) : n(n_), cutoff(cutoff_), result(0) {}
+
+    void execute(pool& p, unsigned self) override
+    {
+        if(n < cutoff)
+        {
+            result = fib_serial(n);
+            return;
+        }
+        fib_task a(n - 1, cutoff), b(n - 2, cutoff);
+        std::atomic<int> pending(1);
+        p.spawn(self, b, pending);
+        a.run(p, self);
+        p.wait(self, pending);
+        result = a.result + b.result;
+    }
+};
+
+// 完全二叉树，节点按下标存放：i 的孩子为 2i+1、2i+2
+struct tree_sum_task : public task
+{
+    const deonSTL::vector<uint64_t>* nodes;
+    size_t      root;
+    size_t      cutoff_depth;
+    uint64_t    result;
+
+    tree_sum_task(const deonSTL::vector<uint64_t>* v, size_t r, size_t d)
+    : nodes(v), root(r), cutoff_depth(d), result(0) {}
+
+    static uint64_t serial(const deonSTL::vector<uint64_t>& v, size_t i)
+    { return i >= v.size() ? 0 : v[i] + serial(v, 2 * i + 1) + serial(v, 2 * i + 2); }
+
+    void execute(pool& p, unsigned self) override
+    {
+        if(root >= nodes->size())
+            return;
+        if(cutoff_depth == 0)
+        {
+            result = serial(*nodes, root);
+            return;
+        }
+        tree_sum_task l(nodes, 2 * root + 1, cutoff_depth - 1);
+        tree_sum_task r(nodes, 2 * root + 2, cutoff_depth - 1);
+        std::atomic<int> pending(1);
+        p.spawn(self, r, pending);
+        l.run(p, self);
+        p.wait(self, pending);
+        result = (*nodes)[root] + l.result + r.result;
+    }
+};
+
+void work_stealing_deque_test(int fib_n = 38, size_t tree_nodes = (1u << 23) - 1,
+                              unsigned max_threads = 0)
+{
+    if(max_threads == 0)
+        max_threads = std::thread::hardware_concurrency() > 0
+                    ? std::thread::hardware_concurrency() : 1;
+    sequential_test();
+
+    deonSTL::vector<uint64_t> nodes(tree_nodes);
+    for(size_t i = 0; i < tree_nodes; ++i)
+        nodes[i] = i;
+    const uint64_t tree_expect = static_cast<uint64_t>(tree_nodes) * (tree_nodes - 1) / 2;
+
+    uint64_t fib_expect = 0;
+    const double fib_serial_ms = time_ms([&] { fib_expect = fib_serial(fib_n); });
+    uint64_t tree_serial = 0;
+    const double tree_serial_ms = time_ms([&] { tree_serial = tree_sum_task::serial(nodes, 0); });
+
+    printf("fib(%d), tree sum of %zu nodes\n", fib_n, tree_nodes);
+    printf("%-8s %12s %10s %12s %10s\n", "threads", "fib(ms)", "speedup", "tree(ms)", "speedup");
+    DEONSTL_CHECK(tree_serial == tree_expect);
+    printf("%-8s %12.1f %10s %12.1f %10s\n", "serial", fib_serial_ms, "", tree_serial_ms, "");
+    for(unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        pool p(threads);
+        fib_task f(fib_n, 20);
+        const double fib_ms = time_ms([&] { p.invoke(f); });
+        tree_sum_task t(&nodes, 0, 12);
+        const double tree_ms = time_ms([&] { p.invoke(t); });
+        DEONSTL_CHECK(f.result == fib_expect && t.result == tree_expect);
+        printf("%-8u %12.1f %10.2f %12.1f %10.2f\n", threads,
+               fib_ms, fib_serial_ms / fib_ms, tree_ms, tree_serial_ms / tree_ms);
+    }
+}
+
+} // namespace work_stealing_deque_test
+
+} // namespace test
+
+} // namespace deonSTL
+
+#endif /* work_stealing_deque_test_h */
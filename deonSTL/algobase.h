@@ -3,6 +3,10 @@
 //  deonSTL
 //
 //  这个头文件包含 deonSTL 的基本算法
+//  copy, copy_n, move, fill, fill_n, find
+//
+//  这些算法识别分段迭代器（segmented_iterator_traits，如 deque 迭代器）：
+//  逐块处理，块内是原生指针上的连续循环，平凡可复制类型交给 memory_kernel.h 的 memmove / memset / SIMD 内核
 //
 //  Created by 郭松楠 on 2020/5/8.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -11,26 +15,339 @@
 #ifndef algobase_h
 #define algobase_h
 
+#include <algorithm>    // std::find
+#include <iterator>     // std::iterator_traits, std::random_access_iterator_tag
+#include <type_traits>
+#include <utility>      // std::move
+#include "iterator.h"
+#include "memory_kernel.h"
 
 namespace deonSTL {
 
+// 是否为随机访问迭代器（按标准库的标签判断，原生指针、deque 迭代器、std::vector 迭代器都是）
+template <class Iter>
+struct __is_random_access
+: std::is_base_of<std::random_access_iterator_tag,
+                  typename std::iterator_traits<Iter>::iterator_category> {};
+
+template <class Iter>
+struct __is_segmented
+: segmented_iterator_traits<Iter>::is_segmented_iterator {};
+
+//***************************************************************************//
+//                                copy / move                                //
+//        IsMove 为 std::true_type 时移动赋值，否则复制赋值，其余处理完全相同               //
+//***************************************************************************//
+
+// 最内层：两端都是原生指针时交给 memory_kernel，否则逐个赋值
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_move_leaf(InputIt first, InputIt last, OutputIt result,
+                 std::false_type /*IsMove*/, std::true_type /*is_pointer*/)
+{
+    return deonSTL::__copy_trivial(first, last, result);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_move_leaf(InputIt first, InputIt last, OutputIt result,
+                 std::true_type /*IsMove*/, std::true_type /*is_pointer*/)
+{
+    return deonSTL::__move_trivial(first, last, result);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_move_leaf(InputIt first, InputIt last, OutputIt result,
+                 std::false_type /*IsMove*/, std::false_type /*is_pointer*/)
+{
+    for(; first != last; ++first, ++result)
+        *result = *first;
+    return result;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_move_leaf(InputIt first, InputIt last, OutputIt result,
+                 std::true_type /*IsMove*/, std::false_type /*is_pointer*/)
+{
+    for(; first != last; ++first, ++result)
+        *result = std::move(*first);
+    return result;
+}
+
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt __copy_move(InputIt first, InputIt last, OutputIt result);
+
+// 输出为分段迭代器且输入可随机访问：按输出的块切分输入
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt
+__copy_move_out(InputIt first, InputIt last, OutputIt result, std::true_type)
+{
+    typedef segmented_iterator_traits<OutputIt>     traits;
+    typedef typename traits::local_iterator         local_iterator;
+    typedef std::integral_constant<bool, std::is_pointer<InputIt>::value &&
+                                         std::is_pointer<local_iterator>::value> is_pointer;
+    auto seg = traits::segment(result);
+    local_iterator out = traits::local(result);
+    auto n = last - first;
+    while(n > traits::end(seg) - out)
+    {
+        const auto room = traits::end(seg) - out;
+        deonSTL::__copy_move_leaf(first, first + room, out, IsMove{}, is_pointer{});
+        first += room;
+        n -= room;
+        ++seg;
+        out = traits::begin(seg);
+    }
+    out = deonSTL::__copy_move_leaf(first, last, out, IsMove{}, is_pointer{});
+    return traits::compose(seg, out);
+}
+
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt
+__copy_move_out(InputIt first, InputIt last, OutputIt result, std::false_type)
+{
+    typedef std::integral_constant<bool, std::is_pointer<InputIt>::value &&
+                                         std::is_pointer<OutputIt>::value> is_pointer;
+    return deonSTL::__copy_move_leaf(first, last, result, IsMove{}, is_pointer{});
+}
+
+// 输入为分段迭代器：逐块复制，每块 [begin, end) 是一段原生指针区间
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt
+__copy_move_in(InputIt first, InputIt last, OutputIt result, std::true_type)
+{
+    typedef segmented_iterator_traits<InputIt> traits;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(last);
+    if(sfirst == slast)
+        return deonSTL::__copy_move<IsMove>(traits::local(first), traits::local(last), result);
+    result = deonSTL::__copy_move<IsMove>(traits::local(first), traits::end(sfirst), result);
+    for(++sfirst; sfirst != slast; ++sfirst)
+        result = deonSTL::__copy_move<IsMove>(traits::begin(sfirst), traits::end(sfirst), result);
+    return deonSTL::__copy_move<IsMove>(traits::begin(slast), traits::local(last), result);
+}
+
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt
+__copy_move_in(InputIt first, InputIt last, OutputIt result, std::false_type)
+{
+    return deonSTL::__copy_move_out<IsMove>(first, last, result,
+        std::integral_constant<bool, __is_segmented<OutputIt>::value &&
+                                     __is_random_access<InputIt>::value>{});
+}
+
+template <class IsMove, class InputIt, class OutputIt>
+OutputIt
+__copy_move(InputIt first, InputIt last, OutputIt result)
+{
+    return deonSTL::__copy_move_in<IsMove>(first, last, result, __is_segmented<InputIt>{});
+}
+
+// copy 把 [first, last) 复制到 result 开始处，返回结束位置
+// 区间重叠时要求 result 不在 (first, last) 内
+template <class InputIt, class OutputIt>
+OutputIt
+copy(InputIt first, InputIt last, OutputIt result)
+{
+    return deonSTL::__copy_move<std::false_type>(first, last, result);
+}
+
+// move 把 [first, last) 移动到 result 开始处，返回结束位置
+template <class InputIt, class OutputIt>
+OutputIt
+move(InputIt first, InputIt last, OutputIt result)
+{
+    return deonSTL::__copy_move<std::true_type>(first, last, result);
+}
+
+// copy_n 输入可随机访问时同 copy(first, first + n, result)，否则逐个复制
+template <class InputIt, class Size, class OutputIt>
+OutputIt
+__copy_n(InputIt first, Size n, OutputIt result, std::true_type)
+{
+    if(!(n > 0))
+        return result;
+    return deonSTL::copy(first, first + n, result);
+}
+
+template <class InputIt, class Size, class OutputIt>
+OutputIt
+__copy_n(InputIt first, Size n, OutputIt result, std::false_type)
+{
+    for(; n > 0; --n, ++first, ++result)
+        *result = *first;
+    return result;
+}
+
+template <class InputIt, class Size, class OutputIt>
+OutputIt
+copy_n(InputIt first, Size n, OutputIt result)
+{
+    return deonSTL::__copy_n(first, n, result, __is_random_access<InputIt>{});
+}
 
+//***************************************************************************//
+//                                fill / fill_n                              //
+//***************************************************************************//
 
+// 最内层：原生指针交给 memory_kernel，否则逐个赋值
+template <class ForwardIt, class T>
+void
+__fill_leaf(ForwardIt first, ForwardIt last, const T& value, std::true_type /*is_pointer*/)
+{
+    deonSTL::__fill_trivial(first, last, value);
+}
 
+template <class ForwardIt, class T>
+void
+__fill_leaf(ForwardIt first, ForwardIt last, const T& value, std::false_type /*is_pointer*/)
+{
+    for(; first != last; ++first)
+        *first = value;
+}
 
+template <class ForwardIt, class T>
+void
+__fill(ForwardIt first, ForwardIt last, const T& value, std::true_type /*segmented*/)
+{
+    typedef segmented_iterator_traits<ForwardIt>    traits;
+    typedef typename traits::local_iterator         local_iterator;
+    typedef std::is_pointer<local_iterator>         is_pointer;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(last);
+    if(sfirst == slast)
+    {
+        deonSTL::__fill_leaf(traits::local(first), traits::local(last), value, is_pointer{});
+        return;
+    }
+    deonSTL::__fill_leaf(traits::local(first), traits::end(sfirst), value, is_pointer{});
+    for(++sfirst; sfirst != slast; ++sfirst)
+        deonSTL::__fill_leaf(traits::begin(sfirst), traits::end(sfirst), value, is_pointer{});
+    deonSTL::__fill_leaf(traits::begin(slast), traits::local(last), value, is_pointer{});
+}
 
+template <class ForwardIt, class T>
+void
+__fill(ForwardIt first, ForwardIt last, const T& value, std::false_type /*segmented*/)
+{
+    deonSTL::__fill_leaf(first, last, value, std::is_pointer<ForwardIt>{});
+}
 
+// fill 在 [first, last) 上赋值 value
+template <class ForwardIt, class T>
+void
+fill(ForwardIt first, ForwardIt last, const T& value)
+{
+    deonSTL::__fill(first, last, value, __is_segmented<ForwardIt>{});
+}
 
+// fill_n 分段迭代器先求出尾端再按区间填充
+template <class OutputIt, class Size, class T>
+OutputIt
+__fill_n(OutputIt first, Size n, const T& value, std::true_type /*segmented*/)
+{
+    if(!(n > 0))
+        return first;
+    OutputIt last = first + n;
+    deonSTL::fill(first, last, value);
+    return last;
+}
 
+template <class OutputIt, class Size, class T>
+OutputIt
+__fill_n_leaf(OutputIt first, Size n, const T& value, std::true_type /*is_pointer*/)
+{
+    return deonSTL::__fill_n_trivial(first, n, value);
+}
 
+template <class OutputIt, class Size, class T>
+OutputIt
+__fill_n_leaf(OutputIt first, Size n, const T& value, std::false_type /*is_pointer*/)
+{
+    for(; n > 0; --n, ++first)
+        *first = value;
+    return first;
+}
 
+template <class OutputIt, class Size, class T>
+OutputIt
+__fill_n(OutputIt first, Size n, const T& value, std::false_type /*segmented*/)
+{
+    return deonSTL::__fill_n_leaf(first, n, value, std::is_pointer<OutputIt>{});
+}
 
+// fill_n 从 first 开始赋值 n 个 value，返回结束位置
+template <class OutputIt, class Size, class T>
+OutputIt
+fill_n(OutputIt first, Size n, const T& value)
+{
+    return deonSTL::__fill_n(first, n, value, __is_segmented<OutputIt>{});
+}
 
+//***************************************************************************//
+//                                   find                                    //
+//***************************************************************************//
 
+template <class InputIt, class T>
+InputIt
+__find_leaf(InputIt first, InputIt last, const T& value, std::true_type /*is_pointer*/)
+{
+    return std::find(first, last, value);
+}
 
+template <class InputIt, class T>
+InputIt
+__find_leaf(InputIt first, InputIt last, const T& value, std::false_type /*is_pointer*/)
+{
+    for(; first != last; ++first)
+        if(*first == value)
+            break;
+    return first;
+}
 
+template <class InputIt, class T>
+InputIt
+__find(InputIt first, InputIt last, const T& value, std::true_type /*segmented*/)
+{
+    typedef segmented_iterator_traits<InputIt>      traits;
+    typedef typename traits::local_iterator         local_iterator;
+    typedef std::is_pointer<local_iterator>         is_pointer;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(last);
+    if(sfirst == slast)
+        return traits::compose(sfirst, deonSTL::__find_leaf(traits::local(first),
+                                                            traits::local(last), value, is_pointer{}));
+    local_iterator lend = traits::end(sfirst);
+    local_iterator pos = deonSTL::__find_leaf(traits::local(first), lend, value, is_pointer{});
+    if(pos != lend)
+        return traits::compose(sfirst, pos);
+    for(++sfirst; sfirst != slast; ++sfirst)
+    {
+        lend = traits::end(sfirst);
+        pos = deonSTL::__find_leaf(traits::begin(sfirst), lend, value, is_pointer{});
+        if(pos != lend)
+            return traits::compose(sfirst, pos);
+    }
+    return traits::compose(slast, deonSTL::__find_leaf(traits::begin(slast),
+                                                       traits::local(last), value, is_pointer{}));
+}
 
+template <class InputIt, class T>
+InputIt
+__find(InputIt first, InputIt last, const T& value, std::false_type /*segmented*/)
+{
+    return deonSTL::__find_leaf(first, last, value, std::is_pointer<InputIt>{});
+}
 
+// find 返回 [first, last) 中第一个等于 value 的位置，没有则返回 last
+template <class InputIt, class T>
+InputIt
+find(InputIt first, InputIt last, const T& value)
+{
+    return deonSTL::__find(first, last, value, __is_segmented<InputIt>{});
+}
 
 } // namespace deonSTL
 
@@ -11,6 +11,7 @@
 #ifndef algorithm_h
 #define algorithm_h
 
+#include "algobase.h"
 #include "numeric.h"
 
 namespace deonSTL {
@@ -3,6 +3,12 @@
 //  deonSTL
 //
 //  这个头文件包含一个模板类 allocator，用于管理内存的分配、释放，对象的构造、析构
+//  还包含 alloc_holder，容器通过继承它持有空间配置器实例
+//
+//  容器对 Alloc 参数的要求：
+//  value_type, allocate(n), deallocate(p, n), rebind<U>::other，
+//  以及从 rebind 得到的其他配置器类型复制构造（共享同一份状态）
+//  对象的构造、析构由容器使用 construct.h 完成
 //
 //  Created by 郭松楠 on 2020/3/5.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -12,6 +18,7 @@
 #define allocator_h
 
 #include <cstddef> //size_t, ptrdiff_t
+#include <type_traits> // is_empty
 #include "construct.h"
 
 //只是简单封装了operator new
@@ -30,7 +37,19 @@ public:
     typedef size_t      size_type;
     typedef ptrdiff_t   difference_type;
     
+    // 取得另一类型的 allocator（如容器以 T 实例化，但实际申请的是 node）
+    template <class U>
+    struct rebind
+    {
+        typedef allocator<U> other;
+    };
+    
 public:
+    allocator() noexcept {}
+    allocator(const allocator&) noexcept = default;
+    template <class U>
+    allocator(const allocator<U>&) noexcept {}
+    
     //静态成员函数
     static T* allocate();
     static T* allocate(size_type n);
@@ -103,6 +122,56 @@ void allocator<T>::destroy(T* first, T* last){
     deonSTL::destroy(first, last);
 }
 
+// 无状态，任意两个 allocator 都可以互相释放对方申请的内存
+template <class T, class U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept
+{ return true; }
+
+template <class T, class U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept
+{ return false; }
+
+// 配置器的 deallocate 是否为空操作（内存整体归还，如 monotonic arena）
+// 元素无需析构时，容器可以不逐个回收节点
+template <class Alloc>
+struct deallocate_is_noop : std::false_type {};
+
+// 配置器是否提供 reallocate(p, old_n, new_n)，能原地扩大已有的内存块（如 realloc / mremap）
+// 元素可平凡搬移时，vector 扩容交给它而不必申请新空间再整体复制
+template <class Alloc>
+struct has_reallocate : std::false_type {};
+
+//***************************************************************************//
+//                              alloc_holder                                 //
+//       容器继承 alloc_holder 持有配置器实例，空配置器利用空基类优化，不增加容器大小          //
+//***************************************************************************//
+
+template <class Alloc, bool = std::is_empty<Alloc>::value>
+class alloc_holder : private Alloc
+{
+public:
+    alloc_holder() : Alloc() {}
+    explicit alloc_holder(const Alloc& alloc) : Alloc(alloc) {}
+    
+    Alloc&       get_alloc()       noexcept { return *this; }
+    const Alloc& get_alloc() const noexcept { return *this; }
+};
+
+// 有状态的配置器作为成员保存
+template <class Alloc>
+class alloc_holder<Alloc, false>
+{
+private:
+    Alloc alloc_;
+    
+public:
+    alloc_holder() : alloc_() {}
+    explicit alloc_holder(const Alloc& alloc) : alloc_(alloc) {}
+    
+    Alloc&       get_alloc()       noexcept { return alloc_; }
+    const Alloc& get_alloc() const noexcept { return alloc_; }
+};
+
 }//namespace deonSTL
 
 #endif /* allocator_h */
@@ -5,6 +5,7 @@
 //  这个头文件包含两个函数 construct，destroy
 //  construct : 负责在已申请的未构造内存上构造对象
 //  destroy   : 负责对象的析构
+//  还包含 construct_default 和标签 default_init，用于只做默认初始化（平凡类型不清零）
 //
 //  Created by 郭松楠 on 2020/3/8.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -35,6 +36,16 @@ void construct(T* ptr, Args&&... args){
     ::new(ptr) T(std::forward<Args>(args)...);
 }
 
+// construct_default 默认初始化，不同于 construct(ptr) 的值初始化：平凡类型的对象内容不确定
+template<class T>
+void construct_default(T* ptr){
+    ::new(ptr) T;
+}
+
+// default_init 标签，容器以它构造时元素只做默认初始化，用于马上会被覆盖写入的大块空间
+struct default_init_t {};
+constexpr default_init_t default_init{};
+
 // destroy 析构
 
 template<class T>
@@ -52,7 +63,7 @@ void destroy_cat(ForwardIter first, ForwardIter last, std::true_type){}
 template<class ForwardIter>
 void destroy_cat(ForwardIter first, ForwardIter last, std::false_type){
     for(; first != last; ++first)
-        destroy_one(&*first, false); // 与源码不同
+        destroy_one(&*first, std::false_type{});
 }
 
 
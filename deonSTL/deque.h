@@ -18,22 +18,29 @@
 #include "exceptdef.h"
 #include "uninitialized.h"
 #include <initializer_list>
+#include <iterator> // std::iterator_traits
 #include <utility>  // move
 #include <algorithm> // max
+#include <type_traits>  // enable_if, is_integral
 
 namespace deonSTL{
 
-template <class T>
+// deque_buf_size 每个 buffer 容纳的元素个数
+// BufBytes 为 buffer 的字节数，0 表示缺省：元素小于 256 字节时 4096 字节，否则 16 个元素
+template <class T, size_t BufBytes = 0>
 struct deque_buf_size
 {
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+    static constexpr size_t value = BufBytes != 0
+                                  ? (BufBytes / sizeof(T) > 0 ? BufBytes / sizeof(T) : 1)
+                                  : (sizeof(T) < 256 ? 4096 / sizeof(T) : 16);
 };
 
-template <class T, class Ref, class Ptr>
+template <class T, class Ref, class Ptr, size_t BufBytes = 0>
 struct deque_iterator : public iterator<random_access_iterator_tag, T>
 {
-    typedef deque_iterator<T, T&, T*>               iterator;
-    typedef deque_iterator<T, const T&, const T*>   const_iterator;
+    typedef deque_iterator<T, T&, T*, BufBytes>               iterator;
+    typedef deque_iterator<T, const T&, const T*, BufBytes>   const_iterator;
+    typedef deque_iterator                          self;
     
     typedef T                                       value_type;
     typedef Ptr                                     pointer;    // const_pointer 被定义在 const_iterator 中
@@ -43,7 +50,7 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     typedef T*                                      value_pointer;
     typedef T**                                     map_pointer;
     
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufBytes>::value;
     
     // 成员数据
     value_pointer   cur;        // 指向所在缓冲区当前元素
@@ -65,13 +72,14 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     deque_iterator(iterator&& rhs)
     :cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node)
     {
-        rhs.cur = rhs.first = rhs.last = rhs.node = nullptr;
+        rhs.cur = rhs.first = rhs.last = nullptr;
+        rhs.node = nullptr;
     }
     
     deque_iterator(const const_iterator& rhs)
     :cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
     
-    iterator& operator=(const iterator& rhs)
+    self& operator=(const self& rhs)
     {
         if(this != &rhs)
         {
@@ -88,13 +96,14 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     reference operator*() const { return *cur; }
     pointer operator->() const { return cur; }
     
-    difference_type operator-(const iterator& x) const
+    // 两个迭代器之间的距离：中间整块的缓冲区加上两端各自的偏移
+    difference_type operator-(const self& x) const
     {
-        return static_cast<difference_type>(buffer_size * (node - x.node)
-                                            + (cur - first) + (x.cur - x.first));
+        return static_cast<difference_type>(buffer_size) * (node - x.node)
+               + (cur - first) - (x.cur - x.first);
     }
     
-    iterator& operator++()
+    self& operator++()
     {
         ++cur;
         if(cur == last)
@@ -106,14 +115,14 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
         return *this;
     }
     
-    iterator operator++(int)
+    self operator++(int)
     {
-        iterator tmp = *this;
+        self tmp = *this;
         ++*this;
         return tmp;
     }
     
-    iterator& operator--()
+    self& operator--()
     {
         if(cur == first)
         {
@@ -125,44 +134,56 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
         return *this;
     }
     
-    iterator operator--(int)
+    self operator--(int)
     {
-        iterator tmp = *this;
+        self tmp = *this;
         --*this;
         return tmp;
     }
     
-    iterator& operator+=(difference_type n)
+    // 目标仍在当前缓冲区时只移动 cur，否则由 offset 算出相隔的节点数，通过 map 直接跳到目标缓冲区
+    self& operator+=(difference_type n)
     {
-        // 待实现 ⚠️
+        const difference_type buf = static_cast<difference_type>(buffer_size);
+        const difference_type offset = n + (cur - first);
+        if(offset >= 0 && offset < buf)
+            cur += n;
+        else
+        {
+            const difference_type node_offset = offset > 0 ? offset / buf
+                                                           : -((-offset - 1) / buf) - 1;
+            set_node(node + node_offset);
+            cur = first + (offset - node_offset * buf);
+        }
+        return *this;
     }
     
-    iterator operator+(difference_type n)
+    self operator+(difference_type n) const
     {
-        iterator tmp = *this;
+        self tmp = *this;
         return tmp += n;
     }
     
-    iterator& operator-=(difference_type n)
+    self& operator-=(difference_type n)
     {
         return *this += -n;
     }
     
-    iterator operator-(difference_type n)
+    self operator-(difference_type n) const
     {
-        iterator tmp = *this;
+        self tmp = *this;
         return tmp -= n;
     }
     
-    // operator []
+    reference operator[](difference_type n) const { return *(*this + n); }
     
-    bool operator==(const iterator& rhs) const  { return cur == rhs.cur; }
-    bool operator< (const iterator& rhs) const
+    bool operator==(const self& rhs) const  { return cur == rhs.cur; }
+    bool operator< (const self& rhs) const
     { return node == rhs.node ? (cur < rhs.cur) : (node < rhs.node); }
-    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
-    bool operator> (const iterator& rhs) const     { return rhs < *this; }
-    bool operator<=(const iterator& rhs) const  { return !(rhs < *this); }
-    bool operator>=(const iterator& rhs) const  { return !(*this < rhs); }
+    bool operator!=(const self& rhs) const { return !(*this == rhs); }
+    bool operator> (const self& rhs) const     { return rhs < *this; }
+    bool operator<=(const self& rhs) const  { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const  { return !(*this < rhs); }
     
     // ==========================辅助函数=========================== //
     
@@ -175,33 +196,92 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>
     
 };// struct deque_iterator
 
+template <class T, class Ref, class Ptr, size_t BufBytes>
+deque_iterator<T, Ref, Ptr, BufBytes>
+operator+(typename deque_iterator<T, Ref, Ptr, BufBytes>::difference_type n,
+          const deque_iterator<T, Ref, Ptr, BufBytes>& x)
+{ return x + n; }
+
+} // namespace deonSTL
+
+// 迭代器标签与标准库的不是同一类型，特化 std::iterator_traits 后
+// std::sort、std::lower_bound、std::copy 等才能把 deque 迭代器当作随机访问迭代器使用
+namespace std {
+
+template <class T, class Ref, class Ptr, size_t BufBytes>
+struct iterator_traits<deonSTL::deque_iterator<T, Ref, Ptr, BufBytes>>
+{
+    typedef random_access_iterator_tag  iterator_category;
+    typedef T                           value_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef ptrdiff_t                   difference_type;
+};
+
+} // namespace std
+
+namespace deonSTL{
+
+// deque 迭代器以 buffer 为块，copy、fill、find、accumulate 等算法逐个 buffer 处理
+template <class T, class Ref, class Ptr, size_t BufBytes>
+struct segmented_iterator_traits<deque_iterator<T, Ref, Ptr, BufBytes>>
+{
+    typedef std::true_type                  is_segmented_iterator;
+    typedef deque_iterator<T, Ref, Ptr, BufBytes>     iterator;
+    typedef T**                             segment_iterator;
+    typedef Ptr                             local_iterator;
+    
+    static segment_iterator segment(const iterator& it)  { return it.node; }
+    static local_iterator   local(const iterator& it)    { return it.cur; }
+    static local_iterator   begin(segment_iterator seg)  { return *seg; }
+    static local_iterator   end(segment_iterator seg)    { return *seg + iterator::buffer_size; }
+    
+    // 位于块尾时转到下一块的块首，与 operator++ 的结果一致
+    static iterator compose(segment_iterator seg, local_iterator local)
+    {
+        if(local == end(seg))
+        {
+            ++seg;
+            local = begin(seg);
+        }
+        return iterator(const_cast<T*>(local), seg);
+    }
+};
+
 // 模版类 deque
-template <class T>
-class deque
+// 参数二为空间配置器类型，deque 持有一个配置器实例，map 的空间由其 rebind 得到的配置器申请
+// 参数三为每个 buffer 的字节数，0 表示缺省大小，可设为大页或 L2 缓存的大小
+template <class T, class Alloc = deonSTL::allocator<T>, size_t BufBytes = 0>
+class deque : private deonSTL::alloc_holder<Alloc>
 {
 public:
     
-    typedef deonSTL::allocator<T>                       allocator_type;
-    typedef deonSTL::allocator<T>                       data_allocator;
-    typedef deonSTL::allocator<T*>                      map_allocator;
-    
-    typedef typename allocator_type::value_type         value_type;
-    typedef typename allocator_type::pointer            pointer;
-    typedef typename allocator_type::const_pointer      const_pointer;
-    typedef typename allocator_type::reference          reference;
-    typedef typename allocator_type::const_reference    const_reference;
-    typedef typename allocator_type::size_type          size_type;
-    typedef typename allocator_type::difference_type    difference_type;
+    typedef Alloc                                       allocator_type;
+    typedef Alloc                                       data_allocator;
+    typedef typename Alloc::template rebind<T*>::other  map_allocator;
+    
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
     typedef pointer*                                    map_pointer;
     typedef const_pointer*                              const_map_pointer;
     
-    typedef deque_iterator<T, T&, T*>                   iterator;
-    typedef deque_iterator<T, const T&, const T*>       const_iterator;
+    typedef deque_iterator<T, T&, T*, BufBytes>                   iterator;
+    typedef deque_iterator<T, const T&, const T*, BufBytes>       const_iterator;
     // reverse_iterator
     
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufBytes>::value;
+    // 头部、尾部各自最多保留的空闲 buffer 数，弹出元素后空出的 buffer 留给下次扩充复用
+    static const size_type spare_blocks = 2;
     
 private:
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    // 可平凡搬移的元素在插入、删除时按字节逐段搬移
+    typedef deonSTL::is_trivially_relocatable<T>        relocatable;
     
     iterator        begin_;       // 指向第一个元素
     iterator        end_;         // 指向尾后元素
@@ -212,33 +292,51 @@ public:
     // ======================构造、移动、赋值函数====================== //
     
     deque()
-    { fill_init(0, value_type()); }
+    { map_init(0); }
+    
+    explicit deque(const allocator_type& alloc)
+    : alloc_base(alloc)
+    { map_init(0); }
     
-    explicit deque(size_type n)
+    explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     { fill_init(n, value_type()); }
     
-    deque(size_type n, const value_type& value)
+    deque(size_type n, const value_type& value,
+          const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     { fill_init(n, value); }
     
-    template <class IIter>
-    deque(IIter first, IIter last)
+    // n 个元素只做默认初始化，平凡类型不清零
+    deque(size_type n, default_init_t, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
+    { default_fill_init(n); }
+    
+    template <class IIter, typename std::enable_if<
+        !std::is_integral<IIter>::value, int>::type = 0>
+    deque(IIter first, IIter last, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     {
         typedef typename iterator_traits<IIter>::iterator_category Category;
         copy_init(first, last, Category());
     }
     
-    deque(std::initializer_list<value_type> ilist)
+    deque(std::initializer_list<value_type> ilist,
+          const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     {
         copy_init(ilist.begin(), ilist.end(), deonSTL::forward_iterator_tag() );
     }
     
     deque(const deque& rhs)
+    : alloc_base(rhs.get_alloc())
     {
         copy_init(rhs.begin(), rhs.end(), deonSTL::forward_iterator_tag() );
     }
     
     deque(deque&& rhs) noexcept
-    :begin_(std::move(rhs.begin_)), // 交给迭代器的移动构造函数来 移动及转为可析构状态
+    :alloc_base(std::move(rhs.get_alloc())),
+    begin_(std::move(rhs.begin_)), // 交给迭代器的移动构造函数来 移动及转为可析构状态
     end_(std::move(rhs.end_)),
     map_(rhs.map_),
     map_size_(rhs.map_size_)
@@ -252,25 +350,19 @@ public:
     
     deque& operator=(std::initializer_list<value_type> ilist)
     {
-        deque tmp(ilist);
+        deque tmp(ilist, this->get_alloc());
         swap(tmp);
         return *this;
     }
     
     ~deque()
-    {
-        if(map_ != nullptr)
-        {
-            clear();
-            data_allocator::deallocate(*begin_.node, buffer_size);
-            *begin_.node = nullptr;
-            map_allocator::deallocate(map_, map_size_);
-            map_ = nullptr;
-        }
-    }
+    { destroy_all(); }
     
 public:
     // ==========================成员函数============================ //
+    
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
 
     // begin, end
     iterator            begin()             noexcept
@@ -293,9 +385,22 @@ public:
     // resize, shrink_to_fit
     void                resize(size_type new_size) { resize(new_size, value_type()); }
     void                resize(size_type new_size, const value_type& value);
+    void                resize_default_init(size_type new_size);
     
     void                shrink_to_fit() noexcept;
     
+    // operator[]
+    reference           operator[](size_type n)
+    {
+        MY_DEBUG(n < size());
+        return begin_[n];
+    }
+    const_reference     operator[](size_type n) const
+    {
+        MY_DEBUG(n < size());
+        return begin_[n];
+    }
+    
     // front, back
     reference           front()
     {
@@ -341,8 +446,13 @@ public:
     iterator    insert(iterator pos, const value_type& value);
     iterator    insert(iterator pos, value_type&& value);
     void        insert(iterator pos, size_type n, const value_type& value);
-    template <class IIter>
-    void        insert(iterator position, IIter first, IIter last);
+    template <class IIter, typename std::enable_if<
+        !std::is_integral<IIter>::value, int>::type = 0>
+    void        insert(iterator pos, IIter first, IIter last)
+    {
+        typedef typename iterator_traits<IIter>::iterator_category Category;
+        insert_dispatch(pos, first, last, Category());
+    }
     
     // erase
     iterator    erase(iterator pos);
@@ -365,8 +475,12 @@ private:
     // 初始化 map
     void        map_init(size_type nelem);
     
+    // 析构全部元素，释放全部 buffer 与 map
+    void        destroy_all() noexcept;
+    
     // 初始化辅助
     void        fill_init(size_type n, const value_type& value);
+    void        default_fill_init(size_type n);
     
     template <class IIter>
     void        copy_init(IIter first, IIter last, input_iterator_tag);
@@ -375,9 +489,16 @@ private:
     
     void        reallocate_map_at_front(size_type need_buffer);
     void        reallocate_map_at_back (size_type need_buffer);
+    void        move_nodes(map_pointer first, map_pointer last, map_pointer result) noexcept;
     
     void        require_capacity(size_type n, bool front);
     
+    // 空闲 buffer：map 中非空的指针总是连续的一段，[begin_.node, end_.node] 之外的部分为空闲 buffer
+    map_pointer first_spare_front() const noexcept;
+    map_pointer last_spare_back()   const noexcept;
+    void        trim_spare_front();
+    void        trim_spare_back();
+    
     template <class ...Args>
     iterator    insert_aux(iterator pos, Args&& ...args);
     
@@ -386,6 +507,21 @@ private:
     void        copy_insert(iterator pos, FIter first, FIter last);
     template <class IIter>
     void        insert_dispatch(iterator pos, IIter first, IIter last, input_iterator_tag);
+    template <class FIter>
+    void        insert_dispatch(iterator pos, FIter first, FIter last, forward_iterator_tag)
+    { copy_insert(pos, first, last); }
+    
+    // 头部/尾部让出一个位置，不析构元素（元素已被搬走）
+    void        unlink_front();
+    void        unlink_back();
+    
+    // relocate，只用于可平凡搬移的类型，逐个 buffer 调用 memmove
+    void        relocate_to_front(iterator first, iterator last, iterator result);
+    void        relocate_to_back (iterator first, iterator last, iterator result_last);
+    // 在第 elems_before 个元素之前，较短的一侧按字节让出 n 个位置，返回空位的开头
+    // 空位上构造失败时 close_gap 把空位合上
+    iterator    open_gap(size_type elems_before, size_type n);
+    void        close_gap(iterator gap, size_type n) noexcept;
     
     
     
@@ -396,33 +532,25 @@ private:
 //***************************************************************************//
 
 // 拷贝赋值操作符
-template <class T>
-deque<T>&
-deque<T>::operator=(const deque& rhs)
+template <class T, class Alloc, size_t BufBytes>
+deque<T, Alloc, BufBytes>&
+deque<T, Alloc, BufBytes>::operator=(const deque& rhs)
 {
     if(this != &rhs)
-    {
-        const size_type len = size();
-        if(len > rhs.size())
-        {
-            erase(std::copy(rhs,begin(), rhs.end(), begin_), end_);
-        }
-        else
-        {
-            iterator rhs_mid = rhs.begin() + static_cast<difference_type>(len);
-            std::copy(rhs.begin(), rhs_mid, begin_);
-            insert(end_, rhs_mid, rhs.end_);
-        }
+    {// 保留自己的配置器
+        deque tmp(rhs.begin(), rhs.end(), this->get_alloc());
+        swap(tmp);
     }
     return *this;
 }
 
-// 移动赋值操作符
-template <class T>
-deque<T>&
-deque<T>::operator=(deque<T> &&rhs)
+// 移动赋值操作符，连同配置器一起移动
+template <class T, class Alloc, size_t BufBytes>
+deque<T, Alloc, BufBytes>&
+deque<T, Alloc, BufBytes>::operator=(deque<T, Alloc, BufBytes> &&rhs)
 {
-    clear();
+    destroy_all();
+    this->get_alloc() = std::move(rhs.get_alloc());
     begin_ = std::move(rhs.begin_);
     end_ = std::move(rhs.end_);
     map_ = rhs.map_;
@@ -433,9 +561,9 @@ deque<T>::operator=(deque<T> &&rhs)
 }
 
 // resize 重新size大小为new_size，多出的部分用value填充
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::resize(size_type new_size, const value_type& value)
+deque<T, Alloc, BufBytes>::resize(size_type new_size, const value_type& value)
 {
     const auto len = size();
     if(new_size < len)
@@ -444,70 +572,89 @@ deque<T>::resize(size_type new_size, const value_type& value)
         insert(end_, new_size - len, value);
 }
 
+// resize_default_init 同 resize，多出的元素只做默认初始化
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::resize_default_init(size_type new_size)
+{
+    const auto len = size();
+    if(new_size < len)
+    {
+        erase(begin_ + new_size, end_);
+        return;
+    }
+    const size_type n = new_size - len;
+    if(n == 0)
+        return;
+    require_capacity(n, false);
+    auto new_end = end_ + n;
+    deonSTL::uninitialized_default_construct_n(end_, n);
+    end_ = new_end;
+}
+
 // shrink_to_fit 回收头部以前和尾部以后的不用空间
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::shrink_to_fit() noexcept
+deque<T, Alloc, BufBytes>::shrink_to_fit() noexcept
 {
     // 对 begin_ == end_ 调用会留下一个buffer
-    // 回收头部不用空间
-    for(auto cur = map_; cur < begin_.node; ++cur)
+    // 回收头部、尾部的空闲 buffer
+    for(auto cur = first_spare_front(); cur != begin_.node; ++cur)
     {
-        data_allocator::deallocate(*cur, buffer_size);
+        this->get_alloc().deallocate(*cur, buffer_size);
         *cur = nullptr;
     }
-    // 回收尾部不用空间
-    for(auto cur = end_.node + 1; cur < map_ + map_size_; ++cur)
+    for(auto cur = end_.node + 1, last = last_spare_back(); cur != last; ++cur)
     {
-        data_allocator::deallocate(*cur, buffer_size);
+        this->get_alloc().deallocate(*cur, buffer_size);
         *cur = nullptr;
     }
 }
 
 // emplace_front 在头部插入元素，调用构造函数
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class ...Args>
 void
-deque<T>::emplace_front(Args&& ...args)
+deque<T, Alloc, BufBytes>::emplace_front(Args&& ...args)
 {
     if(begin_.cur != begin_.first)
     {
-        data_allocator::construct(begin_.cur - 1, std::forward<Args>(args)...); // 调用 构造函数
+        deonSTL::construct(begin_.cur - 1, std::forward<Args>(args)...); // 调用 构造函数
         --begin_.cur;
     }
     else
     {
         require_capacity(1, true);
         --begin_;
-        data_allocator::construct(begin_.cur, std::forward<Args>(args)...);
+        deonSTL::construct(begin_.cur, std::forward<Args>(args)...);
     }
 }
 
 // 与源码不一致
 // emplace_back 在尾部插入元素，调用构造函数
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class ...Args>
 void
-deque<T>::emplace_back(Args&& ...args)
+deque<T, Alloc, BufBytes>::emplace_back(Args&& ...args)
 {
     if(end_.cur != end_.last - 1)
     {// 注意还剩一个元素的空间就要开始申请，因为若不申请就占用最后一个空间，end_指针会指向一个未声明空间
-        data_allocator::construct(end_.cur, std::forward<Args>(args)...);
+        deonSTL::construct(end_.cur, std::forward<Args>(args)...);
         ++end_.cur;
     }
     else
     {
         require_capacity(1, false);
-        data_allocator::construct(end_.cur, std::forward<Args>(args)...);
+        deonSTL::construct(end_.cur, std::forward<Args>(args)...);
         ++end_;
     }
 }
 
 // emplace 在pos前插入元素，调用构造函数，返回插入的尾后迭代器
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class ...Args>
-typename deque<T>::iterator
-deque<T>::emplace(iterator pos, Args&& ...args)
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::emplace(iterator pos, Args&& ...args)
 {
     if(pos.cur == begin_.cur)
     {
@@ -523,84 +670,65 @@ deque<T>::emplace(iterator pos, Args&& ...args)
 }
 
 // push_front 在头部插入元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::push_front(const value_type &value)
+deque<T, Alloc, BufBytes>::push_front(const value_type &value)
 {
     if(begin_.cur != begin_.first)
     {
-        data_allocator::construct(begin_.cur - 1, value); // 调用 拷贝构造函数
+        deonSTL::construct(begin_.cur - 1, value); // 调用 拷贝构造函数
         --begin_.cur;
     }
     else
     {
         require_capacity(1, true);
         --begin_;
-        data_allocator::construct(begin_.cur, value);
+        deonSTL::construct(begin_.cur, value);
     }
 }
 
 // push_back 在尾部插入元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::push_back(const value_type &value)
+deque<T, Alloc, BufBytes>::push_back(const value_type &value)
 {
     if(end_.cur != end_.last - 1)
     {
-        data_allocator::construct(end_.cur, value);
+        deonSTL::construct(end_.cur, value);
         ++end_.cur;
     }
     else
     {
         require_capacity(1, false);
-        data_allocator::construct(end_.cur, value);
+        deonSTL::construct(end_.cur, value);
         ++end_;
     }
 }
 
 // pop_back 弹出头部元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::pop_front()
+deque<T, Alloc, BufBytes>::pop_front()
 {
     MY_DEBUG(!empty());
-    if(begin_.cur != begin_.last - 1)
-    {
-        data_allocator::destroy(begin_.cur);
-        ++begin_.cur;
-    }
-    else
-    {
-        data_allocator::destroy(begin_.cur);
-        recover_buffer(begin_.node, begin_.node); // 销毁不用的buffer
-        ++begin_;
-    }
+    deonSTL::destroy(begin_.cur);
+    unlink_front();
 }
 
 // pop_back 弹出尾部元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::pop_back()
+deque<T, Alloc, BufBytes>::pop_back()
 {
     MY_DEBUG(!empty());
-    if(end_.cur != end_.first)
-    {
-        --end_.cur;
-        data_allocator::destroy(end_.cur);
-    }
-    else
-    {// 此时buffers状态：[full buffer][ ] 后一个 buffer 中虽然没有元素但依然要存在，
-     // 因为end.cur要指向这个空buffer（上一个buffer的尾后元素是下一个buffer的第一个元素）
-        --end_;
-        data_allocator::destroy(end_.cur);
-        recover_buffer(end_.node + 1, end_.node + 1);
-    }
+    unlink_back();
+    deonSTL::destroy(end_.cur);
 }
 
 // insert 在pos前插入元素，返回尾后迭代器
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator pos, const value_type &value)
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::insert(iterator pos, const value_type &value)
 {
     if(pos.cur == begin_.cur)
     {
@@ -619,9 +747,9 @@ deque<T>::insert(iterator pos, const value_type &value)
 }
 
 // insert 在pos前插入元素，调用构造函数，返回尾后迭代器
-template <class T>
-typename deque<T>::iterator
-deque<T>::insert(iterator pos, value_type &&value)
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::insert(iterator pos, value_type &&value)
 {
     if(pos.cur == begin_.cur)
     {
@@ -640,9 +768,9 @@ deque<T>::insert(iterator pos, value_type &&value)
 }
 
 // insert 在pos前插入n个元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::insert(iterator pos, size_type n, const value_type &value)
+deque<T, Alloc, BufBytes>::insert(iterator pos, size_type n, const value_type &value)
 {
     if(pos.cur == begin_.cur)
     {
@@ -663,31 +791,47 @@ deque<T>::insert(iterator pos, size_type n, const value_type &value)
 }
 
 // erase 删除pos处的元素，不回收空间，返回尾后迭代器
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator pos)
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::erase(iterator pos)
 {
     auto next = pos;
     ++next;
     const size_type elems_before = pos - begin_;
-    if(elems_before < (size() / 2))
+    if(relocatable::value)
+    {// 析构被删除的元素，较短的一侧按字节搬过来填补
+        deonSTL::destroy(pos.cur);
+        if(elems_before < (size() / 2))
+        {
+            relocate_to_back(begin_, pos, next);
+            unlink_front();
+        }
+        else
+        {
+            relocate_to_front(next, end_, pos);
+            unlink_back();
+        }
+    }
+    else if(elems_before < (size() / 2))
     {
-        std::copy_backward(begin_, pos, next);
+        std::move_backward(begin_, pos, next);
         pop_front();
     }
     else
     {
-        std::copy(next, end_, pos);
+        deonSTL::move(next, end_, pos);
         pop_back();
     }
     return begin_ + elems_before;
 }
 
 // erase 删除[first, last)的内容，不回收空间，返回尾后迭代器
-template <class T>
-typename deque<T>::iterator
-deque<T>::erase(iterator first, iterator last)
-{// 会产生begin_之前和end_之后的未使用buffer
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::erase(iterator first, iterator last)
+{
+    if(first == last)
+        return first;
     if(first == begin_ && last == end_)
     {
         clear();
@@ -698,53 +842,73 @@ deque<T>::erase(iterator first, iterator last)
         /*
          源码不保证begin_之前的buffer为未申请空间buffer，
          在begin_.node指向的buffer满之后再push_front，在已有的空间上再create_buffer可能造成内存泄露
+         这里把 begin_ 之前、end_ 之后空出的 buffer 留作空闲 buffer，超出 spare_blocks 的部分回收，
+         require_capacity 会先复用空闲 buffer 再申请
          */
         const size_type len = last - first;
         const size_type elems_before = first - begin_;
         if(elems_before < (size() - len) / 2)
         {
-            std::copy_backward(begin_, first, last);
-            auto new_begin = begin_ + len;
-            data_allocator::destroy(first.cur, new_begin.cur);
-            begin_ = new_begin;
+            if(relocatable::value)
+            {// 析构被删除的元素，前面的元素按字节后移，让出的位置不再析构
+                deonSTL::destroy(first, last);
+                relocate_to_back(begin_, first, last);
+            }
+            else
+            {
+                std::move_backward(begin_, first, last);
+                deonSTL::destroy(begin_, begin_ + len);
+            }
+            begin_ += len;
+            trim_spare_front();
         }
         else
         {
-            std::copy(last, end_, first);
             auto new_end = end_ - len;
-            data_allocator::destroy(new_end.cur, end_);
+            if(relocatable::value)
+            {// 析构被删除的元素，后面的元素按字节前移
+                deonSTL::destroy(first, last);
+                relocate_to_front(last, end_, first);
+            }
+            else
+            {
+                deonSTL::move(last, end_, first);
+                deonSTL::destroy(new_end, end_);
+            }
             end_ = new_end;
+            trim_spare_back();
         }
         return begin_ + elems_before;
     }
 }
 
 // clear 析构全部元素，留下一个buffer空间
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::clear()
+deque<T, Alloc, BufBytes>::clear()
 {
     // 析构除头部尾部外的buffer
     for(map_pointer cur = begin_.node +1; cur < end_.node; ++cur)
-        data_allocator::destroy(*cur, *cur + buffer_size);
+        deonSTL::destroy(*cur, *cur + buffer_size);
     // 析构头部和尾部
     if(begin_.node != end_.node)
     {
-        data_allocator::destroy(begin_.cur, begin_.last);
-        data_allocator::destroy(end_.cur, end_.last);
+        deonSTL::destroy(begin_.cur, begin_.last);
+        deonSTL::destroy(end_.first, end_.cur);
     }
     else
-        data_allocator::destroy(begin_.cur, begin_.last);
+        deonSTL::destroy(begin_.cur, end_.cur);
     
     end_ = begin_; // 源码此句在下一句之后
     shrink_to_fit();
 }
 
-// swap
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept
+// swap 连同配置器一起交换
+template <class T, class Alloc, size_t BufBytes>
+void deque<T, Alloc, BufBytes>::swap(deque& rhs) noexcept
 {
-    std::swap(begin_, rhs.begin_); // 待编写⚠️
+    std::swap(this->get_alloc(), rhs.get_alloc());
+    std::swap(begin_, rhs.begin_);
     std::swap(end_, rhs.end_);
     std::swap(map_, rhs.map_);
     std::swap(map_size_, rhs.map_size_);
@@ -755,31 +919,31 @@ void deque<T>::swap(deque& rhs) noexcept
 //***************************************************************************//
 
 // create_map 申请 size 个map_pointer空间并0初始化map，返回map头指针（申请map）
-template <class T>
-typename deque<T>::map_pointer
-deque<T>::create_map(size_type size)
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::map_pointer
+deque<T, Alloc, BufBytes>::create_map(size_type size)
 {
     map_pointer mp = nullptr;
-    mp = map_allocator::allocate(size);
+    mp = map_allocator(this->get_alloc()).allocate(size);
     for(size_type i = 0; i < size; ++i)
         *(mp + i) = nullptr;
     return mp;
 }
 
 // create_buffer 为[nstart, nfinish] 所指的 buffer 申请空间 (为已构造好的map申请buffer）
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
+deque<T, Alloc, BufBytes>::create_buffer(map_pointer nstart, map_pointer nfinish)
 {
     map_pointer cur = nstart;
     try {
         for(; cur <= nfinish; ++cur)
-            *cur = data_allocator::allocate(buffer_size);
+            *cur = this->get_alloc().allocate(buffer_size);
     } catch (...) {
         while(cur != nstart)
         {
             --cur;
-            data_allocator::deallocate(*cur, buffer_size);
+            this->get_alloc().deallocate(*cur, buffer_size);
             *cur = nullptr;
         }
         throw;
@@ -787,21 +951,21 @@ deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 // recover_buffer 回收 [nstart, nfinish] 指向的所有buffer内存
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::recover_buffer(map_pointer nstart, map_pointer nfinish)
+deque<T, Alloc, BufBytes>::recover_buffer(map_pointer nstart, map_pointer nfinish)
 {
     for(map_pointer n = nstart; n <= nfinish; ++n)
     {
-        data_allocator::deallocate(*n);
+        this->get_alloc().deallocate(*n, buffer_size);
         *n = nullptr;
     }
 }
 
 // 初始化map及buffer，初始化后的map个数比已分配的buffer个数长2或更多，最少分配8个buffer
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::map_init(size_type nElem)
+deque<T, Alloc, BufBytes>::map_init(size_type nElem)
 {
     // map_size(分配空间数) > nNode(元素所占空间)
     const size_type nNode = nElem / buffer_size + 1;
@@ -821,7 +985,7 @@ deque<T>::map_init(size_type nElem)
     try {
         create_buffer(nstart, nfinish);
     } catch (...) {
-        map_allocator::deallocate(map_);
+        map_allocator(this->get_alloc()).deallocate(map_, map_size_);
         map_ = nullptr;
         map_size_ = 0;
         throw;
@@ -832,10 +996,26 @@ deque<T>::map_init(size_type nElem)
     end_.cur = end_.first + (nElem % buffer_size);
 }
 
+// destroy_all 析构全部元素，释放全部 buffer 与 map（被移动后 map_ 为空则什么都不做）
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::destroy_all() noexcept
+{
+    if(map_ != nullptr)
+    {
+        clear();
+        this->get_alloc().deallocate(*begin_.node, buffer_size);
+        *begin_.node = nullptr;
+        map_allocator(this->get_alloc()).deallocate(map_, map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+}
+
 // fill_init 初始化为 n 个 value 元素的deque
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::fill_init(size_type n, const value_type &value)
+deque<T, Alloc, BufBytes>::fill_init(size_type n, const value_type &value)
 {
     map_init(n);
     if(n != 0)
@@ -846,11 +1026,25 @@ deque<T>::fill_init(size_type n, const value_type &value)
     }
 }
 
+// default_fill_init 初始化为 n 个默认初始化元素的deque，平凡类型只需分配空间
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::default_fill_init(size_type n)
+{
+    map_init(n);
+    if(n != 0)
+    {
+        for(auto cur = begin_.node; cur < end_.node; ++cur)
+            deonSTL::uninitialized_default_construct_n(*cur, buffer_size);
+        deonSTL::uninitialized_default_construct_n(end_.first, end_.cur - end_.first);
+    }
+}
+
 // copy_init 从 InputIter: [first, last) 拷贝初始化
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class IIter>
 void
-deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
+deque<T, Alloc, BufBytes>::copy_init(IIter first, IIter last, input_iterator_tag)
 {
     const size_type n = deonSTL::distance(first, last);
     map_init(n);
@@ -859,10 +1053,10 @@ deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
 }
 
 // copy_init 从 ForwardIter: [first, last) 拷贝初始化
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class FIter>
 void
-deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag)
+deque<T, Alloc, BufBytes>::copy_init(FIter first, FIter last, forward_iterator_tag)
 {// 需要逐buffer拷贝，至少需要三个指针来完成
     const size_type n = deonSTL::distance(first, last);
     map_init(n);
@@ -877,38 +1071,76 @@ deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag)
 }
 
 // insert_aux 在pos前（原来的pos位置元素往后走）插入args参数构造的元素(可能调用构造函数或拷贝构造函数)，返回尾后迭代器(pos)
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class ...Args>
-typename deque<T>::iterator
-deque<T>::insert_aux(iterator pos, Args&& ...args)
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::insert_aux(iterator pos, Args&& ...args)
 {
     const size_type elems_before = pos - begin_;
     value_type value_copy = value_type(std::forward<Args>(args)...);
+    if(relocatable::value)
+    {// 较短的一侧按字节让出一个位置，在空位上直接构造
+        if(elems_before < (size() / 2))
+        {
+            require_capacity(1, true); // 可能重新分配 map，之后重新计算 pos
+            auto new_begin = begin_;
+            --new_begin;
+            pos = begin_ + elems_before;
+            relocate_to_front(begin_, pos, new_begin);
+            begin_ = new_begin;
+            --pos;
+        }
+        else
+        {
+            require_capacity(1, false);
+            auto new_end = end_;
+            ++new_end;
+            pos = begin_ + elems_before;
+            relocate_to_back(pos, end_, new_end);
+            end_ = new_end;
+        }
+        deonSTL::construct(pos.cur, std::move(value_copy));
+        return pos;
+    }
     if(elems_before < (size() / 2))
     {
-        emplace_front(front());
+        emplace_front(std::move(front()));
         auto front1 = begin_ + 1;
         auto front2 = front1 + 1;
-        pos = begin_ + elems_before + 1;
-        std::copy(front2, pos, front1);
+        pos = begin_ + elems_before;   // 头部多了一个元素，[front2, pos] 前移一位后 pos 空出
+        deonSTL::move(front2, pos + 1, front1);
     }
     else
     {
-        emplace_back(back());
+        emplace_back(std::move(back()));
         auto back1 = end_ - 1;
         auto back2 = back1 - 1;
         pos = begin_ + elems_before;
-        std::copy_backward(pos, back2, back1);
+        std::move_backward(pos, back2, back1);
     }
     *pos = std::move(value_copy);
     return pos;
 }
 
 // fill_insert 在pos之前插入n个value元素
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::fill_insert(iterator pos, size_type n, const value_type &value)
+deque<T, Alloc, BufBytes>::fill_insert(iterator pos, size_type n, const value_type &value)
 {
+    if(n == 0)
+        return;
+    if(relocatable::value)
+    {// value 可能是容器中的元素，让出位置之前先复制
+        const value_type value_copy(value);
+        iterator gap = open_gap(pos - begin_, n);
+        try {
+            deonSTL::uninitialized_fill_n(gap, n, value_copy);
+        } catch (...) {
+            close_gap(gap, n);
+            throw;
+        }
+        return;
+    }
     const size_type elems_before = pos - begin_;
     const size_type len = size();
     if(elems_before < (len / 2))
@@ -922,15 +1154,15 @@ deque<T>::fill_insert(iterator pos, size_type n, const value_type &value)
             auto begin_n = begin_ + n;
             deonSTL::uninitialized_copy(begin_, begin_n, new_begin);
             begin_ = new_begin;
-            std::copy(begin_n, pos, old_begin);
-            std::fill(pos - n, pos, value);
+            deonSTL::copy(begin_n, pos, old_begin);
+            deonSTL::fill(pos - n, pos, value);
         }
         else
         {// elems_before 全部构造，n 一部分赋值，一部分构造
             deonSTL::uninitialized_copy_n(begin_, elems_before, new_begin);
             deonSTL::uninitialized_fill(new_begin + elems_before, begin_, value);
             begin_ = new_begin;
-            std::fill(old_begin, pos, value);
+            deonSTL::fill(old_begin, pos, value);
         }
     }
     else
@@ -942,29 +1174,42 @@ deque<T>::fill_insert(iterator pos, size_type n, const value_type &value)
         pos = end_ - elems_after;
         if(elems_after > n)
         {// elems_after 一部分构造，一部分赋值，n 全部构造
-            auto end_n = end_ + n;
+            auto end_n = end_ - n;
             deonSTL::uninitialized_copy(end_n, end_, end_);
             end_ = new_end;
-            std::copy(pos, end_n, old_end);
-            std::fill(pos, pos+n, value);
+            std::copy_backward(pos, end_n, old_end);
+            deonSTL::fill(pos, pos+n, value);
         }
         else
         {// elems_after 全部赋值，n 一部分赋值，一部分构造
             deonSTL::uninitialized_fill(end_, pos + n, value);
             deonSTL::uninitialized_copy_n(pos, elems_after, pos + n);
             end_ = new_end;
-            std::fill(pos, old_end, value);
+            deonSTL::fill(pos, old_end, value);
         }
     }
 }
 
 // copy_insert 把[first, last)的内容插入到pos之前（ForwardIter版本）
-template <class T>
+template <class T, class Alloc, size_t BufBytes>
 template <class FIter>
 void
-deque<T>::copy_insert(iterator pos, FIter first, FIter last)
+deque<T, Alloc, BufBytes>::copy_insert(iterator pos, FIter first, FIter last)
 {
     const size_type n = deonSTL::distance(first, last);
+    if(n == 0)
+        return;
+    if(relocatable::value)
+    {
+        iterator gap = open_gap(pos - begin_, n);
+        try {
+            deonSTL::uninitialized_copy(first, last, gap);
+        } catch (...) {
+            close_gap(gap, n);
+            throw;
+        }
+        return;
+    }
     const size_type elems_before = pos - begin_;
     const size_type len = size();
     if(elems_before < (len / 2))
@@ -978,9 +1223,9 @@ deque<T>::copy_insert(iterator pos, FIter first, FIter last)
             auto begin_n = begin_ + n;
             deonSTL::uninitialized_copy(begin_, begin_n, new_begin);
             begin_ = new_begin;
-            std::copy(begin_n, pos, old_begin);
+            deonSTL::copy(begin_n, pos, old_begin);
             //std::fill(pos - n, pos, value);
-            std::copy(first, last, pos - n);
+            deonSTL::copy(first, last, pos - n);
         }
         else
         {// elems_before 全部构造，n 一部分赋值，一部分构造
@@ -989,7 +1234,7 @@ deque<T>::copy_insert(iterator pos, FIter first, FIter last)
             deonSTL::uninitialized_copy(begin_, pos, new_begin);
             deonSTL::uninitialized_copy(first, mid, new_begin + elems_before);
             begin_ = new_begin;
-            std::copy(mid, last, old_begin);
+            deonSTL::copy(mid, last, old_begin);
         }
     }
     else
@@ -1001,12 +1246,12 @@ deque<T>::copy_insert(iterator pos, FIter first, FIter last)
         pos = end_ - elems_after;
         if(elems_after > n)
         {// elems_after 一部分构造，一部分赋值，n 全部构造
-            auto end_n = end_ + n;
+            auto end_n = end_ - n;
             deonSTL::uninitialized_copy(end_n, end_, end_);
             end_ = new_end;
-            std::copy(pos, end_n, old_end);
+            std::copy_backward(pos, end_n, old_end);
             //std::fill(pos, pos+n, value);
-            std::copy(first, last, pos);
+            deonSTL::copy(first, last, pos);
         }
         else
         {// elems_after 全部赋值，n 一部分赋值，一部分构造
@@ -1015,133 +1260,349 @@ deque<T>::copy_insert(iterator pos, FIter first, FIter last)
             deonSTL::uninitialized_copy(mid, last, end_);
             deonSTL::uninitialized_copy(pos, end_, pos + n);
             end_ = new_end;
-            std::copy(first, mid, pos);
+            deonSTL::copy(first, mid, pos);
         }
     }
 }
 
 // insert_dispatch 把[first, last)内容插入到pos之前（InputIter版本）
-template <class T>
+// 输入迭代器只能走一遍，逐个插入，每次插入后 pos 可能失效，按下标重新计算
+template <class T, class Alloc, size_t BufBytes>
 template <class IIter>
 void
-deque<T>::insert_dispatch(iterator pos, IIter first, IIter last, input_iterator_tag)
+deque<T, Alloc, BufBytes>::insert_dispatch(iterator pos, IIter first, IIter last, input_iterator_tag)
 {
-    if(last < first) return;
-    const size_type n = deonSTL::distance(first, last);
-    const size_type elems_before = pos - begin_;
-    if(elems_before < (size() / 2))
-        require_capacity(n, true);
-    else
-        require_capacity(n, false);
-    pos = begin_ + elems_before;
-    auto cur = --last;
-    for(size_type i = 0; i < n; ++i, --cur)
-        insert(pos, *cur);
+    size_type elems_before = pos - begin_;
+    for(; first != last; ++first, ++elems_before)
+        insert(begin_ + elems_before, *first);
 }
 
-// require_capacity 在头部/尾部需要n个元素空间，不足则申请
-template <class T>
+// require_capacity 在头部/尾部需要n个元素空间，不足时依次使用本端的空闲 buffer、另一端的空闲 buffer，
+// 仍不够才申请新的 buffer（队列用法下 pop_front 空出的 buffer 会被 push_back 复用）
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::require_capacity(size_type n, bool front)
+deque<T, Alloc, BufBytes>::require_capacity(size_type n, bool front)
 {
     if(front && (static_cast<size_type>(begin_.cur - begin_.first)) < n)
     {
         const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
         if(need_buffer > static_cast<size_type>(begin_.node - map_))
-        {
             reallocate_map_at_front(need_buffer);
-            return;
+        // [first, cur) 为还没有 buffer 的位置
+        map_pointer first = begin_.node - need_buffer;
+        map_pointer cur   = first_spare_front();
+        if(cur < first)
+            cur = first;
+        // 从尾部最远的空闲 buffer 开始取
+        map_pointer spare = last_spare_back();
+        for(; cur != first && spare != end_.node + 1; )
+        {
+            *--cur = *--spare;
+            *spare = nullptr;
         }
-        create_buffer(begin_.node - need_buffer, begin_.node - 1);
+        if(cur != first)
+            create_buffer(first, cur - 1);
     }
     else if(!front && (static_cast<size_type>(end_.last - end_.cur - 1)) < n)
     {
         const size_type need_buffer = (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
         if(need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1))
-        {
             reallocate_map_at_back(need_buffer);
-            return;
+        // [cur, last) 为还没有 buffer 的位置
+        map_pointer last = end_.node + need_buffer + 1;
+        map_pointer cur  = last_spare_back();
+        if(cur > last)
+            cur = last;
+        // 从头部最远的空闲 buffer 开始取
+        map_pointer spare = first_spare_front();
+        for(; cur != last && spare != begin_.node; ++cur, ++spare)
+        {
+            *cur = *spare;
+            *spare = nullptr;
         }
-        create_buffer(end_.node + 1, end_.node + need_buffer);
+        if(cur != last)
+            create_buffer(cur, last - 1);
+    }
+}
+
+// first_spare_front 返回头部第一个空闲 buffer 的节点，没有空闲 buffer 时返回 begin_.node
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::map_pointer
+deque<T, Alloc, BufBytes>::first_spare_front() const noexcept
+{
+    map_pointer cur = begin_.node;
+    while(cur != map_ && *(cur - 1) != nullptr)
+        --cur;
+    return cur;
+}
+
+// last_spare_back 返回尾部最后一个空闲 buffer 的下一个节点，没有空闲 buffer 时返回 end_.node + 1
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::map_pointer
+deque<T, Alloc, BufBytes>::last_spare_back() const noexcept
+{
+    map_pointer cur = end_.node + 1;
+    while(cur != map_ + map_size_ && *cur != nullptr)
+        ++cur;
+    return cur;
+}
+
+// trim_spare_front 头部空闲 buffer 超过 spare_blocks 个时回收离 begin_ 最远的部分
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::trim_spare_front()
+{
+    map_pointer first = first_spare_front();
+    if(static_cast<size_type>(begin_.node - first) > spare_blocks)
+        recover_buffer(first, begin_.node - spare_blocks - 1);
+}
+
+// trim_spare_back 尾部空闲 buffer 超过 spare_blocks 个时回收离 end_ 最远的部分
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::trim_spare_back()
+{
+    map_pointer last = last_spare_back();
+    if(static_cast<size_type>(last - end_.node - 1) > spare_blocks)
+        recover_buffer(end_.node + spare_blocks + 1, last - 1);
+}
+
+// reallocate_map_at_front 使 begin_ 之前至少有 need_buffer 个位置，不创建 buffer
+// 原 map 的大小超过所需节点数的两倍时在原 map 内居中，否则重新申请 map，空闲 buffer 随已用的节点一起搬移
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::reallocate_map_at_front(size_type need_buffer)
+{
+    map_pointer first = first_spare_front();
+    map_pointer last  = last_spare_back();
+    const size_type front_room = std::max(need_buffer, static_cast<size_type>(begin_.node - first));
+    const size_type used  = last - begin_.node;
+    const size_type nodes = front_room + used;
+    
+    map_pointer new_begin;
+    if(map_size_ > 2 * nodes)
+    {// 空位足够，在原 map 内居中，不申请内存
+        new_begin = map_ + (map_size_ - nodes) / 2 + front_room;
+        move_nodes(first, last, new_begin - (begin_.node - first));
+    }
+    else
+    {
+        const size_type new_size = std::max(map_size_ << 1, map_size_ + need_buffer + 8);
+        map_pointer new_map = create_map(new_size);
+        new_begin = new_map + (new_size - nodes) / 2 + front_room;
+        std::copy(first, last, new_begin - (begin_.node - first));
+        map_allocator(this->get_alloc()).deallocate(map_, map_size_);
+        map_      = new_map;
+        map_size_ = new_size;
+    }
+    auto new_end = new_begin + (end_.node - begin_.node);
+    begin_    = iterator(*new_begin + (begin_.cur - begin_.first), new_begin);
+    end_      = iterator(*new_end + (end_.cur - end_.first), new_end);
+}
+
+// reallocate_map_at_back 使 end_ 之后至少有 need_buffer 个位置，不创建 buffer
+// 队列用法（push_back + pop_front）下节点不断后移，靠在原 map 内居中使 map 的大小保持不变
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::reallocate_map_at_back(size_type need_buffer)
+{
+    map_pointer first = first_spare_front();
+    map_pointer last  = last_spare_back();
+    const size_type back_room = std::max(need_buffer, static_cast<size_type>(last - end_.node - 1));
+    const size_type used  = end_.node - first + 1;
+    const size_type nodes = used + back_room;
+    
+    map_pointer new_first;
+    if(map_size_ > 2 * nodes)
+    {// 空位足够，在原 map 内居中，不申请内存
+        new_first = map_ + (map_size_ - nodes) / 2;
+        move_nodes(first, last, new_first);
+    }
+    else
+    {// 申请new_map，搬移原 buffer（连同空闲 buffer）
+        const size_type new_size = std::max(map_size_ << 1, map_size_ + need_buffer + 8);
+        map_pointer new_map = create_map(new_size);
+        new_first = new_map + (new_size - nodes) / 2;
+        std::copy(first, last, new_first);
+        map_allocator(this->get_alloc()).deallocate(map_, map_size_);
+        map_      = new_map;
+        map_size_ = new_size;
+    }
+    auto new_begin = new_first + (begin_.node - first);
+    auto new_end   = new_first + (end_.node - first);
+    begin_    = iterator(*new_begin + (begin_.cur - begin_.first), new_begin);
+    end_      = iterator(*new_end + (end_.cur - end_.first), new_end);
+}
+
+// move_nodes 在原 map 内把节点 [first, last) 搬到 result 开始的位置，空出的节点置空
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::move_nodes(map_pointer first, map_pointer last, map_pointer result) noexcept
+{
+    const difference_type len = last - first;
+    if(result < first)
+    {
+        std::copy(first, last, result);
+        std::fill(std::max(result + len, first), last, nullptr);
+    }
+    else if(first < result)
+    {
+        std::copy_backward(first, last, result + len);
+        std::fill(first, std::min(result, last), nullptr);
+    }
+}
+
+
+// unlink_front 头部让出一个位置，不析构元素，头部 buffer 用完时留作空闲 buffer
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::unlink_front()
+{
+    if(begin_.cur != begin_.last - 1)
+        ++begin_.cur;
+    else
+    {
+        ++begin_;
+        trim_spare_front();
     }
 }
 
+// unlink_back 尾部让出一个位置，不析构元素
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::unlink_back()
+{
+    if(end_.cur != end_.first)
+        --end_.cur;
+    else
+    {// 此时buffers状态：[full buffer][ ] 后一个 buffer 中虽然没有元素但依然要存在，
+     // 因为end.cur要指向这个空buffer（上一个buffer的尾后元素是下一个buffer的第一个元素）
+        --end_;
+        trim_spare_back();
+    }
+}
 
-// reallocate_map_at_front 重新申请map，在map前创建 need_buffer 个 buffer
-template <class T>
+// relocate_to_front 把 [first, last) 按字节搬到 result 开始的位置（result 不在 first 之后）
+// 从前往后，每次搬移源与目的所在 buffer 中都连续的一段
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::reallocate_map_at_front(size_type need_buffer)
+deque<T, Alloc, BufBytes>::relocate_to_front(iterator first, iterator last, iterator result)
 {
-    const size_type new_size = std::max(map_size_ << 1, map_size_ + need_buffer + 8);
-    map_pointer new_map = create_map(new_size);
-    const size_type old_nNode = end_.node - begin_.node + 1;
-    const size_type new_nNode = old_nNode + need_buffer;
-    
-    auto begin = new_map + (new_size - new_nNode) / 2;
-    auto mid   = begin + need_buffer; // 指向被拷贝的第一个节点
-    auto end   = begin + new_nNode;
-    create_buffer(begin, mid-1);
-    for(auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
-        *begin1 = *begin2;
-    
-    map_allocator::deallocate(map_, map_size_);
-    map_      = new_map;
-    map_size_ = new_size;
-    begin_    = iterator(*mid + (begin_.cur - begin_.first), mid);
-    end_      = iterator(*(end_ - 1) + (end_.cur - end_.first), end_ - 1);
+    while(first != last)
+    {
+        difference_type n = std::min(first.last - first.cur, result.last - result.cur);
+        if(first.node == last.node)
+            n = std::min(n, last.cur - first.cur);
+        deonSTL::uninitialized_relocate(first.cur, first.cur + n, result.cur);
+        first.cur += n;
+        result.cur += n;
+        if(first.cur == first.last)
+        {
+            first.set_node(first.node + 1);
+            first.cur = first.first;
+        }
+        if(result.cur == result.last)
+        {
+            result.set_node(result.node + 1);
+            result.cur = result.first;
+        }
+    }
 }
 
-// reallocate_map_at_back 重新申请map，在map前后创建 need_buffer 个 buffer
-template <class T>
+// relocate_to_back 把 [first, last) 按字节搬到 result_last 结束的位置（result_last 不在 last 之前）
+// 从后往前，每次搬移源与目的所在 buffer 中都连续的一段
+template <class T, class Alloc, size_t BufBytes>
 void
-deque<T>::reallocate_map_at_back(size_type need_buffer)
+deque<T, Alloc, BufBytes>::relocate_to_back(iterator first, iterator last, iterator result_last)
 {
-    // 申请new_map
-    const size_type new_size = std::max(map_size_ << 1, map_size_ + need_buffer + 8);
-    map_pointer new_map = create_map(new_size);
-    const size_type old_nNode = end_.node - begin_.node + 1;
-    const size_type new_nNode = old_nNode + need_buffer;
-    
-    // 移动原buffer, 开辟新buffer
-    auto begin = new_map + ((new_size - new_nNode) / 2);
-    auto mid = begin + old_nNode;
-    auto end = begin + new_nNode;
-    for(auto begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2)
-        *begin1 = *begin2;
-    create_buffer(mid, end-1);
-    
-    // 更新数据
-    map_allocator::deallocate(map_, map_size_);
-    map_      = new_map;
-    map_size_ = new_size;
-    begin_    = iterator(*begin + (begin_.cur - begin_.first), begin);
-    end_      = iterator(*(mid - 1) + (end_.cur - end_.first), mid - 1);
+    while(first != last)
+    {
+        if(last.cur == last.first)
+        {
+            last.set_node(last.node - 1);
+            last.cur = last.last;
+        }
+        if(result_last.cur == result_last.first)
+        {
+            result_last.set_node(result_last.node - 1);
+            result_last.cur = result_last.last;
+        }
+        difference_type n = std::min(last.cur - last.first, result_last.cur - result_last.first);
+        if(first.node == last.node)
+            n = std::min(n, last.cur - first.cur);
+        last.cur -= n;
+        result_last.cur -= n;
+        deonSTL::uninitialized_relocate(last.cur, last.cur + n, result_last.cur);
+    }
 }
 
+// open_gap 与 insert_aux 一样按 elems_before < size() / 2 选择搬移前半部分还是后半部分
+template <class T, class Alloc, size_t BufBytes>
+typename deque<T, Alloc, BufBytes>::iterator
+deque<T, Alloc, BufBytes>::open_gap(size_type elems_before, size_type n)
+{
+    if(elems_before < (size() / 2))
+    {
+        require_capacity(n, true);
+        auto new_begin = begin_ - n;
+        relocate_to_front(begin_, begin_ + elems_before, new_begin);
+        begin_ = new_begin;
+    }
+    else
+    {
+        require_capacity(n, false);
+        auto new_end = end_ + n;
+        relocate_to_back(begin_ + elems_before, end_, new_end);
+        end_ = new_end;
+    }
+    return begin_ + elems_before;
+}
+
+// close_gap 搬移 [gap, gap + n) 两侧较短的一侧，空出的 buffer 留作空闲 buffer
+template <class T, class Alloc, size_t BufBytes>
+void
+deque<T, Alloc, BufBytes>::close_gap(iterator gap, size_type n) noexcept
+{
+    const iterator gap_end = gap + n;
+    if(gap - begin_ < end_ - gap_end)
+    {
+        relocate_to_back(begin_, gap, gap_end);
+        begin_ += n;
+    }
+    else
+    {
+        relocate_to_front(gap_end, end_, gap);
+        end_ -= n;
+    }
+}
 
 //***************************************************************************//
 //                            equal operator                                 //
 //***************************************************************************//
 
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufBytes>
+bool operator==(const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs)
 {
     return lhs.size() == rhs.size() &&
     std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+template <class T, class Alloc, size_t BufBytes>
+bool operator!=(const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs)
+template <class T, class Alloc, size_t BufBytes>
+void swap(deque<T, Alloc, BufBytes>& lhs, deque<T, Alloc, BufBytes>& rhs)
 {
     lhs.swap(rhs);
 }
 
+// deque 的迭代器指向 buffer 而不指向自身
+template <class T, class Alloc, size_t BufBytes>
+struct is_trivially_relocatable<deque<T, Alloc, BufBytes>> : is_trivially_relocatable<Alloc> {};
+
 
 }// namespase deonSTL
 
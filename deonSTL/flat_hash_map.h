@@ -0,0 +1,201 @@
+//
+//  flat_hash_map.h
+//  deonSTL
+//
+//  这个头文件包含模板类 flat_hash_map
+//  以 flat_hashtable 为底层机制，键值对直接存放在按 16 字节一组探测的开放定址数组中
+//  插入、删除可能使迭代器和元素的引用失效（扩容时元素被搬移）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef flat_hash_map_h
+#define flat_hash_map_h
+
+#include <functional> // equal_to
+#include "hash.h"
+#include "flat_hashtable.h"
+
+namespace deonSTL {
+
+// 模板类 flat_hash_map，键值不允许重复
+// 哈希函数缺省使用 deonSTL::hash，比较方式缺省使用 std::equal_to
+template <class Key, class T, class Hash = deonSTL::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = deonSTL::allocator<deonSTL::pair<const Key, T>>>
+class flat_hash_map
+{
+private:
+    // 以 deonSTL::flat_hashtable 作为底层机制
+    typedef deonSTL::flat_hashtable<deonSTL::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
+    base_type   ht_;
+
+public:
+    typedef typename base_type::key_type                key_type;
+    typedef typename base_type::mapped_type             mapped_type;
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::hasher                  hasher;
+    typedef typename base_type::key_equal               key_equal;
+
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::allocator_type          allocator_type;
+
+private:
+    // operator[] 插入的值初始化 mapped_type，由 ht_defer 推迟到确定要插入时才构造
+    struct value_init
+    {
+        mapped_type operator()() const { return mapped_type(); }
+    };
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(size_type bucket_count,
+                           const hasher& hash = hasher(),
+                           const key_equal& equal = key_equal(),
+                           const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc) {}
+
+    template <class InputIter>
+    flat_hash_map(InputIter first, InputIter last, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(first, last); }
+
+    flat_hash_map(std::initializer_list<value_type> ilist, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(ilist.begin(), ilist.end()); }
+
+    flat_hash_map(const flat_hash_map& rhs)
+    : ht_(rhs.ht_) {}
+
+    flat_hash_map(flat_hash_map&& rhs) noexcept
+    : ht_(std::move(rhs.ht_)) {}
+
+    flat_hash_map& operator=(const flat_hash_map& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    flat_hash_map& operator=(flat_hash_map&& rhs) noexcept
+    {
+        ht_ = std::move(rhs.ht_);
+        return *this;
+    }
+
+    flat_hash_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // ==========================成员函数============================ //
+
+    iterator            begin()           noexcept
+    { return ht_.begin(); }
+    const_iterator      begin()     const noexcept
+    { return ht_.begin(); }
+    iterator            end()             noexcept
+    { return ht_.end(); }
+    const_iterator      end()       const noexcept
+    { return ht_.end(); }
+
+    const_iterator      cbegin()    const noexcept
+    { return ht_.cbegin(); }
+    const_iterator      cend()      const noexcept
+    { return ht_.cend(); }
+
+    bool                empty()     const noexcept
+    { return ht_.empty(); }
+    size_type           size()      const noexcept
+    { return ht_.size(); }
+    size_type           max_size()  const noexcept
+    { return ht_.max_size(); }
+
+    allocator_type      get_allocator() const
+    { return ht_.get_allocator(); }
+
+    // 键不存在时插入值初始化的 mapped_type，键已存在时不构造临时的 mapped_type
+    mapped_type& operator[](const key_type& key)
+    { return ht_.try_emplace_unique(key, key, ht_defer<mapped_type>(value_init())).first->second; }
+    mapped_type& operator[](key_type&& key)
+    { return ht_.try_emplace_unique(key, std::move(key), ht_defer<mapped_type>(value_init())).first->second; }
+
+    // emplace
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> emplace(Args&& ...args)
+    { return ht_.emplace_unique(std::forward<Args>(args)...); }
+
+    // insert
+    deonSTL::pair<iterator, bool> insert(const value_type& value)
+    { return ht_.insert_unique(value); }
+    deonSTL::pair<iterator, bool> insert(value_type&& value)
+    { return ht_.insert_unique(std::move(value)); }
+
+    template <class InputIter>
+    void                          insert(InputIter first, InputIter last)
+    { ht_.insert_unique(first, last); }
+
+    // erase
+    iterator       erase(const_iterator pos) { return ht_.erase(pos); }
+    iterator       erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+    size_type      erase(const key_type& key) { return ht_.erase_unique(key); }
+
+    // clear
+    void           clear() { ht_.clear(); }
+
+    // find
+    iterator       find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    // count
+    size_type      count(const key_type& key) const { return ht_.count_unique(key); }
+
+    // equal_range
+    pair<iterator, iterator>
+      equal_range(const key_type& key)
+    { return ht_.equal_range_unique(key); }
+
+    pair<const_iterator, const_iterator>
+      equal_range(const key_type& key) const
+    { return ht_.equal_range_unique(key); }
+
+    // hash policy
+    size_type      bucket_count()    const noexcept { return ht_.bucket_count(); }
+    float          load_factor()     const noexcept { return ht_.load_factor(); }
+    float          max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void           rehash(size_type count)  { ht_.rehash(count); }
+    void           reserve(size_type count) { ht_.reserve(count); }
+
+    hasher         hash_function() const { return ht_.hash_fcn(); }
+    key_equal      key_eq()        const { return ht_.key_eq(); }
+
+    // swap
+    void swap(flat_hash_map& rhs) noexcept
+    { ht_.swap(rhs.ht_); }
+
+public:
+    friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs)
+    { return lhs.ht_.equal_to_unique(rhs.ht_); }
+    friend bool operator!=(const flat_hash_map& lhs, const flat_hash_map& rhs)
+    { return !lhs.ht_.equal_to_unique(rhs.ht_); }
+
+}; // class flat_hash_map
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs, flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{ lhs.swap(rhs); }
+
+} // namespace deonSTL
+
+#endif /* flat_hash_map_h */
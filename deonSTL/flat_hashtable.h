@@ -0,0 +1,993 @@
+//
+//  flat_hashtable.h
+//  deonSTL
+//
+//  这个头文件包含模板类 flat_hashtable，flat_hash_set / flat_hash_map 的底层机制
+//
+//  元素直接存放在槽数组中，每个槽另有一个控制字节：空、已删除、哨兵，或者元素 hash 值的低 7 位（tag）
+//  查找时一次取 16 个（没有 SSE2 时为 8 个）连续的控制字节组成一组，用一条比较指令找出 tag 相等的槽，
+//  只比较这些槽的键；组内有空槽说明键不存在，未命中的查找大多不访问槽数组
+//  组与组之间按三角数跳跃探测，容量为 2^k - 1，最大负载系数 7/8
+//  删除时如果探测不会越过这个槽（前后都有空槽且跨度小于一组）则直接置空，否则留下“已删除”标记
+//
+//  控制字节数组的末尾复制了开头 width - 1 个字节，从任何位置取一组都不需要回绕
+//  hash 值先经过一次乘法混合（hash 函数标记了 is_avalanching 时省去），低 7 位作为 tag，其余位决定探测的起点
+//  不保存 hash 值，扩容时重新计算，要求 hash 函数不抛出异常
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef flat_hashtable_h
+#define flat_hashtable_h
+
+#include <cstdint>      // int8_t, uint64_t
+#include <cstring>      // memcpy, memset
+#include <new>
+#include <utility>      // move, forward
+#include <type_traits>  // aligned_storage
+#include "iterator.h"
+#include "type_traits.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+#include "exceptdef.h"
+#include "hashtable.h"  // ht_value_traits
+#include "hash.h"       // is_avalanching
+
+// 可以预先定义 DEONSTL_FH_SSE2 为 0 强制使用 portable 版本
+#if !defined(DEONSTL_FH_SSE2)
+#if defined(__SSE2__) || defined(_M_X64)
+#define DEONSTL_FH_SSE2 1
+#else
+#define DEONSTL_FH_SSE2 0
+#endif
+#endif
+
+#if DEONSTL_FH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace deonSTL {
+
+//***************************************************************************//
+//                                 控制字节                                    //
+//***************************************************************************//
+
+// 控制字节：最高位为 0 表示槽中有元素，低 7 位为 tag；其余取值如下
+typedef int8_t fh_ctrl;
+
+const fh_ctrl fh_empty    = -128;   // 0b10000000 空槽
+const fh_ctrl fh_deleted  = -2;     // 0b11111110 已删除
+const fh_ctrl fh_sentinel = -1;     // 0b11111111 槽数组末尾的哨兵，迭代到这里停止
+
+inline bool fh_is_full(fh_ctrl c) noexcept { return c >= 0; }
+
+inline int fh_ctz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for(; (x & 1) == 0; x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline int fh_clz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for(; (x & (uint64_t(1) << 63)) == 0; x <<= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// 一组控制字节的匹配结果：每个匹配的字节对应 mask 中的一位
+// Shift 为 0 时第 i 位对应第 i 个字节（SSE2），为 3 时第 8i + 7 位对应第 i 个字节（portable）
+template <int Width, int Shift>
+struct fh_bitmask
+{
+    uint64_t mask;
+
+    explicit fh_bitmask(uint64_t m) : mask(m) {}
+
+    explicit operator bool() const noexcept { return mask != 0; }
+
+    // 最低的匹配字节
+    int  lowest()         const noexcept { return fh_ctz(mask) >> Shift; }
+    void next()                 noexcept { mask &= mask - 1; }
+
+    // 开头 / 末尾连续不匹配的字节数
+    int  trailing_zeros() const noexcept
+    { return mask != 0 ? fh_ctz(mask) >> Shift : Width; }
+    int  leading_zeros()  const noexcept
+    {
+        const int extra = 64 - (Width << Shift);
+        return mask != 0 ? fh_clz(mask << extra) >> Shift : Width;
+    }
+};
+
+#if DEONSTL_FH_SSE2
+
+// 一组 16 个控制字节，每种匹配一条比较指令
+struct fh_group
+{
+    static const size_t width = 16;
+    typedef fh_bitmask<16, 0> bitmask;
+
+    __m128i ctrl;
+
+    explicit fh_group(const fh_ctrl* p)
+    : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    bitmask match(fh_ctrl tag) const noexcept
+    { return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)))); }
+
+    bitmask match_empty() const noexcept
+    { return match(fh_empty); }
+
+    // 空或者已删除：小于哨兵
+    bitmask match_empty_or_deleted() const noexcept
+    { return bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(fh_sentinel), ctrl)))); }
+
+    // 开头连续的空或已删除字节数
+    size_t  count_leading_empty_or_deleted() const noexcept
+    { return static_cast<size_t>(fh_ctz(match_empty_or_deleted().mask + 1)); }
+};
+
+#else
+
+// 一组 8 个控制字节，放在一个 64 位整数中按位并行匹配
+// match 可能把紧挨着真实匹配的字节也报告为匹配，调用者总要再比较键，不影响正确性
+struct fh_group
+{
+    static const size_t width = 8;
+    typedef fh_bitmask<8, 3> bitmask;
+
+    static const uint64_t lsbs = 0x0101010101010101ull;
+    static const uint64_t msbs = 0x8080808080808080ull;
+
+    uint64_t ctrl;
+
+    explicit fh_group(const fh_ctrl* p)
+    {
+        std::memcpy(&ctrl, p, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        ctrl = __builtin_bswap64(ctrl);
+#endif
+    }
+
+    bitmask match(fh_ctrl tag) const noexcept
+    {
+        const uint64_t x = ctrl ^ (lsbs * static_cast<uint8_t>(tag));
+        return bitmask((x - lsbs) & ~x & msbs);
+    }
+
+    // 空槽 0b10000000：最高位为 1 且第 1 位为 0
+    bitmask match_empty() const noexcept
+    { return bitmask(ctrl & ~(ctrl << 6) & msbs); }
+
+    // 空或已删除：最高位为 1 且第 0 位为 0
+    bitmask match_empty_or_deleted() const noexcept
+    { return bitmask(ctrl & ~(ctrl << 7) & msbs); }
+
+    size_t  count_leading_empty_or_deleted() const noexcept
+    {
+        const uint64_t gaps = 0x00FEFEFEFEFEFEFEull;
+        return static_cast<size_t>((fh_ctz(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3);
+    }
+};
+
+#endif // DEONSTL_FH_SSE2
+
+// 空容器使用的一组控制字节：哨兵之后全为空，查找与迭代不需要特殊判断
+inline fh_ctrl* fh_empty_group() noexcept
+{
+    alignas(16) static const fh_ctrl group[16] = {
+        fh_sentinel, fh_empty, fh_empty, fh_empty, fh_empty, fh_empty, fh_empty, fh_empty,
+        fh_empty,    fh_empty, fh_empty, fh_empty, fh_empty, fh_empty, fh_empty, fh_empty};
+    return const_cast<fh_ctrl*>(group);
+}
+
+// 混合 hash 值：std::hash 对整数是恒等映射，低位不均匀，乘以一个奇数常数后把 128 位积的两半异或
+inline size_t fh_mix(size_t h) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 m = static_cast<unsigned __int128>(h) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64));
+#else
+    uint64_t x = h;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+#endif
+}
+
+// 已充分混合的 hash 值不再混合
+inline size_t fh_mix(size_t h, std::false_type) noexcept
+{ return fh_mix(h); }
+inline size_t fh_mix(size_t h, std::true_type) noexcept
+{ return h; }
+
+// 探测序列：以组为单位，第 i 次探测从起点前进 width * i * (i + 1) / 2，
+// 容量加一是 2 的幂时可以遍历所有的组
+struct fh_probe
+{
+    size_t mask;
+    size_t offset;
+    size_t index;
+
+    fh_probe(size_t h1, size_t m) : mask(m), offset(h1 & m), index(0) {}
+
+    size_t at(size_t i) const noexcept { return (offset + i) & mask; }
+
+    void   next() noexcept
+    {
+        index += fh_group::width;
+        offset = (offset + index) & mask;
+    }
+};
+
+//***************************************************************************//
+//                                   迭代器                                    //
+//***************************************************************************//
+
+template <class T>
+struct fh_const_iterator;
+
+// 迭代器保存控制字节与元素的指针，++ 跳过空槽和已删除的槽，停在下一个元素或者哨兵上
+template <class T>
+struct fh_iterator : public deonSTL::iterator<forward_iterator_tag, T>
+{
+    typedef T                       value_type;
+    typedef value_type*             pointer;
+    typedef value_type&             reference;
+    typedef size_t                  size_type;
+    typedef ptrdiff_t               difference_type;
+
+    typedef fh_iterator<T>          self;
+    typedef fh_iterator<T>          iterator;
+    typedef fh_const_iterator<T>    const_iterator;
+
+    fh_ctrl*    ctrl;   // 所指槽的控制字节
+    T*          slot;   // 所指的槽
+
+    fh_iterator() = default;
+
+    fh_iterator(fh_ctrl* c, T* s)
+    : ctrl(c), slot(s) {}
+
+    fh_iterator(const const_iterator& rhs) // const --> non-const
+    : ctrl(rhs.ctrl), slot(const_cast<T*>(rhs.slot)) {}
+
+    reference operator*()  const { return *slot; }
+    pointer   operator->() const { return &(operator*()); }
+
+    self& operator++()
+    {
+        MY_DEBUG(fh_is_full(*ctrl));
+        ++ctrl;
+        ++slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+
+    self operator++(int)
+    {
+        self tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    // 一次跳过一组中开头的空槽和已删除的槽
+    void skip_empty_or_deleted() noexcept
+    {
+        while(*ctrl < fh_sentinel)
+        {
+            const size_t shift = fh_group(ctrl).count_leading_empty_or_deleted();
+            ctrl += shift;
+            slot += shift;
+        }
+    }
+
+    bool operator==(const self& other) const { return ctrl == other.ctrl; }
+    bool operator!=(const self& other) const { return ctrl != other.ctrl; }
+};
+
+template <class T>
+struct fh_const_iterator : public deonSTL::iterator<forward_iterator_tag, T>
+{
+    typedef T                       value_type;
+    typedef const value_type*       pointer;
+    typedef const value_type&       reference;
+    typedef size_t                  size_type;
+    typedef ptrdiff_t               difference_type;
+
+    typedef fh_const_iterator<T>    self;
+    typedef fh_iterator<T>          iterator;
+    typedef fh_const_iterator<T>    const_iterator;
+
+    fh_ctrl*    ctrl;
+    const T*    slot;
+
+    fh_const_iterator() = default;
+
+    fh_const_iterator(fh_ctrl* c, const T* s)
+    : ctrl(c), slot(s) {}
+
+    fh_const_iterator(const iterator& rhs) // non-const --> const
+    : ctrl(rhs.ctrl), slot(rhs.slot) {}
+
+    reference operator*()  const { return *slot; }
+    pointer   operator->() const { return &(operator*()); }
+
+    self& operator++()
+    {
+        MY_DEBUG(fh_is_full(*ctrl));
+        ++ctrl;
+        ++slot;
+        while(*ctrl < fh_sentinel)
+        {
+            const size_t shift = fh_group(ctrl).count_leading_empty_or_deleted();
+            ctrl += shift;
+            slot += shift;
+        }
+        return *this;
+    }
+
+    self operator++(int)
+    {
+        self tmp(*this);
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const self& other) const { return ctrl == other.ctrl; }
+    bool operator!=(const self& other) const { return ctrl != other.ctrl; }
+};
+
+//***************************************************************************//
+//                              flat_hashtable                               //
+//***************************************************************************//
+
+// 槽数组与控制字节放在同一块内存中，以槽为单位申请，控制字节在槽之后
+template <class T>
+struct fh_slot
+{
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type type;
+};
+
+// 模板类 flat_hashtable，只支持不重复的键
+// 参数一代表元素类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表空间配置器
+template <class T, class Hash, class KeyEqual, class Alloc = deonSTL::allocator<T>>
+class flat_hashtable : private deonSTL::alloc_holder<
+    typename Alloc::template rebind<typename fh_slot<T>::type>::other>
+{
+public:
+    typedef ht_value_traits<T>                          value_traits;
+    typedef typename value_traits::key_type             key_type;
+    typedef typename value_traits::mapped_type          mapped_type;
+    typedef typename value_traits::value_type           value_type;
+    typedef Hash                                        hasher;
+    typedef KeyEqual                                    key_equal;
+
+    typedef typename fh_slot<T>::type                   slot_type;
+
+    typedef Alloc                                                   allocator_type;
+    typedef typename Alloc::template rebind<slot_type>::other       slot_allocator;
+
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef deonSTL::fh_iterator<T>                     iterator;
+    typedef deonSTL::fh_const_iterator<T>               const_iterator;
+
+private:
+    typedef deonSTL::alloc_holder<slot_allocator>       alloc_base;
+    typedef typename value_traits::movable_type         movable_type;
+    typedef std::integral_constant<bool,
+        std::is_nothrow_move_constructible<movable_type>::value> nothrow_movable;
+
+    static const size_type group_width = fh_group::width;
+
+    fh_ctrl*    ctrl_;        // 控制字节：capacity_ 个槽 + 1 个哨兵 + group_width - 1 个复制的字节
+    T*          slots_;       // 槽数组，未申请时为空
+    size_type   capacity_;    // 槽数，2^k - 1，未申请时为 0
+    size_type   size_;        // 元素数量
+    size_type   growth_left_; // 还能插入到空槽中的元素个数
+    hasher      hash_;        // hash函数
+    key_equal   equal_;       // 相等函数
+
+public:
+    // ====================构造、移动、赋值、析构操作==================== //
+
+    // bucket_count 不为 0 时容量为不小于它的 2^k - 1
+    explicit flat_hashtable(size_type bucket_count = 0,
+                            const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual(),
+                            const allocator_type& alloc = allocator_type())
+    : alloc_base(slot_allocator(alloc)), ctrl_(fh_empty_group()), slots_(nullptr),
+      capacity_(0), size_(0), growth_left_(0), hash_(hash), equal_(equal)
+    {
+        if(bucket_count != 0)
+            resize(normalize_capacity(bucket_count));
+    }
+
+    flat_hashtable(const flat_hashtable& rhs);
+    flat_hashtable(flat_hashtable&& rhs) noexcept;
+
+    flat_hashtable& operator=(const flat_hashtable& rhs)
+    {
+        if(this != &rhs)
+        {
+            flat_hashtable tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    flat_hashtable& operator=(flat_hashtable&& rhs) noexcept
+    {
+        flat_hashtable tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~flat_hashtable()
+    {
+        destroy_slots();
+        deallocate(slots_, capacity_);
+    }
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type  get_allocator() const
+    { return allocator_type(this->get_alloc()); }
+
+    iterator        begin()           noexcept
+    {
+        iterator it(ctrl_, slots_);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+    const_iterator  begin()     const noexcept
+    { return const_cast<flat_hashtable*>(this)->begin(); }
+    iterator        end()             noexcept
+    { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+    const_iterator  end()       const noexcept
+    { return const_iterator(ctrl_ + capacity_, slots_ + capacity_); }
+
+    const_iterator  cbegin()    const noexcept
+    { return begin(); }
+    const_iterator  cend()      const noexcept
+    { return end(); }
+
+    bool            empty()     const noexcept
+    { return size_ == 0; }
+    size_type       size()      const noexcept
+    { return size_; }
+    size_type       max_size()  const noexcept
+    { return static_cast<size_type>(-1) / (sizeof(T) + 1); }
+    size_type       capacity()  const noexcept
+    { return capacity_; }
+
+    // emplace
+    // 先构造出元素再查找插入位置
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> emplace_unique(Args&& ...args)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        return insert_unique(std::move(tmp));
+    }
+
+    // 键为 key 的元素不存在时才用 args 构造元素（args 构造出的元素的键应当等于 key）
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> try_emplace_unique(const key_type& key, Args&& ...args);
+
+    // insert
+    deonSTL::pair<iterator, bool> insert_unique(const value_type& value)
+    { return try_emplace_unique(value_traits::get_key(value), value); }
+    deonSTL::pair<iterator, bool> insert_unique(value_type&& value)
+    { return try_emplace_unique(value_traits::get_key(value), std::move(value)); }
+
+    template <class InputIter>
+    void            insert_unique(InputIter first, InputIter last)
+    {
+        for(; first != last; ++first)
+            insert_unique(*first);
+    }
+
+    // erase
+    // 其余元素的位置不变，返回 pos 的下一个元素
+    iterator        erase(const_iterator pos);
+    iterator        erase(const_iterator first, const_iterator last);
+
+    size_type       erase_unique(const key_type& key);
+
+    // clear 保留槽数组
+    void            clear() noexcept;
+
+    // swap
+    void            swap(flat_hashtable& rhs) noexcept;
+
+    // count
+    size_type       count_unique(const key_type& key) const
+    { return find_index(key, hash_of(key)) != capacity_ ? 1 : 0; }
+
+    // find
+    iterator        find(const key_type& key)
+    {
+        const size_type i = find_index(key, hash_of(key));
+        return iterator(ctrl_ + i, slots_ + i);
+    }
+    const_iterator  find(const key_type& key) const
+    {
+        const size_type i = find_index(key, hash_of(key));
+        return const_iterator(ctrl_ + i, slots_ + i);
+    }
+
+    // equal_range
+    deonSTL::pair<iterator, iterator>
+    equal_range_unique(const key_type& key)
+    {
+        iterator it = find(key);
+        iterator next = it;
+        if(it != end())
+            ++next;
+        return deonSTL::pair<iterator, iterator>(it, next);
+    }
+    deonSTL::pair<const_iterator, const_iterator>
+    equal_range_unique(const key_type& key) const
+    {
+        const_iterator it = find(key);
+        const_iterator next = it;
+        if(it != end())
+            ++next;
+        return deonSTL::pair<const_iterator, const_iterator>(it, next);
+    }
+
+    // hash policy
+    size_type       bucket_count() const noexcept
+    { return capacity_; }
+
+    float           load_factor() const noexcept
+    { return capacity_ != 0 ? static_cast<float>(size_) / capacity_ : 0.0f; }
+
+    // 最大负载系数固定为 7/8
+    float           max_load_factor() const noexcept
+    { return 0.875f; }
+
+    // 容量调整为不小于 count、并且能容纳现有元素的 2^k - 1，同时清除已删除标记；
+    // count 为 0 且没有元素时释放槽数组
+    void            rehash(size_type count);
+
+    // 能容纳 count 个元素而不扩容
+    void            reserve(size_type count)
+    {
+        if(count > size_ + growth_left_)
+            resize(normalize_capacity(growth_to_capacity(count)));
+    }
+
+    hasher          hash_fcn() const { return hash_; }
+    key_equal       key_eq()   const { return equal_; }
+
+    // 比较两个容器的元素（顺序无关）
+    bool            equal_to_unique(const flat_hashtable& other) const;
+
+private:
+    // ==========================辅助函数============================ //
+
+    size_t          hash_of(const key_type& key) const
+    { return fh_mix(hash_(key), deonSTL::is_avalanching<Hash>()); }
+
+    // 容量与负载
+    // 不小于 n 的 2^k - 1，至少为一组减一，保证从任何位置取一组都不会越过复制的控制字节
+    static size_type normalize_capacity(size_type n) noexcept
+    {
+        if(n < group_width - 1)
+            return group_width - 1;
+        return static_cast<size_type>(~uint64_t(0) >> fh_clz(static_cast<uint64_t>(n)));
+    }
+    // 容量为 cap 时最多容纳的元素个数：(cap + 1) * 7/8 - 1，至少留一个空槽，探测总能停下
+    static size_type capacity_to_growth(size_type cap) noexcept
+    { return cap - (cap + 1) / 8; }
+    // 容纳 growth 个元素需要的容量（未取整）
+    static size_type growth_to_capacity(size_type growth) noexcept
+    { return growth + (growth + 7) / 7; }
+
+    // 槽数组与控制字节
+    static size_type slot_units(size_type cap) noexcept
+    { return cap + (cap + group_width + sizeof(slot_type) - 1) / sizeof(slot_type); }
+    void            deallocate(T* slots, size_type cap) noexcept
+    {
+        if(cap != 0)
+            this->get_alloc().deallocate(reinterpret_cast<slot_type*>(slots), slot_units(cap));
+    }
+    // 第 i 个控制字节置为 c，i 小于 group_width - 1 时同时写末尾复制的字节
+    void            set_ctrl(size_type i, fh_ctrl c) noexcept
+    {
+        ctrl_[i] = c;
+        ctrl_[((i - (group_width - 1)) & capacity_) + (group_width - 1)] = c;
+    }
+    void            reset_ctrl() noexcept
+    {
+        std::memset(ctrl_, fh_empty, capacity_ + group_width);
+        ctrl_[capacity_] = fh_sentinel;
+    }
+    void            destroy_slots() noexcept;
+
+    // hash 值的高位决定探测起点，低 7 位为 tag
+    static size_t   h1(size_t h) noexcept { return h >> 7; }
+    static fh_ctrl  h2(size_t h) noexcept { return static_cast<fh_ctrl>(h & 0x7F); }
+
+    // find：返回元素下标，没有时返回 capacity_
+    size_type       find_index(const key_type& key, size_t h) const;
+
+    // 从 h 的探测起点开始第一个空或已删除的槽
+    size_type       find_first_non_full(size_t h) const noexcept;
+
+    // 在空或已删除的槽 i 中构造元素
+    template <class ...Args>
+    void            emplace_at(size_type i, size_t h, Args&& ...args);
+
+    // 把 src 中的元素移动到未构造的 dst 中并析构 src
+    static void     transfer(T* dst, T* src) noexcept;
+
+    // 删除槽 i 的元素后设置控制字节
+    void            erase_meta(size_type i) noexcept;
+
+    // 没有空槽可用时扩容：已删除的槽较多时以原容量重建，否则容量加倍
+    void            rehash_and_grow()
+    {
+        if(capacity_ != 0 && size_ * 32 <= capacity_ * 25)
+            resize(capacity_);
+        else
+            resize(capacity_ != 0 ? capacity_ * 2 + 1 : normalize_capacity(0));
+    }
+    void            resize(size_type new_cap);
+
+}; // class flat_hashtable
+
+
+//***************************************************************************//
+//                             member functions                              //
+//***************************************************************************//
+
+// 复制构造函数 控制字节整段复制，元素复制到相同的槽中
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::flat_hashtable(const flat_hashtable& rhs)
+: alloc_base(rhs.get_alloc()), ctrl_(fh_empty_group()), slots_(nullptr), capacity_(0),
+  size_(0), growth_left_(0), hash_(rhs.hash_), equal_(rhs.equal_)
+{
+    if(rhs.size_ == 0)
+        return;
+    const size_type cap = rhs.capacity_;
+    T* slots = reinterpret_cast<T*>(this->get_alloc().allocate(slot_units(cap)));
+    fh_ctrl* ctrl = reinterpret_cast<fh_ctrl*>(reinterpret_cast<slot_type*>(slots) + cap);
+    size_type i = 0;
+    try {
+        for(; i < cap; ++i)
+            if(fh_is_full(rhs.ctrl_[i]))
+                deonSTL::construct(slots + i, rhs.slots_[i]);
+    } catch (...) {
+        while(i-- > 0)
+            if(fh_is_full(rhs.ctrl_[i]))
+                deonSTL::destroy(slots + i);
+        deallocate(slots, cap);
+        throw;
+    }
+    std::memcpy(ctrl, rhs.ctrl_, cap + group_width);
+    ctrl_ = ctrl;
+    slots_ = slots;
+    capacity_ = cap;
+    size_ = rhs.size_;
+    growth_left_ = rhs.growth_left_;
+}
+
+// 移动构造函数 接管槽数组，rhs 变为未申请空间的空容器
+template <class T, class Hash, class KeyEqual, class Alloc>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::flat_hashtable(flat_hashtable&& rhs) noexcept
+: alloc_base(rhs.get_alloc()), ctrl_(rhs.ctrl_), slots_(rhs.slots_), capacity_(rhs.capacity_),
+  size_(rhs.size_), growth_left_(rhs.growth_left_), hash_(rhs.hash_), equal_(rhs.equal_)
+{
+    rhs.ctrl_ = fh_empty_group();
+    rhs.slots_ = nullptr;
+    rhs.capacity_ = 0;
+    rhs.size_ = 0;
+    rhs.growth_left_ = 0;
+}
+
+// try_emplace_unique 探测到有空槽的组为止：找到相等的键则返回，否则插入到第一个空或已删除的槽中
+// 没有剩余的空槽、并且这个槽不是已删除的槽时先扩容
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+deonSTL::pair<typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual, Alloc>::try_emplace_unique(const key_type& key, Args&& ...args)
+{
+    const size_t h = hash_of(key);
+    const size_type found = find_index(key, h);
+    if(found != capacity_)
+        return deonSTL::pair<iterator, bool>(iterator(ctrl_ + found, slots_ + found), false);
+    size_type i = find_first_non_full(h);
+    if(growth_left_ == 0 && ctrl_[i] != fh_deleted)
+    {// args 可能引用表中的元素，扩容之前先构造
+        value_type tmp(std::forward<Args>(args)...);
+        rehash_and_grow();
+        i = find_first_non_full(h);
+        emplace_at(i, h, std::move(tmp));
+    }
+    else
+        emplace_at(i, h, std::forward<Args>(args)...);
+    return deonSTL::pair<iterator, bool>(iterator(ctrl_ + i, slots_ + i), true);
+}
+
+// erase 其他元素不移动，从 pos 向后找下一个元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator
+flat_hashtable<T, Hash, KeyEqual, Alloc>::erase(const_iterator pos)
+{
+    MY_DEBUG(pos != end() && fh_is_full(*pos.ctrl));
+    const size_type i = static_cast<size_type>(pos.slot - slots_);
+    deonSTL::destroy(slots_ + i);
+    erase_meta(i);
+    iterator it(ctrl_ + i, slots_ + i);
+    it.skip_empty_or_deleted();
+    return it;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::iterator
+flat_hashtable<T, Hash, KeyEqual, Alloc>::erase(const_iterator first, const_iterator last)
+{
+    iterator cur(first);
+    while(cur != last)
+        cur = erase(cur);
+    return cur;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::erase_unique(const key_type& key)
+{
+    const size_type i = find_index(key, hash_of(key));
+    if(i == capacity_)
+        return 0;
+    deonSTL::destroy(slots_ + i);
+    erase_meta(i);
+    return 1;
+}
+
+// clear 析构所有元素，控制字节全部置空
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::clear() noexcept
+{
+    if(capacity_ == 0)
+        return;
+    destroy_slots();
+    reset_ctrl();
+    size_ = 0;
+    growth_left_ = capacity_to_growth(capacity_);
+}
+
+// swap 连同配置器一起交换
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::swap(flat_hashtable& rhs) noexcept
+{
+    if(this != &rhs)
+    {
+        std::swap(this->get_alloc(), rhs.get_alloc());
+        std::swap(ctrl_, rhs.ctrl_);
+        std::swap(slots_, rhs.slots_);
+        std::swap(capacity_, rhs.capacity_);
+        std::swap(size_, rhs.size_);
+        std::swap(growth_left_, rhs.growth_left_);
+        std::swap(hash_, rhs.hash_);
+        std::swap(equal_, rhs.equal_);
+    }
+}
+
+// rehash
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::rehash(size_type count)
+{
+    if(count == 0 && size_ == 0)
+    {
+        deallocate(slots_, capacity_);
+        ctrl_ = fh_empty_group();
+        slots_ = nullptr;
+        capacity_ = 0;
+        growth_left_ = 0;
+        return;
+    }
+    const size_type need = size_ != 0 ? growth_to_capacity(size_) : 0;
+    resize(normalize_capacity(count > need ? count : need));
+}
+
+// equal_to_unique 元素个数相同，并且每个元素都能在 other 中找到相等的元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool
+flat_hashtable<T, Hash, KeyEqual, Alloc>::equal_to_unique(const flat_hashtable& other) const
+{
+    if(size_ != other.size_)
+        return false;
+    for(const_iterator it = begin(); it != end(); ++it)
+    {
+        const_iterator p = other.find(value_traits::get_key(*it));
+        if(p == other.end() || !(*p == *it))
+            return false;
+    }
+    return true;
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+// destroy_slots 析构所有元素，不修改控制字节
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::destroy_slots() noexcept
+{
+    if(std::is_trivially_destructible<T>::value || size_ == 0)
+        return;
+    for(size_type i = 0; i < capacity_; ++i)
+        if(fh_is_full(ctrl_[i]))
+            deonSTL::destroy(slots_ + i);
+}
+
+// find_index 逐组比较 tag，只有 tag 相等的槽才比较键；组内有空槽时停止
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::find_index(const key_type& key, size_t h) const
+{
+    fh_probe seq(h1(h), capacity_);
+    while(true)
+    {
+        const fh_group g(ctrl_ + seq.offset);
+        for(typename fh_group::bitmask m = g.match(h2(h)); m; m.next())
+        {
+            const size_type i = seq.at(static_cast<size_type>(m.lowest()));
+            if(equal_(value_traits::get_key(slots_[i]), key))
+                return i;
+        }
+        if(g.match_empty())
+            return capacity_;
+        seq.next();
+    }
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename flat_hashtable<T, Hash, KeyEqual, Alloc>::size_type
+flat_hashtable<T, Hash, KeyEqual, Alloc>::find_first_non_full(size_t h) const noexcept
+{
+    fh_probe seq(h1(h), capacity_);
+    while(true)
+    {
+        const typename fh_group::bitmask m = fh_group(ctrl_ + seq.offset).match_empty_or_deleted();
+        if(m)
+            return seq.at(static_cast<size_type>(m.lowest()));
+        seq.next();
+    }
+}
+
+// emplace_at 构造成功后才设置控制字节，构造抛出异常时容器不变
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ...Args>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::emplace_at(size_type i, size_t h, Args&& ...args)
+{
+    deonSTL::construct(slots_ + i, std::forward<Args>(args)...);
+    if(ctrl_[i] == fh_empty)
+        --growth_left_;
+    set_ctrl(i, h2(h));
+    ++size_;
+}
+
+// transfer 搬移一个元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::transfer(T* dst, T* src) noexcept
+{
+    deonSTL::construct(dst, std::move(*reinterpret_cast<movable_type*>(src)));
+    deonSTL::destroy(src);
+}
+
+// erase_meta 槽 i 前后各一组中都有空槽、并且 i 两侧连续的非空槽不足一组时，
+// 任何探测都不会因为这个槽是满的而越过它，可以直接置空；否则置为已删除
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::erase_meta(size_type i) noexcept
+{
+    const size_type before = (i - group_width) & capacity_;
+    const typename fh_group::bitmask empty_after = fh_group(ctrl_ + i).match_empty();
+    const typename fh_group::bitmask empty_before = fh_group(ctrl_ + before).match_empty();
+    const bool was_never_full = empty_before && empty_after &&
+        static_cast<size_type>(empty_after.trailing_zeros() + empty_before.leading_zeros()) < group_width;
+    set_ctrl(i, was_never_full ? fh_empty : fh_deleted);
+    if(was_never_full)
+        ++growth_left_;
+    --size_;
+}
+
+// resize 换成容量为 new_cap 的新数组，重新计算每个元素的 hash 并放到第一个空槽中
+// 元素的移动构造可能抛出异常时改为复制，复制失败时旧数组保持不变
+template <class T, class Hash, class KeyEqual, class Alloc>
+void
+flat_hashtable<T, Hash, KeyEqual, Alloc>::resize(size_type new_cap)
+{
+    MY_DEBUG(capacity_to_growth(new_cap) >= size_);
+    fh_ctrl* old_ctrl = ctrl_;
+    T* old_slots = slots_;
+    const size_type old_cap = capacity_;
+    const size_type old_growth = growth_left_;
+
+    slots_ = reinterpret_cast<T*>(this->get_alloc().allocate(slot_units(new_cap)));
+    ctrl_ = reinterpret_cast<fh_ctrl*>(reinterpret_cast<slot_type*>(slots_) + new_cap);
+    capacity_ = new_cap;
+    reset_ctrl();
+    growth_left_ = capacity_to_growth(new_cap) - size_;
+
+    size_type i = 0;
+    try {
+        for(; i < old_cap; ++i)
+        {
+            if(!fh_is_full(old_ctrl[i]))
+                continue;
+            const size_t h = hash_of(value_traits::get_key(old_slots[i]));
+            const size_type p = find_first_non_full(h);
+            if(nothrow_movable::value)
+                transfer(slots_ + p, old_slots + i);
+            else
+                deonSTL::construct(slots_ + p, old_slots[i]);
+            set_ctrl(p, h2(h));
+        }
+    } catch (...) {
+        destroy_slots();
+        deallocate(slots_, capacity_);
+        ctrl_ = old_ctrl;
+        slots_ = old_slots;
+        capacity_ = old_cap;
+        growth_left_ = old_growth;
+        throw;
+    }
+    if(!nothrow_movable::value)
+        for(i = 0; i < old_cap; ++i)
+            if(fh_is_full(old_ctrl[i]))
+                deonSTL::destroy(old_slots + i);
+    deallocate(old_slots, old_cap);
+}
+
+//***************************************************************************//
+//                             equal operator                                //
+//***************************************************************************//
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+void swap(flat_hashtable<T, Hash, KeyEqual, Alloc>& lhs, flat_hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// flat_hashtable 对象只保存指向槽数组的指针
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct is_trivially_relocatable<flat_hashtable<T, Hash, KeyEqual, Alloc>>
+: std::integral_constant<bool, is_trivially_relocatable<Alloc>::value &&
+                               is_trivially_relocatable<Hash>::value &&
+                               is_trivially_relocatable<KeyEqual>::value> {};
+
+} // namespace deonSTL
+
+#endif /* flat_hashtable_h */
@@ -0,0 +1,70 @@
+//
+//  growth_policy.h
+//  deonSTL
+//
+//  这个头文件包含 vector 的空间增长策略，作为 vector 的第三个模板参数
+//  growth_factor_1_5 : 每次增长为原来的 1.5 倍（缺省）
+//  growth_factor_2   : 每次增长为原来的 2 倍
+//  growth_size_class : 在另一个策略的基础上，把字节数向上取整到配置器的分级大小或整页
+//
+//  策略的要求：static size_t next_capacity(size_t cap, size_t need, size_t max_n, size_t elem_size)
+//  cap 为当前容量，need 为至少需要的容量（need > cap，need <= max_n），返回值在 [need, max_n] 之间
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef growth_policy_h
+#define growth_policy_h
+
+#include <cstddef>  // size_t
+
+namespace deonSTL {
+
+// 1.5 倍增长，释放的旧空间之和有机会被后面的申请复用
+struct growth_factor_1_5
+{
+    static size_t next_capacity(size_t cap, size_t need, size_t max_n, size_t /*elem_size*/)
+    {
+        if(cap > max_n - cap / 2)
+            return max_n;
+        const size_t grown = cap + cap / 2;
+        return grown < need ? need : grown;
+    }
+};
+
+// 2 倍增长，复制次数更少，空间浪费最多为一半
+struct growth_factor_2
+{
+    static size_t next_capacity(size_t cap, size_t need, size_t max_n, size_t /*elem_size*/)
+    {
+        if(cap > max_n - cap)
+            return max_n;
+        const size_t grown = cap * 2;
+        return grown < need ? need : grown;
+    }
+};
+
+// 先由 Base 决定容量，再把字节数向上取整：小于一页时取 ALIGN 的倍数（对应 pool_alloc 的分级），
+// 否则取 PAGE 的倍数，多出的零头原本就会被配置器浪费，不如留给 vector 使用
+template <class Base = growth_factor_1_5, size_t ALIGN = 16, size_t PAGE = 4096>
+struct growth_size_class
+{
+    static_assert((ALIGN & (ALIGN - 1)) == 0 && (PAGE & (PAGE - 1)) == 0,
+                  "ALIGN and PAGE must be powers of two");
+
+    static size_t next_capacity(size_t cap, size_t need, size_t max_n, size_t elem_size)
+    {
+        const size_t n = Base::next_capacity(cap, need, max_n, elem_size);
+        if(n > (static_cast<size_t>(-1) - PAGE) / elem_size)
+            return n;   // 取整后字节数会溢出
+        const size_t bytes = n * elem_size;
+        const size_t unit = bytes < PAGE ? ALIGN : PAGE;
+        const size_t rounded = ((bytes + unit - 1) & ~(unit - 1)) / elem_size;
+        return rounded > max_n ? max_n : rounded;
+    }
+};
+
+} // namespace deonSTL
+
+#endif /* growth_policy_h */
@@ -0,0 +1,343 @@
+//
+//  hash.h
+//  deonSTL
+//
+//  这个头文件包含 hash 函数族 deonSTL::hash 与标记 is_avalanching
+//  hash_int   : 64 位整数的混合函数，两次 64x64 -> 128 位乘法，每个输入位影响每个输出位
+//  hash_bytes : 字节串 hash，按 wyhash 的结构每次读 16 / 48 字节做 128 位乘法；
+//               有 AVX2 时超过 256 字节的串按 xxh3 的结构用 8 路 64 位累加器，每 64 字节两条向量乘法
+//               （因此有无 AVX2 的程序对长串的 hash 值不同，与 std::hash 一样只保证同一程序内一致）
+//
+//  deonSTL::hash<T> 对整数、指针、浮点数、std::string 给出充分混合的 hash 值，其他类型使用 std::hash
+//  is_avalanching<Hash> : Hash 的结果已经充分混合（Hash 中定义了 is_avalanching 类型），
+//                         哈希表可以省去自己的混合步骤；自定义的 hash 函数也可以这样加入
+//
+//  按小端读取内存，大端机上得到的是另一组 hash 值
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef hash_h
+#define hash_h
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t, uint64_t, uintptr_t
+#include <cstring>      // memcpy
+#include <functional>   // std::hash
+#include <string>
+#include <type_traits>
+
+// 长字节串的 8 路累加只在有 AVX2 时使用：SSE2 一次只能做两路 32 位乘法，不如逐次 128 位乘法快
+#ifndef DEONSTL_HASH_AVX2
+#if defined(__AVX2__)
+#define DEONSTL_HASH_AVX2 1
+#else
+#define DEONSTL_HASH_AVX2 0
+#endif
+#endif
+
+#if DEONSTL_HASH_AVX2
+#include <immintrin.h>
+#endif
+
+namespace deonSTL{
+
+//***************************************************************************//
+//                                 基本操作                                    //
+//***************************************************************************//
+
+// 64x64 -> 128 位乘法，返回积的低 64 位与高 64 位的异或
+inline uint64_t __hash_mum(uint64_t a, uint64_t b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 m = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64);
+#else
+    const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+inline uint64_t __hash_read8(const unsigned char* p) noexcept
+{
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t __hash_read4(const unsigned char* p) noexcept
+{
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// 1 ~ 3 个字节：首、中、尾各取一个
+inline uint64_t __hash_read3(const unsigned char* p, size_t k) noexcept
+{
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+// 短字节串使用的常数（wyhash 的缺省 secret）
+const uint64_t __hash_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+//***************************************************************************//
+//                                 hash_int                                  //
+//***************************************************************************//
+
+// 两次“乘法后高低两半异或”：一次不够，输入的高位只影响积的高半部分
+inline uint64_t hash_int(uint64_t x) noexcept
+{
+    return __hash_mum(__hash_mum(x, 0x9E3779B97F4A7C15ull) ^ __hash_secret[0], __hash_secret[1]);
+}
+
+//***************************************************************************//
+//                                hash_bytes                                 //
+//***************************************************************************//
+
+#if DEONSTL_HASH_AVX2
+
+// 长字节串使用的 128 字节常数，每 64 字节的一段从不同的偏移处取 64 字节
+alignas(32) const uint64_t __hash_long_secret[16] = {
+    0x2cb0f69f4abea221ull, 0x9417034723148989ull, 0xdd555950609dfe03ull, 0xdbafb150deb12800ull,
+    0x7e789b2e6c442cb6ull, 0xf41e5636c7e4f8c4ull, 0x0959d150f8fba7e4ull, 0xa97316f13cdb9eeaull,
+    0x74cd8258f9520068ull, 0x55c74a62e116868bull, 0xd2f4c799a2023cbdull, 0xdf98cb79a37b51b9ull,
+    0x396f5885524f3905ull, 0xaf1d56386ca3b276ull, 0xa9ffbe6b5104e85aull, 0x6bd0c51b9fd533b3ull};
+
+const size_t   __hash_long_threshold = 256;                 // 超过这个长度使用 8 路累加器
+const size_t   __hash_stripe = 64;                          // 每次累加的字节数
+const size_t   __hash_secret_bytes = sizeof(__hash_long_secret);
+const size_t   __hash_block_stripes = (__hash_secret_bytes - __hash_stripe) / 8;   // 每块 8 段，之后打乱一次
+const uint64_t __hash_prime32 = 0x9E3779B1ull;
+
+// 长字节串：8 路累加器，每路 acc[i] += 相邻一路的数据 + (数据 ^ 常数) 的低 32 位 x 高 32 位
+// 每 8 段之后打乱一次：acc = (acc ^ acc >> 47 ^ 常数) * prime32，避免高位长期不参与乘法
+// 累加函数一次处理连续的 stripes 段（第 s 段的常数从 secret + 8s 处取），累加器在此期间留在寄存器中：
+// 逐段写回 acc 的话编译器必须假定它与输入重叠，每段都要重新读写
+
+// 一路 256 位：acc + (key 的低 32 位 x 高 32 位) + 交换两半的 data
+inline __m256i __hash_accumulate_lane(__m256i acc, const unsigned char* p, const unsigned char* secret) noexcept
+{
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret)));
+    const __m256i prod = _mm256_mul_epu32(key, _mm256_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+    return _mm256_add_epi64(acc, _mm256_add_epi64(prod, _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+inline void __hash_accumulate(uint64_t* acc, const unsigned char* p, size_t stripes,
+                              const unsigned char* secret) noexcept
+{
+    __m256i* a = reinterpret_cast<__m256i*>(acc);
+    __m256i v0 = _mm256_loadu_si256(a), v1 = _mm256_loadu_si256(a + 1);
+    for(size_t s = 0; s < stripes; ++s, p += __hash_stripe, secret += 8)
+    {
+        v0 = __hash_accumulate_lane(v0, p, secret);
+        v1 = __hash_accumulate_lane(v1, p + 32, secret + 32);
+    }
+    _mm256_storeu_si256(a, v0);
+    _mm256_storeu_si256(a + 1, v1);
+}
+
+inline void __hash_scramble(uint64_t* acc, const unsigned char* secret) noexcept
+{
+    __m256i* a = reinterpret_cast<__m256i*>(acc);
+    const __m256i prime = _mm256_set1_epi32(static_cast<int>(__hash_prime32));
+    for(size_t j = 0; j < 2; ++j)
+    {
+        __m256i v = _mm256_loadu_si256(a + j);
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 47));
+        v = _mm256_xor_si256(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + j));
+        const __m256i lo = _mm256_mul_epu32(v, prime);
+        const __m256i hi = _mm256_mul_epu32(_mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm256_storeu_si256(a + j, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+    }
+}
+
+// 长字节串（len > 256）：整块累加后打乱，最后不足一块的部分逐段累加，最后一段取末尾的 64 字节
+inline uint64_t __hash_long(const unsigned char* p, size_t len, uint64_t seed) noexcept
+{
+    const unsigned char* secret = reinterpret_cast<const unsigned char*>(__hash_long_secret);
+    alignas(32) uint64_t acc[8] = {
+        __hash_secret[0], __hash_secret[1] ^ seed, __hash_secret[2], __hash_secret[3] ^ seed,
+        __hash_secret[0] ^ seed, __hash_secret[1], __hash_secret[2] ^ seed, __hash_secret[3]};
+    const size_t block = __hash_stripe * __hash_block_stripes;
+    const size_t blocks = (len - 1) / block;
+    for(size_t b = 0; b < blocks; ++b)
+    {
+        __hash_accumulate(acc, p + b * block, __hash_block_stripes, secret);
+        __hash_scramble(acc, secret + __hash_secret_bytes - __hash_stripe);
+    }
+    const size_t stripes = ((len - 1) - blocks * block) / __hash_stripe;
+    __hash_accumulate(acc, p + blocks * block, stripes, secret);
+    __hash_accumulate(acc, p + len - __hash_stripe, 1, secret + __hash_secret_bytes - __hash_stripe - 7);
+
+    uint64_t h = len * 0x9E3779B97F4A7C15ull;
+    for(size_t i = 0; i < 8; i += 2)
+        h += __hash_mum(acc[i] ^ __hash_read8(secret + 11 + 8 * i), acc[i + 1] ^ __hash_read8(secret + 19 + 8 * i));
+    return __hash_mum(h ^ (h >> 37), __hash_secret[2]) ^ seed;
+}
+
+#endif // DEONSTL_HASH_AVX2
+
+// hash_bytes 任意字节串
+// 不超过 16 字节时首尾重叠地读两个 4 字节（或 1 ~ 3 字节）的值，更长时每次 16 字节（超过 48 字节时 3 路并行）
+inline uint64_t hash_bytes(const void* key, size_t len, uint64_t seed = 0) noexcept
+{
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+#if DEONSTL_HASH_AVX2
+    if(len > __hash_long_threshold)
+        return __hash_long(p, len, seed);
+#endif
+    seed ^= __hash_mum(seed ^ __hash_secret[0], __hash_secret[1]);
+    uint64_t a, b;
+    if(len <= 16)
+    {
+        if(len >= 4)
+        {
+            a = (__hash_read4(p) << 32) | __hash_read4(p + ((len >> 3) << 2));
+            b = (__hash_read4(p + len - 4) << 32) | __hash_read4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if(len > 0)
+        {
+            a = __hash_read3(p, len);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        size_t i = len;
+        if(i > 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = __hash_mum(__hash_read8(p) ^ __hash_secret[1], __hash_read8(p + 8) ^ seed);
+                see1 = __hash_mum(__hash_read8(p + 16) ^ __hash_secret[2], __hash_read8(p + 24) ^ see1);
+                see2 = __hash_mum(__hash_read8(p + 32) ^ __hash_secret[3], __hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16)
+        {
+            seed = __hash_mum(__hash_read8(p) ^ __hash_secret[1], __hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = __hash_read8(p + i - 16);
+        b = __hash_read8(p + i - 8);
+    }
+    a ^= __hash_secret[1];
+    b ^= seed;
+    return __hash_mum(__hash_mum(a, b) ^ __hash_secret[0] ^ len, b ^ __hash_secret[1]);
+}
+
+//***************************************************************************//
+//                               is_avalanching                              //
+//***************************************************************************//
+
+template <class T>
+struct __hash_void { typedef void type; };
+
+// Hash 中定义了 is_avalanching 类型时为 true_type
+template <class Hash, class = void>
+struct is_avalanching : std::false_type {};
+
+template <class Hash>
+struct is_avalanching<Hash, typename __hash_void<typename Hash::is_avalanching>::type>
+: std::true_type {};
+
+//***************************************************************************//
+//                                   hash                                    //
+//***************************************************************************//
+
+// 没有特化的类型使用 std::hash，不标记 is_avalanching
+template <class T>
+struct hash : public std::hash<T> {};
+
+// 整数：先转换为 64 位再混合，相等的值（不论符号）得到相同的 hash 值
+template <class T>
+struct __hash_integer
+{
+    typedef void is_avalanching;
+
+    size_t operator()(T x) const noexcept
+    { return static_cast<size_t>(hash_int(static_cast<uint64_t>(x))); }
+};
+
+template <> struct hash<bool>               : __hash_integer<bool> {};
+template <> struct hash<char>               : __hash_integer<char> {};
+template <> struct hash<signed char>        : __hash_integer<signed char> {};
+template <> struct hash<unsigned char>      : __hash_integer<unsigned char> {};
+template <> struct hash<wchar_t>            : __hash_integer<wchar_t> {};
+template <> struct hash<char16_t>           : __hash_integer<char16_t> {};
+template <> struct hash<char32_t>           : __hash_integer<char32_t> {};
+template <> struct hash<short>              : __hash_integer<short> {};
+template <> struct hash<unsigned short>     : __hash_integer<unsigned short> {};
+template <> struct hash<int>                : __hash_integer<int> {};
+template <> struct hash<unsigned int>       : __hash_integer<unsigned int> {};
+template <> struct hash<long>               : __hash_integer<long> {};
+template <> struct hash<unsigned long>      : __hash_integer<unsigned long> {};
+template <> struct hash<long long>          : __hash_integer<long long> {};
+template <> struct hash<unsigned long long> : __hash_integer<unsigned long long> {};
+
+template <class T>
+struct hash<T*>
+{
+    typedef void is_avalanching;
+
+    size_t operator()(T* p) const noexcept
+    { return static_cast<size_t>(hash_int(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)))); }
+};
+
+// 浮点数：按位混合，+0.0 与 -0.0 相等，hash 值也相同
+template <>
+struct hash<float>
+{
+    typedef void is_avalanching;
+
+    size_t operator()(float x) const noexcept
+    {
+        uint32_t bits = 0;
+        if(x != 0.0f)
+            std::memcpy(&bits, &x, sizeof(bits));
+        return static_cast<size_t>(hash_int(bits));
+    }
+};
+
+template <>
+struct hash<double>
+{
+    typedef void is_avalanching;
+
+    size_t operator()(double x) const noexcept
+    {
+        uint64_t bits = 0;
+        if(x != 0.0)
+            std::memcpy(&bits, &x, sizeof(bits));
+        return static_cast<size_t>(hash_int(bits));
+    }
+};
+
+template <class CharT, class Traits, class Alloc>
+struct hash<std::basic_string<CharT, Traits, Alloc>>
+{
+    typedef void is_avalanching;
+
+    size_t operator()(const std::basic_string<CharT, Traits, Alloc>& s) const noexcept
+    { return static_cast<size_t>(hash_bytes(s.data(), s.size() * sizeof(CharT))); }
+};
+
+} // namespace deonSTL
+
+#endif /* hash_h */
@@ -0,0 +1,180 @@
+//
+//  hash_policy.h
+//  deonSTL
+//
+//  这个头文件包含 hashtable 由 hash 值求桶下标的策略，作为 hashtable 的第五个模板参数
+//  ht_prime_mod     : 桶数取质数，下标为 h % n，每次查找一条 64 位除法
+//  ht_prime_fastmod : 桶数取质数，扩容时预先算出 n 的倒数，下标用两次乘法求出
+//  ht_pow2_mix      : 桶数取 2 的幂，h 乘以黄金分割常数后取最高的 log2(n) 位，一次乘法一次移位（缺省）
+//
+//  质数桶数对 hash 值的质量要求最低；2 的幂桶数最快，靠乘法混合弥补弱的 hash 函数
+//
+//  策略的要求：
+//  static size_t next_bucket_count(size_t n) 返回不小于 n 的合法桶数，超限则返回最大值
+//  static size_t max_bucket_count()
+//  explicit Policy(size_t n)                 桶数为 n（next_bucket_count 的返回值）时的状态，缺省构造对应 0 个桶
+//  size_t index(size_t h) const              hash 值为 h 的元素所在的桶，小于 n；0 个桶时不会调用
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef hash_policy_h
+#define hash_policy_h
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t, uint64_t
+#include <algorithm>    // lower_bound
+#include <type_traits>  // true_type, false_type
+
+namespace deonSTL {
+
+// size_t 在32位机上定义为32位，64位机上为64位
+#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
+#define SYSTEM_64 1
+#else
+#define SYSTEM_32 1
+#endif
+
+// bucket 大小
+// 为什么是constexpr数组❓
+#ifdef SYSTEM_64
+
+#define PRIME_NUM 99
+
+static constexpr size_t ht_prime_list[] = {
+  101ull, 173ull, 263ull, 397ull, 599ull, 907ull, 1361ull, 2053ull, 3083ull,
+  4637ull, 6959ull, 10453ull, 15683ull, 23531ull, 35311ull, 52967ull, 79451ull,
+  119179ull, 178781ull, 268189ull, 402299ull, 603457ull, 905189ull, 1357787ull,
+  2036687ull, 3055043ull, 4582577ull, 6873871ull, 10310819ull, 15466229ull,
+  23199347ull, 34799021ull, 52198537ull, 78297827ull, 117446801ull, 176170229ull,
+  264255353ull, 396383041ull, 594574583ull, 891861923ull, 1337792887ull,
+  2006689337ull, 3010034021ull, 4515051137ull, 6772576709ull, 10158865069ull,
+  15238297621ull, 22857446471ull, 34286169707ull, 51429254599ull, 77143881917ull,
+  115715822899ull, 173573734363ull, 260360601547ull, 390540902329ull,
+  585811353559ull, 878717030339ull, 1318075545511ull, 1977113318311ull,
+  2965669977497ull, 4448504966249ull, 6672757449409ull, 10009136174239ull,
+  15013704261371ull, 22520556392057ull, 33780834588157ull, 50671251882247ull,
+  76006877823377ull, 114010316735089ull, 171015475102649ull, 256523212653977ull,
+  384784818980971ull, 577177228471507ull, 865765842707309ull, 1298648764060979ull,
+  1947973146091477ull, 2921959719137273ull, 4382939578705967ull, 6574409368058969ull,
+  9861614052088471ull, 14792421078132871ull, 22188631617199337ull, 33282947425799017ull,
+  49924421138698549ull, 74886631708047827ull, 112329947562071807ull, 168494921343107851ull,
+  252742382014661767ull, 379113573021992729ull, 568670359532989111ull, 853005539299483657ull,
+  1279508308949225477ull, 1919262463423838231ull, 2878893695135757317ull, 4318340542703636011ull,
+  6477510814055453699ull, 9716266221083181299ull, 14574399331624771603ull, 18446744073709551557ull
+};
+
+#else
+
+#define PRIME_NUM 44
+
+static constexpr size_t ht_prime_list[] = {
+  101u, 173u, 263u, 397u, 599u, 907u, 1361u, 2053u, 3083u, 4637u, 6959u,
+  10453u, 15683u, 23531u, 35311u, 52967u, 79451u, 119179u, 178781u, 268189u,
+  402299u, 603457u, 905189u, 1357787u, 2036687u, 3055043u, 4582577u, 6873871u,
+  10310819u, 15466229u, 23199347u, 34799021u, 52198537u, 78297827u, 117446801u,
+  176170229u, 264255353u, 396383041u, 594574583u, 891861923u, 1337792887u,
+  2006689337u, 3010034021u, 4294967291u,
+};
+
+#endif
+
+// 找出大于等于n的质数，超限则返回最大值
+inline size_t ht_next_prime(size_t n)
+{
+    const size_t* first = ht_prime_list;
+    const size_t* last = ht_prime_list + PRIME_NUM;
+    const size_t* pos = std::lower_bound(first, last, n);
+    return pos == last ? *(last - 1) : *pos;
+}
+
+// 质数桶数，直接取模
+struct ht_prime_mod
+{
+    size_t n_;
+
+    explicit ht_prime_mod(size_t n = 0) : n_(n) {}
+
+    static size_t next_bucket_count(size_t n) { return ht_next_prime(n); }
+    static size_t max_bucket_count() { return ht_prime_list[PRIME_NUM - 1]; }
+
+    size_t index(size_t h) const noexcept { return h % n_; }
+};
+
+// 质数桶数，用乘法代替取模（Lemire 的 fastmod）：
+// m = ceil(2^64 / n)，a < 2^32 时 a % n 等于 (m * a mod 2^64) * n 的高 64 位
+// hash 值先把高 32 位异或到低 32 位上；桶数超过 2^32 或没有 128 位乘法时退回取模
+struct ht_prime_fastmod
+{
+    size_t   n_;
+    uint64_t m_;    // 0 表示取模
+
+    explicit ht_prime_fastmod(size_t n = 0)
+    : n_(n), m_(0)
+    {
+#if defined(__SIZEOF_INT128__)
+        if(n > 1 && static_cast<uint64_t>(n) <= 0xFFFFFFFFull)
+            m_ = ~uint64_t(0) / n + 1;
+#endif
+    }
+
+    static size_t next_bucket_count(size_t n) { return ht_next_prime(n); }
+    static size_t max_bucket_count() { return ht_prime_list[PRIME_NUM - 1]; }
+
+    size_t index(size_t h) const noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        if(m_ != 0)
+        {
+            const uint64_t a = static_cast<uint32_t>(static_cast<uint64_t>(h) ^ (static_cast<uint64_t>(h) >> 32));
+            const uint64_t low = m_ * a;
+            return static_cast<size_t>((static_cast<unsigned __int128>(low) * n_) >> 64);
+        }
+#endif
+        return h % n_;
+    }
+};
+
+// 2 的幂桶数，Fibonacci hashing：乘法把 h 的所有位混合到高位，再取最高的 log2(n) 位
+// std::hash 对整数是恒等映射，直接取低位会让步长为 2 的幂的键落在少数桶中，所以必须先混合
+struct ht_pow2_mix
+{
+    unsigned shift_;    // 64 - log2(n)
+
+    explicit ht_pow2_mix(size_t n = 0)
+    : shift_(64)
+    {
+        for(size_t k = n; k > 1; k >>= 1)
+            --shift_;
+    }
+
+    static size_t next_bucket_count(size_t n)
+    {
+        size_t count = 8;
+        while(count < n && count < max_bucket_count())
+            count <<= 1;
+        return count;
+    }
+    static size_t max_bucket_count() { return (static_cast<size_t>(-1) >> 1) + 1; }
+
+    size_t index(size_t h) const noexcept
+    { return static_cast<size_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> shift_); }
+};
+
+// 求桶下标，第三个参数为 is_avalanching<Hash>
+// hash 值已充分混合时 ht_pow2_mix 直接取最高的 log2(n) 位，省去乘法；其他策略不受影响
+template <class Policy>
+size_t ht_bucket_index(const Policy& policy, size_t h, std::false_type) noexcept
+{ return policy.index(h); }
+
+template <class Policy>
+size_t ht_bucket_index(const Policy& policy, size_t h, std::true_type) noexcept
+{ return policy.index(h); }
+
+inline size_t ht_bucket_index(const ht_pow2_mix& policy, size_t h, std::true_type) noexcept
+{ return static_cast<size_t>((static_cast<uint64_t>(h) << (64 - 8 * sizeof(size_t))) >> policy.shift_); }
+
+} // namespace deonSTL
+
+#endif /* hash_policy_h */
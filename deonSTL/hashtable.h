@@ -4,6 +4,17 @@
 //
 //  这个头文件包含模板类 hashtable
 //
+//  开放定址：元素直接存放在槽数组中，不为每个元素单独申请节点；冲突用线性探测解决，并采用 Robin Hood 规则
+//  （插入时越过离自己的桶更近的元素），因此槽数组中的元素按所在的桶升序排列：
+//  同一个桶的元素连续存放，相等的键也连续存放（multi 版本的 equal_range 为一段连续的槽）
+//  删除时把后面离桶有距离的元素依次前移一格（backward shift），不需要墓碑
+//
+//  探测不回绕到数组开头：最后一个桶之后有 tail 个溢出槽，再之后是一个永远为空的哨兵槽，
+//  溢出槽不够用时只加倍溢出槽（元素位置不变）
+//  每个槽保存元素的 hash 值与到所在桶的距离，扩容时不需要重新计算 hash，比较键之前先比较 hash
+//
+//  元素在槽之间搬移时使用移动构造（map 的键也移动），要求元素的移动构造不抛出异常
+//
 //  Created by 郭松楠 on 2020/4/26.
 //  Copyright © 2020 郭松楠. All rights reserved.
 //
@@ -11,31 +22,33 @@
 #ifndef hashtable_h
 #define hashtable_h
 
+#include <cstdint>      // uint32_t
+#include <cstring>      // memcpy, memmove
+#include <new>          // placement new
+#include <utility>      // move, forward
+#include <type_traits>  // aligned_storage
 #include "iterator.h"
 #include "type_traits.h"
 #include "allocator.h"
-#include "vector.h"
+#include "construct.h"
 #include "util.h"
 #include "exceptdef.h"
+#include "hash_policy.h"
+#include "hash.h"       // is_avalanching
 #include <algorithm>
 
 namespace deonSTL {
 
-// hashtable 节点，单向链表节点
+// hashtable 的槽，元素直接存放在槽中
 template <class T>
-struct hashtable_node
+struct hashtable_slot
 {
-  hashtable_node* next;   // 指向下一个节点
-  T               value;  // 储存实值
+    size_t      hash;   // 元素的 hash 值
+    uint32_t    dist;   // 到所在桶的距离 + 1，0 表示空槽
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
 
-  hashtable_node() = default;
-  hashtable_node(const T& n) :next(nullptr), value(n) {}
-
-  hashtable_node(const hashtable_node& node) :next(node.next), value(node.value) {}
-  hashtable_node(hashtable_node&& node) :next(node.next), value(std::move(node.value))
-  {
-    node.next = nullptr;
-  }
+    T*       value_ptr()       noexcept { return reinterpret_cast<T*>(&storage); }
+    const T* value_ptr() const noexcept { return reinterpret_cast<const T*>(&storage); }
 };
 
 // 有必要❓
@@ -47,6 +60,7 @@ struct ht_value_traits_imp
   typedef T key_type;
   typedef T mapped_type;
   typedef T value_type;
+  typedef T movable_type;
 
   template <class Ty>
   static const key_type& get_key(const Ty& value)
@@ -67,6 +81,8 @@ struct ht_value_traits_imp<T, true>
   typedef typename std::remove_cv<typename T::first_type>::type key_type;
   typedef typename T::second_type                               mapped_type;
   typedef T                                                     value_type;
+  // 元素为 pair<const K, V>，移动构造会复制键，在槽之间搬移时改按布局相同的 pair<K, V> 移动
+  typedef deonSTL::pair<key_type, mapped_type>                  movable_type;
 
   template <class Ty>
   static const key_type& get_key(const Ty& value)
@@ -91,6 +107,7 @@ struct ht_value_traits
   typedef typename value_traits_type::key_type    key_type;
   typedef typename value_traits_type::mapped_type mapped_type;
   typedef typename value_traits_type::value_type  value_type;
+  typedef typename value_traits_type::movable_type movable_type;
 
   template <class Ty>
   static const key_type& get_key(const Ty& value)
@@ -105,120 +122,126 @@ struct ht_value_traits
   }
 };
 
+// 延迟构造的值：转换为 T 时才调用 make 构造
+// unordered_map 的 try_emplace、flat_hash_map 的 operator[] 把它作为 mapped_type 的参数传给 hashtable，
+// 键已存在时不会构造
+template <class T, class F>
+struct ht_deferred_value
+{
+    F make;
+
+    operator T() const { return make(); }
+};
+
+template <class T, class F>
+ht_deferred_value<T, F> ht_defer(F make)
+{ return ht_deferred_value<T, F>{make}; }
+
+
 // forward declarations
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class Policy>
 class hashtable;
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class Policy>
 struct ht_iterator;
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc, class Policy>
 struct ht_const_iterator;
 template <class T>
 struct ht_local_iterator;
 template <class T>
 struct ht_const_local_iterator;
+template <class T, class HashFun, class KeyEqual, class Alloc, class Policy>
+class incremental_hashtable;
 
 // ht_iterator
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
 struct ht_iterator_base : public deonSTL::iterator<forward_iterator_tag, T>
 {
-    typedef deonSTL::hashtable<T, Hash, KeyEqual>           hashtable;
-    typedef ht_iterator_base<T, Hash, KeyEqual>             base;
-    typedef deonSTL::ht_iterator<T, Hash, KeyEqual>         iterator;
-    typedef deonSTL::ht_const_iterator<T, Hash, KeyEqual>   const_iterator;
-    typedef hashtable_node<T>*                              node_ptr;
+    typedef deonSTL::hashtable<T, Hash, KeyEqual, Alloc, Policy>          hashtable;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, Policy>            base;
+    typedef deonSTL::ht_iterator<T, Hash, KeyEqual, Alloc, Policy>        iterator;
+    typedef deonSTL::ht_const_iterator<T, Hash, KeyEqual, Alloc, Policy>  const_iterator;
+    typedef hashtable_slot<T>*                              slot_ptr;
     typedef hashtable*                                      contain_ptr;
-    typedef const node_ptr                                  const_node_ptr;
-    typedef const contain_ptr                               const_contain_ptr;
-    
+
     typedef size_t                                          size_type;
     typedef ptrdiff_t                                       difference_type;
-    
-    node_ptr    node;   // 迭代器所指节点
+
+    slot_ptr    slot;   // 迭代器所指的槽
     contain_ptr ht;     // 迭代器关联的容器
-    
+
     ht_iterator_base() = default;
-    
-    bool operator==(const base& rhs) const { return node == rhs.node; }
-    bool operator!=(const base& rhs) const { return node != rhs.node; }
+
+    bool operator==(const base& rhs) const { return slot == rhs.slot; }
+    bool operator!=(const base& rhs) const { return slot != rhs.slot; }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual, Alloc, Policy>
 {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, Policy> base;
     typedef typename base::hashtable            hashtable;
     typedef typename base::iterator             iterator;
     typedef typename base::const_iterator       const_iterator;
-    typedef typename base::node_ptr             node_ptr;
+    typedef typename base::slot_ptr             slot_ptr;
     typedef typename base::contain_ptr          contain_ptr;
-    
-    typedef ht_value_traits<T>                  value_traits;
+
     typedef T                                   value_type;
     typedef value_type*                         pointer;
     typedef value_type&                         reference;
-    
-    using base::node;
+
+    using base::slot;
     using base::ht;
-    
+
     ht_iterator() = default;
-    
-    ht_iterator(node_ptr n, contain_ptr t)
+
+    ht_iterator(slot_ptr s, contain_ptr t)
     {
-        node = n;
+        slot = s;
         ht = t;
     }
-    
+
     ht_iterator(const iterator& rhs)
     {
-        node = rhs.node;
+        slot = rhs.slot;
         ht = rhs.ht;
     }
-    
+
     ht_iterator(const const_iterator& rhs) // const --> non-const
     {
-        node = rhs.node;
+        slot = rhs.slot;
         ht = rhs.ht;
     }
-    
+
     iterator& operator=(const iterator& rhs)
     {
         if(this != &rhs)
         {
-            node = rhs.node;
+            slot = rhs.slot;
             ht = rhs.ht;
         }
         return *this;
     }
-    
+
     iterator& operator=(const const_iterator& rhs) // const --> non-const
     {
-        if(this != &rhs)
-        {
-            node = rhs.node;
-            ht = rhs.ht;
-        }
+        slot = rhs.slot;
+        ht = rhs.ht;
         return *this;
     }
-    
-    reference operator*()  const { return node->value; }
+
+    reference operator*()  const { return *slot->value_ptr(); }
     pointer   operator->() const { return &(operator*()); }
-    
+
+    // 跳过空槽，直到下一个元素或者槽数组的末尾
     iterator& operator++()
     {
-        MY_DEBUG(node != nullptr);
-        const node_ptr old = node;
-        node = node->next;
-        if(node == nullptr)
-        {
-            auto index = ht->hash(value_traits::get_key(node->value));
-            while(!node && ++index < ht->bucket_size_)
-                node = ht->buckets_[index];
-        }
+        MY_DEBUG(slot != ht->slots_end());
+        slot = ht->skip_empty(slot + 1);
         return *this;
     }
-    
+
     iterator operator++(int)
     {
         iterator tmp = *this;
@@ -228,87 +251,81 @@ struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual>
 };
 
 // ht_const_iterator
-template <class T, class Hash, class KeyEqual>
-struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual>
-{
-  typedef ht_iterator_base<T, Hash, KeyEqual> base;
-  typedef typename base::hashtable            hashtable;
-  typedef typename base::iterator             iterator;
-  typedef typename base::const_iterator       const_iterator;
-  typedef typename base::const_node_ptr       node_ptr;
-  typedef typename base::const_contain_ptr    contain_ptr;
-
-  typedef ht_value_traits<T>                  value_traits;
-  typedef T                                   value_type;
-  typedef const value_type*                   pointer;      // const
-  typedef const value_type&                   reference;    // const
-
-  using base::node;
-  using base::ht;
-
-  ht_const_iterator() = default;
-  ht_const_iterator(node_ptr n, contain_ptr t)
-  {
-    node = n;
-    ht = t;
-  }
-  ht_const_iterator(const iterator& rhs) // non-const --> const
-  {
-    node = rhs.node;
-    ht = rhs.ht;
-  }
-  ht_const_iterator(const const_iterator& rhs)
-  {
-    node = rhs.node;
-    ht = rhs.ht;
-  }
-  const_iterator& operator=(const iterator& rhs) // non-const --> const
-  {
-    if (this != &rhs)
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual, Alloc, Policy>
+{
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc, Policy> base;
+    typedef typename base::hashtable            hashtable;
+    typedef typename base::iterator             iterator;
+    typedef typename base::const_iterator       const_iterator;
+    typedef typename base::slot_ptr             slot_ptr;
+    typedef typename base::contain_ptr          contain_ptr;
+
+    typedef T                                   value_type;
+    typedef const value_type*                   pointer;      // const
+    typedef const value_type&                   reference;    // const
+
+    using base::slot;
+    using base::ht;
+
+    ht_const_iterator() = default;
+
+    ht_const_iterator(slot_ptr s, const hashtable* t)
     {
-      node = rhs.node;
-      ht = rhs.ht;
+        slot = s;
+        ht = const_cast<contain_ptr>(t);
     }
-    return *this;
-  }
-  const_iterator& operator=(const const_iterator& rhs)
-  {
-    if (this != &rhs)
+
+    ht_const_iterator(const iterator& rhs) // non-const --> const
     {
-      node = rhs.node;
-      ht = rhs.ht;
+        slot = rhs.slot;
+        ht = rhs.ht;
     }
-    return *this;
-  }
 
-  // 重载操作符
-  reference operator*()  const { return node->value; }
-  pointer   operator->() const { return &(operator*()); }
+    ht_const_iterator(const const_iterator& rhs)
+    {
+        slot = rhs.slot;
+        ht = rhs.ht;
+    }
 
-  const_iterator& operator++()
-  {
-    MY_DEBUG(node != nullptr);
-    const node_ptr old = node;
-    node = node->next;
-    if (node == nullptr)
-    { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-      auto index = ht->hash(value_traits::get_key(old->value));
-      while (!node && ++index < ht->bucket_size_)
-      {
-        node = ht->buckets_[index];
-      }
-    }
-    return *this;
-  }
-  const_iterator operator++(int)
-  {
-    const_iterator tmp = *this;
-    ++*this;
-    return tmp;
-  }
+    const_iterator& operator=(const iterator& rhs) // non-const --> const
+    {
+        slot = rhs.slot;
+        ht = rhs.ht;
+        return *this;
+    }
+
+    const_iterator& operator=(const const_iterator& rhs)
+    {
+        if(this != &rhs)
+        {
+            slot = rhs.slot;
+            ht = rhs.ht;
+        }
+        return *this;
+    }
+
+    // 重载操作符
+    reference operator*()  const { return *slot->value_ptr(); }
+    pointer   operator->() const { return &(operator*()); }
+
+    const_iterator& operator++()
+    {
+        MY_DEBUG(slot != ht->slots_end());
+        slot = ht->skip_empty(slot + 1);
+        return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+        const_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
 };
 
-// ht_local_iterator,链表上的iterator
+// ht_local_iterator，桶内的 iterator
+// 同一个桶的元素在槽数组中连续存放，桶内迭代只需要移动到下一个槽
 template <class T>
 struct ht_local_iterator : public deonSTL::iterator<forward_iterator_tag, T>
 {
@@ -317,163 +334,103 @@ struct ht_local_iterator : public deonSTL::iterator<forward_iterator_tag, T>
     typedef value_type&                reference;
     typedef size_t                     size_type;
     typedef ptrdiff_t                  difference_type;
-    typedef hashtable_node<T>*         node_ptr;
+    typedef hashtable_slot<T>*         slot_ptr;
 
     typedef ht_local_iterator<T>       self;
     typedef ht_local_iterator<T>       local_iterator;
     typedef ht_const_local_iterator<T> const_local_iterator;
-    
-    node_ptr node; // 指向链表节点的指针
-    
-    ht_local_iterator(node_ptr n)
-    : node(n) {}
-    
+
+    slot_ptr slot; // 指向桶内槽的指针
+
+    ht_local_iterator(slot_ptr s)
+    : slot(s) {}
+
     ht_local_iterator(const local_iterator& rhs)
-    : node(rhs.node) {}
-    
+    : slot(rhs.slot) {}
+
     ht_local_iterator(const const_local_iterator& rhs) // const --> non-const
-    : node(rhs.node) {}
-    
-    reference operator*()  const { return node->value; }
+    : slot(const_cast<slot_ptr>(rhs.slot)) {}
+
+    reference operator*()  const { return *slot->value_ptr(); }
     pointer   operator->() const { return &(operator*()); }
-    
+
     self& operator++()
     {
-        node = node->next;
+        ++slot;
         return *this;
     }
-    
+
     self operator++(int)
     {
-      self tmp(*this);
-      ++*this;
-      return tmp;
+        self tmp(*this);
+        ++*this;
+        return tmp;
     }
 
-    bool operator==(const self& other) const { return node == other.node; }
-    bool operator!=(const self& other) const { return node != other.node; }
+    bool operator==(const self& other) const { return slot == other.slot; }
+    bool operator!=(const self& other) const { return slot != other.slot; }
 };
 
-
 // ht_const_local_iterator
 
 template <class T>
 struct ht_const_local_iterator :public deonSTL::iterator<deonSTL::forward_iterator_tag, T>
 {
-  typedef T                          value_type;
-  typedef const value_type*          pointer;
-  typedef const value_type&          reference;
-  typedef size_t                     size_type;
-  typedef ptrdiff_t                  difference_type;
-  typedef const hashtable_node<T>*   node_ptr;
-
-  typedef ht_const_local_iterator<T> self;
-  typedef ht_local_iterator<T>       local_iterator;
-  typedef ht_const_local_iterator<T> const_local_iterator;
-
-  node_ptr node;
-
-  ht_const_local_iterator(node_ptr n)
-    :node(n)
-  {
-  }
-  ht_const_local_iterator(const local_iterator& rhs)
-    :node(rhs.node)
-  {
-  }
-  ht_const_local_iterator(const const_local_iterator& rhs)
-    :node(rhs.node)
-  {
-  }
+    typedef T                          value_type;
+    typedef const value_type*          pointer;
+    typedef const value_type&          reference;
+    typedef size_t                     size_type;
+    typedef ptrdiff_t                  difference_type;
+    typedef const hashtable_slot<T>*   slot_ptr;
 
-  reference operator*()  const { return node->value; }
-  pointer   operator->() const { return &(operator*()); }
+    typedef ht_const_local_iterator<T> self;
+    typedef ht_local_iterator<T>       local_iterator;
+    typedef ht_const_local_iterator<T> const_local_iterator;
 
-  self& operator++()
-  {
-    MY_DEBUG(node != nullptr);
-    node = node->next;
-    return *this;
-  }
+    slot_ptr slot;
 
-  self operator++(int)
-  {
-    self tmp(*this);
-    ++*this;
-    return tmp;
-  }
+    ht_const_local_iterator(slot_ptr s)
+    : slot(s) {}
 
-  bool operator==(const self& other) const { return node == other.node; }
-  bool operator!=(const self& other) const { return node != other.node; }
-};
+    ht_const_local_iterator(const local_iterator& rhs)
+    : slot(rhs.slot) {}
 
+    ht_const_local_iterator(const const_local_iterator& rhs)
+    : slot(rhs.slot) {}
 
-// size_t 在32位机上定义为32位，64位机上为64位
-#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
-#define SYSTEM_64 1
-#else
-#define SYSTEM_32 1
-#endif
-
-// bucket 大小
-// 为什么是constexpr数组❓
-#ifdef SYSTEM_64
-
-#define PRIME_NUM 99
-
-static constexpr size_t ht_prime_list[] = {
-  101ull, 173ull, 263ull, 397ull, 599ull, 907ull, 1361ull, 2053ull, 3083ull,
-  4637ull, 6959ull, 10453ull, 15683ull, 23531ull, 35311ull, 52967ull, 79451ull,
-  119179ull, 178781ull, 268189ull, 402299ull, 603457ull, 905189ull, 1357787ull,
-  2036687ull, 3055043ull, 4582577ull, 6873871ull, 10310819ull, 15466229ull,
-  23199347ull, 34799021ull, 52198537ull, 78297827ull, 117446801ull, 176170229ull,
-  264255353ull, 396383041ull, 594574583ull, 891861923ull, 1337792887ull,
-  2006689337ull, 3010034021ull, 4515051137ull, 6772576709ull, 10158865069ull,
-  15238297621ull, 22857446471ull, 34286169707ull, 51429254599ull, 77143881917ull,
-  115715822899ull, 173573734363ull, 260360601547ull, 390540902329ull,
-  585811353559ull, 878717030339ull, 1318075545511ull, 1977113318311ull,
-  2965669977497ull, 4448504966249ull, 6672757449409ull, 10009136174239ull,
-  15013704261371ull, 22520556392057ull, 33780834588157ull, 50671251882247ull,
-  76006877823377ull, 114010316735089ull, 171015475102649ull, 256523212653977ull,
-  384784818980971ull, 577177228471507ull, 865765842707309ull, 1298648764060979ull,
-  1947973146091477ull, 2921959719137273ull, 4382939578705967ull, 6574409368058969ull,
-  9861614052088471ull, 14792421078132871ull, 22188631617199337ull, 33282947425799017ull,
-  49924421138698549ull, 74886631708047827ull, 112329947562071807ull, 168494921343107851ull,
-  252742382014661767ull, 379113573021992729ull, 568670359532989111ull, 853005539299483657ull,
-  1279508308949225477ull, 1919262463423838231ull, 2878893695135757317ull, 4318340542703636011ull,
-  6477510814055453699ull, 9716266221083181299ull, 14574399331624771603ull, 18446744073709551557ull
-};
+    reference operator*()  const { return *slot->value_ptr(); }
+    pointer   operator->() const { return &(operator*()); }
 
-#else
+    self& operator++()
+    {
+        ++slot;
+        return *this;
+    }
 
-#define PRIME_NUM 44
+    self operator++(int)
+    {
+        self tmp(*this);
+        ++*this;
+        return tmp;
+    }
 
-static constexpr size_t ht_prime_list[] = {
-  101u, 173u, 263u, 397u, 599u, 907u, 1361u, 2053u, 3083u, 4637u, 6959u,
-  10453u, 15683u, 23531u, 35311u, 52967u, 79451u, 119179u, 178781u, 268189u,
-  402299u, 603457u, 905189u, 1357787u, 2036687u, 3055043u, 4582577u, 6873871u,
-  10310819u, 15466229u, 23199347u, 34799021u, 52198537u, 78297827u, 117446801u,
-  176170229u, 264255353u, 396383041u, 594574583u, 891861923u, 1337792887u,
-  2006689337u, 3010034021u, 4294967291u,
+    bool operator==(const self& other) const { return slot == other.slot; }
+    bool operator!=(const self& other) const { return slot != other.slot; }
 };
 
-#endif
-
-// 找出大于等于n的质数，超限则返回最大值
-inline size_t ht_next_prime(size_t n)
-{
-    const size_t* first = ht_prime_list;
-    const size_t* last = ht_prime_list + PRIME_NUM;
-    const size_t* pos = std::lower_bound(first, last, n);
-    return pos == last ? *(last - 1) : *pos;
-}
 
 // hashtable
-template <class T, class Hash, class KeyEqual>
-class hashtable
+// 参数四为空间配置器类型，槽数组的空间由它 rebind 得到的配置器申请
+// 参数五为由 hash 值求桶下标的策略，见 hash_policy.h
+template <class T, class Hash, class KeyEqual, class Alloc = deonSTL::allocator<T>,
+          class Policy = deonSTL::ht_pow2_mix>
+class hashtable : private deonSTL::alloc_holder<
+    typename Alloc::template rebind<hashtable_slot<T>>::other>
 {
-    // friend iterator
-    
+    friend struct deonSTL::ht_iterator<T, Hash, KeyEqual, Alloc, Policy>;
+    friend struct deonSTL::ht_const_iterator<T, Hash, KeyEqual, Alloc, Policy>;
+    friend class deonSTL::incremental_hashtable<T, Hash, KeyEqual, Alloc, Policy>;
+
 public:
     typedef ht_value_traits<T>                          value_traits;
     typedef typename value_traits::key_type             key_type;
@@ -481,92 +438,337 @@ public:
     typedef typename value_traits::value_type           value_type;
     typedef Hash                                        hasher;
     typedef KeyEqual                                    key_equal;
-    
-    typedef hashtable_node<T>                           node_type;
-    typedef node_type*                                  node_ptr;
-    // vector 作为hashtable容器，存储指向节点的指针
-    typedef deonSTL::vector<node_ptr>                   bucket_type;
-    
-    typedef deonSTL::allocator<T>                       allocator_type;
-    typedef deonSTL::allocator<T>                       data_allocator;
-    typedef deonSTL::allocator<node_type>               node_allocator;
-
-    typedef typename allocator_type::pointer            pointer;
-    typedef typename allocator_type::const_pointer      const_pointer;
-    typedef typename allocator_type::reference          reference;
-    typedef typename allocator_type::const_reference    const_reference;
-    typedef typename allocator_type::size_type          size_type;
-    typedef typename allocator_type::difference_type    difference_type;
-
-    typedef deonSTL::ht_iterator<T, Hash, KeyEqual>       iterator;
-    typedef deonSTL::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
+    typedef Policy                                      policy_type;
+
+    typedef hashtable_slot<T>                           slot_type;
+    typedef slot_type*                                  slot_ptr;
+
+    typedef Alloc                                                   allocator_type;
+    typedef typename Alloc::template rebind<T>::other               data_allocator;
+    typedef typename Alloc::template rebind<slot_type>::other       slot_allocator;
+
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef deonSTL::ht_iterator<T, Hash, KeyEqual, Alloc, Policy>       iterator;
+    typedef deonSTL::ht_const_iterator<T, Hash, KeyEqual, Alloc, Policy> const_iterator;
     typedef deonSTL::ht_local_iterator<T>                 local_iterator;
     typedef deonSTL::ht_const_local_iterator<T>           const_local_iterator;
 
 private:
-    bucket_type buckets_;     // 桶容器
-    size_type   bucket_size_; // 桶大小
+    typedef deonSTL::alloc_holder<slot_allocator>       alloc_base;
+    typedef deonSTL::is_trivially_relocatable<T>        relocatable;
+
+    typedef typename value_traits::movable_type         movable_type;
+    typedef std::integral_constant<bool,
+        std::is_nothrow_move_constructible<movable_type>::value> nothrow_movable;
+
+    static const size_type default_tail = 32;   // 缺省的溢出槽数
+
+    slot_ptr    slots_;       // 槽数组：bucket_size_ 个桶 + 溢出槽 + 1 个哨兵空槽，未申请时为空
+    size_type   bucket_size_; // 桶数
+    policy_type policy_;      // 桶数为 bucket_size_ 时求桶下标的策略
+    size_type   slot_size_;   // 桶与溢出槽的总数（不含哨兵），未申请时为 0
     size_type   size_;        // 元素数量
-    float       mlf_;
+    float       mlf_;         // 最大负载系数
     hasher      hash_;        // hash函数
     key_equal   equal_;       // 相等函数
-    
-    // private functions
-    
+
 public:
     // ====================构造、移动、赋值、析构操作==================== //
-    
-    
-    // ==========================成员函数============================ //
-    iterator        begin()           noexcept
+
+    explicit hashtable(size_type bucket_count = 0,
+                       const Hash& hash = Hash(),
+                       const KeyEqual& equal = KeyEqual(),
+                       const allocator_type& alloc = allocator_type())
+    : alloc_base(slot_allocator(alloc)), slots_(nullptr), bucket_size_(0), policy_(),
+      slot_size_(0), size_(0), mlf_(0.8f), hash_(hash), equal_(equal)
     {
-        for(size_type i = 0; i < bucket_size_; ++i)
-            if(buckets_[i]) return iterator(buckets_[i], this);
-        return iterator(nullptr, this);
+        if(bucket_count != 0)
+            rehash_to(Policy::next_bucket_count(bucket_count));
     }
-    const_iterator  begin()     const noexcept
+
+    hashtable(const hashtable& rhs);
+    hashtable(hashtable&& rhs) noexcept;
+
+    hashtable& operator=(const hashtable& rhs)
     {
-        for(size_type i = 0; i < bucket_size_; ++i)
-            if(buckets_[i]) return const_iterator(buckets_[i], const_cast<hashtable*>(this));
-        return iterator(nullptr, const_cast<hashtable*>(this));
+        if(this != &rhs)
+        {
+            hashtable tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
     }
+
+    hashtable& operator=(hashtable&& rhs) noexcept
+    {
+        hashtable tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~hashtable()
+    {
+        clear();
+        deallocate_slots(slots_, slot_size_);
+    }
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type  get_allocator() const
+    { return allocator_type(this->get_alloc()); }
+
+    iterator        begin()           noexcept
+    { return iterator(skip_empty(slots_), this); }
+    const_iterator  begin()     const noexcept
+    { return const_iterator(skip_empty(slots_), this); }
     iterator        end()             noexcept
-    { return iterator(nullptr, this); }
-    iterator        end()       const noexcept
-    { return const_iterator(nullptr, const_cast<hashtable*>(this)); }
-    
+    { return iterator(slots_end(), this); }
+    const_iterator  end()       const noexcept
+    { return const_iterator(slots_end(), this); }
+
+    const_iterator  cbegin()    const noexcept
+    { return begin(); }
+    const_iterator  cend()      const noexcept
+    { return end(); }
+
     bool            empty()     const noexcept
     { return size_ == 0; }
     size_type       size()      const noexcept
     { return size_; }
     size_type       max_size()  const noexcept
     { return static_cast<size_type>(-1); }
-    
+
     // emplace
-    
+    // 先构造出元素再查找插入位置
+    template <class ...Args>
+    iterator        emplace_multi(Args&& ...args)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        return insert_multi(std::move(tmp));
+    }
+
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> emplace_unique(Args&& ...args)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        return insert_unique(std::move(tmp));
+    }
+
+    // 键为 key 的元素不存在时才用 args 构造元素（args 构造出的元素的键应当等于 key）
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> try_emplace_unique(const key_type& key, Args&& ...args);
+
     // insert
-    
+    // 按值复制时先复制一份：插入前的搬移、扩容可能移动 value 所在的元素
+    iterator        insert_multi(const value_type& value)
+    { return emplace_multi(value); }
+    iterator        insert_multi(value_type&& value)
+    { return insert_multi_value(std::move(value)); }
+
+    deonSTL::pair<iterator, bool> insert_unique(const value_type& value)
+    { return try_emplace_unique(value_traits::get_key(value), value); }
+    deonSTL::pair<iterator, bool> insert_unique(value_type&& value)
+    { return try_emplace_unique(value_traits::get_key(value), std::move(value)); }
+
+    template <class InputIter>
+    void            insert_multi(InputIter first, InputIter last)
+    {
+        for(; first != last; ++first)
+            insert_multi(*first);
+    }
+
+    template <class InputIter>
+    void            insert_unique(InputIter first, InputIter last)
+    {
+        for(; first != last; ++first)
+            insert_unique(*first);
+    }
+
     // erase
-    
-    // clear
-    
+    // 后面的元素前移填补空位，返回原来在 pos 之后的第一个元素
+    iterator        erase(const_iterator pos);
+    iterator        erase(const_iterator first, const_iterator last);
+
+    size_type       erase_multi(const key_type& key);
+    size_type       erase_unique(const key_type& key);
+
+    // clear 保留槽数组
+    void            clear() noexcept;
+
     // swap
-    
+    void            swap(hashtable& rhs) noexcept;
+
     // count
-    
+    size_type       count_unique(const key_type& key) const
+    { return find_slot(key, hash_(key)) != nullptr ? 1 : 0; }
+    size_type       count_multi(const key_type& key) const;
+
     // find
-    
+    iterator        find(const key_type& key)
+    {
+        slot_ptr p = find_slot(key, hash_(key));
+        return p != nullptr ? iterator(p, this) : end();
+    }
+    const_iterator  find(const key_type& key) const
+    {
+        slot_ptr p = find_slot(key, hash_(key));
+        return p != nullptr ? const_iterator(p, this) : end();
+    }
+
     // equal_range
-    
+    deonSTL::pair<iterator, iterator>
+    equal_range_unique(const key_type& key);
+    deonSTL::pair<const_iterator, const_iterator>
+    equal_range_unique(const key_type& key) const;
+
+    deonSTL::pair<iterator, iterator>
+    equal_range_multi(const key_type& key);
+    deonSTL::pair<const_iterator, const_iterator>
+    equal_range_multi(const key_type& key) const;
+
     // bucket interface
-    
+    // 桶 n 的元素是从 begin(n) 开始的一段连续的槽
+    local_iterator          begin(size_type n) noexcept
+    { return local_iterator(bucket_first(n)); }
+    const_local_iterator    begin(size_type n) const noexcept
+    { return const_local_iterator(bucket_first(n)); }
+    const_local_iterator    cbegin(size_type n) const noexcept
+    { return const_local_iterator(bucket_first(n)); }
+
+    local_iterator          end(size_type n) noexcept
+    { return local_iterator(bucket_last(n)); }
+    const_local_iterator    end(size_type n) const noexcept
+    { return const_local_iterator(bucket_last(n)); }
+    const_local_iterator    cend(size_type n) const noexcept
+    { return const_local_iterator(bucket_last(n)); }
+
+    size_type       bucket_count()      const noexcept
+    { return bucket_size_; }
+    size_type       max_bucket_count()  const noexcept
+    { return Policy::max_bucket_count(); }
+
+    size_type       bucket_size(size_type n) const noexcept
+    { return static_cast<size_type>(bucket_last(n) - bucket_first(n)); }
+    size_type       bucket(const key_type& key) const
+    {
+        MY_DEBUG(bucket_size_ != 0);
+        return bucket_index(hash_(key));
+    }
+
+    // hash policy
+    float           load_factor() const noexcept
+    { return bucket_size_ != 0 ? static_cast<float>(size_) / bucket_size_ : 0.0f; }
+
+    float           max_load_factor() const noexcept
+    { return mlf_; }
+    // 开放定址要求负载系数小于 1
+    void            max_load_factor(float ml)
+    {
+        MY_DEBUG(ml > 0.0f && ml < 1.0f);
+        mlf_ = ml;
+        if(static_cast<float>(size_) > static_cast<float>(bucket_size_) * mlf_)
+            rehash(0);
+    }
+
+    // 桶数调整为不小于 count、并且能以最大负载系数容纳现有元素的质数
+    void            rehash(size_type count);
+
+    // 能容纳 count 个元素而不扩容
+    void            reserve(size_type count)
+    { rehash(static_cast<size_type>(static_cast<float>(count) / mlf_) + 1); }
+
+    hasher          hash_fcn() const { return hash_; }
+    key_equal       key_eq()   const { return equal_; }
+
+    // 比较两个容器的元素（顺序无关）
+    bool            equal_to_unique(const hashtable& other) const;
+    bool            equal_to_multi(const hashtable& other) const;
+
 private:
     // ==========================辅助函数============================ //
-    
-    
-    
-    
-    
+
+    // 槽数组
+    slot_ptr        allocate_slots(size_type count);
+    void            deallocate_slots(slot_ptr p, size_type count) noexcept
+    {
+        if(p != nullptr)
+            this->get_alloc().deallocate(p, count + 1);
+    }
+
+    slot_ptr        slots_end() const noexcept
+    { return slots_ + slot_size_; }
+    slot_ptr        skip_empty(slot_ptr p) const noexcept
+    {
+        const slot_ptr last = slots_end();
+        while(p != last && p->dist == 0)
+            ++p;
+        return p;
+    }
+
+    size_type       bucket_index(size_t h) const noexcept
+    { return deonSTL::ht_bucket_index(policy_, h, deonSTL::is_avalanching<Hash>()); }
+
+    // 插入 count 个元素需要的桶数
+    size_type       next_bucket_count(size_type count) const noexcept
+    {
+        const size_type need = static_cast<size_type>(static_cast<float>(count) / mlf_) + 1;
+        return Policy::next_bucket_count(need > bucket_size_ ? need : bucket_size_ + 1);
+    }
+
+    // find
+    slot_ptr        find_slot(const key_type& key, size_t h) const;
+
+    // 桶 n 的第一个槽与最后一个槽的下一个位置
+    slot_ptr        bucket_first(size_type n) const noexcept;
+    slot_ptr        bucket_last(size_type n) const noexcept;
+
+    // 桶 home 的元素之后的位置：新元素插在这里，d 为它到桶的距离 + 1
+    void            locate_end(size_t h, slot_ptr& p, uint32_t& d) const noexcept;
+
+    // insert
+    iterator        insert_multi_value(value_type&& value);
+
+    // 在 p 处构造元素，[p, 第一个空槽) 的元素后移一格
+    template <class ...Args>
+    slot_ptr        emplace_at(slot_ptr p, uint32_t d, size_t h, Args&& ...args);
+    void            rotate_into(slot_ptr p, slot_ptr e) noexcept;
+
+    // 把 src 中的元素移动到未构造的 dst 中并析构 src
+    static void     transfer(T* dst, T* src) noexcept;
+    static movable_type&& movable(T* p) noexcept
+    { return std::move(*reinterpret_cast<movable_type*>(p)); }
+    // 扩容时在新槽数组中构造元素：移动不抛出异常时移动，否则复制，构造失败时原表不变
+    static void     rehash_construct(T* dst, T* src, std::true_type)
+    { deonSTL::construct(dst, movable(src)); }
+    static void     rehash_construct(T* dst, T* src, std::false_type)
+    { deonSTL::construct(dst, std::move_if_noexcept(*src)); }
+
+    // 槽的搬移：[first, last) 后移 / 前移一格，搬移后 dist 加一 / 减一
+    void            shift_right(slot_ptr first, slot_ptr last) noexcept;
+    void            shift_left(slot_ptr first, slot_ptr last) noexcept;
+
+    // erase：p 中的元素已经析构，后面离桶有距离的元素前移一格
+    void            erase_shift(slot_ptr p) noexcept;
+
+    // rehash
+    void            rehash_to(size_type n);
+    void            grow_tail();
+
+    // 增量扩容：把桶 n 的元素移到 dst 中，前面的桶必须已经移走，返回移动的元素个数
+    // track 不为空时指向 dst 中的一个槽下标，元素后移时随之更新
+    size_type       migrate_bucket(size_type n, hashtable& dst, size_type* track);
+    // 增量扩容：新的槽数组由调用者分步置空，不带元素的表直接换上 n 个桶的 p
+    slot_ptr        allocate_raw_slots(size_type count)
+    { return this->get_alloc().allocate(count + 1); }
+    void            adopt_slots(slot_ptr p, size_type n) noexcept;
+
 }; // class hashtable
 
 
@@ -574,23 +776,668 @@ private:
 //                             member functions                              //
 //***************************************************************************//
 
+// 复制构造函数 槽数组的布局不变，逐个复制元素
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::hashtable(const hashtable& rhs)
+: alloc_base(rhs.get_alloc()), slots_(nullptr), bucket_size_(rhs.bucket_size_), policy_(rhs.policy_),
+  slot_size_(rhs.slot_size_), size_(0), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
+{
+    if(rhs.slots_ == nullptr)
+        return;
+    slots_ = allocate_slots(slot_size_);
+    try {
+        for(size_type i = 0; i < slot_size_; ++i)
+        {
+            const slot_type& src = rhs.slots_[i];
+            if(src.dist == 0)
+                continue;
+            deonSTL::construct(slots_[i].value_ptr(), *src.value_ptr());
+            slots_[i].hash = src.hash;
+            slots_[i].dist = src.dist;
+            ++size_;
+        }
+    } catch (...) {
+        clear();
+        deallocate_slots(slots_, slot_size_);
+        throw;
+    }
+}
+
+// 移动构造函数 接管槽数组，rhs 变为未申请空间的空容器
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::hashtable(hashtable&& rhs) noexcept
+: alloc_base(rhs.get_alloc()), slots_(rhs.slots_), bucket_size_(rhs.bucket_size_), policy_(rhs.policy_),
+  slot_size_(rhs.slot_size_), size_(rhs.size_), mlf_(rhs.mlf_),
+  hash_(rhs.hash_), equal_(rhs.equal_)
+{
+    rhs.slots_ = nullptr;
+    rhs.bucket_size_ = 0;
+    rhs.policy_ = policy_type();
+    rhs.slot_size_ = 0;
+    rhs.size_ = 0;
+}
+
+// try_emplace_unique 从桶开始探测：遇到相等的键则返回；遇到离桶更近的元素或空槽说明键不存在，这里就是插入位置
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+template <class ...Args>
+deonSTL::pair<typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::try_emplace_unique(const key_type& key, Args&& ...args)
+{
+    const size_t h = hash_(key);
+    slot_ptr p = nullptr;
+    uint32_t d = 1;
+    if(bucket_size_ != 0)
+    {
+        for(p = slots_ + bucket_index(h); p->dist >= d; ++p, ++d)
+            if(p->hash == h && equal_(value_traits::get_key(*p->value_ptr()), key))
+                return deonSTL::pair<iterator, bool>(iterator(p, this), false);
+    }
+    if(static_cast<float>(size_ + 1) > static_cast<float>(bucket_size_) * mlf_)
+    {// args 可能引用表中的元素，扩容之前先构造
+        value_type tmp(std::forward<Args>(args)...);
+        rehash_to(next_bucket_count(size_ + 1));
+        locate_end(h, p, d);
+        p = emplace_at(p, d, h, std::move(tmp));
+    }
+    else
+        p = emplace_at(p, d, h, std::forward<Args>(args)...);
+    return deonSTL::pair<iterator, bool>(iterator(p, this), true);
+}
+
+// erase 返回 pos：后面的元素前移后 pos 处可能是还没有访问过的元素
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::erase(const_iterator pos)
+{
+    MY_DEBUG(pos.slot != slots_end() && pos.slot->dist != 0);
+    slot_ptr p = pos.slot;
+    deonSTL::destroy(p->value_ptr());
+    erase_shift(p);
+    --size_;
+    return iterator(skip_empty(p), this);
+}
+
+// erase 前移不改变剩下元素的相对顺序，从 first 开始删除 distance(first, last) 次
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::erase(const_iterator first, const_iterator last)
+{
+    size_type n = 0;
+    for(const_iterator it = first; it != last; ++it)
+        ++n;
+    iterator cur(first);
+    for(; n > 0; --n)
+        cur = erase(cur);
+    return cur;
+}
+
+// erase_multi 相等的键连续存放，删除第一个后下一个前移到同一个槽
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::erase_multi(const key_type& key)
+{
+    const size_t h = hash_(key);
+    slot_ptr p = find_slot(key, h);
+    size_type n = 0;
+    if(p == nullptr)
+        return 0;
+    do {
+        deonSTL::destroy(p->value_ptr());
+        erase_shift(p);
+        ++n;
+    } while(p->dist != 0 && p->hash == h && equal_(value_traits::get_key(*p->value_ptr()), key));
+    size_ -= n;
+    return n;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::erase_unique(const key_type& key)
+{
+    slot_ptr p = find_slot(key, hash_(key));
+    if(p == nullptr)
+        return 0;
+    deonSTL::destroy(p->value_ptr());
+    erase_shift(p);
+    --size_;
+    return 1;
+}
+
+// clear 析构所有元素，槽全部置空
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::clear() noexcept
+{
+    if(size_ == 0)
+        return;
+    for(slot_ptr p = slots_; p != slots_end(); ++p)
+        if(p->dist != 0)
+        {
+            deonSTL::destroy(p->value_ptr());
+            p->dist = 0;
+        }
+    size_ = 0;
+}
+
+// swap 连同配置器一起交换
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::swap(hashtable& rhs) noexcept
+{
+    if(this != &rhs)
+    {
+        std::swap(this->get_alloc(), rhs.get_alloc());
+        std::swap(slots_, rhs.slots_);
+        std::swap(bucket_size_, rhs.bucket_size_);
+        std::swap(policy_, rhs.policy_);
+        std::swap(slot_size_, rhs.slot_size_);
+        std::swap(size_, rhs.size_);
+        std::swap(mlf_, rhs.mlf_);
+        std::swap(hash_, rhs.hash_);
+        std::swap(equal_, rhs.equal_);
+    }
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::count_multi(const key_type& key) const
+{
+    auto p = equal_range_multi(key);
+    return static_cast<size_type>(deonSTL::distance(p.first, p.second));
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+deonSTL::pair<typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator,
+              typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_range_unique(const key_type& key)
+{
+    slot_ptr p = find_slot(key, hash_(key));
+    if(p == nullptr)
+        return deonSTL::pair<iterator, iterator>(end(), end());
+    return deonSTL::pair<iterator, iterator>(iterator(p, this), iterator(skip_empty(p + 1), this));
+}
 
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+deonSTL::pair<typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::const_iterator,
+              typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_range_unique(const key_type& key) const
+{
+    slot_ptr p = find_slot(key, hash_(key));
+    if(p == nullptr)
+        return deonSTL::pair<const_iterator, const_iterator>(end(), end());
+    return deonSTL::pair<const_iterator, const_iterator>(const_iterator(p, this),
+                                                         const_iterator(skip_empty(p + 1), this));
+}
+
+// equal_range_multi 相等的键连续存放，从第一个开始向后数
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+deonSTL::pair<typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator,
+              typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_range_multi(const key_type& key)
+{
+    const size_t h = hash_(key);
+    slot_ptr first = find_slot(key, h);
+    if(first == nullptr)
+        return deonSTL::pair<iterator, iterator>(end(), end());
+    slot_ptr last = first + 1;
+    while(last->dist != 0 && last->hash == h && equal_(value_traits::get_key(*last->value_ptr()), key))
+        ++last;
+    return deonSTL::pair<iterator, iterator>(iterator(first, this), iterator(skip_empty(last), this));
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+deonSTL::pair<typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::const_iterator,
+              typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_range_multi(const key_type& key) const
+{
+    const size_t h = hash_(key);
+    slot_ptr first = find_slot(key, h);
+    if(first == nullptr)
+        return deonSTL::pair<const_iterator, const_iterator>(end(), end());
+    slot_ptr last = first + 1;
+    while(last->dist != 0 && last->hash == h && equal_(value_traits::get_key(*last->value_ptr()), key))
+        ++last;
+    return deonSTL::pair<const_iterator, const_iterator>(const_iterator(first, this),
+                                                         const_iterator(skip_empty(last), this));
+}
+
+// rehash 桶数不变时什么也不做
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::rehash(size_type count)
+{
+    const size_type need = static_cast<size_type>(static_cast<float>(size_) / mlf_) + 1;
+    if(count < need)
+        count = need;
+    if(bucket_size_ == 0 && size_ == 0 && count <= 1)
+        return;
+    count = Policy::next_bucket_count(count);
+    if(count != bucket_size_)
+        rehash_to(count);
+}
+
+// equal_to_unique 元素个数相同，并且每个元素都能在 other 中找到相等的元素
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+bool
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_to_unique(const hashtable& other) const
+{
+    if(size_ != other.size_)
+        return false;
+    for(const_iterator it = begin(); it != end(); ++it)
+    {
+        const_iterator res = other.find(value_traits::get_key(*it));
+        if(res == other.end() || !(*res == *it))
+            return false;
+    }
+    return true;
+}
+
+// equal_to_multi 对每一段相等的键，other 中对应的一段元素个数相同，并且每个值出现的次数相同
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+bool
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::equal_to_multi(const hashtable& other) const
+{
+    if(size_ != other.size_)
+        return false;
+    for(const_iterator first = begin(); first != end(); )
+    {
+        const key_type& key = value_traits::get_key(*first);
+        const_iterator last = first;
+        size_type n = 0;
+        while(last != end() && equal_(value_traits::get_key(*last), key))
+        {
+            ++last;
+            ++n;
+        }
+        auto range = other.equal_range_multi(key);
+        if(static_cast<size_type>(deonSTL::distance(range.first, range.second)) != n)
+            return false;
+        for(const_iterator it = first; it != last; ++it)
+        {
+            size_type c1 = 0, c2 = 0;
+            for(const_iterator x = first; x != last; ++x)
+                c1 += *x == *it ? 1 : 0;
+            for(const_iterator x = range.first; x != range.second; ++x)
+                c2 += *x == *it ? 1 : 0;
+            if(c1 != c2)
+                return false;
+        }
+        first = last;
+    }
+    return true;
+}
 
 //***************************************************************************//
 //                             helper functions                              //
 //***************************************************************************//
 
+// allocate_slots 申请 count 个槽和一个哨兵，全部置空
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::slot_ptr
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::allocate_slots(size_type count)
+{
+    slot_ptr p = this->get_alloc().allocate(count + 1);
+    for(size_type i = 0; i <= count; ++i)
+        p[i].dist = 0;
+    return p;
+}
 
+// find_slot 距离小于当前探测距离的槽（包括空槽）之后不会再有要找的键
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::slot_ptr
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::find_slot(const key_type& key, size_t h) const
+{
+    if(size_ == 0)
+        return nullptr;
+    slot_ptr p = slots_ + bucket_index(h);
+    for(uint32_t d = 1; p->dist >= d; ++p, ++d)
+        if(p->hash == h && equal_(value_traits::get_key(*p->value_ptr()), key))
+            return p;
+    return nullptr;
+}
 
-//***************************************************************************//
-//                             equal operator                                //
-//***************************************************************************//
+// bucket_first 跳过属于前面的桶的元素（它们到桶 n 的距离大于当前的探测距离）
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::slot_ptr
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::bucket_first(size_type n) const noexcept
+{
+    MY_DEBUG(n < bucket_size_);
+    slot_ptr p = slots_ + n;
+    for(uint32_t d = 1; p->dist > d; ++p, ++d) {}
+    return p;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::slot_ptr
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::bucket_last(size_type n) const noexcept
+{
+    slot_ptr p = bucket_first(n);
+    for(uint32_t d = static_cast<uint32_t>(p - (slots_ + n)) + 1; p->dist == d; ++p, ++d) {}
+    return p;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::locate_end(size_t h, slot_ptr& p, uint32_t& d) const noexcept
+{
+    p = slots_ + bucket_index(h);
+    for(d = 1; p->dist >= d; ++p, ++d) {}
+}
 
+// insert_multi_value 插在最后一个相等的键之后，没有相等的键时插在桶的末尾
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::iterator
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::insert_multi_value(value_type&& value)
+{
+    const key_type& key = value_traits::get_key(value);
+    const size_t h = hash_(key);
+    if(static_cast<float>(size_ + 1) > static_cast<float>(bucket_size_) * mlf_)
+        rehash_to(next_bucket_count(size_ + 1));
+    slot_ptr p = slots_ + bucket_index(h);
+    slot_ptr after = nullptr;
+    uint32_t d = 1, after_d = 0;
+    for(; p->dist >= d; ++p, ++d)
+        if(p->hash == h && equal_(value_traits::get_key(*p->value_ptr()), key))
+        {
+            after = p + 1;
+            after_d = d + 1;
+        }
+    if(after != nullptr)
+    {
+        p = after;
+        d = after_d;
+    }
+    return iterator(emplace_at(p, d, h, std::move(value)), this);
+}
 
+// emplace_at 先在 p 之后的第一个空槽中构造元素，再把它转到 p 处，[p, 空槽) 的元素后移一格：
+// args 可能引用表中的元素，构造完成之前不能搬动任何元素；构造失败时表不变
+// 用到哨兵时要先加倍溢出槽，此时先用 args 构造一个临时元素
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+template <class ...Args>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::slot_ptr
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::emplace_at(slot_ptr p, uint32_t d, size_t h, Args&& ...args)
+{
+    slot_ptr e = p;
+    while(e->dist != 0)
+        ++e;
+    if(e == slots_end())
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        const size_type offset = static_cast<size_type>(p - slots_);
+        const size_type last = slot_size_;
+        grow_tail();
+        p = slots_ + offset;
+        e = slots_ + last;
+        deonSTL::construct(e->value_ptr(), std::move(tmp));
+    }
+    else
+        deonSTL::construct(e->value_ptr(), std::forward<Args>(args)...);
+    rotate_into(p, e);
+    p->hash = h;
+    p->dist = d;
+    ++size_;
+    return p;
+}
 
+// rotate_into e 中的元素放到 p 处，[p, e) 后移一格
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::rotate_into(slot_ptr p, slot_ptr e) noexcept
+{
+    if(p == e)
+        return;
+    if(relocatable::value)
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buf;
+        std::memcpy(static_cast<void*>(&buf), static_cast<const void*>(e->value_ptr()), sizeof(T));
+        shift_right(p, e);
+        std::memcpy(static_cast<void*>(p->value_ptr()), static_cast<const void*>(&buf), sizeof(T));
+        return;
+    }
+    movable_type tmp(movable(e->value_ptr()));
+    deonSTL::destroy(e->value_ptr());
+    shift_right(p, e);
+    deonSTL::construct(p->value_ptr(), std::move(tmp));
+}
 
+// transfer 搬移一个元素
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::transfer(T* dst, T* src) noexcept
+{
+    deonSTL::construct(dst, movable(src));
+    deonSTL::destroy(src);
+}
 
+// shift_right 从后往前搬，可按字节搬移的元素整段 memmove
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::shift_right(slot_ptr first, slot_ptr last) noexcept
+{
+    if(first == last)
+        return;
+    if(relocatable::value)
+    {
+        std::memmove(static_cast<void*>(first + 1), static_cast<const void*>(first),
+                     static_cast<size_t>(last - first) * sizeof(slot_type));
+        for(slot_ptr p = first + 1; p != last + 1; ++p)
+            ++p->dist;
+        return;
+    }
+    for(slot_ptr p = last; p != first; --p)
+    {
+        slot_ptr src = p - 1;
+        transfer(p->value_ptr(), src->value_ptr());
+        p->hash = src->hash;
+        p->dist = src->dist + 1;
+    }
+}
+
+// shift_left 从前往后搬
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::shift_left(slot_ptr first, slot_ptr last) noexcept
+{
+    if(first == last)
+        return;
+    if(relocatable::value)
+    {
+        std::memmove(static_cast<void*>(first - 1), static_cast<const void*>(first),
+                     static_cast<size_t>(last - first) * sizeof(slot_type));
+        for(slot_ptr p = first - 1; p != last - 1; ++p)
+            --p->dist;
+        return;
+    }
+    for(slot_ptr p = first; p != last; ++p)
+    {
+        slot_ptr dst = p - 1;
+        transfer(dst->value_ptr(), p->value_ptr());
+        dst->hash = p->hash;
+        dst->dist = p->dist - 1;
+    }
+}
+
+// erase_shift 前移到遇见空槽或者正好在自己的桶上的元素为止，最后空出来的槽置空
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::erase_shift(slot_ptr p) noexcept
+{
+    slot_ptr last = p + 1;
+    while(last->dist > 1)
+        ++last;
+    shift_left(p + 1, last);
+    (last - 1)->dist = 0;
+}
+
+// migrate_bucket 前面的桶都已移走时，桶 n 的元素从槽 n 开始（到桶的距离为 1），
+// 每移走一个，后面的元素前移一格，下一个元素又来到槽 n
+// dst 中不存在这些键，按保存的 hash 值直接插到桶的末尾，不重新计算 hash，也不检查负载系数
+// 插入位置 p 与 *track 之间没有空槽时，*track 处的元素会后移一格
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+typename hashtable<T, Hash, KeyEqual, Alloc, Policy>::size_type
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::migrate_bucket(size_type n, hashtable& dst, size_type* track)
+{
+    MY_DEBUG(n < bucket_size_);
+    size_type count = 0;
+    const slot_ptr q = slots_ + n;
+    while(q->dist == 1)
+    {
+        slot_ptr p = nullptr;
+        uint32_t d = 1;
+        dst.locate_end(q->hash, p, d);
+        if(track != nullptr && static_cast<size_type>(p - dst.slots_) <= *track)
+        {
+            slot_ptr e = p;
+            while(e->dist != 0 && e != dst.slots_ + *track)
+                ++e;
+            if(e == dst.slots_ + *track)
+                ++*track;
+        }
+        dst.emplace_at(p, d, q->hash, movable(q->value_ptr()));
+        deonSTL::destroy(q->value_ptr());
+        erase_shift(q);
+        --size_;
+        ++count;
+    }
+    return count;
+}
+
+// adopt_slots p 中有 n 个桶、default_tail 个溢出槽和一个哨兵，都已置空
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::adopt_slots(slot_ptr p, size_type n) noexcept
+{
+    MY_DEBUG(size_ == 0);
+    deallocate_slots(slots_, slot_size_);
+    slots_ = p;
+    bucket_size_ = n;
+    policy_ = policy_type(n);
+    slot_size_ = n + default_tail;
+}
+
+// rehash_to 换成 n 个桶，按桶做一次计数排序，每个元素直接放到最终位置，不需要探测和搬移：
+// 先统计每个桶的元素个数，元素紧密排列时桶 i 从 max(前一个桶的末尾, i) 开始，由此得到需要的溢出槽数；
+// 再按旧数组的顺序放到各自的桶中（相等的键仍然连续）
+// 元素的移动构造可能抛出异常时改为复制，失败时旧数组保持不变
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::rehash_to(size_type n)
+{
+    typedef typename Alloc::template rebind<uint32_t>::other cursor_allocator;
+
+    const policy_type policy(n);
+    size_type tail = default_tail;
+    slot_ptr new_slots = nullptr;
+    if(size_ == 0)
+        new_slots = allocate_slots(n + tail);
+    else
+    {
+        // cursor[i]：桶 i 的下一个元素的位置 - i
+        cursor_allocator calloc(this->get_alloc());
+        uint32_t* cursor = calloc.allocate(n);
+        std::memset(static_cast<void*>(cursor), 0, n * sizeof(uint32_t));
+        for(slot_ptr q = slots_; q != slots_end(); ++q)
+            if(q->dist != 0)
+                ++cursor[deonSTL::ht_bucket_index(policy, q->hash, deonSTL::is_avalanching<Hash>())];
+        size_type used = 0;
+        for(size_type i = 0; i < n; ++i)
+        {
+            const size_type first = used > i ? used : i;
+            used = first + cursor[i];
+            cursor[i] = static_cast<uint32_t>(first - i);
+        }
+        if(used > n + tail)
+            tail = used - n;
+        try {
+            new_slots = allocate_slots(n + tail);
+        } catch (...) {
+            calloc.deallocate(cursor, n);
+            throw;
+        }
+
+        slot_ptr q = slots_;
+        try {
+            for(; q != slots_end(); ++q)
+            {
+                if(q->dist == 0)
+                    continue;
+                const size_type home = deonSTL::ht_bucket_index(policy, q->hash, deonSTL::is_avalanching<Hash>());
+                const uint32_t offset = cursor[home]++;
+                slot_ptr p = new_slots + home + offset;
+                if(relocatable::value)
+                    std::memcpy(static_cast<void*>(p->value_ptr()),
+                                static_cast<const void*>(q->value_ptr()), sizeof(T));
+                else
+                    rehash_construct(p->value_ptr(), q->value_ptr(), nothrow_movable());
+                p->hash = q->hash;
+                p->dist = offset + 1;
+            }
+        } catch (...) {
+            for(slot_ptr p = new_slots; p != new_slots + n + tail; ++p)
+                if(p->dist != 0)
+                    deonSTL::destroy(p->value_ptr());
+            deallocate_slots(new_slots, n + tail);
+            calloc.deallocate(cursor, n);
+            throw;
+        }
+        calloc.deallocate(cursor, n);
+        if(!relocatable::value)
+            for(q = slots_; q != slots_end(); ++q)
+                if(q->dist != 0)
+                    deonSTL::destroy(q->value_ptr());
+    }
+    deallocate_slots(slots_, slot_size_);
+    slots_ = new_slots;
+    bucket_size_ = n;
+    policy_ = policy;
+    slot_size_ = n + tail;
+}
+
+// grow_tail 溢出槽加倍，元素留在原来的下标上
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void
+hashtable<T, Hash, KeyEqual, Alloc, Policy>::grow_tail()
+{
+    const size_type tail = slot_size_ - bucket_size_;
+    const size_type new_size = bucket_size_ + (tail != 0 ? tail * 2 : default_tail);
+    slot_ptr new_slots = allocate_slots(new_size);
+    if(relocatable::value)
+        std::memcpy(static_cast<void*>(new_slots), static_cast<const void*>(slots_),
+                    slot_size_ * sizeof(slot_type));
+    else
+    {
+        for(size_type i = 0; i < slot_size_; ++i)
+        {
+            slot_ptr q = slots_ + i;
+            if(q->dist == 0)
+                continue;
+            transfer(new_slots[i].value_ptr(), q->value_ptr());
+            new_slots[i].hash = q->hash;
+            new_slots[i].dist = q->dist;
+        }
+    }
+    deallocate_slots(slots_, slot_size_);
+    slots_ = new_slots;
+    slot_size_ = new_size;
+}
+
+//***************************************************************************//
+//                             equal operator                                //
+//***************************************************************************//
+
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+void swap(hashtable<T, Hash, KeyEqual, Alloc, Policy>& lhs, hashtable<T, Hash, KeyEqual, Alloc, Policy>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
 
+// hashtable 对象只保存指向槽数组的指针
+template <class T, class Hash, class KeyEqual, class Alloc, class Policy>
+struct is_trivially_relocatable<hashtable<T, Hash, KeyEqual, Alloc, Policy>>
+: std::integral_constant<bool, is_trivially_relocatable<Alloc>::value &&
+                               is_trivially_relocatable<Hash>::value &&
+                               is_trivially_relocatable<KeyEqual>::value> {};
 
 } // namespace deonSTL
 
@@ -3,7 +3,7 @@
 //  deonSTL
 //
 //  这个头文件用于迭代器设计，包含了迭代器类型标签，迭代器模板(基类)，迭代器萃取器
-//  还包含算法 distance 和 advance
+//  还包含算法 distance 和 advance，以及分段迭代器萃取器 segmented_iterator_traits
 //
 //  Created by 郭松楠 on 2020/3/14.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -12,6 +12,9 @@
 #ifndef iterator_h
 #define iterator_h
 
+#include <cstddef> // ptrdiff_t
+#include <type_traits> // true_type, false_type
+
 namespace deonSTL {
 
 // 五种迭代器
@@ -50,7 +53,7 @@ struct iterator_traits
     typedef typename Iterator::value_type           value_type;
     typedef typename Iterator::pointer              pointer;
     typedef typename Iterator::reference            reference;
-    typedef typename Iterator::Distance             difference_type;
+    typedef typename Iterator::difference_type      difference_type;
 };
 
 // 针对原生指针的特化版本
@@ -155,6 +158,26 @@ void advance(Iterator &i, Distance n)
 }
 
 
+//***************************************************************************//
+//                         segmented_iterator_traits                         //
+//     分段迭代器（如 deque 迭代器）的元素分布在若干块连续空间上，算法可以逐块处理：             //
+//     每块内用 local_iterator（原生指针）做连续的内层循环，不必每一步都检查是否跨块            //
+//***************************************************************************//
+
+// 缺省不是分段迭代器
+// 分段迭代器的特化需要提供（分段迭代器同时要求是随机访问迭代器）：
+//  is_segmented_iterator : std::true_type
+//  segment_iterator      : 遍历各个块的迭代器
+//  local_iterator        : 块内的迭代器
+//  segment(it), local(it)   : it 所在的块，it 在块内的位置
+//  begin(seg), end(seg)     : 块 seg 的首尾
+//  compose(seg, local)      : 由块和块内位置组合出迭代器
+template <class Iterator>
+struct segmented_iterator_traits
+{
+    typedef std::false_type is_segmented_iterator;
+};
+
 // reverse_iterator ⚠️
 
 }// namespace deonSTL
@@ -0,0 +1,309 @@
+//
+//  lock_free_stack.h
+//  deonSTL
+//
+//  这个头文件包含模板类 lock_free_stack：多线程并发 push / pop 的无锁栈（Treiber 栈）
+//  可以作为多个线程共享的对象池空闲链表
+//
+//  节点不用指针而用 32 位下标表示，栈顶是一个 64 位的原子字：高 32 位为版本号，低 32 位为栈顶节点下标 + 1，
+//  每次成功的 CAS 都让版本号加一，节点被弹出又压回时版本号已经不同，避免 ABA 问题（64 位 CAS 在各平台都是无锁的）
+//
+//  节点来自栈自己的节点池：弹出的节点压入另一条同样带版本号的空闲链表，之后的 push 优先复用，
+//  节点池的空间只在析构时释放，所以其他线程读到一个刚被弹出的节点时内存仍然有效（只会让 CAS 失败），
+//  不需要 hazard pointer 或 epoch
+//  节点池按块申请，第 k 块有 64 << k 个节点，块一旦装好就不再移动；装块用 CAS，不需要锁
+//  26 块共 64 * (2^26 - 1) = 2^32 - 64 个节点，节点用完后 push 抛出 length_error
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef lock_free_stack_h
+#define lock_free_stack_h
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t, uint64_t
+#include <atomic>
+#include <new>          // placement new
+#include <stdexcept>    // length_error
+#include <utility>      // move, forward
+#include <type_traits>  // aligned_storage
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "spsc_queue.h" // cache_line_size
+
+namespace deonSTL{
+
+// 模版类 lock_free_stack
+// 参数二为空间配置器类型，节点池的空间由其 rebind 得到的配置器申请
+template <class T, class Alloc = deonSTL::allocator<T>>
+class lock_free_stack : private deonSTL::alloc_holder<Alloc>
+{
+public:
+
+    typedef Alloc                                       allocator_type;
+
+    typedef T                                           value_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+
+private:
+    struct node
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type  value;
+        std::atomic<uint32_t>                                       next;   // 下一个节点的下标 + 1，0 表示没有
+    };
+
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    typedef typename Alloc::template rebind<node>::other node_allocator;
+
+    static const uint32_t   first_chunk = 64;       // 第 0 块的节点数
+    static const size_type  max_chunks  = 26;       // 再多一块，块内的下标就超出 32 位
+    static const uint32_t   max_nodes   = first_chunk * ((uint32_t(1) << max_chunks) - 1);    // 2^32 - 64
+
+    std::atomic<uint64_t>   head_;                  // 栈顶
+    char                    pad0_[cache_line_size];
+
+    std::atomic<uint64_t>   free_;                  // 空闲链表
+    char                    pad1_[cache_line_size];
+
+    std::atomic<uint32_t>   next_index_;            // 从未使用过的第一个节点下标
+    std::atomic<node*>      chunks_[max_chunks];    // 各块的首地址，未申请时为空
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    lock_free_stack()
+    { init(); }
+
+    explicit lock_free_stack(const allocator_type& alloc)
+    : alloc_base(alloc)
+    { init(); }
+
+    lock_free_stack(const lock_free_stack&) = delete;
+    lock_free_stack& operator=(const lock_free_stack&) = delete;
+
+    // 析构时不能有其他线程在使用栈
+    ~lock_free_stack();
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+
+    // 其他线程同时在操作时只是一个近似值
+    bool                empty_approx() const noexcept
+    { return link_of(head_.load(std::memory_order_acquire)) == 0; }
+
+    template <class ...Args>
+    void        emplace(Args&& ...args);
+    void        push(const value_type& value) { emplace(value); }
+    void        push(value_type&& value)      { emplace(std::move(value)); }
+
+    // 空时返回 false
+    bool        pop(value_type& value);
+
+private:
+    // ==========================辅助函数============================ //
+
+    void        init() noexcept;
+
+    // 带版本号的栈顶：高 32 位为版本号，低 32 位为节点下标 + 1
+    static uint32_t link_of(uint64_t word) noexcept
+    { return static_cast<uint32_t>(word); }
+    static uint64_t make_word(uint64_t old_word, uint32_t link) noexcept
+    { return ((old_word >> 32) + 1) << 32 | link; }
+
+    // 下标 index 所在的块号 floor(log2(index / 64 + 1))，index 小于 max_nodes
+    static size_type chunk_of(uint32_t index) noexcept
+    {
+        const uint64_t i = index / first_chunk + 1;
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_type>(63 - __builtin_clzll(i));
+#else
+        size_type k = 0;
+        while((i >> (k + 1)) != 0)
+            ++k;
+        return k;
+#endif
+    }
+    node*       node_at(uint32_t link) const noexcept;
+
+    // 在 top 所指的链表上压入 / 弹出一个节点，返回弹出节点的 link，空时返回 0
+    void        push_link(std::atomic<uint64_t>& top, uint32_t link) noexcept;
+    uint32_t    pop_link(std::atomic<uint64_t>& top) noexcept;
+
+    // 取得一个空节点：先从空闲链表取，没有再从节点池取新的
+    uint32_t    get_node();
+    void        install_chunk(size_type k);
+
+    // CAS 失败后的退避
+    static void backoff(unsigned& spins) noexcept
+    {
+        for(unsigned i = 0; i < spins; ++i)
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        if(spins < 1024)
+            spins <<= 1;
+    }
+
+};// class lock_free_stack
+
+//***************************************************************************//
+//                           member functions                                //
+//***************************************************************************//
+
+template <class T, class Alloc>
+lock_free_stack<T, Alloc>::~lock_free_stack()
+{
+    for(uint32_t link = link_of(head_.load(std::memory_order_relaxed)); link != 0; )
+    {
+        node* n = node_at(link);
+        deonSTL::destroy(reinterpret_cast<value_type*>(&n->value));
+        link = n->next.load(std::memory_order_relaxed);
+    }
+    for(size_type k = 0; k < max_chunks; ++k)
+    {
+        node* c = chunks_[k].load(std::memory_order_relaxed);
+        if(c != nullptr)
+            node_allocator(this->get_alloc()).deallocate(c, static_cast<size_type>(first_chunk) << k);
+    }
+}
+
+// emplace 先在空节点中构造元素，再把节点压入栈（release，弹出者看到节点时元素一定已构造好）
+template <class T, class Alloc>
+template <class ...Args>
+void
+lock_free_stack<T, Alloc>::emplace(Args&& ...args)
+{
+    const uint32_t link = get_node();
+    try {
+        deonSTL::construct(reinterpret_cast<value_type*>(&node_at(link)->value),
+                           std::forward<Args>(args)...);
+    } catch (...) {
+        push_link(free_, link);
+        throw;
+    }
+    push_link(head_, link);
+}
+
+// pop 弹出栈顶节点后节点只属于自己，移出元素后节点放回空闲链表
+template <class T, class Alloc>
+bool
+lock_free_stack<T, Alloc>::pop(value_type& value)
+{
+    const uint32_t link = pop_link(head_);
+    if(link == 0)
+        return false;
+    value_type* p = reinterpret_cast<value_type*>(&node_at(link)->value);
+    value = std::move(*p);
+    deonSTL::destroy(p);
+    push_link(free_, link);
+    return true;
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+template <class T, class Alloc>
+void
+lock_free_stack<T, Alloc>::init() noexcept
+{
+    head_.store(0, std::memory_order_relaxed);
+    free_.store(0, std::memory_order_relaxed);
+    next_index_.store(0, std::memory_order_relaxed);
+    for(size_type k = 0; k < max_chunks; ++k)
+        chunks_[k].store(nullptr, std::memory_order_relaxed);
+}
+
+// node_at 下标 i 在第 k = floor(log2(i / 64 + 1)) 块中，前 k 块共有 64 * (2^k - 1) 个节点
+template <class T, class Alloc>
+typename lock_free_stack<T, Alloc>::node*
+lock_free_stack<T, Alloc>::node_at(uint32_t link) const noexcept
+{
+    const uint32_t index = link - 1;
+    const size_type k = chunk_of(index);
+    const uint32_t offset = index - first_chunk * ((uint32_t(1) << k) - 1);
+    return chunks_[k].load(std::memory_order_acquire) + offset;
+}
+
+// push_link 节点的 next 指向当前栈顶，CAS 成功则节点成为新的栈顶
+template <class T, class Alloc>
+void
+lock_free_stack<T, Alloc>::push_link(std::atomic<uint64_t>& top, uint32_t link) noexcept
+{
+    node* n = node_at(link);
+    uint64_t old_word = top.load(std::memory_order_relaxed);
+    unsigned spins = 1;
+    for(;;)
+    {
+        n->next.store(link_of(old_word), std::memory_order_relaxed);
+        if(top.compare_exchange_weak(old_word, make_word(old_word, link),
+                                     std::memory_order_release, std::memory_order_relaxed))
+            return;
+        backoff(spins);
+    }
+}
+
+// pop_link 读栈顶节点的 next 后 CAS；节点可能同时被别的线程弹出并重新压入，
+// 此时读到的 next 可能已经过时，但栈顶的版本号也已经变了，CAS 一定失败
+template <class T, class Alloc>
+uint32_t
+lock_free_stack<T, Alloc>::pop_link(std::atomic<uint64_t>& top) noexcept
+{
+    uint64_t old_word = top.load(std::memory_order_acquire);
+    unsigned spins = 1;
+    for(;;)
+    {
+        const uint32_t link = link_of(old_word);
+        if(link == 0)
+            return 0;
+        const uint32_t next = node_at(link)->next.load(std::memory_order_relaxed);
+        if(top.compare_exchange_weak(old_word, make_word(old_word, next),
+                                     std::memory_order_acquire, std::memory_order_acquire))
+            return link;
+        backoff(spins);
+    }
+}
+
+// get_node 空闲链表为空时从节点池取一个新下标，所在的块还没有申请就先装上
+// 节点池的 max_nodes 个节点都已取出时抛出 length_error
+template <class T, class Alloc>
+uint32_t
+lock_free_stack<T, Alloc>::get_node()
+{
+    uint32_t link = pop_link(free_);
+    if(link != 0)
+        return link;
+    uint32_t index = next_index_.load(std::memory_order_relaxed);
+    do {
+        if(index >= max_nodes)
+            throw std::length_error("lock_free_stack has too many nodes");
+    } while(!next_index_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+    const size_type k = chunk_of(index);
+    if(chunks_[k].load(std::memory_order_acquire) == nullptr)
+        install_chunk(k);
+    return index + 1;
+}
+
+// install_chunk 申请第 k 块，多个线程同时装时只有一个 CAS 成功，其余的释放自己申请的空间
+template <class T, class Alloc>
+void
+lock_free_stack<T, Alloc>::install_chunk(size_type k)
+{
+    const size_type n = static_cast<size_type>(first_chunk) << k;
+    node* c = node_allocator(this->get_alloc()).allocate(n);
+    for(size_type i = 0; i < n; ++i)
+        ::new (static_cast<void*>(&c[i].next)) std::atomic<uint32_t>(0);
+    node* expected = nullptr;
+    if(!chunks_[k].compare_exchange_strong(expected, c, std::memory_order_acq_rel,
+                                           std::memory_order_acquire))
+        node_allocator(this->get_alloc()).deallocate(c, n);
+}
+
+}// namespace deonSTL
+
+#endif /* lock_free_stack_h */
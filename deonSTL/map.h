@@ -11,6 +11,7 @@
 #ifndef map_h
 #define map_h
 
+#include <functional> // less
 #include "rb_tree.h"
 
 namespace deonSTL{
@@ -19,7 +20,8 @@ namespace deonSTL{
 //                                  map                                      //
 //***************************************************************************//
 
-template <class Key, class T, class Compare = std::less<Key>>
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = deonSTL::allocator<deonSTL::pair<Key, T>>>
 class map
 {
 public:
@@ -32,7 +34,7 @@ public:
     
 private:
     // 以 deonSTL::rb_tree 作为底层机制
-    typedef deonSTL::rb_tree<value_type, mapped_type>   base_type;
+    typedef deonSTL::rb_tree<value_type, key_compare, Alloc>   base_type;
     base_type tree_;
     
 public:
@@ -52,6 +54,12 @@ public:
 
     map() = default;
     
+    explicit map(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    : tree_(comp, alloc) {}
+    
+    explicit map(const allocator_type& alloc)
+    : tree_(key_compare(), alloc) {}
+    
     template <class InputIter>
     map(InputIter first, InputIter last)
     : tree_()
@@ -65,7 +73,7 @@ public:
     : tree_(rhs.tree_) {}
     
     map(map&& rhs) noexcept
-    : tree_(std::move(rhs)) {}
+    : tree_(std::move(rhs.tree_)) {}
     
     map& operator=(const map& rhs)
     {
@@ -75,7 +83,7 @@ public:
     
     map& operator=(map&& rhs)
     {
-        tree_ = std::move(rhs);
+        tree_ = std::move(rhs.tree_);
         return *this;
     }
     
@@ -103,6 +111,9 @@ public:
     { return tree_.size(); }
     size_type              max_size() const noexcept
     { return tree_.max_size(); }
+    
+    allocator_type         get_allocator() const
+    { return tree_.get_allocator(); }
 
     // 未定义 emplace_hint 的版本
     mapped_type& operator[](const key_type& key)
@@ -136,7 +147,7 @@ public:
     void                 erase(iterator pos)
     { tree_.erase(pos); }
     size_type            erase(const key_type& key)
-    { tree_.erase_multi(key); }
+    { return tree_.erase_unique(key); }
     void                 erase(iterator first, iterator last)
     { tree_.erase(first, last); }
     
@@ -179,20 +190,20 @@ public:
 }; // class map
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(map<Key, T, Compare, Alloc>& lhs, map<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -202,7 +213,8 @@ void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
 //                               multi_map                                   //
 //***************************************************************************//
 
-template <class Key, class T, class Compare = std::less<Key>>
+template <class Key, class T, class Compare = std::less<Key>,
+          class Alloc = deonSTL::allocator<deonSTL::pair<const Key, T>>>
 class multimap
 {
 public:
@@ -216,7 +228,7 @@ public:
 
 private:
   // 用 mystl::rb_tree 作为底层机制
-  typedef deonSTL::rb_tree<value_type, key_compare>  base_type;
+  typedef deonSTL::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;
 
 public:
@@ -228,8 +240,6 @@ public:
   typedef typename base_type::const_reference        const_reference;
   typedef typename base_type::iterator               iterator;
   typedef typename base_type::const_iterator         const_iterator;
-  typedef typename base_type::reverse_iterator       reverse_iterator;
-  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
   typedef typename base_type::size_type              size_type;
   typedef typename base_type::difference_type        difference_type;
   typedef typename base_type::allocator_type         allocator_type;
@@ -238,6 +248,12 @@ public:
   // 构造、复制、移动函数
 
   multimap() = default;
+  
+  explicit multimap(const key_compare& comp, const allocator_type& alloc = allocator_type())
+  : tree_(comp, alloc) {}
+  
+  explicit multimap(const allocator_type& alloc)
+  : tree_(key_compare(), alloc) {}
 
   template <class InputIterator>
   multimap(InputIterator first, InputIterator last)
@@ -349,22 +365,22 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator==(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc>
+bool operator!=(const multimap<Key, T, Compare, Alloc>& lhs, const multimap<Key, T, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc>
+void swap(multimap<Key, T, Compare, Alloc>& lhs, multimap<Key, T, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
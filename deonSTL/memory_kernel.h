@@ -0,0 +1,259 @@
+//
+//  memory_kernel.h
+//  deonSTL
+//
+//  这个头文件包含 uninitialized.h 使用的批量复制、填充内核，只用于连续空间上的平凡可复制类型
+//  __copy_trivial / __move_trivial : memmove
+//  __fill_trivial / __fill_n_trivial : 每个字节相同的值用 memset，4/8 字节的值用 SIMD 广播写入，
+//                                      超过 __nt_store_threshold 字节时使用非临时写入（不经过缓存）
+//  迭代器不是指针时交给 std::copy、std::move、std::fill 等
+//
+//  SIMD 指令集在编译期由编译选项决定：-mavx512f 使用 AVX-512，-mavx2 使用 AVX2，否则使用 SSE2
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef memory_kernel_h
+#define memory_kernel_h
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint32_t, uint64_t, uintptr_t
+#include <cstring>      // memmove, memset, memcpy
+#include <algorithm>    // copy, fill_n
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace deonSTL{
+
+// 填充超过这个字节数时使用非临时写入，避免把缓存中其他数据挤出去
+constexpr size_t __nt_store_threshold = 8 * 1024 * 1024;
+
+//***************************************************************************//
+//                                SIMD 基本操作                                //
+//***************************************************************************//
+
+#if defined(__AVX512F__)
+
+#define DEONSTL_SIMD_BYTES 64
+typedef __m512i __simd_vec;
+inline __simd_vec __simd_set1(uint32_t w) { return _mm512_set1_epi32(static_cast<int>(w)); }
+inline __simd_vec __simd_set1(uint64_t w) { return _mm512_set1_epi64(static_cast<long long>(w)); }
+inline void __simd_store (void* p, __simd_vec v) { _mm512_storeu_si512(p, v); }
+inline void __simd_stream(void* p, __simd_vec v) { _mm512_stream_si512(static_cast<__m512i*>(p), v); }
+
+#elif defined(__AVX2__)
+
+#define DEONSTL_SIMD_BYTES 32
+typedef __m256i __simd_vec;
+inline __simd_vec __simd_set1(uint32_t w) { return _mm256_set1_epi32(static_cast<int>(w)); }
+inline __simd_vec __simd_set1(uint64_t w) { return _mm256_set1_epi64x(static_cast<long long>(w)); }
+inline void __simd_store (void* p, __simd_vec v) { _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+inline void __simd_stream(void* p, __simd_vec v) { _mm256_stream_si256(static_cast<__m256i*>(p), v); }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#define DEONSTL_SIMD_BYTES 16
+typedef __m128i __simd_vec;
+inline __simd_vec __simd_set1(uint32_t w) { return _mm_set1_epi32(static_cast<int>(w)); }
+inline __simd_vec __simd_set1(uint64_t w) { return _mm_set1_epi64x(static_cast<long long>(w)); }
+inline void __simd_store (void* p, __simd_vec v) { _mm_storeu_si128(static_cast<__m128i*>(p), v); }
+inline void __simd_stream(void* p, __simd_vec v) { _mm_stream_si128(static_cast<__m128i*>(p), v); }
+
+#else
+
+#define DEONSTL_SIMD_BYTES 0
+
+#endif
+
+//***************************************************************************//
+//                               __copy_trivial                              //
+//          源和目的都是同一平凡可复制类型的指针时 memmove，否则交给 std::copy              //
+//***************************************************************************//
+
+template <class InputIt, class OutputIt>
+struct __is_memmove_copyable
+: std::integral_constant<bool,
+    std::is_pointer<InputIt>::value && std::is_pointer<OutputIt>::value &&
+    std::is_same<typename std::remove_cv<typename std::remove_pointer<InputIt>::type>::type,
+                 typename std::remove_pointer<OutputIt>::type>::value &&
+    std::is_trivially_copyable<typename std::remove_pointer<OutputIt>::type>::value> {};
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_trivial(InputIt first, InputIt last, OutputIt result, std::false_type)
+{
+    return std::copy(first, last, result);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_trivial(InputIt first, InputIt last, OutputIt result, std::true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if(n != 0)
+        std::memmove(result, first, n * sizeof(*first));
+    return result + n;
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__copy_trivial(InputIt first, InputIt last, OutputIt result)
+{
+    return deonSTL::__copy_trivial(first, last, result,
+                                   __is_memmove_copyable<InputIt, OutputIt>{});
+}
+
+// 平凡可复制类型的移动就是复制
+template <class InputIt, class OutputIt>
+OutputIt
+__move_trivial(InputIt first, InputIt last, OutputIt result, std::false_type)
+{
+    return std::move(first, last, result);
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__move_trivial(InputIt first, InputIt last, OutputIt result, std::true_type)
+{
+    return deonSTL::__copy_trivial(first, last, result, std::true_type{});
+}
+
+template <class InputIt, class OutputIt>
+OutputIt
+__move_trivial(InputIt first, InputIt last, OutputIt result)
+{
+    return deonSTL::__move_trivial(first, last, result,
+                                   __is_memmove_copyable<InputIt, OutputIt>{});
+}
+
+//***************************************************************************//
+//                               __fill_trivial                              //
+//***************************************************************************//
+
+// __byte_pattern 对象的每个字节都相同时返回 true，并由 byte 带回这个字节（如 0、-1、字符）
+template <class T>
+bool
+__byte_pattern(const T& value, unsigned char& byte)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+    byte = p[0];
+    for(size_t i = 1; i < sizeof(T); ++i)
+        if(p[i] != byte)
+            return false;
+    return true;
+}
+
+// __fill_n_wide 4/8 字节的值先用标量写到 SIMD 对齐，再整块广播写入，最后标量写入余下部分
+template <class T>
+T*
+__fill_n_wide(T* first, size_t n, const T& value, std::false_type)
+{
+    return std::fill_n(first, n, value);
+}
+
+template <class T>
+T*
+__fill_n_wide(T* first, size_t n, const T& value, std::true_type)
+{
+#if DEONSTL_SIMD_BYTES
+    typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type word_type;
+    const size_t per = DEONSTL_SIMD_BYTES / sizeof(T);
+    word_type word;
+    std::memcpy(&word, &value, sizeof(T));
+    const __simd_vec v = __simd_set1(word);
+    const bool aligned = reinterpret_cast<uintptr_t>(first) % sizeof(T) == 0;
+    if(aligned && n * sizeof(T) >= __nt_store_threshold)
+    {
+        for(; reinterpret_cast<uintptr_t>(first) % DEONSTL_SIMD_BYTES != 0; --n)
+            *first++ = value;
+        for(; n >= per; n -= per, first += per)
+            __simd_stream(first, v);
+        _mm_sfence();   // 非临时写入对其他线程可见之前需要 sfence
+    }
+    else
+    {
+        for(; n >= per; n -= per, first += per)
+            __simd_store(first, v);
+    }
+#endif
+    for(; n > 0; --n)
+        *first++ = value;
+    return first;
+}
+
+// __fill_kernel 在 [first, first+n) 填充 value
+template <class T>
+T*
+__fill_kernel(T* first, size_t n, const T& value)
+{
+    unsigned char byte;
+    if(__byte_pattern(value, byte))
+    {
+        if(n != 0)
+            std::memset(static_cast<void*>(first), byte, n * sizeof(T));
+        return first + n;
+    }
+    return deonSTL::__fill_n_wide(first, n, value,
+                                  std::integral_constant<bool, sizeof(T) == 4 || sizeof(T) == 8>{});
+}
+
+// 目的为平凡可复制类型的指针时使用上面的内核，否则交给 std::fill_n
+template <class ForwardIt>
+struct __is_memset_fillable
+: std::integral_constant<bool,
+    std::is_pointer<ForwardIt>::value &&
+    std::is_trivially_copyable<typename std::remove_pointer<ForwardIt>::type>::value> {};
+
+template <class ForwardIt, class Size, class T>
+ForwardIt
+__fill_n_trivial(ForwardIt first, Size n, const T& value, std::false_type)
+{
+    return std::fill_n(first, n, value);
+}
+
+template <class ForwardIt, class Size, class T>
+ForwardIt
+__fill_n_trivial(ForwardIt first, Size n, const T& value, std::true_type)
+{
+    typedef typename std::remove_pointer<ForwardIt>::type value_type;
+    if(!(n > 0))
+        return first;
+    const value_type v = value;     // 可能需要类型转换（如用 int 填充 double）
+    return deonSTL::__fill_kernel(first, static_cast<size_t>(n), v);
+}
+
+template <class ForwardIt, class Size, class T>
+ForwardIt
+__fill_n_trivial(ForwardIt first, Size n, const T& value)
+{
+    return deonSTL::__fill_n_trivial(first, n, value, __is_memset_fillable<ForwardIt>{});
+}
+
+template <class ForwardIt, class T>
+void
+__fill_trivial(ForwardIt first, ForwardIt last, const T& value, std::false_type)
+{
+    std::fill(first, last, value);
+}
+
+template <class ForwardIt, class T>
+void
+__fill_trivial(ForwardIt first, ForwardIt last, const T& value, std::true_type)
+{
+    deonSTL::__fill_n_trivial(first, last - first, value, std::true_type{});
+}
+
+template <class ForwardIt, class T>
+void
+__fill_trivial(ForwardIt first, ForwardIt last, const T& value)
+{
+    deonSTL::__fill_trivial(first, last, value, __is_memset_fillable<ForwardIt>{});
+}
+
+} // namespace deonSTL
+
+#endif /* memory_kernel_h */
@@ -0,0 +1,379 @@
+//
+//  memory_resource.h
+//  deonSTL
+//
+//  这个头文件包含内存资源 memory_resource 及其实现，以及配合容器使用的配置器
+//  memory_resource            : 内存资源抽象基类，按 (字节数, 对齐) 申请/释放
+//  monotonic_buffer_resource  : 单调增长的 arena，申请为指针递增，释放为空操作，release() 整体归还
+//  polymorphic_allocator      : 持有 memory_resource 指针的配置器，同一容器类型可使用不同的内存资源
+//  monotonic_allocator        : 直接绑定 monotonic_buffer_resource 的配置器，申请内联为指针递增
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef memory_resource_h
+#define memory_resource_h
+
+#include <cstddef>  // size_t, max_align_t
+#include <cstdint>  // uintptr_t
+#include <new>      // operator new, bad_alloc
+#include <atomic>   // atomic
+#include "allocator.h"
+
+namespace deonSTL {
+
+//***************************************************************************//
+//                              memory_resource                              //
+//                 公有接口不是虚函数，由派生类实现 do_allocate 等                      //
+//***************************************************************************//
+
+class memory_resource
+{
+public:
+    virtual ~memory_resource() {}
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+    { return do_allocate(bytes, align); }
+
+    void  deallocate(void* ptr, size_t bytes, size_t align = alignof(std::max_align_t))
+    { do_deallocate(ptr, bytes, align); }
+
+    // 一个资源申请的内存能否由另一个资源释放
+    bool  is_equal(const memory_resource& other) const noexcept
+    { return do_is_equal(other); }
+
+private:
+    virtual void* do_allocate(size_t bytes, size_t align) = 0;
+    virtual void  do_deallocate(void* ptr, size_t bytes, size_t align) = 0;
+    virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+
+}; // class memory_resource
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{ return &lhs == &rhs || lhs.is_equal(rhs); }
+
+inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{ return !(lhs == rhs); }
+
+//***************************************************************************//
+//                            new_delete_resource                            //
+//***************************************************************************//
+
+class new_delete_memory_resource : public memory_resource
+{
+private:
+    // 超过 operator new 默认对齐的请求多申请 align 字节，在返回地址前保存原始指针
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        if(align <= alignof(std::max_align_t))
+            return ::operator new(bytes);
+        if(bytes > static_cast<size_t>(-1) - align - sizeof(void*))
+            throw std::bad_alloc();
+        void* raw = ::operator new(bytes + align + sizeof(void*));
+        uintptr_t p = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + align - 1)
+                      & ~(static_cast<uintptr_t>(align) - 1);
+        reinterpret_cast<void**>(p)[-1] = raw;
+        return reinterpret_cast<void*>(p);
+    }
+
+    void  do_deallocate(void* ptr, size_t, size_t align) override
+    {
+        if(ptr == nullptr) return;
+        if(align <= alignof(std::max_align_t))
+            ::operator delete(ptr);
+        else
+            ::operator delete(static_cast<void**>(ptr)[-1]);
+    }
+
+    bool  do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+}; // class new_delete_memory_resource
+
+// new_delete_resource 返回全局唯一的 new_delete_memory_resource，不析构
+inline memory_resource* new_delete_resource() noexcept
+{
+    static new_delete_memory_resource* resource = new new_delete_memory_resource;
+    return resource;
+}
+
+inline std::atomic<memory_resource*>& default_resource_ptr() noexcept
+{
+    static std::atomic<memory_resource*> ptr(new_delete_resource());
+    return ptr;
+}
+
+// 缺省内存资源，polymorphic_allocator 默认构造时使用
+inline memory_resource* get_default_resource() noexcept
+{ return default_resource_ptr().load(); }
+
+// 设置缺省内存资源，传入 nullptr 恢复为 new_delete_resource，返回原来的资源
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{ return default_resource_ptr().exchange(r != nullptr ? r : new_delete_resource()); }
+
+//***************************************************************************//
+//                         monotonic_buffer_resource                         //
+//           从当前块中按指针递增切割内存，块用完时向上游申请一个两倍大的新块              //
+//         deallocate 什么都不做，release() 或析构时把所有块一次性归还上游             //
+//***************************************************************************//
+
+class monotonic_buffer_resource : public memory_resource
+{
+private:
+    // 每个向上游申请的块头部记录块大小，块之间单向链接
+    struct chunk
+    {
+        chunk* prev;
+        size_t size;
+    };
+
+    static constexpr size_t INITIAL_SIZE = 1024;    // 未指定时第一个块的大小
+    static constexpr size_t GROWTH = 2;             // 块大小增长倍数
+
+    memory_resource* upstream_;
+    void*            initial_buf_;  // 用户提供的初始缓冲区，不归还
+    size_t           initial_size_;
+    char*            cur_;          // 当前块未使用部分
+    char*            end_;
+    chunk*           chunks_;       // 最近申请的块
+    size_t           next_size_;    // 下一个块的大小
+    size_t           first_size_;   // 第一个块的大小，release 后恢复
+
+public:
+    explicit monotonic_buffer_resource(memory_resource* upstream = get_default_resource())
+    : upstream_(upstream), initial_buf_(nullptr), initial_size_(0),
+      cur_(nullptr), end_(nullptr), chunks_(nullptr),
+      next_size_(INITIAL_SIZE), first_size_(INITIAL_SIZE) {}
+
+    explicit monotonic_buffer_resource(size_t initial_size,
+                                       memory_resource* upstream = get_default_resource())
+    : upstream_(upstream), initial_buf_(nullptr), initial_size_(0),
+      cur_(nullptr), end_(nullptr), chunks_(nullptr),
+      next_size_(initial_size > sizeof(chunk) ? initial_size : size_t(INITIAL_SIZE)),
+      first_size_(next_size_) {}
+
+    // 先使用栈上（或其他地方）的缓冲区 [buffer, buffer + size)，不够时才向上游申请
+    monotonic_buffer_resource(void* buffer, size_t size,
+                              memory_resource* upstream = get_default_resource())
+    : upstream_(upstream), initial_buf_(buffer), initial_size_(size),
+      cur_(static_cast<char*>(buffer)), end_(static_cast<char*>(buffer) + size),
+      chunks_(nullptr), next_size_(size > INITIAL_SIZE ? grown_size(size) : size_t(INITIAL_SIZE)),
+      first_size_(next_size_) {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+    ~monotonic_buffer_resource()
+    { release(); }
+
+    // bump 指针递增申请，内联的快速路径，monotonic_allocator 直接调用
+    // 比较剩余字节数而不是 p + bytes，bytes 很大时不会回绕
+    void* bump(size_t bytes, size_t align)
+    {
+        const uintptr_t p = (reinterpret_cast<uintptr_t>(cur_) + align - 1)
+                            & ~(static_cast<uintptr_t>(align) - 1);
+        const uintptr_t e = reinterpret_cast<uintptr_t>(end_);
+        if(cur_ != nullptr && p <= e && bytes <= e - p)
+        {
+            cur_ = reinterpret_cast<char*>(p + bytes);
+            return reinterpret_cast<void*>(p);
+        }
+        return bump_slow(bytes, align);
+    }
+
+    // release 归还全部块，回到构造时的状态；已申请的内存全部失效
+    void release() noexcept;
+
+    memory_resource* upstream_resource() const noexcept
+    { return upstream_; }
+
+private:
+    void* bump_slow(size_t bytes, size_t align);
+
+    // size 增长一次，溢出时停在 size_t 的最大值
+    static size_t grown_size(size_t size) noexcept
+    { return size <= static_cast<size_t>(-1) / GROWTH ? size * GROWTH : static_cast<size_t>(-1); }
+
+    void* do_allocate(size_t bytes, size_t align) override
+    { return bump(bytes, align); }
+
+    void  do_deallocate(void*, size_t, size_t) override
+    {}
+
+    bool  do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+}; // class monotonic_buffer_resource
+
+// bump_slow 当前块不足，向上游申请一个能容纳请求的新块
+// 请求大到块头 + 请求 + 对齐超出 size_t 时抛出 bad_alloc；倍增越界时块大小取 need
+inline void*
+monotonic_buffer_resource::bump_slow(size_t bytes, size_t align)
+{
+    const size_t max_size = static_cast<size_t>(-1);
+    if(bytes > max_size - sizeof(chunk) - align)
+        throw std::bad_alloc();
+    const size_t need = sizeof(chunk) + bytes + align;
+    size_t size = next_size_;
+    while(size < need)
+    {
+        const size_t next = grown_size(size);
+        if(next == max_size)
+        {
+            size = need;
+            break;
+        }
+        size = next;
+    }
+    chunk* c = static_cast<chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+    c->prev = chunks_;
+    c->size = size;
+    chunks_ = c;
+    cur_ = reinterpret_cast<char*>(c + 1);
+    end_ = reinterpret_cast<char*>(c) + size;
+    next_size_ = grown_size(size);
+
+    const uintptr_t p = (reinterpret_cast<uintptr_t>(cur_) + align - 1)
+                        & ~(static_cast<uintptr_t>(align) - 1);
+    cur_ = reinterpret_cast<char*>(p + bytes);
+    return reinterpret_cast<void*>(p);
+}
+
+// 块大小按倍数增长，块的个数是申请总量的对数，与元素个数无关
+inline void
+monotonic_buffer_resource::release() noexcept
+{
+    while(chunks_ != nullptr)
+    {
+        chunk* prev = chunks_->prev;
+        upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+        chunks_ = prev;
+    }
+    cur_ = static_cast<char*>(initial_buf_);
+    end_ = cur_ + initial_size_;
+    next_size_ = first_size_;
+}
+
+//***************************************************************************//
+//                           polymorphic_allocator                           //
+//                      接口同 allocator，可作为容器的 Alloc 参数                    //
+//***************************************************************************//
+
+template <class T>
+class polymorphic_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef polymorphic_allocator<U> other;
+    };
+
+private:
+    memory_resource* resource_;
+
+public:
+    polymorphic_allocator() noexcept
+    : resource_(get_default_resource()) {}
+
+    // 允许由 memory_resource* 隐式转换，方便 vector<int, polymorphic_allocator<int>> v(&arena)
+    polymorphic_allocator(memory_resource* r) noexcept
+    : resource_(r) {}
+
+    polymorphic_allocator(const polymorphic_allocator&) noexcept = default;
+
+    template <class U>
+    polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept
+    : resource_(rhs.resource()) {}
+
+    T* allocate(size_type n)
+    { return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T))); }
+
+    void deallocate(T* ptr, size_type n)
+    { resource_->deallocate(ptr, n * sizeof(T), alignof(T)); }
+
+    memory_resource* resource() const noexcept
+    { return resource_; }
+
+}; // class polymorphic_allocator
+
+template <class T, class U>
+bool operator==(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+{ return *lhs.resource() == *rhs.resource(); }
+
+template <class T, class U>
+bool operator!=(const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs) noexcept
+{ return !(lhs == rhs); }
+
+//***************************************************************************//
+//                            monotonic_allocator                            //
+//       直接持有 monotonic_buffer_resource*，申请内联为指针递增，没有虚函数调用           //
+//***************************************************************************//
+
+template <class T>
+class monotonic_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef monotonic_allocator<U> other;
+    };
+
+private:
+    monotonic_buffer_resource* arena_;
+
+public:
+    monotonic_allocator(monotonic_buffer_resource* arena) noexcept
+    : arena_(arena) {}
+
+    monotonic_allocator(const monotonic_allocator&) noexcept = default;
+
+    template <class U>
+    monotonic_allocator(const monotonic_allocator<U>& rhs) noexcept
+    : arena_(rhs.arena()) {}
+
+    T* allocate(size_type n)
+    { return static_cast<T*>(arena_->bump(n * sizeof(T), alignof(T))); }
+
+    // 空间在 arena release 时整体归还
+    void deallocate(T*, size_type) noexcept
+    {}
+
+    monotonic_buffer_resource* arena() const noexcept
+    { return arena_; }
+
+}; // class monotonic_allocator
+
+template <class T, class U>
+bool operator==(const monotonic_allocator<T>& lhs, const monotonic_allocator<U>& rhs) noexcept
+{ return lhs.arena() == rhs.arena(); }
+
+template <class T, class U>
+bool operator!=(const monotonic_allocator<T>& lhs, const monotonic_allocator<U>& rhs) noexcept
+{ return !(lhs == rhs); }
+
+// monotonic_allocator 的 deallocate 为空操作
+template <class T>
+struct deallocate_is_noop<monotonic_allocator<T>> : std::true_type {};
+
+}// namespace deonSTL
+
+#endif /* memory_resource_h */
@@ -0,0 +1,346 @@
+//
+//  mpmc_queue.h
+//  deonSTL
+//
+//  这个头文件包含模板类 mpmc_queue：多生产者、多消费者的有界队列（每个位置带序号的环形数组）
+//  try_push / try_pop 不阻塞，满或空时返回 false；push / pop 在满或空时自旋等待，等待久了让出 cpu
+//
+//  每个位置 cell 有一个序号 seq：
+//  seq == pos         位置空闲，逻辑位置为 pos 的生产者可以写入
+//  seq == pos + 1     元素已写好，逻辑位置为 pos 的消费者可以读出
+//  seq == pos + cap   读出后空出，留给下一圈的生产者
+//  生产者、消费者分别用 CAS 抢占 enqueue_pos_、dequeue_pos_，抢到后只访问自己的 cell，
+//  两个下标、以及每个 cell 都独占缓存行，不同线程写的数据不会落在同一缓存行上
+//
+//  元素用 construct.h 的 construct / destroy 构造、析构，要求元素的移动构造、移动赋值不抛出异常
+//  不能由参数无异常构造的元素先在抢占位置之前构造成临时对象：抢到的位置必须被填上，否则消费者会一直等在这个位置，
+//  因此这时 try_emplace 在队列满返回 false 时，右值参数可能已被移动
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef mpmc_queue_h
+#define mpmc_queue_h
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uintptr_t
+#include <atomic>
+#include <thread>       // this_thread::yield
+#include <new>          // placement new
+#include <utility>      // move, forward
+#include <type_traits>  // aligned_storage, is_nothrow_constructible, is_nothrow_move_assignable
+#include "allocator.h"
+#include "construct.h"
+#include "spsc_queue.h" // cache_line_size
+
+namespace deonSTL{
+
+// 模版类 mpmc_queue
+// 容量向上取整为 2 的幂（至少为 2），cell 的空间由 Alloc rebind 得到的配置器申请
+template <class T, class Alloc = deonSTL::allocator<T>>
+class mpmc_queue : private deonSTL::alloc_holder<Alloc>
+{
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "mpmc_queue requires a nothrow move constructor");
+    // try_pop 抢到位置后把元素移动赋值给调用者，抛出异常会让这个位置永远不能交还给生产者
+    static_assert(std::is_nothrow_move_assignable<T>::value,
+                  "mpmc_queue requires a nothrow move assignment");
+
+public:
+
+    typedef Alloc                                       allocator_type;
+
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+
+private:
+    typedef std::atomic<size_type>                      index_type;
+
+    struct cell_data
+    {
+        index_type                                                  seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type  value;
+    };
+    // cell 的大小向上取整为缓存行的整数倍
+    static const size_type cell_bytes =
+        (sizeof(cell_data) + cache_line_size - 1) / cache_line_size * cache_line_size;
+    typedef typename std::aligned_storage<cell_bytes, alignof(cell_data)>::type cell;
+
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    typedef typename Alloc::template rebind<cell>::other cell_allocator;
+
+    // 两个线程都只读
+    cell*           raw_;       // 申请到的空间（多申请一个 cell 用于对齐）
+    char*           cells_;     // 对齐到缓存行的第一个 cell
+    size_type       cap_;
+    size_type       mask_;
+    char            pad0_[cache_line_size];
+
+    index_type      enqueue_pos_;   // 生产者抢占
+    char            pad1_[cache_line_size];
+
+    index_type      dequeue_pos_;   // 消费者抢占
+    char            pad2_[cache_line_size];
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    explicit mpmc_queue(size_type capacity, const allocator_type& alloc = allocator_type());
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue();
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+
+    size_type           capacity()    const noexcept
+    { return cap_; }
+
+    // 其他线程同时在操作时只是一个近似值
+    size_type           size_approx() const noexcept
+    {
+        const size_type deq = dequeue_pos_.load(std::memory_order_acquire);
+        const size_type enq = enqueue_pos_.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    // 不阻塞：满时返回 false
+    template <class ...Args>
+    bool        try_emplace(Args&& ...args);
+    bool        try_push(const value_type& value) { return try_emplace(value); }
+    bool        try_push(value_type&& value)      { return try_emplace(std::move(value)); }
+
+    // 不阻塞：空时返回 false
+    bool        try_pop(value_type& value);
+
+    // 阻塞：满时等待
+    template <class ...Args>
+    void        emplace(Args&& ...args);
+    void        push(const value_type& value) { emplace(value); }
+    void        push(value_type&& value)      { emplace(std::move(value)); }
+
+    // 阻塞：空时等待
+    void        pop(value_type& value);
+
+private:
+    // ==========================辅助函数============================ //
+
+    cell_data*  cell_at(size_type pos) const noexcept
+    { return reinterpret_cast<cell_data*>(cells_ + (pos & mask_) * cell_bytes); }
+
+    // 抢占一个可写/可读的位置，失败返回 nullptr
+    cell_data*  claim_enqueue(size_type& pos) noexcept;
+    cell_data*  claim_dequeue(size_type& pos) noexcept;
+
+    // 能由参数无异常构造时抢到位置后原地构造，否则先构造临时对象（可能抛出异常），再抢位置移动进去
+    template <class ...Args>
+    bool        try_emplace_dispatch(std::true_type, Args&& ...args);
+    template <class ...Args>
+    bool        try_emplace_dispatch(std::false_type, Args&& ...args);
+    template <class ...Args>
+    void        emplace_dispatch(std::true_type, Args&& ...args);
+    template <class ...Args>
+    void        emplace_dispatch(std::false_type, Args&& ...args);
+
+    template <class ...Args>
+    struct nothrow_from : std::integral_constant<bool,
+        std::is_nothrow_constructible<T, Args...>::value> {};
+
+    // 自旋等待，次数多了以后让出 cpu
+    static void backoff(unsigned& spins) noexcept
+    {
+        if(++spins > 64)
+            std::this_thread::yield();
+    }
+
+};// class mpmc_queue
+
+//***************************************************************************//
+//                           member functions                                //
+//***************************************************************************//
+
+// 构造函数 申请 cap_ + 1 个 cell，第一个 cell 对齐到缓存行，seq 初始化为各自的下标
+template <class T, class Alloc>
+mpmc_queue<T, Alloc>::mpmc_queue(size_type capacity, const allocator_type& alloc)
+: alloc_base(alloc), enqueue_pos_(0), dequeue_pos_(0)
+{
+    cap_ = 2;
+    while(cap_ < capacity)
+        cap_ <<= 1;
+    mask_ = cap_ - 1;
+    raw_ = cell_allocator(this->get_alloc()).allocate(cap_ + 1);
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(raw_);
+    cells_ = reinterpret_cast<char*>(raw_) + (cache_line_size - addr % cache_line_size) % cache_line_size;
+    for(size_type i = 0; i < cap_; ++i)
+        ::new (static_cast<void*>(&cell_at(i)->seq)) index_type(i);
+}
+
+// 析构函数 析构队列中剩下的元素（此时不能有其他线程在使用队列）
+template <class T, class Alloc>
+mpmc_queue<T, Alloc>::~mpmc_queue()
+{
+    const size_type enq = enqueue_pos_.load(std::memory_order_relaxed);
+    for(size_type pos = dequeue_pos_.load(std::memory_order_relaxed); pos != enq; ++pos)
+    {
+        cell_data* c = cell_at(pos);
+        if(c->seq.load(std::memory_order_relaxed) == pos + 1)
+            deonSTL::destroy(reinterpret_cast<T*>(&c->value));
+    }
+    cell_allocator(this->get_alloc()).deallocate(raw_, cap_ + 1);
+}
+
+// try_emplace 满时返回 false
+template <class T, class Alloc>
+template <class ...Args>
+bool
+mpmc_queue<T, Alloc>::try_emplace(Args&& ...args)
+{
+    return try_emplace_dispatch(nothrow_from<Args...>(), std::forward<Args>(args)...);
+}
+
+// try_pop 抢到位置后移出元素，再把 seq 设为 pos + cap_ 交给下一圈的生产者
+template <class T, class Alloc>
+bool
+mpmc_queue<T, Alloc>::try_pop(value_type& value)
+{
+    size_type pos;
+    cell_data* c = claim_dequeue(pos);
+    if(c == nullptr)
+        return false;
+    T* p = reinterpret_cast<T*>(&c->value);
+    value = std::move(*p);
+    deonSTL::destroy(p);
+    c->seq.store(pos + cap_, std::memory_order_release);
+    return true;
+}
+
+// emplace 满时等待
+template <class T, class Alloc>
+template <class ...Args>
+void
+mpmc_queue<T, Alloc>::emplace(Args&& ...args)
+{
+    emplace_dispatch(nothrow_from<Args...>(), std::forward<Args>(args)...);
+}
+
+// pop 空时等待
+template <class T, class Alloc>
+void
+mpmc_queue<T, Alloc>::pop(value_type& value)
+{
+    unsigned spins = 0;
+    while(!try_pop(value))
+        backoff(spins);
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+// try_emplace_dispatch 抢到位置后原地构造元素，再把 seq 设为 pos + 1（release）交给消费者
+template <class T, class Alloc>
+template <class ...Args>
+bool
+mpmc_queue<T, Alloc>::try_emplace_dispatch(std::true_type, Args&& ...args)
+{
+    size_type pos;
+    cell_data* c = claim_enqueue(pos);
+    if(c == nullptr)
+        return false;
+    deonSTL::construct(reinterpret_cast<T*>(&c->value), std::forward<Args>(args)...);
+    c->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// try_emplace_dispatch 构造可能抛出异常：在抢占位置之前构造临时对象，抢到后只做不抛出异常的移动
+template <class T, class Alloc>
+template <class ...Args>
+bool
+mpmc_queue<T, Alloc>::try_emplace_dispatch(std::false_type, Args&& ...args)
+{
+    T tmp(std::forward<Args>(args)...);
+    return try_emplace_dispatch(std::true_type(), std::move(tmp));
+}
+
+// emplace_dispatch 自旋直到抢到位置，参数只在抢到之后使用一次
+template <class T, class Alloc>
+template <class ...Args>
+void
+mpmc_queue<T, Alloc>::emplace_dispatch(std::true_type, Args&& ...args)
+{
+    size_type pos;
+    cell_data* c;
+    unsigned spins = 0;
+    while((c = claim_enqueue(pos)) == nullptr)
+        backoff(spins);
+    deonSTL::construct(reinterpret_cast<T*>(&c->value), std::forward<Args>(args)...);
+    c->seq.store(pos + 1, std::memory_order_release);
+}
+
+template <class T, class Alloc>
+template <class ...Args>
+void
+mpmc_queue<T, Alloc>::emplace_dispatch(std::false_type, Args&& ...args)
+{
+    T tmp(std::forward<Args>(args)...);
+    emplace_dispatch(std::true_type(), std::move(tmp));
+}
+
+// claim_enqueue seq == pos 时用 CAS 把 enqueue_pos_ 推进一格；seq < pos 说明这一圈的元素还没被取走，队列满
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::cell_data*
+mpmc_queue<T, Alloc>::claim_enqueue(size_type& pos) noexcept
+{
+    pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        cell_data* c = cell_at(pos);
+        const size_type seq = c->seq.load(std::memory_order_acquire);
+        const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - pos);
+        if(diff == 0)
+        {
+            if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return c;
+        }
+        else if(diff < 0)
+            return nullptr;
+        else
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+}
+
+// claim_dequeue seq == pos + 1 时用 CAS 把 dequeue_pos_ 推进一格；seq < pos + 1 说明元素还没写好，队列空
+template <class T, class Alloc>
+typename mpmc_queue<T, Alloc>::cell_data*
+mpmc_queue<T, Alloc>::claim_dequeue(size_type& pos) noexcept
+{
+    pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        cell_data* c = cell_at(pos);
+        const size_type seq = c->seq.load(std::memory_order_acquire);
+        const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - (pos + 1));
+        if(diff == 0)
+        {
+            if(dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return c;
+        }
+        else if(diff < 0)
+            return nullptr;
+        else
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+}
+
+}// namespace deonSTL
+
+#endif /* mpmc_queue_h */
@@ -11,6 +11,7 @@
 #ifndef numeric_h
 #define numeric_h
 
+#include <type_traits>
 #include "iterator.h"
 
 namespace deonSTL {
@@ -19,25 +20,72 @@ namespace deonSTL {
 // accumulate
 // 版本1：以初值 init 对每个元素进行累加
 // 版本2：以初值 init 对每个元素进行二元操作
+// 分段迭代器（如 deque 迭代器）逐块累加，块内是原生指针上的连续循环
 // ====================================================== //
 // 版本 1
 template <class InputIter, class T>
-T accumulate(InputIter first, InputIter last, T init)
+T __accumulate(InputIter first, InputIter last, T init, std::false_type)
 {
     for(; first != last; ++first)
         init += *first;
     return init;
 }
 
+template <class InputIter, class T>
+T __accumulate(InputIter first, InputIter last, T init, std::true_type)
+{
+    typedef segmented_iterator_traits<InputIter> traits;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(last);
+    if(sfirst == slast)
+        return deonSTL::__accumulate(traits::local(first), traits::local(last), init, std::false_type{});
+    init = deonSTL::__accumulate(traits::local(first), traits::end(sfirst), init, std::false_type{});
+    for(++sfirst; sfirst != slast; ++sfirst)
+        init = deonSTL::__accumulate(traits::begin(sfirst), traits::end(sfirst), init, std::false_type{});
+    return deonSTL::__accumulate(traits::begin(slast), traits::local(last), init, std::false_type{});
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter first, InputIter last, T init)
+{
+    return deonSTL::__accumulate(first, last, init,
+                        typename segmented_iterator_traits<InputIter>::is_segmented_iterator{});
+}
+
 // 版本 2
 template <class InputIter, class T, class BinaryOp>
-T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
+T __accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op, std::false_type)
 {
     for(; first != last; ++first)
         init = binary_op(init, *first);
     return init;
 }
 
+template <class InputIter, class T, class BinaryOp>
+T __accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op, std::true_type)
+{
+    typedef segmented_iterator_traits<InputIter> traits;
+    auto sfirst = traits::segment(first);
+    auto slast = traits::segment(last);
+    if(sfirst == slast)
+        return deonSTL::__accumulate(traits::local(first), traits::local(last), init, binary_op,
+                            std::false_type{});
+    init = deonSTL::__accumulate(traits::local(first), traits::end(sfirst), init, binary_op,
+                        std::false_type{});
+    for(++sfirst; sfirst != slast; ++sfirst)
+        init = deonSTL::__accumulate(traits::begin(sfirst), traits::end(sfirst), init, binary_op,
+                            std::false_type{});
+    return deonSTL::__accumulate(traits::begin(slast), traits::local(last), init, binary_op,
+                        std::false_type{});
+}
+
+template <class InputIter, class T, class BinaryOp>
+T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+    return deonSTL::__accumulate(first, last, init, binary_op,
+                        typename segmented_iterator_traits<InputIter>::is_segmented_iterator{});
+}
+
 
 // ====================================================== //
 // adjacent_difference
@@ -0,0 +1,403 @@
+//
+//  pool_allocator.h
+//  deonSTL
+//
+//  这个头文件包含一个内存池 pool_alloc 和模板类 pool_allocator
+//  pool_alloc     : 按大小分级的内存池，每一级一条空闲链表，链表空时从大块 slab 中切割补充
+//  pool_allocator : 接口与 allocator 相同，底层使用 pool_alloc，可直接替换 allocator
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef pool_allocator_h
+#define pool_allocator_h
+
+#include <cstddef>  // size_t, ptrdiff_t
+#include <cstdint>  // uintptr_t
+#include <new>      // operator new
+#include <mutex>    // mutex, lock_guard
+#include "construct.h"
+
+namespace deonSTL {
+
+//***************************************************************************//
+//                                pool_alloc                                 //
+//        小块内存（<= MAX_BYTES）按 ALIGN 分级，大块内存直接使用 operator new          //
+//         每个线程持有一份缓存（无锁），缓存空/过满时才与中心池（加锁）批量交换            //
+//***************************************************************************//
+
+class pool_alloc
+{
+public:
+    enum { ALIGN       = 16 };                  // 分级粒度，也是返回内存的对齐
+    enum { MAX_BYTES   = 512 };                 // 超过此大小不进内存池
+    enum { NFREELISTS  = MAX_BYTES / ALIGN };   // 空闲链表个数
+    enum { SLAB_BYTES  = 64 * 1024 };           // 每次向系统申请的 slab 大小
+    enum { BATCH       = 32 };                  // 线程缓存与中心池一次交换的块数
+    enum { CACHE_LIMIT = 4 * BATCH };           // 线程缓存单条链表的上限，超过则归还中心池
+
+private:
+    // 空闲块复用自身空间存放 next 指针
+    union obj
+    {
+        obj* next;
+    };
+
+    struct free_list
+    {
+        obj*   head;
+        size_t count;
+    };
+
+    // 中心池，所有线程共享
+    struct central_pool
+    {
+        std::mutex mtx;
+        free_list  lists[NFREELISTS];
+        char*      slab_begin;  // 当前 slab 未切割部分
+        char*      slab_end;
+
+        central_pool() : lists(), slab_begin(nullptr), slab_end(nullptr) {}
+    };
+
+    // 线程退出时把线程缓存的全部空闲块归还中心池
+    struct cache_guard
+    {
+        ~cache_guard();
+    };
+
+public:
+    static void* allocate(size_t n);
+    static void  deallocate(void* ptr, size_t n);
+
+private:
+    static size_t round_up(size_t bytes)
+    { return (bytes + ALIGN - 1) & ~(static_cast<size_t>(ALIGN) - 1); }
+    static size_t freelist_index(size_t bytes)
+    { return (bytes + ALIGN - 1) / ALIGN - 1; }
+
+    // 中心池不析构：进程退出时仍可能有静态容器归还内存
+    static central_pool& central()
+    {
+        static central_pool* pool = new central_pool;
+        return *pool;
+    }
+
+    // 线程缓存，平凡类型零初始化，访问时没有构造检查
+    static free_list* cache()
+    {
+        static thread_local free_list lists[NFREELISTS];
+        return lists;
+    }
+
+    // 第一次补充缓存或向缓存放入块时注册，线程退出时由 cache_guard 归还缓存
+    // 只释放不申请的线程（如生产者/消费者中的消费者）也要注册，否则退出时缓存中的块丢失
+    static void register_cache()
+    {
+        static thread_local cache_guard guard;
+        (void)guard;
+    }
+
+    // 线程缓存已归还（线程退出阶段）时直接访问中心池
+    static bool& cache_destroyed()
+    {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static void refill(free_list& list, size_t bytes);
+    static void release(free_list& list, size_t index, size_t count);
+    static void carve_slab(free_list& list, size_t bytes, size_t count);
+
+}; // class pool_alloc
+
+// allocate 申请 n 字节
+inline void*
+pool_alloc::allocate(size_t n)
+{
+    if(n > static_cast<size_t>(MAX_BYTES))
+        return ::operator new(n);
+    const size_t index = freelist_index(n);
+    if(cache_destroyed())
+    {
+        central_pool& c = central();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        free_list& list = c.lists[index];
+        if(list.head == nullptr)
+            carve_slab(list, round_up(n), 1);
+        obj* result = list.head;
+        list.head = result->next;
+        --list.count;
+        return result;
+    }
+    free_list& list = cache()[index];
+    if(list.head == nullptr)
+        refill(list, round_up(n));
+    obj* result = list.head;
+    list.head = result->next;
+    --list.count;
+    return result;
+}
+
+// deallocate 归还 ptr 开始的 n 字节，n 须与申请时一致
+inline void
+pool_alloc::deallocate(void* ptr, size_t n)
+{
+    if(ptr == nullptr) return;
+    if(n > static_cast<size_t>(MAX_BYTES))
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    const size_t index = freelist_index(n);
+    obj* block = static_cast<obj*>(ptr);
+    if(cache_destroyed())
+    {
+        central_pool& c = central();
+        std::lock_guard<std::mutex> lock(c.mtx);
+        block->next = c.lists[index].head;
+        c.lists[index].head = block;
+        ++c.lists[index].count;
+        return;
+    }
+    register_cache();
+    free_list& list = cache()[index];
+    block->next = list.head;
+    list.head = block;
+    if(++list.count > static_cast<size_t>(CACHE_LIMIT))
+        release(list, index, BATCH); // 防止某个线程只释放不申请而囤积内存
+}
+
+// refill 线程缓存的链表为空，从中心池取 BATCH 个 bytes 大小的块
+inline void
+pool_alloc::refill(free_list& list, size_t bytes)
+{
+    register_cache();
+    central_pool& c = central();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    free_list& src = c.lists[freelist_index(bytes)];
+    if(src.head == nullptr)
+    {
+        carve_slab(list, bytes, BATCH);
+        return;
+    }
+    // 中心池链表可能很长（其他线程退出时归还），只取 BATCH 个
+    size_t n = 0;
+    while(src.head != nullptr && n < static_cast<size_t>(BATCH))
+    {
+        obj* block = src.head;
+        src.head = block->next;
+        block->next = list.head;
+        list.head = block;
+        ++n;
+    }
+    src.count -= n;
+    list.count += n;
+}
+
+// release 把线程缓存第 index 条链表头部 count 个块归还中心池
+inline void
+pool_alloc::release(free_list& list, size_t index, size_t count)
+{
+    obj* first = list.head;
+    obj* last = first;
+    for(size_t i = 1; i < count; ++i)
+        last = last->next;
+    list.head = last->next;
+    list.count -= count;
+
+    central_pool& c = central();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    free_list& dst = c.lists[index];
+    last->next = dst.head;
+    dst.head = first;
+    dst.count += count;
+}
+
+// carve_slab 从当前 slab 切出至多 count 个 bytes 大小的块放入 list（已持锁）
+// slab 剩余不足一个块时，把零头挂到对应的链表，再申请新的 slab
+inline void
+pool_alloc::carve_slab(free_list& list, size_t bytes, size_t count)
+{
+    central_pool& c = central();
+    size_t left = static_cast<size_t>(c.slab_end - c.slab_begin);
+    if(left < bytes)
+    {
+        if(left != 0)
+        {// 零头也是 ALIGN 的倍数，放入对应链表
+            free_list& rest = c.lists[freelist_index(left)];
+            obj* block = reinterpret_cast<obj*>(c.slab_begin);
+            block->next = rest.head;
+            rest.head = block;
+            ++rest.count;
+        }
+        c.slab_begin = static_cast<char*>(::operator new(SLAB_BYTES));
+        c.slab_end = c.slab_begin + SLAB_BYTES;
+        left = SLAB_BYTES;
+    }
+    if(count > left / bytes)
+        count = left / bytes;
+    for(size_t i = 0; i < count; ++i)
+    {
+        obj* block = reinterpret_cast<obj*>(c.slab_begin);
+        block->next = list.head;
+        list.head = block;
+        c.slab_begin += bytes;
+    }
+    list.count += count;
+}
+
+// 线程退出，归还全部缓存
+inline
+pool_alloc::cache_guard::~cache_guard()
+{
+    free_list* lists = cache();
+    central_pool& c = central();
+    std::lock_guard<std::mutex> lock(c.mtx);
+    for(size_t i = 0; i < NFREELISTS; ++i)
+    {
+        obj* block = lists[i].head;
+        while(block != nullptr)
+        {
+            obj* next = block->next;
+            block->next = c.lists[i].head;
+            c.lists[i].head = block;
+            block = next;
+        }
+        c.lists[i].count += lists[i].count;
+        lists[i].head = nullptr;
+        lists[i].count = 0;
+    }
+    cache_destroyed() = true;
+}
+
+//***************************************************************************//
+//                              pool_allocator                               //
+//                    接口同 allocator，可作为容器的 Alloc 参数                     //
+//***************************************************************************//
+
+template <class T>
+class pool_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef pool_allocator<U> other;
+    };
+
+public:
+    pool_allocator() noexcept {}
+    pool_allocator(const pool_allocator&) noexcept = default;
+    template <class U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    static T* allocate();
+    static T* allocate(size_type n);
+
+    static void deallocate(T* ptr);
+    static void deallocate(T* ptr, size_type n);
+
+    static void construct(T* ptr);
+    static void construct(T* ptr, const T& value);
+
+    template<class ...Args>
+    static void construct(T* ptr, Args&& ...args);
+
+    static void destroy(T* ptr);
+    static void destroy(T* first, T* last);
+
+private:
+    // 对齐要求超过 pool_alloc::ALIGN 的类型不进内存池，由 operator new 申请后手动对齐
+    static constexpr bool use_pool = alignof(T) <= pool_alloc::ALIGN;
+
+}; // class pool_allocator
+
+// 所有 pool_allocator 共享同一个 pool_alloc
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{ return true; }
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept
+{ return false; }
+
+template <class T>
+T* pool_allocator<T>::allocate()
+{
+    return allocate(1);
+}
+
+template <class T>
+T* pool_allocator<T>::allocate(size_type n)
+{
+    if(n == 0) return nullptr;
+    if(!use_pool)
+    {// operator new 只保证默认对齐，多申请 alignof(T) 字节手动对齐，原始地址存于对齐地址之前
+        void* raw = ::operator new(n * sizeof(T) + alignof(T));
+        uintptr_t addr = (reinterpret_cast<uintptr_t>(raw) + alignof(T)) & ~(static_cast<uintptr_t>(alignof(T)) - 1);
+        reinterpret_cast<void**>(addr)[-1] = raw;
+        return reinterpret_cast<T*>(addr);
+    }
+    return static_cast<T*>(pool_alloc::allocate(n * sizeof(T)));
+}
+
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr)
+{
+    deallocate(ptr, 1);
+}
+
+template <class T>
+void pool_allocator<T>::deallocate(T* ptr, size_type n)
+{
+    if(ptr == nullptr) return ;
+    if(!use_pool)
+        ::operator delete(reinterpret_cast<void**>(ptr)[-1]);
+    else
+        pool_alloc::deallocate(ptr, n * sizeof(T));
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr)
+{
+    deonSTL::construct(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::construct(T* ptr, const T& value)
+{
+    deonSTL::construct(ptr, value);
+}
+
+template <class T>
+template <class ...Args>
+void pool_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+    deonSTL::construct(ptr, std::forward<Args>(args)...);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* ptr)
+{
+    deonSTL::destroy(ptr);
+}
+
+template <class T>
+void pool_allocator<T>::destroy(T* first, T* last)
+{
+    deonSTL::destroy(first, last);
+}
+
+}// namespace deonSTL
+
+#endif /* pool_allocator_h */
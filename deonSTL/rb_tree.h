@@ -176,7 +176,7 @@ struct rb_tree_iterator : public deonSTL::iterator<deonSTL::bidirectional_iterat
     iterator operator++(int)
     {
         iterator tmp(*this);
-        ++this;
+        ++*this;
         return tmp;
     }
     
@@ -184,7 +184,9 @@ struct rb_tree_iterator : public deonSTL::iterator<deonSTL::bidirectional_iterat
     // 若对最小元素--，node指向header_
     iterator& operator--()
     {
-        if(node->left != nullptr)
+        if(rb_tree_is_header(node)) // 对 end()--，node 指向最大元素
+            node = node->right;
+        else if(node->left != nullptr)
             node = rb_tree_max(node->left);
         else
         {// 无左子树，找第一个左祖先
@@ -202,11 +204,11 @@ struct rb_tree_iterator : public deonSTL::iterator<deonSTL::bidirectional_iterat
     iterator operator--(int)
     {
         iterator tmp(*this);
-        --this;
+        --*this;
         return tmp;
     }
-    bool operator==(const rb_tree_iterator& rhs) { return node == rhs.node; }
-    bool operator!=(const rb_tree_iterator& rhs) { return !(*this == rhs); }
+    bool operator==(const rb_tree_iterator& rhs) const { return node == rhs.node; }
+    bool operator!=(const rb_tree_iterator& rhs) const { return !(*this == rhs); }
 };
 
 // rb_tree迭代器，const版本
@@ -258,12 +260,14 @@ struct rb_tree_const_iterator : public iterator<deonSTL::bidirectional_iterator_
     const_iterator operator++(int)
     {
         iterator tmp(*this);
-        ++this;
+        ++*this;
         return tmp;
     }
     const_iterator& operator--()
     {// 寻找前驱
-        if(node->left != nullptr)
+        if(rb_tree_is_header(node)) // 对 end()--，node 指向最大元素
+            node = node->right;
+        else if(node->left != nullptr)
             node = rb_tree_max(node->left);
         else
         {// 无左子树，找第一个左祖先
@@ -283,11 +287,11 @@ struct rb_tree_const_iterator : public iterator<deonSTL::bidirectional_iterator_
     const_iterator operator--(int)
     {
         iterator tmp(*this);
-        --this;
+        --*this;
         return tmp;
     }
-    bool operator==(const rb_tree_const_iterator& rhs) { return node == rhs.node; }
-    bool operator!=(const rb_tree_const_iterator& rhs) { return !(*this == rhs); }
+    bool operator==(const rb_tree_const_iterator& rhs) const { return node == rhs.node; }
+    bool operator!=(const rb_tree_const_iterator& rhs) const { return !(*this == rhs); }
 };
 
 //***************************************************************************//
@@ -329,6 +333,14 @@ bool rb_tree_is_red(NodePtr node) noexcept
     return node->color == rb_tree_red;
 }
 
+// header_ 为红色，且与根节点互为父节点（空树时 header_ 的父节点为 nullptr）
+template <class NodePtr>
+bool rb_tree_is_header(NodePtr node) noexcept
+{
+    return node->color == rb_tree_red &&
+           (node->parent == nullptr || node->parent->parent == node);
+}
+
 template <class NodePtr>
 bool rb_tree_is_black(NodePtr node) noexcept
 {
@@ -442,7 +454,7 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept
                 rb_tree_set_black(x->parent);
                 rb_tree_set_black(uncle);
                 x = x->parent->parent;
-                rb_tree_is_red(x);
+                rb_tree_set_red(x);
             }
             else
             {// 叔节点是黑（已无需要分裂的5-node）
@@ -506,7 +518,7 @@ void rb_tree_transplant(NodePtr pos, NodePtr treeRoot, NodePtr& root, NodePtr& l
 template <class Nodeptr>
 void rb_tree_erase_reballence(Nodeptr x, Nodeptr xp, Nodeptr& root)
 {
-    while(x != root && (x == nullptr || !rb_tree_is_black(x)))
+    while(x != root && (x == nullptr || rb_tree_is_black(x)))
     {// x是黑节点，且没有循环到根节点
         if(x == xp->left)
         {// 若 x 为左子节点
@@ -514,7 +526,7 @@ void rb_tree_erase_reballence(Nodeptr x, Nodeptr xp, Nodeptr& root)
             if(rb_tree_is_red(brother))
             {// 兄弟红色变到父亲（不改变对应2-3-4树，使变换情况减少）
                 rb_tree_set_black(brother);
-                rb_tree_is_red(xp);
+                rb_tree_set_red(xp);
                 rb_tree_rotate_left(xp, root);
                 brother = xp->right;
             }
@@ -592,6 +604,7 @@ NodePtr rb_tree_erase(NodePtr z, NodePtr& root, NodePtr& lmost, NodePtr& rmost)
     // x 指向实际移动的节点
     auto x = y->left != nullptr ? y->left : y->right;
     auto xp = y->parent; // x 的父节点
+    auto y_color = y->color; // 实际被摘除位置的颜色
     
     if(y != z)
     {// y 指向z的后继，x指向y的右节点（可能为空）
@@ -600,6 +613,8 @@ NodePtr rb_tree_erase(NodePtr z, NodePtr& root, NodePtr& lmost, NodePtr& rmost)
             y->right = z->right;
             y->right->parent = y;
         }
+        else
+            xp = y; // y 为 z 的右孩子，x 仍挂在 y 下
         rb_tree_transplant(z, y, root, lmost, rmost);
         y->left = z->left;
         y->left->parent = y;
@@ -613,7 +628,7 @@ NodePtr rb_tree_erase(NodePtr z, NodePtr& root, NodePtr& lmost, NodePtr& rmost)
     }
     // 此时 y指向被删除节点（已不在树中），x 指向替代节点
     // fix
-    if(y->color == rb_tree_black)
+    if(y_color == rb_tree_black)
         rb_tree_erase_reballence(x, xp, root);
     return z;
 }
@@ -623,12 +638,14 @@ NodePtr rb_tree_erase(NodePtr z, NodePtr& root, NodePtr& lmost, NodePtr& rmost)
 
 //***************************************************************************//
 //                                rb_tree                                    //
-//                             参数二为比较类型                                 //
+//                     参数二为比较类型，参数三为空间配置器类型                        //
 //***************************************************************************//
 
-template <class T, class Compare>
-class rb_tree
+template <class T, class Compare, class Alloc = deonSTL::allocator<T>>
+class rb_tree : private deonSTL::alloc_holder<
+    typename Alloc::template rebind<rb_tree_node<T>>::other>
 {
+public:
     typedef rb_tree_traits<T>                                   tree_traits;
     typedef rb_tree_value_traits<T>                             value_traits;
     
@@ -639,21 +656,23 @@ class rb_tree
     typedef typename tree_traits::value_type                    value_type;
     typedef Compare                                             key_compare;
     
-    typedef deonSTL::allocator<T>                               allocator_type;
-    typedef deonSTL::allocator<T>                               data_allocator;
-    typedef deonSTL::allocator<node_type>                       node_allocator;
+    typedef Alloc                                               allocator_type;
+    typedef typename Alloc::template rebind<T>::other           data_allocator;
+    typedef typename Alloc::template rebind<node_type>::other   node_allocator;
     
-    typedef typename allocator_type::pointer                    pointer;
-    typedef typename allocator_type::const_pointer              const_pointer;
-    typedef typename allocator_type::reference                  reference;
-    typedef typename allocator_type::const_reference            const_reference;
-    typedef typename allocator_type::size_type                  size_type;
-    typedef typename allocator_type::difference_type            difference_type;
+    typedef T*                                                  pointer;
+    typedef const T*                                            const_pointer;
+    typedef T&                                                  reference;
+    typedef const T&                                            const_reference;
+    typedef size_t                                              size_type;
+    typedef ptrdiff_t                                           difference_type;
     
     typedef rb_tree_iterator<T>                                 iterator;
     typedef rb_tree_const_iterator<T>                           const_iterator;
     
 private:
+    typedef deonSTL::alloc_holder<node_allocator>               alloc_base;
+    
     node_ptr    header_;        // 特殊节点，标识各种不存在，与跟节点互为对方的父节点，左、右分别指向树的最小值、最大值
     size_type   node_count_;    // 节点数
     key_compare key_comp_;      // 比较准则
@@ -669,17 +688,29 @@ public:
     
     rb_tree() { rb_tree_init(); }
     
+    explicit rb_tree(const Compare& comp, const allocator_type& alloc = allocator_type())
+    : alloc_base(node_allocator(alloc)), key_comp_(comp)
+    { rb_tree_init(); }
+    
     rb_tree(const rb_tree& rhs);
     rb_tree(rb_tree&& rhs) noexcept;
     
     rb_tree& operator=(const rb_tree& rhs);
     rb_tree& operator=(rb_tree&& rhs);
     
-    ~rb_tree() { clear(); }
+    ~rb_tree()
+    {
+        clear();
+        this->get_alloc().deallocate(header_, 1); // header_ 只申请了空间，未构造 value
+        header_ = nullptr;
+    }
     
 public:
     // ==========================成员函数============================ //
     
+    allocator_type  get_allocator() const { return allocator_type(this->get_alloc()); }
+    key_compare     key_comp()      const { return key_comp_; }
+    
     //------------test helper---------------//
     node_ptr        getRootNode()       noexcept
     { return root(); }
@@ -718,7 +749,15 @@ public:
     // insert
     iterator        insert_multi(const value_type& value);
     iterator        insert_multi(value_type&& value)
-    { emplace_multi(std::move(value)); }
+    { return emplace_multi(std::move(value)); }
+    
+    template <class InputIter>
+    void            insert_multi(InputIter first, InputIter last)
+    {
+        size_type n = deonSTL::distance(first, last);
+        for(; n > 0; --n, ++first)
+            insert_multi(*first);
+    }
     
     deonSTL::pair<iterator, bool> insert_unique(const value_type& value);
     deonSTL::pair<iterator, bool> insert_unique(value_type&& value)
@@ -769,20 +808,24 @@ public:
     equal_range_multi(const key_type& key) const
     { return deonSTL::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key)); }
     
-    // equal_unique
+    // equal_unique，key 不存在时返回 [lower_bound, lower_bound)
     deonSTL::pair<iterator, iterator>
      equal_range_unique(const key_type& key)
      {
-       iterator it = find(key);
+       iterator it = lower_bound(key);
        auto next = it;
-       return it == end() ? deonSTL::make_pair(it, it) : deonSTL::make_pair(it, ++next);
+       if(it == end() || key_comp_(key, value_traits::get_key(*it)))
+           return deonSTL::make_pair(it, it);
+       return deonSTL::make_pair(it, ++next);
      }
      deonSTL::pair<const_iterator, const_iterator>
      equal_range_unique(const key_type& key) const
      {
-       const_iterator it = find(key);
+       const_iterator it = lower_bound(key);
        auto next = it;
-       return it == end() ? deonSTL::make_pair(it, it) : deonSTL::make_pair(it, ++next);
+       if(it == end() || key_comp_(key, value_traits::get_key(*it)))
+           return deonSTL::make_pair(it, it);
+       return deonSTL::make_pair(it, ++next);
      }
     
     //swap
@@ -817,7 +860,6 @@ private:
     iterator insert_unique_use_hint(iterator hint, key_type key, node_ptr node);
     
     // copy
-    node_ptr copy_from(node_ptr x);
     node_ptr copy_from(node_ptr x, node_ptr p);
     
     // erase
@@ -830,13 +872,14 @@ private:
 //***************************************************************************//
 
 // 拷贝构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(const rb_tree& rhs)
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::rb_tree(const rb_tree& rhs)
+:alloc_base(rhs.get_alloc())
 {
     rb_tree_init();
     if(rhs.node_count_ != 0)
     {
-        root() = copy_from(rhs.root());
+        root() = copy_from(rhs.root(), header_);
         leftmost() = rb_tree_min(root());
         rightmost() = rb_tree_max(root());
     }
@@ -845,9 +888,10 @@ rb_tree<T, Compare>::rb_tree(const rb_tree& rhs)
 }
 
 // 移动构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(rb_tree&& rhs) noexcept
-:header_(std::move(rhs.header_)),
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>::rb_tree(rb_tree&& rhs) noexcept
+:alloc_base(std::move(rhs.get_alloc())),
+ header_(std::move(rhs.header_)),
  node_count_(rhs.node_count_),
  key_comp_(rhs.key_comp_)
 {
@@ -856,16 +900,16 @@ rb_tree<T, Compare>::rb_tree(rb_tree&& rhs) noexcept
 }
 
 // 拷贝赋值函数
-template <class T, class Compare>
-rb_tree<T, Compare>&
-rb_tree<T, Compare>::operator=(const rb_tree &rhs)
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>&
+rb_tree<T, Compare, Alloc>::operator=(const rb_tree &rhs)
 {
     if(this != &rhs)
     {
         clear();
         if(rhs.node_count_ != 0)
         {
-            root() = copy_from(rhs.root());
+            root() = copy_from(rhs.root(), header_);
             leftmost() = rb_tree_min(root());
             rightmost() = rb_tree_max(root());
         }
@@ -875,12 +919,14 @@ rb_tree<T, Compare>::operator=(const rb_tree &rhs)
     return *this;
 }
 
-// 移动赋值函数
-template <class T, class Compare>
-rb_tree<T, Compare>&
-rb_tree<T, Compare>::operator=(rb_tree &&rhs)
+// 移动赋值函数，连同配置器一起移动
+template <class T, class Compare, class Alloc>
+rb_tree<T, Compare, Alloc>&
+rb_tree<T, Compare, Alloc>::operator=(rb_tree &&rhs)
 {
     clear();
+    this->get_alloc().deallocate(header_, 1);
+    this->get_alloc() = std::move(rhs.get_alloc());
     header_ = std::move(rhs.header_);
     node_count_ = rhs.node_count_;
     key_comp_ = rhs.key_comp_;
@@ -890,10 +936,10 @@ rb_tree<T, Compare>::operator=(rb_tree &&rhs)
 }
 
 // emplace_multi 允许重复的插入，构造value，返回插入节点
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_multi(Args&& ...args)
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::emplace_multi(Args&& ...args)
 {
     node_ptr node = creat_node(std::forward<Args>(args)...);
     auto res = get_insert_multi_pos(value_traits::get_key(node->value));
@@ -901,10 +947,10 @@ rb_tree<T, Compare>::emplace_multi(Args&& ...args)
 }
 
 // emplace_unique 不允许重复的插入，构造value，返回 <插入节点，是否插入成功>
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename deonSTL::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::emplace_unique(Args&& ...args)
+typename deonSTL::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+rb_tree<T, Compare, Alloc>::emplace_unique(Args&& ...args)
 {
     node_ptr node = creat_node(std::forward<Args>(args)...);
     auto res = get_insert_unique_pos(value_traits::get_key(node->value));
@@ -915,18 +961,18 @@ rb_tree<T, Compare>::emplace_unique(Args&& ...args)
 }
 
 // insert_multi 允许重复的插入，传入value，返回插入节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_multi(const value_type &value)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::insert_multi(const value_type &value)
 {
     auto res = get_insert_multi_pos(value_traits::get_key(value));
     return insert_value_at(res.first, value, res.second);
 }
 
 // insert_unique 不允许重复的插入，传入value，返回 <插入节点，是否插入成功>
-template <class T, class Compare>
-deonSTL::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::insert_unique(const value_type &value)
+template <class T, class Compare, class Alloc>
+deonSTL::pair<typename rb_tree<T, Compare, Alloc>::iterator, bool>
+rb_tree<T, Compare, Alloc>::insert_unique(const value_type &value)
 {
     auto res = get_insert_unique_pos(value_traits::get_key(value));
     if(res.second)
@@ -935,9 +981,9 @@ rb_tree<T, Compare>::insert_unique(const value_type &value)
 }
 
 // erase 删除pos位置节点，返回被删除节点的后继
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::erase(iterator pos)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::erase(iterator pos)
 {
     node_ptr node = pos.node;
     iterator next(node); // 返回next
@@ -950,9 +996,9 @@ rb_tree<T, Compare>::erase(iterator pos)
 }
 
 // erase_multi
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::erase_multi(const key_type &key)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::erase_multi(const key_type &key)
 {
     auto p = equal_range_multi(key);
     size_type n = deonSTL::distance(p.first, p.second);
@@ -961,9 +1007,9 @@ rb_tree<T, Compare>::erase_multi(const key_type &key)
 }
 
 // erase_unique
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::erase_unique(const key_type &key)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::size_type
+rb_tree<T, Compare, Alloc>::erase_unique(const key_type &key)
 {
     auto it = find(key);
     if(it != end())
@@ -976,9 +1022,9 @@ rb_tree<T, Compare>::erase_unique(const key_type &key)
 }
 
 // erase 删除 [first, last) 区间内的元素
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::erase(iterator first, iterator last)
+rb_tree<T, Compare, Alloc>::erase(iterator first, iterator last)
 {
     if(first == begin() && last == end())
         clear();
@@ -991,13 +1037,16 @@ rb_tree<T, Compare>::erase(iterator first, iterator last)
 }
 
 // clear 清空
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::clear()
+rb_tree<T, Compare, Alloc>::clear()
 {
     if(node_count_ != 0)
     {
-        erase_since(root());
+        // 元素无需析构且配置器不回收单个节点时，直接丢弃整棵树
+        if(!(std::is_trivially_destructible<T>::value &&
+             deonSTL::deallocate_is_noop<node_allocator>::value))
+            erase_since(root());
         leftmost() = header_;
         root() = nullptr;
         rightmost() = header_;
@@ -1006,9 +1055,9 @@ rb_tree<T, Compare>::clear()
 }
 
 // find 查找key位置，若存在返回第一个位置，不存在返回nullptr
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::find(const key_type &key)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::find(const key_type &key)
 {
     node_ptr x = root();
     while(x != nullptr && value_traits::get_key(x->value) != key)
@@ -1018,21 +1067,21 @@ rb_tree<T, Compare>::find(const key_type &key)
 }
 
 // find 返回 const_iter
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::find(const key_type &key) const
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::find(const key_type &key) const
 {
     node_ptr x = root();
     while(x != nullptr && value_traits::get_key(x->value) != key)
-        x = key_comp_(value_traits::get_key(x->value), key) ? x->left : x->right;
+        x = key_comp_(key, value_traits::get_key(x->value)) ? x->left : x->right;
     return x == nullptr ? end() : const_iterator(x);
 }
 
 // lower_bound 键值大于等于key的第一个位置
 // 若key比最大值大则返回 header_
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::lower_bound(const key_type &key)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::lower_bound(const key_type &key)
 {
     auto p = header_;
     auto x = root();
@@ -1048,9 +1097,9 @@ rb_tree<T, Compare>::lower_bound(const key_type &key)
     return iterator(p);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::lower_bound(const key_type &key) const
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::lower_bound(const key_type &key) const
 {
     auto p = header_;
     auto x = root();
@@ -1066,9 +1115,9 @@ rb_tree<T, Compare>::lower_bound(const key_type &key) const
     return const_iterator(p);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::upper_bound(const key_type &key)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::upper_bound(const key_type &key)
 {
     auto p = header_;
     auto x = root();
@@ -1086,9 +1135,9 @@ rb_tree<T, Compare>::upper_bound(const key_type &key)
     return iterator(p);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::upper_bound(const key_type &key) const
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::const_iterator
+rb_tree<T, Compare, Alloc>::upper_bound(const key_type &key) const
 {
     auto p = header_;
     auto x = root();
@@ -1106,13 +1155,14 @@ rb_tree<T, Compare>::upper_bound(const key_type &key) const
     return const_iterator(p);
 }
 
-// swap
-template <class T, class Compare>
+// swap 连同配置器一起交换
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept
+rb_tree<T, Compare, Alloc>::swap(rb_tree& rhs) noexcept
 {
     if(this != &rhs)
     {
+        std::swap(this->get_alloc(), rhs.get_alloc());
         std::swap(header_, rhs.header_);
         std::swap(node_count_, rhs.node_count_);
         std::swap(key_comp_, rhs.key_comp_);
@@ -1127,26 +1177,26 @@ rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept
 
 
 // creat_node 创建节点，传入value的构造信息，创建指针均为nullptr，颜色未定义的节点，返回该节点
-template <class T, class  Compare>
+template <class T, class Compare, class Alloc>
 template <class ...Args>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::creat_node(Args&&... args)
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::creat_node(Args&&... args)
 {
-    auto tmp = node_allocator::allocate(1);
+    node_ptr tmp = this->get_alloc().allocate(1);
     try {
-        data_allocator::construct(std::addressof(tmp->value), std::forward<Args>(args)...);
+        deonSTL::construct(std::addressof(tmp->value), std::forward<Args>(args)...);
         tmp->left = tmp->right = tmp->parent = nullptr; // 颜色未定义
     } catch (...) {
-        node_allocator::deallocate(tmp);
+        this->get_alloc().deallocate(tmp, 1);
         throw;
     }
     return tmp;
 }
 
 // clone_node 复制节点的value和color，指针为nullptr，返回该节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::clone_node(node_ptr x)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::clone_node(node_ptr x)
 {
     node_ptr tmp = creat_node(x->value);
     tmp->color = x->color;
@@ -1154,12 +1204,12 @@ rb_tree<T, Compare>::clone_node(node_ptr x)
 }
 
 // destroy_node 析构并回收空间
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::destroy_node(node_ptr p)
+rb_tree<T, Compare, Alloc>::destroy_node(node_ptr p)
 {
-    data_allocator::destroy(&p->value);
-    node_allocator::deallocate(p);
+    deonSTL::destroy(std::addressof(p->value));
+    this->get_alloc().deallocate(p, 1);
 }
 
 
@@ -1173,11 +1223,11 @@ rb_tree<T, Compare>::destroy_node(node_ptr p)
  \*------------------------*/
 
 // rb_tree_init 创建一个只有header节点的空树
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::rb_tree_init()
+rb_tree<T, Compare, Alloc>::rb_tree_init()
 {
-    header_ = node_allocator::allocate(1);
+    header_ = this->get_alloc().allocate(1);
     header_->color = rb_tree_red; // header_节点颜色为红，与root区分
     root() = nullptr;
     leftmost()  = header_;
@@ -1187,9 +1237,9 @@ rb_tree<T, Compare>::rb_tree_init()
 
 
 // get_insert_multi_pos 返回（插入位置的父节点，是否插入在左），元素允许重复
-template <class T, class Compare>
-deonSTL::pair<typename rb_tree<T, Compare>::node_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos(const key_type &key)
+template <class T, class Compare, class Alloc>
+deonSTL::pair<typename rb_tree<T, Compare, Alloc>::node_ptr, bool>
+rb_tree<T, Compare, Alloc>::get_insert_multi_pos(const key_type &key)
 {
     auto y = header_;
     auto x = root();
@@ -1198,16 +1248,17 @@ rb_tree<T, Compare>::get_insert_multi_pos(const key_type &key)
     {
         y = x;
         // 小于时插入左，大于等于插入右
-        add_to_left = key_comp_(key, y->value);
+        add_to_left = key_comp_(key, value_traits::get_key(y->value));
         x = add_to_left ? x->left : x->right;
     }
     return deonSTL::make_pair(y, add_to_left);
 }
 
 // get_insert_unique_pos 返回（插入位置的父节点，是否在左插入，是否需要插入），不允许元素重复
-template <class T, class Compare>
-deonSTL::pair<deonSTL::pair<typename rb_tree<T, Compare>::node_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos(const key_type &key)
+// 元素已存在时，返回的节点为与之重复的节点
+template <class T, class Compare, class Alloc>
+deonSTL::pair<deonSTL::pair<typename rb_tree<T, Compare, Alloc>::node_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc>::get_insert_unique_pos(const key_type &key)
 {
     auto y = header_;
     auto x = root();
@@ -1216,7 +1267,7 @@ rb_tree<T, Compare>::get_insert_unique_pos(const key_type &key)
     {
         y = x;
         // 小于时插入左，大于等于插入右
-        add_to_left = key_comp_(key, y->value);
+        add_to_left = key_comp_(key, value_traits::get_key(y->value));
         x = add_to_left ? x->left : x->right;
     }
     // 若重复，则重复节点为前驱
@@ -1235,16 +1286,16 @@ rb_tree<T, Compare>::get_insert_unique_pos(const key_type &key)
     {// 小于，不重复
         return deonSTL::make_pair(deonSTL::make_pair(y, add_to_left), true);
     }
-    // j->key == key
-    return deonSTL::make_pair(deonSTL::make_pair(y, add_to_left), false);
+    // j->key == key，返回重复的节点
+    return deonSTL::make_pair(deonSTL::make_pair(j.node, add_to_left), false);
     
 }
 
 // insert_value_at 把value插在x的左（add_at_left=true）或右孩子处，返回指向插入节点的迭代器
 // 本函数控制修改 lmost, rmost, node_count_
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_value_at(node_ptr x, const value_type &value, bool add_at_left)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::insert_value_at(node_ptr x, const value_type &value, bool add_at_left)
 {
     node_ptr node = creat_node(value);
     node->parent = x;
@@ -1273,9 +1324,9 @@ rb_tree<T, Compare>::insert_value_at(node_ptr x, const value_type &value, bool a
 
 // insert_node_at 把 node 类型的 node 插入x的左(add_to_left=true) 或右，返回指向插入节点的迭代器
 // 本函数控制修改 lmost, rmost, node_count_
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_node_at(node_ptr x, node_ptr node, bool add_at_left)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::insert_node_at(node_ptr x, node_ptr node, bool add_at_left)
 {
     node->parent = x;
     if(x == header_)
@@ -1304,9 +1355,9 @@ rb_tree<T, Compare>::insert_node_at(node_ptr x, node_ptr node, bool add_at_left)
  
 // 传入提示迭代器hint，被插入关键字key，被插入节点node，返回被插入节点
 // 若node比hint所指节点小一点，可能可以快速插入，允许关键字重复
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::insert_multi_use_hint(iterator hint, key_type key, node_ptr node)
 {
     base_ptr np = hint.node;
     auto before = hint;
@@ -1325,9 +1376,9 @@ rb_tree<T, Compare>::insert_multi_use_hint(iterator hint, key_type key, node_ptr
 }
 
 // insert_unique_use_hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::iterator
+rb_tree<T, Compare, Alloc>::insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 {
     base_ptr np = hint.node;
     auto before = hint;
@@ -1351,18 +1402,10 @@ rb_tree<T, Compare>::insert_unique_use_hint(iterator hint, key_type key, node_pt
 }
  */
 
-// copy_from 复制以x为根节点的树，返回复制得到的根节点，该根节点的父亲指向x的父亲
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::copy_from(node_ptr x)
-{
-    return copy_from(x, x->parent);
-}
-
-// copy_from 复制一棵树，半递归实现
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::copy_from(node_ptr x, node_ptr p)
+// copy_from 复制以 x 为根的树，返回复制得到的根节点，其父节点为 p，半递归实现
+template <class T, class Compare, class Alloc>
+typename rb_tree<T, Compare, Alloc>::node_ptr
+rb_tree<T, Compare, Alloc>::copy_from(node_ptr x, node_ptr p)
 {// 递归copy所有右子树，手动copy所有左子树
     auto top = clone_node(x);
     top->parent = p;
@@ -1383,9 +1426,9 @@ rb_tree<T, Compare>::copy_from(node_ptr x, node_ptr p)
 }
 
 // erase_since 删除x节点及其子树
-template <class T, class Compare>
+template <class T, class Compare, class Alloc>
 void
-rb_tree<T, Compare>::erase_since(node_ptr x)
+rb_tree<T, Compare, Alloc>::erase_since(node_ptr x)
 {
     /*
     erase_since(x->left);
@@ -1408,7 +1451,21 @@ rb_tree<T, Compare>::erase_since(node_ptr x)
 //                             equal operator                                //
 //***************************************************************************//
 
+// operator== 元素个数相同且按序逐个相等
+template <class T, class Compare, class Alloc>
+bool operator==(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
+{
+    if(lhs.size() != rhs.size()) return false;
+    auto it1 = lhs.begin();
+    auto it2 = rhs.begin();
+    for(; it1 != lhs.end(); ++it1, ++it2)
+        if(!(*it1 == *it2)) return false;
+    return true;
+}
 
+template <class T, class Compare, class Alloc>
+bool operator!=(const rb_tree<T, Compare, Alloc>& lhs, const rb_tree<T, Compare, Alloc>& rhs)
+{ return !(lhs == rhs); }
  
 } // namespace deonSTL
 
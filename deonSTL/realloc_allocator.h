@@ -0,0 +1,270 @@
+//
+//  realloc_allocator.h
+//  deonSTL
+//
+//  这个头文件包含 realloc_alloc 和模板类 realloc_allocator
+//  realloc_alloc     : 小块用 malloc/realloc，大块（>= MMAP_THRESHOLD）直接 mmap，扩大时用 mremap
+//                      mremap 只修改页表，不复制数据，旧页也不会和新页同时占用物理内存
+//  realloc_allocator : 接口与 allocator 相同，另外提供 reallocate，
+//                      vector 中元素可平凡搬移时扩容交给它原地完成
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef realloc_allocator_h
+#define realloc_allocator_h
+
+#include <cstddef>  // size_t, ptrdiff_t, max_align_t
+#include <cstdlib>  // malloc, realloc, free
+#include <cstring>  // memcpy
+#include <new>      // bad_alloc
+#include "allocator.h"
+
+// 只有 Linux 提供 mremap，其他平台大块也使用 realloc
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DEONSTL_HAS_MREMAP 1
+#else
+#define DEONSTL_HAS_MREMAP 0
+#endif
+
+namespace deonSTL {
+
+//***************************************************************************//
+//                               realloc_alloc                               //
+//          同一块内存走哪条路径只由字节数决定，所以 deallocate 需要传入申请时的大小           //
+//***************************************************************************//
+
+class realloc_alloc
+{
+public:
+    enum { MMAP_THRESHOLD = 1 << 20 };  // 不小于 1MB 的块直接向系统映射
+
+public:
+    static void* allocate(size_t n);
+    static void  deallocate(void* ptr, size_t n);
+    // reallocate 把 old_n 字节的块调整为 new_n 字节，内容按字节保留
+    // 失败时抛出 bad_alloc，原来的块不变
+    static void* reallocate(void* ptr, size_t old_n, size_t new_n);
+
+private:
+    static bool use_mmap(size_t n)
+    { return DEONSTL_HAS_MREMAP && n >= static_cast<size_t>(MMAP_THRESHOLD); }
+
+#if DEONSTL_HAS_MREMAP
+    static size_t page_round(size_t n)
+    {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return (n + page - 1) & ~(page - 1);
+    }
+#endif
+
+}; // class realloc_alloc
+
+// allocate 申请 n 字节
+inline void*
+realloc_alloc::allocate(size_t n)
+{
+#if DEONSTL_HAS_MREMAP
+    if(use_mmap(n))
+    {
+        void* result = ::mmap(nullptr, page_round(n), PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(result == MAP_FAILED)
+            throw std::bad_alloc();
+        return result;
+    }
+#endif
+    void* result = std::malloc(n);
+    if(result == nullptr)
+        throw std::bad_alloc();
+    return result;
+}
+
+// deallocate 归还 ptr 开始的 n 字节，n 须与申请时一致
+inline void
+realloc_alloc::deallocate(void* ptr, size_t n)
+{
+    if(ptr == nullptr) return;
+#if DEONSTL_HAS_MREMAP
+    if(use_mmap(n))
+    {
+        ::munmap(ptr, page_round(n));
+        return;
+    }
+#else
+    (void)n;
+#endif
+    std::free(ptr);
+}
+
+// reallocate 两端都在堆上用 realloc，两端都是映射用 mremap，跨越阈值时申请新块再复制
+inline void*
+realloc_alloc::reallocate(void* ptr, size_t old_n, size_t new_n)
+{
+    if(ptr == nullptr)
+        return allocate(new_n);
+#if DEONSTL_HAS_MREMAP
+    const bool old_mmap = use_mmap(old_n), new_mmap = use_mmap(new_n);
+    if(old_mmap && new_mmap)
+    {
+        const size_t old_len = page_round(old_n), new_len = page_round(new_n);
+        if(old_len == new_len)
+            return ptr;
+        void* result = ::mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+        if(result == MAP_FAILED)
+            throw std::bad_alloc();
+        return result;
+    }
+    if(old_mmap || new_mmap)
+    {
+        void* result = allocate(new_n);
+        std::memcpy(result, ptr, old_n < new_n ? old_n : new_n);
+        deallocate(ptr, old_n);
+        return result;
+    }
+#else
+    (void)old_n;
+#endif
+    void* result = std::realloc(ptr, new_n);
+    if(result == nullptr)
+        throw std::bad_alloc();
+    return result;
+}
+
+//***************************************************************************//
+//                             realloc_allocator                             //
+//                    接口同 allocator，可作为容器的 Alloc 参数                     //
+//***************************************************************************//
+
+template <class T>
+class realloc_allocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "realloc_allocator does not support over-aligned types");
+
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef realloc_allocator<U> other;
+    };
+
+public:
+    realloc_allocator() noexcept {}
+    realloc_allocator(const realloc_allocator&) noexcept = default;
+    template <class U>
+    realloc_allocator(const realloc_allocator<U>&) noexcept {}
+
+    static T* allocate();
+    static T* allocate(size_type n);
+
+    static void deallocate(T* ptr);
+    static void deallocate(T* ptr, size_type n);
+
+    // reallocate 把 old_n 个元素的空间调整为 new_n 个，已有对象按字节跟随，只能用于可平凡搬移的类型
+    static T* reallocate(T* ptr, size_type old_n, size_type new_n);
+
+    static void construct(T* ptr);
+    static void construct(T* ptr, const T& value);
+
+    template<class ...Args>
+    static void construct(T* ptr, Args&& ...args);
+
+    static void destroy(T* ptr);
+    static void destroy(T* first, T* last);
+
+}; // class realloc_allocator
+
+// 无状态，任意两个 realloc_allocator 都可以互相释放对方申请的内存
+template <class T, class U>
+bool operator==(const realloc_allocator<T>&, const realloc_allocator<U>&) noexcept
+{ return true; }
+
+template <class T, class U>
+bool operator!=(const realloc_allocator<T>&, const realloc_allocator<U>&) noexcept
+{ return false; }
+
+template <class T>
+struct has_reallocate<realloc_allocator<T>> : std::true_type {};
+
+template <class T>
+T* realloc_allocator<T>::allocate()
+{
+    return allocate(1);
+}
+
+template <class T>
+T* realloc_allocator<T>::allocate(size_type n)
+{
+    if(n == 0) return nullptr;
+    return static_cast<T*>(realloc_alloc::allocate(n * sizeof(T)));
+}
+
+template <class T>
+void realloc_allocator<T>::deallocate(T* ptr)
+{
+    deallocate(ptr, 1);
+}
+
+template <class T>
+void realloc_allocator<T>::deallocate(T* ptr, size_type n)
+{
+    realloc_alloc::deallocate(ptr, n * sizeof(T));
+}
+
+template <class T>
+T* realloc_allocator<T>::reallocate(T* ptr, size_type old_n, size_type new_n)
+{
+    if(new_n == 0)
+    {
+        deallocate(ptr, old_n);
+        return nullptr;
+    }
+    return static_cast<T*>(realloc_alloc::reallocate(ptr, old_n * sizeof(T), new_n * sizeof(T)));
+}
+
+template <class T>
+void realloc_allocator<T>::construct(T* ptr)
+{
+    deonSTL::construct(ptr);
+}
+
+template <class T>
+void realloc_allocator<T>::construct(T* ptr, const T& value)
+{
+    deonSTL::construct(ptr, value);
+}
+
+template <class T>
+template <class ...Args>
+void realloc_allocator<T>::construct(T* ptr, Args&& ...args)
+{
+    deonSTL::construct(ptr, std::forward<Args>(args)...);
+}
+
+template <class T>
+void realloc_allocator<T>::destroy(T* ptr)
+{
+    deonSTL::destroy(ptr);
+}
+
+template <class T>
+void realloc_allocator<T>::destroy(T* first, T* last)
+{
+    deonSTL::destroy(first, last);
+}
+
+}// namespace deonSTL
+
+#endif /* realloc_allocator_h */
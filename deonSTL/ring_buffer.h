@@ -0,0 +1,712 @@
+//
+//  ring_buffer.h
+//  deonSTL
+//
+//  这个头文件包含模板类 ring_buffer、circular_buffer 和迭代器 ring_buffer_iterator
+//  ring_buffer     : 容量固定的环形队列，只申请一块连续空间，容量向上取整为 2 的幂，下标与 mask 相与回绕
+//                    满时不能再插入单个元素（由调用者用 full() 判断），批量 push_back 只放入装得下的部分
+//  circular_buffer : 满时覆盖最旧的元素（push_back 丢弃头部，push_front 丢弃尾部）
+//  批量 push_back(first, last)、pop_front(n, out) 最多分成两段连续空间处理，平凡类型为两次 memmove
+//
+//  ring_buffer(n) 构造容量为 n 的空队列，ring_buffer(n, value) 构造装满 n 个 value 的队列
+//  可以作为 stack 的底层容器：deonSTL::stack<T, deonSTL::ring_buffer<T>> s(deonSTL::ring_buffer<T>(n));
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef ring_buffer_h
+#define ring_buffer_h
+
+#include <cstddef>          // size_t, ptrdiff_t
+#include <initializer_list>
+#include <iterator>         // std::iterator_traits
+#include <utility>          // move, forward, swap
+#include <algorithm>        // min, equal
+#include <type_traits>      // integral_constant, enable_if, is_integral
+#include "iterator.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "uninitialized.h"
+#include "type_traits.h"
+
+namespace deonSTL{
+
+//***************************************************************************//
+//                           ring_buffer_iterator                            //
+//   pos 为不回绕的逻辑位置（从 0 开始一直递增），解引用时才与 mask 相与，                    //
+//   因此 begin() 与 end() 在满队列时也不相等，两个迭代器相减就是 pos 之差                    //
+//***************************************************************************//
+
+template <class T, class Ref, class Ptr>
+struct ring_buffer_iterator : public iterator<random_access_iterator_tag, T>
+{
+    typedef ring_buffer_iterator<T, T&, T*>               iterator;
+    typedef ring_buffer_iterator<T, const T&, const T*>   const_iterator;
+    typedef ring_buffer_iterator                          self;
+
+    typedef T                                       value_type;
+    typedef Ptr                                     pointer;
+    typedef Ref                                     reference;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+
+    // 成员数据
+    T*          buf;        // 缓冲区首地址
+    size_type   mask;       // 容量 - 1
+    size_type   pos;        // 逻辑位置
+
+    // ======================构造、移动、赋值函数====================== //
+
+    ring_buffer_iterator() noexcept
+    :buf(nullptr), mask(0), pos(0) {}
+
+    ring_buffer_iterator(T* b, size_type m, size_type p) noexcept
+    :buf(b), mask(m), pos(p) {}
+
+    ring_buffer_iterator(const iterator& rhs) noexcept
+    :buf(rhs.buf), mask(rhs.mask), pos(rhs.pos) {}
+
+    // ==========================重载操作符========================== //
+
+    reference operator*() const { return buf[pos & mask]; }
+    pointer operator->() const { return buf + (pos & mask); }
+
+    difference_type operator-(const self& x) const
+    { return static_cast<difference_type>(pos - x.pos); }
+
+    self& operator++()    { ++pos; return *this; }
+    self operator++(int)  { self tmp = *this; ++pos; return tmp; }
+    self& operator--()    { --pos; return *this; }
+    self operator--(int)  { self tmp = *this; --pos; return tmp; }
+
+    self& operator+=(difference_type n)
+    {
+        pos += static_cast<size_type>(n);
+        return *this;
+    }
+    self operator+(difference_type n) const
+    {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self& operator-=(difference_type n) { return *this += -n; }
+    self operator-(difference_type n) const
+    {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bool operator==(const self& rhs) const  { return pos == rhs.pos; }
+    bool operator!=(const self& rhs) const  { return !(*this == rhs); }
+    bool operator< (const self& rhs) const  { return (*this - rhs) < 0; }
+    bool operator> (const self& rhs) const  { return rhs < *this; }
+    bool operator<=(const self& rhs) const  { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const  { return !(*this < rhs); }
+
+};// struct ring_buffer_iterator
+
+template <class T, class Ref, class Ptr>
+ring_buffer_iterator<T, Ref, Ptr>
+operator+(typename ring_buffer_iterator<T, Ref, Ptr>::difference_type n,
+          const ring_buffer_iterator<T, Ref, Ptr>& x)
+{ return x + n; }
+
+} // namespace deonSTL
+
+// 与 deque 迭代器相同，特化 std::iterator_traits 后 std 算法把它当作随机访问迭代器
+namespace std {
+
+template <class T, class Ref, class Ptr>
+struct iterator_traits<deonSTL::ring_buffer_iterator<T, Ref, Ptr>>
+{
+    typedef random_access_iterator_tag  iterator_category;
+    typedef T                           value_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef ptrdiff_t                   difference_type;
+};
+
+} // namespace std
+
+namespace deonSTL{
+
+// 模版类 ring_buffer
+// 参数二为空间配置器类型，参数三为满时是否覆盖最旧的元素（circular_buffer）
+template <class T, class Alloc = deonSTL::allocator<T>, bool Overwrite = false>
+class ring_buffer : private deonSTL::alloc_holder<Alloc>
+{
+public:
+
+    typedef Alloc                                       allocator_type;
+
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef ring_buffer_iterator<T, T&, T*>             iterator;
+    typedef ring_buffer_iterator<T, const T&, const T*> const_iterator;
+
+private:
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    typedef std::integral_constant<bool, Overwrite>     overwrite;
+
+    pointer         buf_;       // 缓冲区
+    size_type       cap_;       // 容量，0 或 2 的幂
+    size_type       head_;      // 第一个元素的逻辑位置
+    size_type       tail_;      // 尾后元素的逻辑位置，tail_ - head_ 为元素个数
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    ring_buffer() noexcept
+    :buf_(nullptr), cap_(0), head_(0), tail_(0) {}
+
+    explicit ring_buffer(const allocator_type& alloc) noexcept
+    :alloc_base(alloc), buf_(nullptr), cap_(0), head_(0), tail_(0) {}
+
+    // 容量为 capacity（向上取整为 2 的幂）的空队列
+    explicit ring_buffer(size_type capacity, const allocator_type& alloc = allocator_type())
+    :alloc_base(alloc), buf_(nullptr), cap_(0), head_(0), tail_(0)
+    { init_space(capacity); }
+
+    ring_buffer(size_type n, const value_type& value,
+                const allocator_type& alloc = allocator_type())
+    :alloc_base(alloc), buf_(nullptr), cap_(0), head_(0), tail_(0)
+    {
+        init_space(n);
+        try {
+            deonSTL::uninitialized_fill_n(buf_, n, value);
+        } catch (...) {
+            destroy_and_recover();
+            throw;
+        }
+        tail_ = n;
+    }
+
+    // 容量为 [first, last) 的元素个数
+    template <class FIter, typename std::enable_if<
+        !std::is_integral<FIter>::value, int>::type = 0>
+    ring_buffer(FIter first, FIter last, const allocator_type& alloc = allocator_type())
+    :alloc_base(alloc), buf_(nullptr), cap_(0), head_(0), tail_(0)
+    { copy_init(first, static_cast<size_type>(deonSTL::distance(first, last))); }
+
+    ring_buffer(std::initializer_list<value_type> ilist,
+                const allocator_type& alloc = allocator_type())
+    :alloc_base(alloc), buf_(nullptr), cap_(0), head_(0), tail_(0)
+    { copy_init(ilist.begin(), ilist.size()); }
+
+    // 复制后容量与 rhs 相同
+    ring_buffer(const ring_buffer& rhs)
+    :alloc_base(rhs.get_alloc()), buf_(nullptr), cap_(0), head_(0), tail_(0)
+    {
+        init_space(rhs.cap_);
+        try {
+            copy_span(rhs, rhs.head_, rhs.size());
+        } catch (...) {
+            destroy_and_recover();
+            throw;
+        }
+    }
+
+    ring_buffer(ring_buffer&& rhs) noexcept
+    :alloc_base(std::move(rhs.get_alloc())),
+    buf_(rhs.buf_), cap_(rhs.cap_), head_(rhs.head_), tail_(rhs.tail_)
+    {
+        rhs.buf_ = nullptr;
+        rhs.cap_ = rhs.head_ = rhs.tail_ = 0;
+    }
+
+    ring_buffer& operator=(const ring_buffer& rhs)
+    {
+        if(this != &rhs)
+        {
+            ring_buffer tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ring_buffer& operator=(ring_buffer&& rhs) noexcept
+    {
+        if(this != &rhs)
+        {
+            ring_buffer tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~ring_buffer()
+    { destroy_and_recover(); }
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+
+    // begin, end
+    iterator            begin()             noexcept
+    { return iterator(buf_, mask(), head_); }
+    const_iterator      begin()       const noexcept
+    { return const_iterator(buf_, mask(), head_); }
+    iterator            end()               noexcept
+    { return iterator(buf_, mask(), tail_); }
+    const_iterator      end()         const noexcept
+    { return const_iterator(buf_, mask(), tail_); }
+
+    // empty, full, size, capacity
+    bool                empty()       const noexcept
+    { return head_ == tail_; }
+    bool                full()        const noexcept
+    { return size() == cap_; }
+    size_type           size()        const noexcept
+    { return tail_ - head_; }
+    size_type           capacity()    const noexcept
+    { return cap_; }
+    size_type           max_size()    const noexcept
+    { return static_cast<size_type>(-1) / sizeof(T); }
+
+    // 容量扩大到不小于 new_cap，元素搬到新空间的开头，仍然只有一块空间
+    void                reserve(size_type new_cap);
+
+    // operator[]
+    reference           operator[](size_type n)
+    {
+        MY_DEBUG(n < size());
+        return buf_[(head_ + n) & mask()];
+    }
+    const_reference     operator[](size_type n) const
+    {
+        MY_DEBUG(n < size());
+        return buf_[(head_ + n) & mask()];
+    }
+
+    // front, back
+    reference           front()
+    {
+        MY_DEBUG(!empty());
+        return buf_[head_ & mask()];
+    }
+    const_reference     front() const
+    {
+        MY_DEBUG(!empty());
+        return buf_[head_ & mask()];
+    }
+    reference           back()
+    {
+        MY_DEBUG(!empty());
+        return buf_[(tail_ - 1) & mask()];
+    }
+    const_reference     back() const
+    {
+        MY_DEBUG(!empty());
+        return buf_[(tail_ - 1) & mask()];
+    }
+
+    // emplace
+    template <class ...Args>
+    void        emplace_front(Args&& ...args);
+    template <class ...Args>
+    void        emplace_back(Args&& ...args);
+
+    // push_front, push_back, pop_front, pop_back
+    void        push_front(const value_type& value) { emplace_front(value); }
+    void        push_back (const value_type& value) { emplace_back(value);  }
+    void        push_front(value_type&& value)      { emplace_front(std::move(value)); }
+    void        push_back (value_type&& value)      { emplace_back(std::move(value));  }
+
+    void        pop_front();
+    void        pop_back();
+
+    // 批量操作，返回实际处理的元素个数
+    template <class FIter, typename std::enable_if<
+        !std::is_integral<FIter>::value, int>::type = 0>
+    size_type   push_back(FIter first, FIter last);
+    size_type   pop_front(size_type n);
+    // 把头部 n 个元素移动到 out，返回 out 的尾后位置
+    template <class OIter>
+    OIter       pop_front(size_type n, OIter out);
+
+    // clear
+    void        clear() noexcept;
+
+    // swap
+    void        swap(ring_buffer& rhs) noexcept;
+
+private:
+    // ==========================辅助函数============================ //
+
+    size_type   mask() const noexcept { return cap_ - 1; }
+
+    // 不小于 n 的最小的 2 的幂
+    static size_type round_capacity(size_type n) noexcept;
+
+    // 申请不小于 n 的 2 的幂个元素的空间
+    void        init_space(size_type n);
+    void        destroy_and_recover() noexcept;
+
+    template <class FIter>
+    void        copy_init(FIter first, size_type n);
+
+    // 把 rhs 从逻辑位置 pos 开始的 n 个元素复制到尾部（空间足够）
+    void        copy_span(const ring_buffer& rhs, size_type pos, size_type n);
+
+    // 析构从逻辑位置 pos 开始的 n 个元素
+    void        destroy_span(size_type pos, size_type n) noexcept;
+
+    // 插入单个元素前腾出位置：circular_buffer 满时丢弃另一端的元素，ring_buffer 要求不满
+    void        make_room_back (std::true_type);
+    void        make_room_back (std::false_type);
+    void        make_room_front(std::true_type);
+    void        make_room_front(std::false_type);
+
+    template <class FIter>
+    size_type   bulk_push_back(FIter first, size_type n, std::true_type);
+    template <class FIter>
+    size_type   bulk_push_back(FIter first, size_type n, std::false_type);
+    template <class FIter>
+    void        copy_to_back(FIter first, size_type n);
+
+};// class ring_buffer
+
+// circular_buffer 满时覆盖最旧的元素
+template <class T, class Alloc = deonSTL::allocator<T>>
+using circular_buffer = ring_buffer<T, Alloc, true>;
+
+//***************************************************************************//
+//                           member functions                                //
+//***************************************************************************//
+
+// reserve 容量不足 new_cap 时申请新空间，两段元素依次移动到新空间的开头
+// 移动抛出异常时析构新空间中已构造的元素并释放新空间，原队列保留全部元素（已移动的元素处于移动后的状态）
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::reserve(size_type new_cap)
+{
+    if(new_cap <= cap_)
+        return;
+    const size_type cap = round_capacity(new_cap);
+    const size_type len = size();
+    const size_type idx = head_ & mask();
+    const size_type n1  = std::min(len, cap_ - idx);
+    pointer new_buf = this->get_alloc().allocate(cap);
+    pointer cur = new_buf;
+    try {
+        cur = deonSTL::uninitialized_move(buf_ + idx, buf_ + idx + n1, new_buf);
+        cur = deonSTL::uninitialized_move(buf_, buf_ + (len - n1), cur);
+    } catch (...) {
+        deonSTL::destroy(new_buf, cur);
+        this->get_alloc().deallocate(new_buf, cap);
+        throw;
+    }
+    destroy_and_recover();
+    buf_  = new_buf;
+    cap_  = cap;
+    head_ = 0;
+    tail_ = len;
+}
+
+// emplace_front 在头部构造元素
+template <class T, class Alloc, bool Overwrite>
+template <class ...Args>
+void
+ring_buffer<T, Alloc, Overwrite>::emplace_front(Args&& ...args)
+{
+    make_room_front(overwrite());
+    deonSTL::construct(buf_ + ((head_ - 1) & mask()), std::forward<Args>(args)...);
+    --head_;
+}
+
+// emplace_back 在尾部构造元素
+template <class T, class Alloc, bool Overwrite>
+template <class ...Args>
+void
+ring_buffer<T, Alloc, Overwrite>::emplace_back(Args&& ...args)
+{
+    make_room_back(overwrite());
+    deonSTL::construct(buf_ + (tail_ & mask()), std::forward<Args>(args)...);
+    ++tail_;
+}
+
+// pop_front 弹出头部元素
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::pop_front()
+{
+    MY_DEBUG(!empty());
+    deonSTL::destroy(buf_ + (head_ & mask()));
+    ++head_;
+}
+
+// pop_back 弹出尾部元素
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::pop_back()
+{
+    MY_DEBUG(!empty());
+    --tail_;
+    deonSTL::destroy(buf_ + (tail_ & mask()));
+}
+
+// push_back 把 [first, last) 追加到尾部，返回放入的个数
+// ring_buffer 只放入装得下的前一部分；circular_buffer 全部放入，丢弃最旧的元素，只保留最后 capacity() 个
+template <class T, class Alloc, bool Overwrite>
+template <class FIter, typename std::enable_if<
+    !std::is_integral<FIter>::value, int>::type>
+typename ring_buffer<T, Alloc, Overwrite>::size_type
+ring_buffer<T, Alloc, Overwrite>::push_back(FIter first, FIter last)
+{
+    return bulk_push_back(first, static_cast<size_type>(deonSTL::distance(first, last)),
+                          overwrite());
+}
+
+// pop_front 弹出头部 n 个元素（不足 n 个时全部弹出），返回弹出的个数
+template <class T, class Alloc, bool Overwrite>
+typename ring_buffer<T, Alloc, Overwrite>::size_type
+ring_buffer<T, Alloc, Overwrite>::pop_front(size_type n)
+{
+    n = std::min(n, size());
+    destroy_span(head_, n);
+    head_ += n;
+    return n;
+}
+
+// pop_front 把头部 n 个元素（不足 n 个时全部）移动到 out 后弹出，最多两段
+template <class T, class Alloc, bool Overwrite>
+template <class OIter>
+OIter
+ring_buffer<T, Alloc, Overwrite>::pop_front(size_type n, OIter out)
+{
+    n = std::min(n, size());
+    const size_type idx = head_ & mask();
+    const size_type n1  = std::min(n, cap_ - idx);
+    out = deonSTL::move(buf_ + idx, buf_ + idx + n1, out);
+    out = deonSTL::move(buf_, buf_ + (n - n1), out);
+    destroy_span(head_, n);
+    head_ += n;
+    return out;
+}
+
+// clear 析构全部元素，保留空间
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::clear() noexcept
+{
+    destroy_span(head_, size());
+    head_ = tail_ = 0;
+}
+
+// swap 连同配置器一起交换
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::swap(ring_buffer& rhs) noexcept
+{
+    std::swap(this->get_alloc(), rhs.get_alloc());
+    std::swap(buf_, rhs.buf_);
+    std::swap(cap_, rhs.cap_);
+    std::swap(head_, rhs.head_);
+    std::swap(tail_, rhs.tail_);
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+// round_capacity 容量向上取整为 2 的幂
+template <class T, class Alloc, bool Overwrite>
+typename ring_buffer<T, Alloc, Overwrite>::size_type
+ring_buffer<T, Alloc, Overwrite>::round_capacity(size_type n) noexcept
+{
+    size_type cap = 1;
+    while(cap < n)
+        cap <<= 1;
+    return cap;
+}
+
+// init_space 申请空间，n 向上取整为 2 的幂，n 为 0 时不申请
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::init_space(size_type n)
+{
+    if(n == 0)
+        return;
+    const size_type cap = round_capacity(n);
+    buf_ = this->get_alloc().allocate(cap);
+    cap_ = cap;
+}
+
+// destroy_and_recover 析构全部元素并释放空间
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::destroy_and_recover() noexcept
+{
+    if(buf_ == nullptr)
+        return;
+    destroy_span(head_, size());
+    this->get_alloc().deallocate(buf_, cap_);
+    buf_ = nullptr;
+    cap_ = head_ = tail_ = 0;
+}
+
+// copy_init 申请 n 个元素的空间并复制 [first, first+n)
+template <class T, class Alloc, bool Overwrite>
+template <class FIter>
+void
+ring_buffer<T, Alloc, Overwrite>::copy_init(FIter first, size_type n)
+{
+    init_space(n);
+    try {
+        deonSTL::uninitialized_copy_n(first, n, buf_);
+    } catch (...) {
+        destroy_and_recover();
+        throw;
+    }
+    tail_ = n;
+}
+
+// copy_span rhs 中的元素最多分成两段，逐段复制到尾部
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::copy_span(const ring_buffer& rhs, size_type pos, size_type n)
+{
+    const size_type idx = pos & rhs.mask();
+    const size_type n1  = std::min(n, rhs.cap_ - idx);
+    copy_to_back(rhs.buf_ + idx, n1);
+    copy_to_back(rhs.buf_, n - n1);
+}
+
+// destroy_span 析构从 pos 开始的 n 个元素，最多两段
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::destroy_span(size_type pos, size_type n) noexcept
+{
+    if(n == 0)
+        return;
+    const size_type idx = pos & mask();
+    const size_type n1  = std::min(n, cap_ - idx);
+    deonSTL::destroy(buf_ + idx, buf_ + idx + n1);
+    deonSTL::destroy(buf_, buf_ + (n - n1));
+}
+
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::make_room_back(std::true_type)
+{
+    MY_DEBUG(cap_ != 0);
+    if(full())
+        pop_front();
+}
+
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::make_room_back(std::false_type)
+{
+    MY_DEBUG(!full());
+}
+
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::make_room_front(std::true_type)
+{
+    MY_DEBUG(cap_ != 0);
+    if(full())
+        pop_back();
+}
+
+template <class T, class Alloc, bool Overwrite>
+void
+ring_buffer<T, Alloc, Overwrite>::make_room_front(std::false_type)
+{
+    MY_DEBUG(!full());
+}
+
+// bulk_push_back circular_buffer 版本：n 不小于容量时只保留最后 cap_ 个，否则先丢弃头部多出的元素
+template <class T, class Alloc, bool Overwrite>
+template <class FIter>
+typename ring_buffer<T, Alloc, Overwrite>::size_type
+ring_buffer<T, Alloc, Overwrite>::bulk_push_back(FIter first, size_type n, std::true_type)
+{
+    if(n >= cap_)
+    {
+        clear();
+        deonSTL::advance(first, n - cap_);
+        copy_to_back(first, cap_);
+    }
+    else
+    {
+        if(size() + n > cap_)
+            pop_front(size() + n - cap_);
+        copy_to_back(first, n);
+    }
+    return n;
+}
+
+// bulk_push_back ring_buffer 版本：只放入装得下的前一部分
+template <class T, class Alloc, bool Overwrite>
+template <class FIter>
+typename ring_buffer<T, Alloc, Overwrite>::size_type
+ring_buffer<T, Alloc, Overwrite>::bulk_push_back(FIter first, size_type n, std::false_type)
+{
+    n = std::min(n, cap_ - size());
+    copy_to_back(first, n);
+    return n;
+}
+
+// copy_to_back 把 [first, first+n) 复制到尾部（空间足够），回绕时分成两段
+template <class T, class Alloc, bool Overwrite>
+template <class FIter>
+void
+ring_buffer<T, Alloc, Overwrite>::copy_to_back(FIter first, size_type n)
+{
+    if(n == 0)
+        return;
+    const size_type idx = tail_ & mask();
+    const size_type n1  = std::min(n, cap_ - idx);
+    FIter mid = first;
+    deonSTL::advance(mid, n1);
+    deonSTL::uninitialized_copy(first, mid, buf_ + idx);
+    tail_ += n1;
+    deonSTL::uninitialized_copy_n(mid, n - n1, buf_);
+    tail_ += n - n1;
+}
+
+//***************************************************************************//
+//                            equal operator                                 //
+//***************************************************************************//
+
+template <class T, class Alloc, bool Overwrite>
+bool operator==(const ring_buffer<T, Alloc, Overwrite>& lhs,
+                const ring_buffer<T, Alloc, Overwrite>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+    std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Alloc, bool Overwrite>
+bool operator!=(const ring_buffer<T, Alloc, Overwrite>& lhs,
+                const ring_buffer<T, Alloc, Overwrite>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, class Alloc, bool Overwrite>
+void swap(ring_buffer<T, Alloc, Overwrite>& lhs, ring_buffer<T, Alloc, Overwrite>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+// 元素在堆上的缓冲区中，对象本身只保存指针和下标
+template <class T, class Alloc, bool Overwrite>
+struct is_trivially_relocatable<ring_buffer<T, Alloc, Overwrite>> : is_trivially_relocatable<Alloc> {};
+
+}// namespace deonSTL
+
+#endif /* ring_buffer_h */
@@ -11,6 +11,7 @@
 #ifndef set_h
 #define set_h
 
+#include <functional> // less
 #include "rb_tree.h"
 
 namespace deonSTL {
@@ -18,7 +19,7 @@ namespace deonSTL {
 
 // 模版类set
 // 比较方式缺省使用 std::less
-template <class Key, class Compare = std::less<Key>>
+template <class Key, class Compare = std::less<Key>, class Alloc = deonSTL::allocator<Key>>
 class set
 {
     
@@ -30,7 +31,7 @@ public:
     
 private:
     // 以 deonSTL::rb_tree 作为底层机制
-    typedef deonSTL::rb_tree<value_type, value_compare> base_type;
+    typedef deonSTL::rb_tree<value_type, value_compare, Alloc> base_type;
     base_type   tree_;
     
 public:
@@ -51,6 +52,12 @@ public:
     
     set() = default;
     
+    explicit set(const key_compare& comp, const allocator_type& alloc = allocator_type())
+    : tree_(comp, alloc) {}
+    
+    explicit set(const allocator_type& alloc)
+    : tree_(key_compare(), alloc) {}
+    
     template <class InputIter>
     set(InputIter first, InputIter last)
     : tree_()
@@ -102,6 +109,9 @@ public:
     size_type           max_size()  const noexcept
     { return tree_.max_size(); }
     
+    allocator_type      get_allocator() const
+    { return tree_.get_allocator(); }
+    
     // emplace
     template <class ...Args>
     deonSTL::pair<iterator, bool> emplace(Args&& ... args)
@@ -119,7 +129,7 @@ public:
     
     // erase
     void           erase(iterator pos) { tree_.erase(pos); }
-    size_type      erase(const key_type& key) { return tree_.erase_multi(key); }
+    size_type      erase(const key_type& key) { return tree_.erase_unique(key); }
     void           erase(iterator first, iterator last) { tree_.erase(first, last); }
     
     // clear
@@ -158,16 +168,16 @@ public:
     
 }; // class set
 
-template <class Key, class Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 { return lhs == rhs; }
 
-template <class Key, class Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const set<Key, Compare, Alloc>& lhs, const set<Key, Compare, Alloc>& rhs)
 { return !(lhs == rhs); }
 
-template <class Key, class Compare>
-void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+void swap(set<Key, Compare, Alloc>& lhs, set<Key, Compare, Alloc>& rhs)
 { lhs.swap(rhs); }
 
 
@@ -176,7 +186,7 @@ void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs)
 //***************************************************************************//
 
 
-template <class Key, class Compare = std::less<Key>>
+template <class Key, class Compare = std::less<Key>, class Alloc = deonSTL::allocator<Key>>
 class multiset
 {
 public:
@@ -187,7 +197,7 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef deonSTL::rb_tree<value_type, key_compare>  base_type;
+  typedef deonSTL::rb_tree<value_type, key_compare, Alloc>  base_type;
   base_type tree_;  // 以 rb_tree 表现 multiset
 
 public:
@@ -199,8 +209,6 @@ public:
   typedef typename base_type::const_reference        const_reference;
   typedef typename base_type::const_iterator         iterator;
   typedef typename base_type::const_iterator         const_iterator;
-  typedef typename base_type::const_reverse_iterator reverse_iterator;
-  typedef typename base_type::const_reverse_iterator const_reverse_iterator;
   typedef typename base_type::size_type              size_type;
   typedef typename base_type::difference_type        difference_type;
   typedef typename base_type::allocator_type         allocator_type;
@@ -208,6 +216,12 @@ public:
 public:
   // 构造、复制、移动函数
   multiset() = default;
+  
+  explicit multiset(const key_compare& comp, const allocator_type& alloc = allocator_type())
+  : tree_(comp, alloc) {}
+  
+  explicit multiset(const allocator_type& alloc)
+  : tree_(key_compare(), alloc) {}
 
   template <class InputIterator>
   multiset(InputIterator first, InputIterator last)
@@ -260,23 +274,10 @@ public:
   const_iterator         end()     const noexcept
   { return tree_.end(); }
 
-  reverse_iterator       rbegin()        noexcept
-  { return reverse_iterator(end()); }
-  const_reverse_iterator rbegin()  const noexcept
-  { return const_reverse_iterator(end()); }
-  reverse_iterator       rend()          noexcept
-  { return reverse_iterator(begin()); }
-  const_reverse_iterator rend()    const noexcept
-  { return const_reverse_iterator(begin()); }
-
   const_iterator         cbegin()  const noexcept
   { return begin(); }
   const_iterator         cend()    const noexcept
   { return end(); }
-  const_reverse_iterator crbegin() const noexcept
-  { return rbegin(); }
-  const_reverse_iterator crend()   const noexcept
-  { return rend(); }
 
   // 容量相关
   bool                   empty()    const noexcept { return tree_.empty(); }
@@ -341,21 +342,21 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator==(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs)
+template <class Key, class Compare, class Alloc>
+bool operator!=(const multiset<Key, Compare, Alloc>& lhs, const multiset<Key, Compare, Alloc>& rhs)
 {
   return !(lhs == rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept
+template <class Key, class Compare, class Alloc>
+void swap(multiset<Key, Compare, Alloc>& lhs, multiset<Key, Compare, Alloc>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -0,0 +1,385 @@
+//
+//  small_vector.h
+//  deonSTL
+//
+//  这个头文件包含模板类 small_vector 和它使用的配置器 inline_buffer_allocator
+//  inline_buffer_allocator : 自带 N 个元素的内嵌缓冲区，申请不超过 N 个元素且缓冲区空闲时直接返回缓冲区，
+//                            否则交给上游配置器 Alloc
+//  small_vector            : 以 inline_buffer_allocator 实例化的 vector，不超过 N 个元素时不申请堆内存，
+//                            插入、删除、扩容等操作全部复用 vector，只重写复制、移动、交换
+//
+//  small_vector 私有继承 vector：vector 的 swap、移动赋值、shrink_to_fit 会把内嵌缓冲区当作堆空间处理，
+//  所以不允许把 small_vector 转换成 vector 的引用，其余操作通过 using 声明公开
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef small_vector_h
+#define small_vector_h
+
+#include <algorithm>    // equal
+#include <cstddef>      // size_t
+#include <iterator>     // make_move_iterator
+#include <type_traits>  // aligned_storage
+#include "vector.h"
+
+namespace deonSTL {
+
+//***************************************************************************//
+//                          inline_buffer_allocator                          //
+//         缓冲区属于配置器对象本身：复制配置器只复制上游配置器，新对象的缓冲区为空闲            //
+//***************************************************************************//
+
+template <class T, size_t N, class Alloc = deonSTL::allocator<T>>
+class inline_buffer_allocator : private deonSTL::alloc_holder<Alloc>
+{
+    static_assert(N > 0, "inline_buffer_allocator needs a non-empty buffer");
+
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+    typedef Alloc       upstream_allocator;
+
+    template <class U>
+    struct rebind
+    {
+        typedef inline_buffer_allocator<U, N, typename Alloc::template rebind<U>::other> other;
+    };
+
+private:
+    typedef deonSTL::alloc_holder<Alloc> upstream_base;
+
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;
+    bool used_;     // 缓冲区是否已交给容器
+
+public:
+    inline_buffer_allocator() noexcept
+    : used_(false) {}
+
+    explicit inline_buffer_allocator(const Alloc& upstream) noexcept
+    : upstream_base(upstream), used_(false) {}
+
+    inline_buffer_allocator(const inline_buffer_allocator& rhs) noexcept
+    : upstream_base(rhs.upstream()), used_(false) {}
+
+    template <class U, class A>
+    inline_buffer_allocator(const inline_buffer_allocator<U, N, A>& rhs) noexcept
+    : upstream_base(Alloc(rhs.upstream())), used_(false) {}
+
+    // 只赋值上游配置器，缓冲区的使用状态仍属于自己
+    inline_buffer_allocator& operator=(const inline_buffer_allocator& rhs) noexcept
+    {
+        this->get_alloc() = rhs.upstream();
+        return *this;
+    }
+
+    const Alloc& upstream() const noexcept
+    { return this->get_alloc(); }
+
+    // ptr 是否指向内嵌缓冲区
+    bool is_inline(const T* ptr) const noexcept
+    { return ptr == inline_data(); }
+
+    T* allocate(size_type n)
+    {
+        if(!used_ && n <= N)
+        {
+            used_ = true;
+            return inline_data();
+        }
+        return this->get_alloc().allocate(n);
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        if(is_inline(ptr))
+            used_ = false;
+        else
+            this->get_alloc().deallocate(ptr, n);
+    }
+
+private:
+    T* inline_data() noexcept
+    { return reinterpret_cast<T*>(&buf_); }
+    const T* inline_data() const noexcept
+    { return reinterpret_cast<const T*>(&buf_); }
+
+}; // class inline_buffer_allocator
+
+// 两个配置器只有在是同一个对象时才能互相释放对方的缓冲区
+template <class T, size_t N, class Alloc>
+bool operator==(const inline_buffer_allocator<T, N, Alloc>& lhs,
+                const inline_buffer_allocator<T, N, Alloc>& rhs) noexcept
+{ return &lhs == &rhs; }
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const inline_buffer_allocator<T, N, Alloc>& lhs,
+                const inline_buffer_allocator<T, N, Alloc>& rhs) noexcept
+{ return !(lhs == rhs); }
+
+// 缓冲区在对象内部，按字节搬移后指针会指向旧对象
+template <class T, size_t N, class Alloc>
+struct is_trivially_relocatable<inline_buffer_allocator<T, N, Alloc>> : std::false_type {};
+
+//***************************************************************************//
+//                               small_vector                                //
+//        容量始终不小于 N：构造时先占用内嵌缓冲区，超过 N 个元素后由 vector 扩容到堆上          //
+//***************************************************************************//
+
+template <class T, size_t N, class Alloc = deonSTL::allocator<T>,
+          class Growth = deonSTL::growth_factor_1_5>
+class small_vector
+: private deonSTL::vector<T, inline_buffer_allocator<T, N, Alloc>, Growth>
+{
+public:
+    typedef deonSTL::vector<T, inline_buffer_allocator<T, N, Alloc>, Growth>   base_type;
+    typedef Alloc                                       allocator_type;
+
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+
+    static const size_type inline_capacity = N;
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    small_vector() noexcept
+    { reset_inline(); }
+
+    explicit small_vector(const allocator_type& alloc) noexcept
+    : base_type(typename base_type::allocator_type(alloc))
+    { reset_inline(); }
+
+    explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+    : base_type(typename base_type::allocator_type(alloc))
+    {
+        reset_inline();
+        this->resize(n);
+    }
+
+    small_vector(size_type n, default_init_t, const allocator_type& alloc = allocator_type())
+    : base_type(typename base_type::allocator_type(alloc))
+    {
+        reset_inline();
+        this->resize_default_init(n);
+    }
+    
+    small_vector(size_type n, const value_type& value,
+                 const allocator_type& alloc = allocator_type())
+    : base_type(typename base_type::allocator_type(alloc))
+    {
+        reset_inline();
+        this->insert(this->end(), n, value);
+    }
+
+    template <class Iter, typename std::enable_if<
+        !std::is_integral<Iter>::value, int>::type = 0>
+    small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : base_type(typename base_type::allocator_type(alloc))
+    {
+        reset_inline();
+        this->insert(this->end(), first, last);
+    }
+
+    small_vector(std::initializer_list<value_type> ilist,
+                 const allocator_type& alloc = allocator_type())
+    : base_type(typename base_type::allocator_type(alloc))
+    {
+        reset_inline();
+        this->insert(this->end(), ilist.begin(), ilist.end());
+    }
+
+    small_vector(const small_vector& rhs)
+    : base_type(typename base_type::allocator_type(rhs.get_allocator()))
+    {
+        reset_inline();
+        this->insert(this->end(), rhs.begin(), rhs.end());
+    }
+
+    small_vector(small_vector&& rhs)
+    : base_type(typename base_type::allocator_type(rhs.get_allocator()))
+    {
+        reset_inline();
+        move_from(rhs);
+    }
+
+    small_vector& operator=(const small_vector& rhs)
+    {
+        if(this != &rhs)
+        {
+            this->clear();
+            this->insert(this->end(), rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& rhs)
+    {
+        if(this != &rhs)
+            move_from(rhs);
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<value_type> ilist)
+    {
+        this->clear();
+        this->insert(this->end(), ilist.begin(), ilist.end());
+        return *this;
+    }
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type  get_allocator() const
+    { return this->get_alloc().upstream(); }
+
+    // 元素是否保存在内嵌缓冲区中
+    bool            is_inline() const noexcept
+    { return this->get_alloc().is_inline(this->begin_); }
+
+    // 元素不超过 N 个时搬回内嵌缓冲区
+    void            shrink_to_fit();
+
+    void            swap(small_vector& rhs);
+
+    // 以下操作直接复用 vector
+    using base_type::begin;
+    using base_type::end;
+    using base_type::empty;
+    using base_type::size;
+    using base_type::max_size;
+    using base_type::capacity;
+    using base_type::reserve;
+    using base_type::operator[];
+    using base_type::front;
+    using base_type::back;
+    using base_type::emplace;
+    using base_type::emplace_back;
+    using base_type::push_back;
+    using base_type::pop_back;
+    using base_type::insert;
+    using base_type::erase;
+    using base_type::clear;
+    using base_type::resize;
+    using base_type::resize_default_init;
+
+private:
+    // ==========================辅助函数============================ //
+
+    // 占用内嵌缓冲区作为空的存储空间（此时缓冲区一定空闲）
+    void reset_inline() noexcept
+    {
+        this->begin_ = this->end_ = this->get_alloc().allocate(N);
+        this->cap_ = this->begin_ + N;
+    }
+
+    void move_from(small_vector& rhs);
+
+}; // class small_vector
+
+// move_from 从 rhs 移入元素：rhs 在堆上则直接接管它的空间（连同上游配置器），否则逐个移动
+// 结束后 rhs 为空，并重新占用自己的内嵌缓冲区
+template <class T, size_t N, class Alloc, class Growth>
+void
+small_vector<T, N, Alloc, Growth>::move_from(small_vector& rhs)
+{
+    if(rhs.is_inline())
+    {
+        this->clear();
+        this->insert(this->end(), std::make_move_iterator(rhs.begin()),
+                     std::make_move_iterator(rhs.end()));
+        rhs.clear();
+        return;
+    }
+    this->destroy_and_recover(this->begin_, this->end_, this->capacity());
+    this->get_alloc() = rhs.get_alloc();
+    this->begin_ = rhs.begin_;
+    this->end_ = rhs.end_;
+    this->cap_ = rhs.cap_;
+    rhs.reset_inline();
+}
+
+// shrink_to_fit 在堆上且元素不超过 N 个时搬回内嵌缓冲区，否则同 vector
+template <class T, size_t N, class Alloc, class Growth>
+void
+small_vector<T, N, Alloc, Growth>::shrink_to_fit()
+{
+    if(is_inline())
+        return;
+    if(this->size() > N)
+    {
+        base_type::shrink_to_fit();
+        return;
+    }
+    const size_type len = this->size();
+    iterator buf = this->get_alloc().allocate(N);   // 元素在堆上，缓冲区一定空闲
+    try {
+        deonSTL::uninitialized_move(this->begin_, this->end_, buf);
+    } catch (...) {
+        this->get_alloc().deallocate(buf, N);
+        throw;
+    }
+    this->destroy_and_recover(this->begin_, this->end_, this->capacity());
+    this->begin_ = buf;
+    this->end_ = buf + len;
+    this->cap_ = buf + N;
+}
+
+// swap 两边都在堆上时交换指针，否则通过一个临时对象逐个移动
+template <class T, size_t N, class Alloc, class Growth>
+void
+small_vector<T, N, Alloc, Growth>::swap(small_vector& rhs)
+{
+    if(this == &rhs)
+        return;
+    if(!is_inline() && !rhs.is_inline())
+    {
+        base_type::swap(rhs);
+        return;
+    }
+    small_vector tmp(std::move(rhs));
+    rhs.move_from(*this);
+    move_from(tmp);
+}
+
+//***************************************************************************//
+//                            equal operator                                 //
+//***************************************************************************//
+
+template <class T, size_t N, class Alloc, class Growth>
+bool operator == (const small_vector<T, N, Alloc, Growth>& lhs,
+                  const small_vector<T, N, Alloc, Growth>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+    std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc, class Growth>
+bool operator != (const small_vector<T, N, Alloc, Growth>& lhs,
+                  const small_vector<T, N, Alloc, Growth>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc, class Growth>
+void swap(small_vector<T, N, Alloc, Growth>& lhs, small_vector<T, N, Alloc, Growth>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace deonSTL
+
+#endif /* small_vector_h */
@@ -0,0 +1,258 @@
+//
+//  spsc_queue.h
+//  deonSTL
+//
+//  这个头文件包含模板类 spsc_queue：单生产者、单消费者的有界无锁队列
+//  只能有一个线程调用 try_push，一个线程调用 try_pop（可以是不同的线程），不需要互斥锁
+//
+//  head_ 只由消费者写，tail_ 只由生产者写，两者以及各自的缓存副本放在不同的缓存行，避免伪共享
+//  生产者保存 head_ 的副本 head_cache_，只有看起来满的时候才去读 head_；消费者对 tail_ 同理，
+//  大多数操作只访问本线程独占的缓存行
+//  批量 try_push(first, last)、try_pop(out, n) 最多分成两段连续空间复制，并且只发布一次下标
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef spsc_queue_h
+#define spsc_queue_h
+
+#include <cstddef>      // size_t
+#include <atomic>
+#include <utility>      // move, forward
+#include <algorithm>    // min
+#include "iterator.h"
+#include "allocator.h"
+#include "uninitialized.h"
+#include "algobase.h"
+
+namespace deonSTL{
+
+// 缓存行大小，并发容器用它隔开不同线程写的数据
+constexpr size_t cache_line_size = 64;
+
+// 模版类 spsc_queue
+// 容量向上取整为 2 的幂，下标为不回绕的计数，与 mask_ 相与得到位置
+template <class T, class Alloc = deonSTL::allocator<T>>
+class spsc_queue : private deonSTL::alloc_holder<Alloc>
+{
+public:
+
+    typedef Alloc                                       allocator_type;
+
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+
+private:
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    typedef std::atomic<size_type>                      index_type;
+
+    // 两个线程都只读
+    pointer         buf_;
+    size_type       cap_;
+    size_type       mask_;
+    char            pad0_[cache_line_size];
+
+    // 生产者独占
+    index_type      tail_;          // 下一个写入位置
+    size_type       head_cache_;    // 生产者看到的 head_
+    char            pad1_[cache_line_size];
+
+    // 消费者独占
+    index_type      head_;          // 下一个读出位置
+    size_type       tail_cache_;    // 消费者看到的 tail_
+    char            pad2_[cache_line_size];
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    explicit spsc_queue(size_type capacity, const allocator_type& alloc = allocator_type());
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue();
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+
+    size_type           capacity()    const noexcept
+    { return cap_; }
+
+    // 其他线程同时在操作时只是一个近似值
+    size_type           size_approx() const noexcept
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool                empty_approx() const noexcept
+    { return size_approx() == 0; }
+
+    // 生产者：队列满时返回 false
+    template <class ...Args>
+    bool        try_emplace(Args&& ...args);
+    bool        try_push(const value_type& value) { return try_emplace(value); }
+    bool        try_push(value_type&& value)      { return try_emplace(std::move(value)); }
+
+    // 生产者：放入 [first, last) 中装得下的前一部分，返回放入的个数
+    template <class FIter>
+    size_type   try_push(FIter first, FIter last);
+
+    // 消费者：队列空时返回 false
+    bool        try_pop(value_type& value);
+
+    // 消费者：最多取出 n 个元素移动到 out，返回取出的个数
+    template <class OIter>
+    size_type   try_pop(OIter out, size_type n);
+
+private:
+    // ==========================辅助函数============================ //
+
+    // 生产者还能放入的个数，不足 n 时重新读取 head_
+    size_type   free_slots(size_type tail, size_type n) noexcept;
+    // 消费者能取出的个数，不足 n 时重新读取 tail_
+    size_type   ready_slots(size_type head, size_type n) noexcept;
+
+};// class spsc_queue
+
+//***************************************************************************//
+//                           member functions                                //
+//***************************************************************************//
+
+// 构造函数 申请不小于 capacity 的 2 的幂个元素的空间
+template <class T, class Alloc>
+spsc_queue<T, Alloc>::spsc_queue(size_type capacity, const allocator_type& alloc)
+: alloc_base(alloc), tail_(0), head_cache_(0), head_(0), tail_cache_(0)
+{
+    cap_ = 1;
+    while(cap_ < capacity)
+        cap_ <<= 1;
+    mask_ = cap_ - 1;
+    buf_ = this->get_alloc().allocate(cap_);
+}
+
+// 析构函数 析构队列中剩下的元素（此时不能有其他线程在使用队列）
+template <class T, class Alloc>
+spsc_queue<T, Alloc>::~spsc_queue()
+{
+    const size_type head = head_.load(std::memory_order_relaxed);
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    for(size_type i = head; i != tail; ++i)
+        deonSTL::destroy(buf_ + (i & mask_));
+    this->get_alloc().deallocate(buf_, cap_);
+}
+
+// try_emplace 构造好元素后才发布 tail_（release），消费者读到新的 tail_ 时元素一定可见
+template <class T, class Alloc>
+template <class ...Args>
+bool
+spsc_queue<T, Alloc>::try_emplace(Args&& ...args)
+{
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if(free_slots(tail, 1) == 0)
+        return false;
+    deonSTL::construct(buf_ + (tail & mask_), std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+// try_push 批量版本，回绕时分成两段复制
+template <class T, class Alloc>
+template <class FIter>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::try_push(FIter first, FIter last)
+{
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    const size_type n = free_slots(tail, static_cast<size_type>(deonSTL::distance(first, last)));
+    if(n == 0)
+        return 0;
+    const size_type idx = tail & mask_;
+    const size_type n1  = std::min(n, cap_ - idx);
+    FIter mid = first;
+    deonSTL::advance(mid, n1);
+    deonSTL::uninitialized_copy(first, mid, buf_ + idx);
+    try {
+        deonSTL::uninitialized_copy_n(mid, n - n1, buf_);
+    } catch (...) {
+        deonSTL::destroy(buf_ + idx, buf_ + idx + n1);
+        throw;
+    }
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+// try_pop 移出元素并析构后才发布 head_，生产者读到新的 head_ 时这个位置已经可以重用
+template <class T, class Alloc>
+bool
+spsc_queue<T, Alloc>::try_pop(value_type& value)
+{
+    const size_type head = head_.load(std::memory_order_relaxed);
+    if(ready_slots(head, 1) == 0)
+        return false;
+    pointer p = buf_ + (head & mask_);
+    value = std::move(*p);
+    deonSTL::destroy(p);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// try_pop 批量版本，回绕时分成两段移动
+template <class T, class Alloc>
+template <class OIter>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::try_pop(OIter out, size_type n)
+{
+    const size_type head = head_.load(std::memory_order_relaxed);
+    n = ready_slots(head, n);
+    if(n == 0)
+        return 0;
+    const size_type idx = head & mask_;
+    const size_type n1  = std::min(n, cap_ - idx);
+    out = deonSTL::move(buf_ + idx, buf_ + idx + n1, out);
+    deonSTL::move(buf_, buf_ + (n - n1), out);
+    deonSTL::destroy(buf_ + idx, buf_ + idx + n1);
+    deonSTL::destroy(buf_, buf_ + (n - n1));
+    head_.store(head + n, std::memory_order_release);
+    return n;
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+// free_slots 先用缓存的 head_cache_ 计算，不够时才读取消费者的 head_（acquire，与 try_pop 的 release 配对）
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::free_slots(size_type tail, size_type n) noexcept
+{
+    size_type avail = cap_ - (tail - head_cache_);
+    if(avail < n)
+    {
+        head_cache_ = head_.load(std::memory_order_acquire);
+        avail = cap_ - (tail - head_cache_);
+    }
+    return std::min(avail, n);
+}
+
+// ready_slots 先用缓存的 tail_cache_ 计算，不够时才读取生产者的 tail_
+template <class T, class Alloc>
+typename spsc_queue<T, Alloc>::size_type
+spsc_queue<T, Alloc>::ready_slots(size_type head, size_type n) noexcept
+{
+    size_type avail = tail_cache_ - head;
+    if(avail < n)
+    {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        avail = tail_cache_ - head;
+    }
+    return std::min(avail, n);
+}
+
+}// namespace deonSTL
+
+#endif /* spsc_queue_h */
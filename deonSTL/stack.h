@@ -3,6 +3,8 @@
 //  deonSTL
 //
 // 这个头文件包含了一个模板类 stack
+// 缺省的底层容器为 vector：元素连续存放，push / pop 只移动尾指针；
+// inline_stack 以 small_vector 为底层容器，不超过 N 个元素时不申请堆内存，适合深度有限的 DFS
 //
 //  Created by 郭松楠 on 2020/4/1.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -12,12 +14,14 @@
 #define stack_h
 
 #include "deque.h"
+#include "vector.h"
+#include "small_vector.h"
 
 
 namespace deonSTL {
 
-// 第二参数代表底层容器类型，缺省使用 deonSTL::deque
-template <class T, class Container = deonSTL::deque<T>>
+// 第二参数代表底层容器类型，缺省使用 deonSTL::vector，也可以使用 deque、ring_buffer 等
+template <class T, class Container = deonSTL::vector<T>>
 class stack
 {
 public:
@@ -43,6 +47,15 @@ public:
     : c_(n, value)
     {}
     
+    // 使用已有的底层容器，如预先设定容量的 ring_buffer
+    explicit stack(const container_type& c)
+    : c_(c)
+    {}
+    
+    explicit stack(container_type&& c)
+    : c_(std::move(c))
+    {}
+    
     template <class IIter>
     stack(IIter first, IIter last)
     : c_(first, last)
@@ -100,8 +113,16 @@ public:
     void pop()
     { c_.pop_back(); }
     
+    // 交给底层容器的 clear，vector 中元素可平凡析构时为 O(1)
     void clear()
-    { while(!empty()) pop(); }
+    { c_.clear(); }
+    
+    // 只能用于有 reserve 的底层容器（vector、small_vector、ring_buffer）
+    void reserve(size_type n)
+    { c_.reserve(n); }
+    
+    size_type capacity() const noexcept
+    { return c_.capacity(); }
     
     void swap(stack& rhs)
     { deonSTL::swap(c_, rhs.c_); }
@@ -111,6 +132,10 @@ public:
     
 }; // class stack
 
+// 以 small_vector 为底层容器的 stack，前 N 个元素存放在对象内部
+template <class T, size_t N, class Alloc = deonSTL::allocator<T>>
+using inline_stack = stack<T, deonSTL::small_vector<T, N, Alloc>>;
+
 //***************************************************************************//
 //                            equal operator                                 //
 //***************************************************************************//
@@ -3,6 +3,7 @@
 //  deonSTL
 //
 //  这个头文件用于提取类型的信息（ has_trivial_default_constructor等 ）
+//  is_trivially_relocatable : 对象能否按字节搬到新地址（并且不再析构旧对象）
 //
 //  Created by 郭松楠 on 2020/3/14.
 //  Copyright © 2020 郭松楠. All rights reserved.
@@ -12,11 +13,39 @@
 #define type_traits_h
 
 #include <type_traits> // 使用标准库
+#include <memory>      // unique_ptr, default_delete
 
 namespace deonSTL{
 
 // 例 has_trivial_default_constructor
 
+//***************************************************************************//
+//                          is_trivially_relocatable                         //
+//       “移动构造到新地址 + 析构旧对象” 可以用一次 memcpy 代替的类型                    //
+//       缺省为平凡可复制类型，其他类型（如自己的句柄类）可以特化为 true_type 来选择加入       //
+//       注意：对象内部保存指向自身的指针的类型不可以（如 libstdc++ 的 std::string）       //
+//***************************************************************************//
+
+template <class T>
+struct is_trivially_relocatable
+: std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+template <class T>
+struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+
+// pair 的两个成员都可以按字节搬移时 pair 也可以
+template <class T1, class T2>
+struct pair;
+
+template <class T1, class T2>
+struct is_trivially_relocatable<pair<T1, T2>>
+: std::integral_constant<bool, is_trivially_relocatable<T1>::value &&
+                               is_trivially_relocatable<T2>::value> {};
+
+// unique_ptr 只有一个指针（缺省删除器为空类）
+template <class T, class U>
+struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<U>>> : std::true_type {};
+
 } // namespace deonSTL
 
 #endif /* type_traits_h */
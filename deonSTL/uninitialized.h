@@ -11,8 +11,11 @@
 #ifndef uninitialized_h
 #define uninitialized_h
 
-#include "type_traits"
+#include <type_traits>
+#include <cstring>   // memmove
 #include "construct.h"
+#include "type_traits.h"
+#include "algobase.h"
 #include <algorithm> //copy, copy_n, fill
 
 namespace deonSTL{
@@ -23,13 +26,13 @@ namespace deonSTL{
 //               把 [first, last) 上的内容复制到 result 为起始的空间，返回结束位置                 //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memmove）
 template <class InputIt, class ForwardIt>
 ForwardIt
 __uninitialized_copy(InputIt first, InputIt last, ForwardIt result,
                                     std::true_type)
 {
-    return std::copy(first, last, result);
+    return deonSTL::copy(first, last, result);
 }
 
 // 对于 has non_trivial 特化版本
@@ -47,7 +50,9 @@ __uninitialized_copy(InputIt first, InputIt last, ForwardIt result,
     catch (...){
         for(; result != cur; ++result)
             destroy(&*result);
+        throw ;
     }
+    return cur;
 }
 
 // uninitialized_copy 实作
@@ -65,12 +70,12 @@ uninitialized_copy(InputIt first, InputIt last, ForwardIt result)
 //            把 [first, first+n ) 上的内容复制到 result 为起始的空间，返回结束位置                //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memmove）
 template <class InputIt, class Size, class ForwardIt>
 ForwardIt __uninitialized_copy_n(InputIt first, Size n, ForwardIt result,
                                        std::true_type)
 {
-    return std::copy_n(first, n, result);
+    return deonSTL::copy_n(first, n, result);
 }
 
 // 对于 has non_trivial 特化版本
@@ -86,6 +91,7 @@ __uninitialized_copy_n(InputIt first, Size n, ForwardIt result,
     } catch (...) {
         for(; result != cur; ++result)
             destroy(&*result);
+        throw ;
     }
     return cur;
 }
@@ -105,13 +111,13 @@ uninitialized_copy_n(InputIt first, Size n, ForwardIt result)
 //                         在 [first, last) 区间赋值 value，不返回值                           //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memset / SIMD 填充）
 template <class ForwardIt, class T>
 void
 __uninitialized_fill( ForwardIt first, ForwardIt last, const T& value,
                           std::true_type)
 {
-    std::fill(first, last, value);
+    deonSTL::fill(first, last, value);
 }
 
 // 对于 has non_trivial 特化版本
@@ -126,7 +132,8 @@ __uninitialized_fill( ForwardIt first, ForwardIt last, const T& value,
             construct(&*cur, value);
     } catch (...) {
         for( ; first != cur; ++first)
-            destroy(first);
+            destroy(&*first);
+        throw ;
     }
 }
 
@@ -142,21 +149,21 @@ uninitialized_fill( ForwardIt first, ForwardIt last, const T& value)
 
 //*****************************************************************************************//
 //                                  uninitialized_fill_n                                    //
-//                         在 [first, first+n) 区间赋值 value，不返回值                        //
+//                     在 [first, first+n) 区间构造 value，返回结束位置                         //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memset / SIMD 填充）
 template <class ForwardIt, class Size, class T>
-void
+ForwardIt
 __uninitialized_fill_n( ForwardIt first, Size n, const T& value,
                       std::true_type)
 {
-    std::fill_n(first, n, value);
+    return deonSTL::fill_n(first, n, value);
 }
 
 // 对于 has non_trivial 特化版本
 template <class ForwardIt, class Size, class T>
-void
+ForwardIt
 __uninitialized_fill_n( ForwardIt first, Size n, const T& value,
                       std::false_type)
 {
@@ -167,30 +174,73 @@ __uninitialized_fill_n( ForwardIt first, Size n, const T& value,
     } catch (...) {
         for( ; first != cur; ++first)
             destroy(&*first);
+        throw ;
     }
+    return cur;
 }
 
 // uninitialized_fill_n 实作
 template <class ForwardIt, class Size, class T>
-void
+ForwardIt
 uninitialized_fill_n( ForwardIt first, Size n, const T& value)
 {
-    __uninitialized_fill_n(first, n, value,
+    return __uninitialized_fill_n(first, n, value,
                           std::is_trivially_copy_assignable<
                           typename iterator_traits<ForwardIt>::value_type>{});
 }
 
+//*****************************************************************************************//
+//                            uninitialized_default_construct_n                             //
+//           在 [first, first+n) 区间默认初始化，返回结束位置，平凡类型不写入任何内容             //
+//*****************************************************************************************//
+
+// 对于 has trivial 特化版本，什么也不做
+template <class ForwardIt, class Size>
+ForwardIt
+__uninitialized_default_construct_n(ForwardIt first, Size n, std::true_type)
+{
+    deonSTL::advance(first, n);
+    return first;
+}
+
+// 对于 has non_trivial 特化版本
+template <class ForwardIt, class Size>
+ForwardIt
+__uninitialized_default_construct_n(ForwardIt first, Size n, std::false_type)
+{
+    auto cur = first;
+    try {
+        for( ; n > 0; --n, ++cur)
+            construct_default(&*cur);
+    } catch (...) {
+        for( ; first != cur; ++first)
+            destroy(&*first);
+        throw ;
+    }
+    return cur;
+}
+
+// uninitialized_default_construct_n 实作
+template <class ForwardIt, class Size>
+ForwardIt
+uninitialized_default_construct_n(ForwardIt first, Size n)
+{
+    return __uninitialized_default_construct_n(first, n,
+                          std::is_trivially_default_constructible<
+                          typename iterator_traits<ForwardIt>::value_type>{});
+}
+
 //*****************************************************************************************//
 //                                  uninitialized_move                                      //
 //                      把[first, last) 的内容移动到 result开始处，窃取空间                      //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memmove）
 template <class InputIter, class ForwardIter>
 ForwardIter
 __uninitialized_move(InputIter first, InputIter last, ForwardIter result, std::true_type)
 {
-    return std::move(first, last, result);
+    return deonSTL::move(first, last, result);
 }
 
 // 对于 has non_trivial 特化版本
@@ -207,6 +257,7 @@ __uninitialized_move(InputIter first, InputIter last, ForwardIter result, std::f
     catch(...)
     {
         deonSTL::destroy(result, cur);
+        throw ;
     }
     return cur;
 }
@@ -226,12 +277,12 @@ uninitialized_move(InputIter first, InputIter last, ForwardIter result)
 //                     把[first, first+n) 的内容移动到 result开始处，窃取空间                    //
 //*****************************************************************************************//
 
-// 对于 has trivial 特化版本
+// 对于 has trivial 特化版本，交给 algobase（分段迭代器逐块处理，连续空间使用 memmove）
 template <class InputIter, class Size, class ForwardIter>
 ForwardIter
 __uninitialized_move_n(InputIter first, Size n, ForwardIter result, std::true_type)
 {
-    return std::move(first, first + n, result);
+    return deonSTL::move(first, first + n, result);
 }
 
 // 对于 has non_trivial 特化版本
@@ -264,6 +315,42 @@ uninitialized_move_n(InputIter first, Size n, ForwardIter result)
                                           typename iterator_traits<InputIter>::value_type>{});
 }
 
+//*****************************************************************************************//
+//                                uninitialized_relocate                                    //
+//         把 [first, last) 的对象搬到 result 开始的未初始化空间，返回结束位置                       //
+//               搬完后 [first, last) 视为未初始化空间（不再析构），两段空间可以重叠                 //
+//*****************************************************************************************//
+
+// 对于 trivially relocatable 特化版本，按字节搬移
+template <class T>
+T*
+__uninitialized_relocate(T* first, T* last, T* result, std::true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if(n != 0)
+        std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+    return result + n;
+}
+
+// 对于 non-trivially relocatable 特化版本，逐个移动构造再析构，只用于不重叠的空间
+template <class T>
+T*
+__uninitialized_relocate(T* first, T* last, T* result, std::false_type)
+{
+    T* cur = deonSTL::uninitialized_move(first, last, result);
+    deonSTL::destroy(first, last);
+    return cur;
+}
+
+// uninitialized_relocate 实作
+template <class T>
+T*
+uninitialized_relocate(T* first, T* last, T* result)
+{
+    return deonSTL::__uninitialized_relocate(first, last, result,
+                                            deonSTL::is_trivially_relocatable<T>{});
+}
+
 
 
 
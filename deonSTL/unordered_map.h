@@ -0,0 +1,434 @@
+//
+//  unordered_map.h
+//  deonSTL
+//
+//  这个头文件包含两个模板类 unordered_map 和 unordered_multimap
+//  以 hashtable 为底层机制，键值对直接存放在开放定址的槽数组中
+//  与 std::unordered_map 不同，插入、删除可能使迭代器和元素的引用失效（元素在槽之间搬移）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef unordered_map_h
+#define unordered_map_h
+
+#include <functional> // equal_to
+#include "hash.h"
+#include "hashtable.h"
+
+namespace deonSTL{
+
+//***************************************************************************//
+//                              unordered_map                                //
+//***************************************************************************//
+
+// 模板类 unordered_map，键值不允许重复
+// 哈希函数缺省使用 deonSTL::hash，比较方式缺省使用 std::equal_to
+template <class Key, class T, class Hash = deonSTL::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = deonSTL::allocator<deonSTL::pair<const Key, T>>>
+class unordered_map
+{
+private:
+    // 以 deonSTL::hashtable 作为底层机制
+    typedef deonSTL::hashtable<deonSTL::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
+    base_type   ht_;
+
+public:
+    typedef typename base_type::key_type                key_type;
+    typedef typename base_type::mapped_type             mapped_type;
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::hasher                  hasher;
+    typedef typename base_type::key_equal               key_equal;
+
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::local_iterator          local_iterator;
+    typedef typename base_type::const_local_iterator    const_local_iterator;
+    typedef typename base_type::allocator_type          allocator_type;
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    unordered_map() = default;
+
+    explicit unordered_map(size_type bucket_count,
+                           const hasher& hash = hasher(),
+                           const key_equal& equal = key_equal(),
+                           const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc) {}
+
+    template <class InputIter>
+    unordered_map(InputIter first, InputIter last, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(first, last); }
+
+    unordered_map(std::initializer_list<value_type> ilist, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(ilist.begin(), ilist.end()); }
+
+    unordered_map(const unordered_map& rhs)
+    : ht_(rhs.ht_) {}
+
+    unordered_map(unordered_map&& rhs) noexcept
+    : ht_(std::move(rhs.ht_)) {}
+
+    unordered_map& operator=(const unordered_map& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    unordered_map& operator=(unordered_map&& rhs) noexcept
+    {
+        ht_ = std::move(rhs.ht_);
+        return *this;
+    }
+
+    unordered_map& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // ==========================成员函数============================ //
+
+    iterator            begin()           noexcept
+    { return ht_.begin(); }
+    const_iterator      begin()     const noexcept
+    { return ht_.begin(); }
+    iterator            end()             noexcept
+    { return ht_.end(); }
+    const_iterator      end()       const noexcept
+    { return ht_.end(); }
+
+    const_iterator      cbegin()    const noexcept
+    { return ht_.cbegin(); }
+    const_iterator      cend()      const noexcept
+    { return ht_.cend(); }
+
+    bool                empty()     const noexcept
+    { return ht_.empty(); }
+    size_type           size()      const noexcept
+    { return ht_.size(); }
+    size_type           max_size()  const noexcept
+    { return ht_.max_size(); }
+
+    allocator_type      get_allocator() const
+    { return ht_.get_allocator(); }
+
+    // 键不存在时插入值初始化的 mapped_type
+    mapped_type& operator[](const key_type& key)
+    { return try_emplace(key).first->second; }
+    mapped_type& operator[](key_type&& key)
+    { return try_emplace(std::move(key)).first->second; }
+
+    // emplace
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> emplace(Args&& ...args)
+    { return ht_.emplace_unique(std::forward<Args>(args)...); }
+
+    // try_emplace
+    // 键不存在时才以 args 构造 mapped_type，否则 args 不被移动
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+    {
+        return ht_.try_emplace_unique(key, key, ht_defer<mapped_type>([&]() {
+            mapped_type value(std::forward<Args>(args)...);
+            return value;
+        }));
+    }
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+    {
+        return ht_.try_emplace_unique(key, std::move(key), ht_defer<mapped_type>([&]() {
+            mapped_type value(std::forward<Args>(args)...);
+            return value;
+        }));
+    }
+
+    // insert_or_assign
+    // 键存在时把 obj 赋给它的 mapped_type，返回值的 second 为 false
+    template <class M>
+    deonSTL::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj)
+    {
+        deonSTL::pair<iterator, bool> res = ht_.try_emplace_unique(key, key, std::forward<M>(obj));
+        if(!res.second)
+            res.first->second = std::forward<M>(obj);
+        return res;
+    }
+    template <class M>
+    deonSTL::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj)
+    {
+        deonSTL::pair<iterator, bool> res = ht_.try_emplace_unique(key, std::move(key), std::forward<M>(obj));
+        if(!res.second)
+            res.first->second = std::forward<M>(obj);
+        return res;
+    }
+
+    // insert
+    deonSTL::pair<iterator, bool> insert(const value_type& value)
+    { return ht_.insert_unique(value); }
+    deonSTL::pair<iterator, bool> insert(value_type&& value)
+    { return ht_.insert_unique(std::move(value)); }
+
+    template <class InputIter>
+    void                          insert(InputIter first, InputIter last)
+    { ht_.insert_unique(first, last); }
+
+    // erase
+    iterator       erase(const_iterator pos) { return ht_.erase(pos); }
+    iterator       erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+    size_type      erase(const key_type& key) { return ht_.erase_unique(key); }
+
+    // clear
+    void           clear() { ht_.clear(); }
+
+    // find
+    iterator       find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    // count
+    size_type      count(const key_type& key) const { return ht_.count_unique(key); }
+
+    // equal_range
+    pair<iterator, iterator>
+      equal_range(const key_type& key)
+    { return ht_.equal_range_unique(key); }
+
+    pair<const_iterator, const_iterator>
+      equal_range(const key_type& key) const
+    { return ht_.equal_range_unique(key); }
+
+    // bucket interface
+    local_iterator       begin(size_type n)        noexcept { return ht_.begin(n); }
+    const_local_iterator begin(size_type n)  const noexcept { return ht_.begin(n); }
+    const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+    local_iterator       end(size_type n)          noexcept { return ht_.end(n); }
+    const_local_iterator end(size_type n)    const noexcept { return ht_.end(n); }
+    const_local_iterator cend(size_type n)   const noexcept { return ht_.cend(n); }
+
+    size_type      bucket_count()           const noexcept { return ht_.bucket_count(); }
+    size_type      max_bucket_count()       const noexcept { return ht_.max_bucket_count(); }
+    size_type      bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+    size_type      bucket(const key_type& key) const { return ht_.bucket(key); }
+
+    // hash policy
+    float          load_factor()     const noexcept { return ht_.load_factor(); }
+    float          max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void           max_load_factor(float ml) { ht_.max_load_factor(ml); }
+    void           rehash(size_type count)   { ht_.rehash(count); }
+    void           reserve(size_type count)  { ht_.reserve(count); }
+
+    hasher         hash_function() const { return ht_.hash_fcn(); }
+    key_equal      key_eq()        const { return ht_.key_eq(); }
+
+    // swap
+    void swap(unordered_map& rhs) noexcept
+    { ht_.swap(rhs.ht_); }
+
+public:
+    friend bool operator==(const unordered_map& lhs, const unordered_map& rhs)
+    { return lhs.ht_.equal_to_unique(rhs.ht_); }
+    friend bool operator!=(const unordered_map& lhs, const unordered_map& rhs)
+    { return !lhs.ht_.equal_to_unique(rhs.ht_); }
+
+}; // class unordered_map
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs, unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{ lhs.swap(rhs); }
+
+
+//***************************************************************************//
+//                            unordered_multimap                             //
+//***************************************************************************//
+
+// 模板类 unordered_multimap，键值允许重复，键相等的元素存放在连续的槽中
+template <class Key, class T, class Hash = deonSTL::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = deonSTL::allocator<deonSTL::pair<const Key, T>>>
+class unordered_multimap
+{
+private:
+    // 以 deonSTL::hashtable 作为底层机制
+    typedef deonSTL::hashtable<deonSTL::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
+    base_type   ht_;
+
+public:
+    typedef typename base_type::key_type                key_type;
+    typedef typename base_type::mapped_type             mapped_type;
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::hasher                  hasher;
+    typedef typename base_type::key_equal               key_equal;
+
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::pointer                 pointer;
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::reference               reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::iterator                iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::local_iterator          local_iterator;
+    typedef typename base_type::const_local_iterator    const_local_iterator;
+    typedef typename base_type::allocator_type          allocator_type;
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    unordered_multimap() = default;
+
+    explicit unordered_multimap(size_type bucket_count,
+                                const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal(),
+                                const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc) {}
+
+    template <class InputIter>
+    unordered_multimap(InputIter first, InputIter last, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_multi(first, last); }
+
+    unordered_multimap(std::initializer_list<value_type> ilist, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_multi(ilist.begin(), ilist.end()); }
+
+    unordered_multimap(const unordered_multimap& rhs)
+    : ht_(rhs.ht_) {}
+
+    unordered_multimap(unordered_multimap&& rhs) noexcept
+    : ht_(std::move(rhs.ht_)) {}
+
+    unordered_multimap& operator=(const unordered_multimap& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    unordered_multimap& operator=(unordered_multimap&& rhs) noexcept
+    {
+        ht_ = std::move(rhs.ht_);
+        return *this;
+    }
+
+    unordered_multimap& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // ==========================成员函数============================ //
+
+    iterator            begin()           noexcept
+    { return ht_.begin(); }
+    const_iterator      begin()     const noexcept
+    { return ht_.begin(); }
+    iterator            end()             noexcept
+    { return ht_.end(); }
+    const_iterator      end()       const noexcept
+    { return ht_.end(); }
+
+    const_iterator      cbegin()    const noexcept
+    { return ht_.cbegin(); }
+    const_iterator      cend()      const noexcept
+    { return ht_.cend(); }
+
+    bool                empty()     const noexcept
+    { return ht_.empty(); }
+    size_type           size()      const noexcept
+    { return ht_.size(); }
+    size_type           max_size()  const noexcept
+    { return ht_.max_size(); }
+
+    allocator_type      get_allocator() const
+    { return ht_.get_allocator(); }
+
+    // emplace
+    template <class ...Args>
+    iterator       emplace(Args&& ...args)
+    { return ht_.emplace_multi(std::forward<Args>(args)...); }
+
+    // insert
+    iterator       insert(const value_type& value)
+    { return ht_.insert_multi(value); }
+    iterator       insert(value_type&& value)
+    { return ht_.insert_multi(std::move(value)); }
+
+    template <class InputIter>
+    void           insert(InputIter first, InputIter last)
+    { ht_.insert_multi(first, last); }
+
+    // erase
+    iterator       erase(const_iterator pos) { return ht_.erase(pos); }
+    iterator       erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+    size_type      erase(const key_type& key) { return ht_.erase_multi(key); }
+
+    // clear
+    void           clear() { ht_.clear(); }
+
+    // find
+    iterator       find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    // count
+    size_type      count(const key_type& key) const { return ht_.count_multi(key); }
+
+    // equal_range
+    pair<iterator, iterator>
+      equal_range(const key_type& key)
+    { return ht_.equal_range_multi(key); }
+
+    pair<const_iterator, const_iterator>
+      equal_range(const key_type& key) const
+    { return ht_.equal_range_multi(key); }
+
+    // bucket interface
+    local_iterator       begin(size_type n)        noexcept { return ht_.begin(n); }
+    const_local_iterator begin(size_type n)  const noexcept { return ht_.begin(n); }
+    const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+    local_iterator       end(size_type n)          noexcept { return ht_.end(n); }
+    const_local_iterator end(size_type n)    const noexcept { return ht_.end(n); }
+    const_local_iterator cend(size_type n)   const noexcept { return ht_.cend(n); }
+
+    size_type      bucket_count()           const noexcept { return ht_.bucket_count(); }
+    size_type      max_bucket_count()       const noexcept { return ht_.max_bucket_count(); }
+    size_type      bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+    size_type      bucket(const key_type& key) const { return ht_.bucket(key); }
+
+    // hash policy
+    float          load_factor()     const noexcept { return ht_.load_factor(); }
+    float          max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void           max_load_factor(float ml) { ht_.max_load_factor(ml); }
+    void           rehash(size_type count)   { ht_.rehash(count); }
+    void           reserve(size_type count)  { ht_.reserve(count); }
+
+    hasher         hash_function() const { return ht_.hash_fcn(); }
+    key_equal      key_eq()        const { return ht_.key_eq(); }
+
+    // swap
+    void swap(unordered_multimap& rhs) noexcept
+    { ht_.swap(rhs.ht_); }
+
+public:
+    friend bool operator==(const unordered_multimap& lhs, const unordered_multimap& rhs)
+    { return lhs.ht_.equal_to_multi(rhs.ht_); }
+    friend bool operator!=(const unordered_multimap& lhs, const unordered_multimap& rhs)
+    { return !lhs.ht_.equal_to_multi(rhs.ht_); }
+
+}; // class unordered_multimap
+
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs, unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept
+{ lhs.swap(rhs); }
+
+} // namespace deonSTL
+
+#endif /* unordered_map_h */
@@ -0,0 +1,388 @@
+//
+//  unordered_set.h
+//  deonSTL
+//
+//  这个头文件包含两个模板类 unordered_set 和 unordered_multiset
+//  以 hashtable 为底层机制，元素直接存放在开放定址的槽数组中
+//  与 std::unordered_set 不同，插入、删除可能使迭代器和元素的引用失效（元素在槽之间搬移）
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef unordered_set_h
+#define unordered_set_h
+
+#include <functional> // equal_to
+#include "hash.h"
+#include "hashtable.h"
+
+namespace deonSTL{
+
+//***************************************************************************//
+//                              unordered_set                                //
+//***************************************************************************//
+
+// 模板类 unordered_set，键值不允许重复
+// 哈希函数缺省使用 deonSTL::hash，比较方式缺省使用 std::equal_to
+template <class Key, class Hash = deonSTL::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = deonSTL::allocator<Key>>
+class unordered_set
+{
+private:
+    // 以 deonSTL::hashtable 作为底层机制
+    typedef deonSTL::hashtable<Key, Hash, KeyEqual, Alloc> base_type;
+    base_type   ht_;
+
+public:
+    typedef typename base_type::key_type                key_type;
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::hasher                  hasher;
+    typedef typename base_type::key_equal               key_equal;
+
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::const_pointer           pointer;    // 不允许修改元素的值
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::const_reference         reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::const_iterator          iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::const_local_iterator    local_iterator;
+    typedef typename base_type::const_local_iterator    const_local_iterator;
+    typedef typename base_type::allocator_type          allocator_type;
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    unordered_set() = default;
+
+    explicit unordered_set(size_type bucket_count,
+                           const hasher& hash = hasher(),
+                           const key_equal& equal = key_equal(),
+                           const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc) {}
+
+    template <class InputIter>
+    unordered_set(InputIter first, InputIter last, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(first, last); }
+
+    unordered_set(std::initializer_list<value_type> ilist, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_unique(ilist.begin(), ilist.end()); }
+
+    unordered_set(const unordered_set& rhs)
+    : ht_(rhs.ht_) {}
+
+    unordered_set(unordered_set&& rhs) noexcept
+    : ht_(std::move(rhs.ht_)) {}
+
+    unordered_set& operator=(const unordered_set& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    unordered_set& operator=(unordered_set&& rhs) noexcept
+    {
+        ht_ = std::move(rhs.ht_);
+        return *this;
+    }
+
+    unordered_set& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // ==========================成员函数============================ //
+
+    iterator            begin()           noexcept
+    { return ht_.begin(); }
+    const_iterator      begin()     const noexcept
+    { return ht_.begin(); }
+    iterator            end()             noexcept
+    { return ht_.end(); }
+    const_iterator      end()       const noexcept
+    { return ht_.end(); }
+
+    const_iterator      cbegin()    const noexcept
+    { return ht_.cbegin(); }
+    const_iterator      cend()      const noexcept
+    { return ht_.cend(); }
+
+    bool                empty()     const noexcept
+    { return ht_.empty(); }
+    size_type           size()      const noexcept
+    { return ht_.size(); }
+    size_type           max_size()  const noexcept
+    { return ht_.max_size(); }
+
+    allocator_type      get_allocator() const
+    { return ht_.get_allocator(); }
+
+    // emplace
+    template <class ...Args>
+    deonSTL::pair<iterator, bool> emplace(Args&& ...args)
+    { return ht_.emplace_unique(std::forward<Args>(args)...); }
+
+    // insert
+    deonSTL::pair<iterator, bool> insert(const value_type& value)
+    { return ht_.insert_unique(value); }
+    deonSTL::pair<iterator, bool> insert(value_type&& value)
+    { return ht_.insert_unique(std::move(value)); }
+
+    template <class InputIter>
+    void                          insert(InputIter first, InputIter last)
+    { ht_.insert_unique(first, last); }
+
+    // erase
+    iterator       erase(const_iterator pos) { return ht_.erase(pos); }
+    iterator       erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+    size_type      erase(const key_type& key) { return ht_.erase_unique(key); }
+
+    // clear
+    void           clear() { ht_.clear(); }
+
+    // find
+    iterator       find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    // count
+    size_type      count(const key_type& key) const { return ht_.count_unique(key); }
+
+    // equal_range
+    pair<iterator, iterator>
+      equal_range(const key_type& key)
+    { return ht_.equal_range_unique(key); }
+
+    pair<const_iterator, const_iterator>
+      equal_range(const key_type& key) const
+    { return ht_.equal_range_unique(key); }
+
+    // bucket interface
+    local_iterator       begin(size_type n)        noexcept { return ht_.cbegin(n); }
+    const_local_iterator begin(size_type n)  const noexcept { return ht_.cbegin(n); }
+    const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+    local_iterator       end(size_type n)          noexcept { return ht_.cend(n); }
+    const_local_iterator end(size_type n)    const noexcept { return ht_.cend(n); }
+    const_local_iterator cend(size_type n)   const noexcept { return ht_.cend(n); }
+
+    size_type      bucket_count()           const noexcept { return ht_.bucket_count(); }
+    size_type      max_bucket_count()       const noexcept { return ht_.max_bucket_count(); }
+    size_type      bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+    size_type      bucket(const key_type& key) const { return ht_.bucket(key); }
+
+    // hash policy
+    float          load_factor()     const noexcept { return ht_.load_factor(); }
+    float          max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void           max_load_factor(float ml) { ht_.max_load_factor(ml); }
+    void           rehash(size_type count)   { ht_.rehash(count); }
+    void           reserve(size_type count)  { ht_.reserve(count); }
+
+    hasher         hash_function() const { return ht_.hash_fcn(); }
+    key_equal      key_eq()        const { return ht_.key_eq(); }
+
+    // swap
+    void swap(unordered_set& rhs) noexcept
+    { ht_.swap(rhs.ht_); }
+
+public:
+    friend bool operator==(const unordered_set& lhs, const unordered_set& rhs)
+    { return lhs.ht_.equal_to_unique(rhs.ht_); }
+    friend bool operator!=(const unordered_set& lhs, const unordered_set& rhs)
+    { return !lhs.ht_.equal_to_unique(rhs.ht_); }
+
+}; // class unordered_set
+
+template <class Key, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_set<Key, Hash, KeyEqual, Alloc>& lhs, unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) noexcept
+{ lhs.swap(rhs); }
+
+
+//***************************************************************************//
+//                            unordered_multiset                             //
+//***************************************************************************//
+
+// 模板类 unordered_multiset，键值允许重复，相等的元素存放在连续的槽中
+template <class Key, class Hash = deonSTL::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = deonSTL::allocator<Key>>
+class unordered_multiset
+{
+private:
+    // 以 deonSTL::hashtable 作为底层机制
+    typedef deonSTL::hashtable<Key, Hash, KeyEqual, Alloc> base_type;
+    base_type   ht_;
+
+public:
+    typedef typename base_type::key_type                key_type;
+    typedef typename base_type::value_type              value_type;
+    typedef typename base_type::hasher                  hasher;
+    typedef typename base_type::key_equal               key_equal;
+
+    typedef typename base_type::size_type               size_type;
+    typedef typename base_type::difference_type         difference_type;
+    typedef typename base_type::const_pointer           pointer;    // 不允许修改元素的值
+    typedef typename base_type::const_pointer           const_pointer;
+    typedef typename base_type::const_reference         reference;
+    typedef typename base_type::const_reference         const_reference;
+    typedef typename base_type::const_iterator          iterator;
+    typedef typename base_type::const_iterator          const_iterator;
+    typedef typename base_type::const_local_iterator    local_iterator;
+    typedef typename base_type::const_local_iterator    const_local_iterator;
+    typedef typename base_type::allocator_type          allocator_type;
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    unordered_multiset() = default;
+
+    explicit unordered_multiset(size_type bucket_count,
+                                const hasher& hash = hasher(),
+                                const key_equal& equal = key_equal(),
+                                const allocator_type& alloc = allocator_type())
+    : ht_(bucket_count, hash, equal, alloc) {}
+
+    template <class InputIter>
+    unordered_multiset(InputIter first, InputIter last, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_multi(first, last); }
+
+    unordered_multiset(std::initializer_list<value_type> ilist, size_type bucket_count = 0)
+    : ht_(bucket_count)
+    { ht_.insert_multi(ilist.begin(), ilist.end()); }
+
+    unordered_multiset(const unordered_multiset& rhs)
+    : ht_(rhs.ht_) {}
+
+    unordered_multiset(unordered_multiset&& rhs) noexcept
+    : ht_(std::move(rhs.ht_)) {}
+
+    unordered_multiset& operator=(const unordered_multiset& rhs)
+    {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+
+    unordered_multiset& operator=(unordered_multiset&& rhs) noexcept
+    {
+        ht_ = std::move(rhs.ht_);
+        return *this;
+    }
+
+    unordered_multiset& operator=(std::initializer_list<value_type> ilist)
+    {
+        ht_.clear();
+        ht_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // ==========================成员函数============================ //
+
+    iterator            begin()           noexcept
+    { return ht_.begin(); }
+    const_iterator      begin()     const noexcept
+    { return ht_.begin(); }
+    iterator            end()             noexcept
+    { return ht_.end(); }
+    const_iterator      end()       const noexcept
+    { return ht_.end(); }
+
+    const_iterator      cbegin()    const noexcept
+    { return ht_.cbegin(); }
+    const_iterator      cend()      const noexcept
+    { return ht_.cend(); }
+
+    bool                empty()     const noexcept
+    { return ht_.empty(); }
+    size_type           size()      const noexcept
+    { return ht_.size(); }
+    size_type           max_size()  const noexcept
+    { return ht_.max_size(); }
+
+    allocator_type      get_allocator() const
+    { return ht_.get_allocator(); }
+
+    // emplace
+    template <class ...Args>
+    iterator       emplace(Args&& ...args)
+    { return ht_.emplace_multi(std::forward<Args>(args)...); }
+
+    // insert
+    iterator       insert(const value_type& value)
+    { return ht_.insert_multi(value); }
+    iterator       insert(value_type&& value)
+    { return ht_.insert_multi(std::move(value)); }
+
+    template <class InputIter>
+    void           insert(InputIter first, InputIter last)
+    { ht_.insert_multi(first, last); }
+
+    // erase
+    iterator       erase(const_iterator pos) { return ht_.erase(pos); }
+    iterator       erase(const_iterator first, const_iterator last) { return ht_.erase(first, last); }
+    size_type      erase(const key_type& key) { return ht_.erase_multi(key); }
+
+    // clear
+    void           clear() { ht_.clear(); }
+
+    // find
+    iterator       find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    // count
+    size_type      count(const key_type& key) const { return ht_.count_multi(key); }
+
+    // equal_range
+    pair<iterator, iterator>
+      equal_range(const key_type& key)
+    { return ht_.equal_range_multi(key); }
+
+    pair<const_iterator, const_iterator>
+      equal_range(const key_type& key) const
+    { return ht_.equal_range_multi(key); }
+
+    // bucket interface
+    local_iterator       begin(size_type n)        noexcept { return ht_.cbegin(n); }
+    const_local_iterator begin(size_type n)  const noexcept { return ht_.cbegin(n); }
+    const_local_iterator cbegin(size_type n) const noexcept { return ht_.cbegin(n); }
+    local_iterator       end(size_type n)          noexcept { return ht_.cend(n); }
+    const_local_iterator end(size_type n)    const noexcept { return ht_.cend(n); }
+    const_local_iterator cend(size_type n)   const noexcept { return ht_.cend(n); }
+
+    size_type      bucket_count()           const noexcept { return ht_.bucket_count(); }
+    size_type      max_bucket_count()       const noexcept { return ht_.max_bucket_count(); }
+    size_type      bucket_size(size_type n) const noexcept { return ht_.bucket_size(n); }
+    size_type      bucket(const key_type& key) const { return ht_.bucket(key); }
+
+    // hash policy
+    float          load_factor()     const noexcept { return ht_.load_factor(); }
+    float          max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void           max_load_factor(float ml) { ht_.max_load_factor(ml); }
+    void           rehash(size_type count)   { ht_.rehash(count); }
+    void           reserve(size_type count)  { ht_.reserve(count); }
+
+    hasher         hash_function() const { return ht_.hash_fcn(); }
+    key_equal      key_eq()        const { return ht_.key_eq(); }
+
+    // swap
+    void swap(unordered_multiset& rhs) noexcept
+    { ht_.swap(rhs.ht_); }
+
+public:
+    friend bool operator==(const unordered_multiset& lhs, const unordered_multiset& rhs)
+    { return lhs.ht_.equal_to_multi(rhs.ht_); }
+    friend bool operator!=(const unordered_multiset& lhs, const unordered_multiset& rhs)
+    { return !lhs.ht_.equal_to_multi(rhs.ht_); }
+
+}; // class unordered_multiset
+
+template <class Key, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs, unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs) noexcept
+{ lhs.swap(rhs); }
+
+} // namespace deonSTL
+
+#endif /* unordered_set_h */
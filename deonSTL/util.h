@@ -63,6 +63,7 @@ struct pair
             first  = std::move(rhs.first);
             second = std::move(rhs.second);
         }
+        return *this;
     }
 
     template <class U1, class U2>
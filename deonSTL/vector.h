@@ -15,68 +15,104 @@
 #include "allocator.h"
 #include "uninitialized.h"
 #include "exceptdef.h"
+#include "growth_policy.h"
 #include <initializer_list>
 #include <algorithm>    // max, copy_backward, equal, fill
 #include <memory>       // addressof
+#include <type_traits>  // enable_if, is_integral
+#include <stdexcept>    // length_error
 
 
 
 namespace deonSTL {
 
-template <class T>
-class vector
+template <class T, size_t N, class Alloc, class Growth>
+class small_vector;
+
+// 参数二为空间配置器类型，vector 持有一个配置器实例
+// 参数三为空间增长策略，见 growth_policy.h
+template <class T, class Alloc = deonSTL::allocator<T>,
+          class Growth = deonSTL::growth_factor_1_5>
+class vector : private deonSTL::alloc_holder<Alloc>
 {
     
 public:
     
-    typedef allocator<T>                                allocator_type;
-    typedef allocator<T>                                data_allocator;
+    typedef Alloc                                       allocator_type;
+    typedef Alloc                                       data_allocator;
+    typedef Growth                                      growth_policy;
     
-    typedef typename allocator_type::value_type         value_type;
-    typedef typename allocator_type::pointer            pointer;
-    typedef typename allocator_type::const_pointer      const_pointer;
-    typedef typename allocator_type::reference          reference;
-    typedef typename allocator_type::const_reference    const_reference;
-    typedef typename allocator_type::size_type          size_type;
-    typedef typename allocator_type::difference_type    difference_type;
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
     
     typedef value_type*                                 iterator;
     typedef const value_type*                           const_iterator;
     // reverse_iterator ⚠️
     
 private:
+    typedef deonSTL::alloc_holder<Alloc>                alloc_base;
+    // 可平凡搬移的元素在扩容、插入、删除时按字节搬移
+    typedef deonSTL::is_trivially_relocatable<T>        relocatable;
+    
     iterator begin_;    // 使用空间头部
     iterator end_;      // 使用空间尾部
     iterator cap_;      // 存储空间尾部
     
+    // small_vector 复用 vector 的全部操作，只在复制、移动、交换时直接处理内嵌缓冲区
+    template <class U, size_t N, class A, class G>
+    friend class small_vector;
+    
 public:
     
     vector() noexcept
     { try_init(); }
+    
+    explicit vector( const allocator_type& alloc) noexcept
+    : alloc_base(alloc)
+    { try_init(); }
 
-    explicit vector( size_type n)
+    explicit vector( size_type n, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     { fill_init(n, value_type()); }
     
-    vector( size_type n, const value_type& value)
+    vector( size_type n, const value_type& value,
+            const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     { fill_init(n, value); }
     
-    template<class Iter>
-    vector( Iter first, Iter last)
+    // n 个元素只做默认初始化，平凡类型不清零
+    vector( size_type n, default_init_t,
+            const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
+    { default_fill_init(n); }
+    
+    template<class Iter, typename std::enable_if<
+        !std::is_integral<Iter>::value, int>::type = 0>
+    vector( Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     {
-        MY_DEBUG(last > first);
         range_init(first, last);
     }
     
-    vector( std:: initializer_list<value_type> ilist)
+    vector( std:: initializer_list<value_type> ilist,
+            const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     {
         range_init(ilist.begin(), ilist.end());
     }
     
     vector( const vector& rhs)
+    : alloc_base(rhs.get_alloc())
     { range_init(rhs.begin_, rhs.end_); }
     
     vector( vector&& rhs) noexcept
-        :begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_)
+        :alloc_base(std::move(rhs.get_alloc())),
+         begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_)
     {
         rhs.begin_ = rhs.end_ = rhs.cap_ = nullptr;
     }
@@ -87,14 +123,14 @@ public:
     
     vector& operator = ( std::initializer_list<value_type> ilist)
     {
-        vector tmp(ilist);
+        vector tmp(ilist, this->get_alloc());
         swap(tmp);
         return *this;
     }
     
     ~vector( )
     {
-        destroy_and_recover(begin_, end_);
+        destroy_and_recover(begin_, end_, capacity());
         begin_ = end_ = cap_ = nullptr;
     }
     
@@ -102,6 +138,9 @@ public:
     
     // =======================成员函数====================== //
     
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+    
     iterator            begin()             noexcept
     { return begin_; }
     const_iterator      begin()       const noexcept
@@ -138,7 +177,7 @@ public:
     
     // at 检测越界的 [] 函数（未实现）
     
-    reference       font()
+    reference       front()
     {
         MY_DEBUG(!empty());
         return *begin_;
@@ -184,7 +223,8 @@ public:
         return fill_insert(const_cast<iterator>(pos), n, value);
     }
     
-    template <class Iter>
+    template <class Iter, typename std::enable_if<
+        !std::is_integral<Iter>::value, int>::type = 0>
     iterator insert(const_iterator pos, Iter first, Iter second)
     {
         MY_DEBUG(pos >= begin_ && pos <= end_);
@@ -203,6 +243,8 @@ public:
     void resize(size_type new_size)
     { return resize(new_size, value_type()); }
     void resize(size_type new_size, const value_type& value);
+    // 多出的元素只做默认初始化，平凡类型不清零
+    void resize_default_init(size_type new_size);
     
     // swap
     
@@ -220,11 +262,13 @@ private:
     
     void fill_init(size_type n, const value_type& value) noexcept;
     
+    void default_fill_init(size_type n);
+    
     template <class Iter>
     void range_init( Iter first, Iter last) noexcept;
     
     // 析构函数 辅助函数
-    void destroy_and_recover( iterator first, iterator last);
+    void destroy_and_recover( iterator first, iterator last, size_type n);
     
     // 计算动态增长后的大小
     size_type get_new_cap(size_type add_size);
@@ -240,7 +284,20 @@ private:
     iterator fill_insert(iterator pos, size_type n, const value_type& value);
     
     template <class Iter>
-    void copy_insert(iterator pos, Iter first, Iter last);
+    iterator copy_insert(iterator pos, Iter first, Iter last);
+    
+    // relocate，只用于可平凡搬移的类型
+    // construct_gap(p) 在 [p, p+n) 构造插入的元素，失败时自己析构已构造的部分并抛出异常
+    template <class ConstructGap>
+    void relocate_realloc(iterator pos, size_type n, size_type new_cap, ConstructGap construct_gap);
+    template <class ConstructGap>
+    void relocate_insert(iterator pos, size_type n, ConstructGap construct_gap);
+    
+    // reallocate_storage 把存储空间调整为 new_cap（不小于 size()），只用于可平凡搬移的类型
+    void reallocate_storage(size_type new_cap)
+    { reallocate_storage(new_cap, deonSTL::has_reallocate<Alloc>{}); }
+    void reallocate_storage(size_type new_cap, std::true_type);
+    void reallocate_storage(size_type new_cap, std::false_type);
     
 
 };  // class vector
@@ -252,22 +309,22 @@ private:
 //***************************************************************************//
 
 // 复制赋值操作符
-template <class T>
-vector<T>&
-vector<T>::operator=( const vector& rhs)
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>&
+vector<T, Alloc, Growth>::operator=( const vector& rhs)
 {
     if(this != &rhs)
     {
         const size_type len = rhs.size();
         if(len > capacity())
-        {
-            vector tmp(rhs.begin(), rhs.end());
+        {// 保留自己的配置器
+            vector tmp(rhs.begin(), rhs.end(), this->get_alloc());
             swap(tmp);
         }
         else if(size() >= len)
         {
             auto i = std::copy(rhs.begin(), rhs.end(), begin());
-            data_allocator::destroy(i, end_);
+            deonSTL::destroy(i, end_);
             end_ = begin_ + len;
         }
         else
@@ -282,11 +339,12 @@ vector<T>::operator=( const vector& rhs)
 }
 
 // 移动赋值操作符
-template <class T>
-vector<T>&
-vector<T>::operator=(vector<T>&& rhs) noexcept
-{
-    destroy_and_recover(begin_, end_);
+template <class T, class Alloc, class Growth>
+vector<T, Alloc, Growth>&
+vector<T, Alloc, Growth>::operator=(vector<T, Alloc, Growth>&& rhs) noexcept
+{// 连同配置器一起移动，空间由新的配置器释放
+    destroy_and_recover(begin_, end_, capacity());
+    this->get_alloc() = std::move(rhs.get_alloc());
     begin_ = rhs.begin_;
     end_ = rhs.end_;
     cap_ = rhs.cap_;
@@ -294,45 +352,56 @@ vector<T>::operator=(vector<T>&& rhs) noexcept
     return *this;
 }
 
-template <class T>
-void vector<T>::reserve(size_type n)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reserve(size_type n)
 {
     if(capacity() < n)
     {
+        if(relocatable::value)
+        {
+            reallocate_storage(n);
+            return;
+        }
         const size_type old_size = size();
-        auto new_begin = data_allocator::allocate(n);
+        auto new_begin = this->get_alloc().allocate(n);
         deonSTL::uninitialized_move(begin_, end_, new_begin);
-        data_allocator::deallocate(begin_);
+        destroy_and_recover(begin_, end_, capacity());
         begin_ = new_begin;
         end_ = new_begin + old_size;
         cap_ = begin_ + n;
     }
 }
 
-template <class T>
-void vector<T>::shrink_to_fit()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit()
 {
-    size_type size = size();
-    auto new_begin = data_allocator::allocate(size);
+    const size_type len = size();
+    if(len == capacity()) return;
+    if(relocatable::value)
+    {
+        reallocate_storage(len);
+        return;
+    }
+    auto new_begin = this->get_alloc().allocate(len);
     try {
         deonSTL::uninitialized_move(begin_, end_, new_begin);
     } catch (...) {
-        data_allocator::deallocate(new_begin);
+        this->get_alloc().deallocate(new_begin, len);
         throw;
     }
-    data_allocator::deallocate(begin_);
+    destroy_and_recover(begin_, end_, capacity());
     begin_ = new_begin;
-    end_ = begin_ + size;
-    cap_ = begin_ + size;
+    end_ = begin_ + len;
+    cap_ = begin_ + len;
 }
 
 
 
 // emplace 在pos处构造元素，构造元素时调用移动构造函数和直接构造函数（可能有拷贝赋值符号），返回插入位置
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class... Args>
-typename vector<T>::iterator
-vector<T>::emplace(const_iterator pos, Args&& ...args)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&& ...args)
 {
     // 可以在 [begin, end] 的任何位置构造
     MY_DEBUG(pos >= begin_ && pos <= end_);
@@ -340,14 +409,20 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
     const size_type offset = xpos - begin_;
     if(end_ != cap_ && xpos == end_)
     {// 在尾部插入，空间足够
-        data_allocator::construct(std::addressof(*end_), std::forward<Args>(args)...);
+        deonSTL::construct(std::addressof(*end_), std::forward<Args>(args)...);
         ++end_;
     }
+    else if(end_ != cap_ && relocatable::value)
+    {// 在中部插入，空间足够，先构造临时对象（参数可能引用被搬走的元素），再搬开后面的元素
+        value_type tmp(std::forward<Args>(args)...);
+        relocate_insert(xpos, 1, [&](iterator p) { deonSTL::construct(p, std::move(tmp)); });
+    }
     else if(end_ != cap_)
-    {// 在中部插入，空间足够
-        data_allocator::construct(std::addressof(*end_), *(end_ - 1));
-        std::copy_backward(xpos, end_-1, end_);
-        *xpos = value_type(std::forward<Args>(args)...); // 调用 移动构造函数和拷贝赋值函数
+    {// 在中部插入，空间足够，先构造临时对象（参数可能引用被移动的元素）
+        value_type tmp(std::forward<Args>(args)...);
+        deonSTL::construct(std::addressof(*end_), std::move(*(end_ - 1)));
+        std::move_backward(xpos, end_-1, end_);
+        *xpos = std::move(tmp); // 调用 移动赋值函数
         ++end_; // 与源码不一致 ⚠️
     }
     else
@@ -358,14 +433,14 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
 }
 
 // emplace_back 直接构造，避免复制
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class... Args>
 void
-vector<T>::emplace_back(Args && ...args)
+vector<T, Alloc, Growth>::emplace_back(Args && ...args)
 {
     if(end_ < cap_)
     {
-        data_allocator::construct(end_, std::forward<Args>(args)...);
+        deonSTL::construct(end_, std::forward<Args>(args)...);
         ++end_;
     }
     else
@@ -373,12 +448,12 @@ vector<T>::emplace_back(Args && ...args)
 }
 
 // push_back 空间不够时扩充（reallocate_insert)
-template <class T>
-void vector<T>::push_back(const value_type &value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::push_back(const value_type &value)
 {
     if(end_ < cap_)
     {
-        data_allocator::construct(std::addressof(*end_), value);
+        deonSTL::construct(std::addressof(*end_), value);
         ++end_;
     }
     else
@@ -386,36 +461,42 @@ void vector<T>::push_back(const value_type &value)
 }
 
 // 右值引用版本 push_back ，空间不够只扩充一个
-template <class T>
-void vector<T>::push_back(value_type &&value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::push_back(value_type &&value)
 { emplace_back(std::move(value)); }
 
-template <class T>
-void vector<T>::pop_back()
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::pop_back()
 {
     MY_DEBUG(!empty());
-    data_allocator::destroy(end_ - 1);
+    deonSTL::destroy(end_ - 1);
     --end_;
 }
 
 // insert 在pos处插入元素，插入时调用拷贝构造函数（可能有拷贝赋值符号），返回插入位置
-template <class T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, const value_type &value)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type &value)
 {
     MY_DEBUG(pos >= begin_ && pos <= end_);
     iterator xpos = const_cast<iterator>(pos);
     const size_type offset = pos - begin_;
     if(end_ != cap_ && xpos == end_)
     {// 在尾部插入，空间足够
-        data_allocator::construct(std::addressof(*end_), value);
+        deonSTL::construct(std::addressof(*end_), value);
         ++end_;
     }
+    else if(end_ != cap_ && relocatable::value)
+    {// 在中部插入，空间足够，value 可能就是被搬走的元素
+        value_type tmp(value);
+        relocate_insert(xpos, 1, [&](iterator p) { deonSTL::construct(p, std::move(tmp)); });
+    }
     else if(end_ != cap_)
-    {// 在中部插入，空间足够
-        data_allocator::construct(std::addressof(*end_), *(end_ - 1));
-        std::copy_backward(xpos, end_-1, end_);
-        *xpos = value_type(value);  // 调用 构造函数和拷贝赋值函数 (源码调用移动赋值函数？⚠️）
+    {// 在中部插入，空间足够，value 可能就是被移动的元素
+        value_type tmp(value);
+        deonSTL::construct(std::addressof(*end_), std::move(*(end_ - 1)));
+        std::move_backward(xpos, end_-1, end_);
+        *xpos = std::move(tmp);
         ++end_;
     }
     else
@@ -425,38 +506,64 @@ vector<T>::insert(const_iterator pos, const value_type &value)
     return begin_ + offset;
 }
 
-template <class T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, value_type &&value)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, value_type &&value)
 { return emplace(pos, std::move(value)); }
 
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator pos)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator pos)
 {
     MY_DEBUG(pos >= begin_ && pos < end_);
     iterator xpos = const_cast<iterator>(pos);
+    if(relocatable::value)
+    {// 析构被删除的元素，后面的元素按字节前移
+        deonSTL::destroy(xpos);
+        deonSTL::uninitialized_relocate(xpos + 1, end_, xpos);
+        --end_;
+        return xpos;
+    }
     std::move(xpos+1, end_, xpos);
-    data_allocator::destroy(&*(end_ - 1)); // 源码 destroy(end_ - 1) ❓
+    deonSTL::destroy(&*(end_ - 1)); // 源码 destroy(end_ - 1) ❓
     --end_;
     return xpos;
 }
 
 // 与源码不一致
-template <class T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator first, const_iterator last)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
 {
-    MY_DENUG(first >= begin_ && last <= end_ && (last >= first));
+    MY_DEBUG(first >= begin_ && last <= end_ && (last >= first));
     iterator xfirst = const_cast<iterator>(first), xlast = const_cast<iterator>(last);
-    data_allocator::destroy(std::move(xlast, end_, xfirst), end_);
+    if(relocatable::value)
+    {
+        deonSTL::destroy(xfirst, xlast);
+        end_ = deonSTL::uninitialized_relocate(xlast, end_, xfirst);
+        return xfirst;
+    }
+    deonSTL::destroy(std::move(xlast, end_, xfirst), end_);
     end_ = end_ - (last - first);
     return xfirst;
 }
 
 
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type &value)
+// swap 连同配置器一起交换
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::swap(vector& rhs) noexcept
+{
+    if(this != &rhs)
+    {
+        std::swap(this->get_alloc(), rhs.get_alloc());
+        std::swap(begin_, rhs.begin_);
+        std::swap(end_, rhs.end_);
+        std::swap(cap_, rhs.cap_);
+    }
+}
+
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type &value)
 {
     if(new_size < size())
     {
@@ -468,33 +575,43 @@ void vector<T>::resize(size_type new_size, const value_type &value)
     }
 }
 
+// resize_default_init 同 resize，多出的元素默认初始化，需要扩容时按增长策略扩容
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::resize_default_init(size_type new_size)
+{
+    const size_type len = size();
+    if(new_size < len)
+    {
+        erase(begin() + new_size, end());
+        return;
+    }
+    const size_type n = new_size - len;
+    if(static_cast<size_type>(cap_ - end_) < n)
+        reserve(get_new_cap(n));
+    end_ = deonSTL::uninitialized_default_construct_n(end_, n);
+}
+
 
 //***************************************************************************//
 //                             helper functions                              //
 //***************************************************************************//
 
-// try_init 函数，分配16个T空间，不抛出异常
-template <class T>
-void vector<T>::try_init() noexcept
+// try_init 函数，不申请空间，第一次插入时再按增长策略申请
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::try_init() noexcept
 {
-    try {
-        begin_ = data_allocator::allocate(16);
-        end_ = begin_;
-        cap_ = begin_ + 16;
-    } catch (...) {
-        begin_ = nullptr;
-        end_ = nullptr;
-        cap_ = nullptr;
-    }
+    begin_ = nullptr;
+    end_ = nullptr;
+    cap_ = nullptr;
 }
 
 // init_space 函数 申请cap个T空间，使用size个T空间，设置好vector参数，向上抛出异常
-template <class T>
+template <class T, class Alloc, class Growth>
 void
-vector<T>::init_space(size_type size, size_type cap)
+vector<T, Alloc, Growth>::init_space(size_type size, size_type cap)
 {
     try {
-        begin_ = data_allocator::allocate(cap);
+        begin_ = this->get_alloc().allocate(cap);
         end_ = begin_ + size;
         cap_ = begin_ + cap;
     } catch (...) {
@@ -506,73 +623,101 @@ vector<T>::init_space(size_type size, size_type cap)
 }
 
 // fill_init 函数，申请空间并用value初始化，不抛出异常
-template <class T>
+template <class T, class Alloc, class Growth>
 void
-vector<T>::fill_init(size_type n, const value_type& value) noexcept
+vector<T, Alloc, Growth>::fill_init(size_type n, const value_type& value) noexcept
 {
-    const size_type init_size = std::max(static_cast<size_type>(16), n);    // max 待写 ⚠️
-    init_space(n, init_size);
-    uninitialized_fill_n(begin_, n, value);
+    init_space(n, n);
+    deonSTL::uninitialized_fill_n(begin_, n, value);
+}
+
+// default_fill_init 函数，申请空间，n 个元素默认初始化
+template <class T, class Alloc, class Growth>
+void
+vector<T, Alloc, Growth>::default_fill_init(size_type n)
+{
+    init_space(n, n);
+    try {
+        deonSTL::uninitialized_default_construct_n(begin_, n);
+    } catch (...) {
+        this->get_alloc().deallocate(begin_, n);
+        begin_ = end_ = cap_ = nullptr;
+        throw;
+    }
 }
 
 // range_init 函数，通过拷贝[first,last)内容初始化，不抛出异常
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class Iter>
 void
-vector<T>::range_init(Iter first, Iter last) noexcept
+vector<T, Alloc, Growth>::range_init(Iter first, Iter last) noexcept
 {
-    const size_type init_space = std::max( static_cast<size_type>(last - first),
-                                          static_cast<size_type>(16));
-    init_space( static_cast<size_type>(last - first), init_space);
-    uninitialized_copy(first, last, begin_);
+    const size_type n = static_cast<size_type>(deonSTL::distance(first, last));
+    init_space(n, n);
+    deonSTL::uninitialized_copy(first, last, begin_);
 }
 
 // destroy_and_recover 函数
-// 析构 [first,last) 的内容，释放全部申请的空间(只能选择释放全部）
-template <class T>
+// 析构 [first,last) 的内容，释放从 first 开始的 n 个T空间(只能选择释放全部）
+template <class T, class Alloc, class Growth>
 void
-vector<T>::destroy_and_recover(iterator first, iterator last)
+vector<T, Alloc, Growth>::destroy_and_recover(iterator first, iterator last, size_type n)
 {
-    data_allocator::destroy(first, last);
-    data_allocator::deallocate(first);
+    deonSTL::destroy(first, last);
+    this->get_alloc().deallocate(first, n);
 }
 
-// get_new_cap 返回动态增长以后空间的大小
-// 小空间增长得快（3/2倍），大空间增长得慢（+16）
-template <class T>
-typename vector<T>::size_type
-vector<T>::get_new_cap(size_type add_size)
+// get_new_cap 返回动态增长以后空间的大小，至少能再容纳 add_size 个元素，由增长策略决定
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::size_type
+vector<T, Alloc, Growth>::get_new_cap(size_type add_size)
 {
-    const size_type old_size = capacity();
-    // trow exception vector is too big
-    if(old_size + old_size/2 > max_size())
-        return old_size + add_size +16 > max_size() ?
-        old_size + add_size : old_size + add_size + 16;
-    const size_type new_size = old_size == 0
-    ? std::max(add_size, static_cast<size_type>(16))
-    : std::max(old_size + old_size/2, old_size + add_size);
-    return new_size;
+    if(add_size > max_size() - size())
+        throw std::length_error("vector<T> size too big");
+    const size_type need = size() + add_size;
+    const size_type new_cap = Growth::next_capacity(capacity(), need, max_size(), sizeof(T));
+    MY_DEBUG(new_cap >= need && new_cap <= max_size());
+    return new_cap;
 }
 
 // reallocate_emplace 重新申请另一块空间并构造插入元素，并管理begin_,end_,cap_
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class ...Args>
 void
-vector<T>::reallocate_emplace(iterator pos, Args&& ...args)
+vector<T, Alloc, Growth>::reallocate_emplace(iterator pos, Args&& ...args)
 {
     const size_type new_size = get_new_cap(1);
-    iterator new_begin = data_allocator::allocate(new_size);
+    if(relocatable::value && deonSTL::has_reallocate<Alloc>::value)
+    {// 原地扩大会使参数引用的旧元素失效，先构造临时对象
+        value_type tmp(std::forward<Args>(args)...);
+        relocate_realloc(pos, 1, new_size, [&](iterator p) { deonSTL::construct(p, std::move(tmp)); });
+        return;
+    }
+    if(relocatable::value)
+    {
+        relocate_realloc(pos, 1, new_size, [&](iterator p)
+                         { deonSTL::construct(p, std::forward<Args>(args)...); });
+        return;
+    }
+    iterator new_begin = this->get_alloc().allocate(new_size);
+    iterator new_pos = new_begin + (pos - begin_);
     iterator new_end = new_begin;
+    try {// 先构造插入的元素，参数可能引用即将被移走的旧元素
+        deonSTL::construct(std::addressof(*new_pos), std::forward<Args>(args)...);
+    } catch (...) {
+        this->get_alloc().deallocate(new_begin, new_size);
+        throw;
+    }
     try {
         new_end = deonSTL::uninitialized_move(begin_, pos, new_begin);
-        data_allocator::construct(std::addressof(*new_end), std::forward<Args>(args)...); // 调用 构造函数
-        ++new_end;
-        new_end = deonSTL::uninitialized_move(pos, end_, new_end);
+        new_end = deonSTL::uninitialized_move(pos, end_, new_pos + 1);
     } catch (...) {
-        data_allocator::deallocate(new_begin);
+        deonSTL::destroy(new_begin, new_end); // 只有前半段已移动完成时非空
+        deonSTL::destroy(std::addressof(*new_pos));
+        this->get_alloc().deallocate(new_begin, new_size);
         throw;
     }
-    destroy_and_recover(begin_, end_);
+    destroy_and_recover(begin_, end_, capacity());
     begin_ = new_begin;
     end_ = new_end;
     cap_ = new_begin + new_size;
@@ -580,64 +725,94 @@ vector<T>::reallocate_emplace(iterator pos, Args&& ...args)
 
 
 // reallocate_insert 重新申请另一块空间并插入元素，并管理begin_,end_,cap_
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type &value)
+template <class T, class Alloc, class Growth>
+void vector<T, Alloc, Growth>::reallocate_insert(iterator pos, const value_type &value)
 {
     const size_type new_size = get_new_cap(1);
-    iterator new_begin = data_allocator::allocate(new_size);
+    if(relocatable::value && deonSTL::has_reallocate<Alloc>::value)
+    {// 原地扩大会使 value 引用的旧元素失效，先复制一份
+        value_type tmp(value);
+        relocate_realloc(pos, 1, new_size, [&](iterator p) { deonSTL::construct(p, std::move(tmp)); });
+        return;
+    }
+    if(relocatable::value)
+    {
+        relocate_realloc(pos, 1, new_size, [&](iterator p) { deonSTL::construct(p, value); });
+        return;
+    }
+    iterator new_begin = this->get_alloc().allocate(new_size);
+    iterator new_pos = new_begin + (pos - begin_);
     iterator new_end = new_begin;
+    try {// 先构造插入的元素，参数可能引用即将被移走的旧元素
+        deonSTL::construct(std::addressof(*new_pos), value);
+    } catch (...) {
+        this->get_alloc().deallocate(new_begin, new_size);
+        throw;
+    }
     try {
-        new_end = uninitialized_move(begin_, pos, new_begin);
-        data_allocator::construct(pos, value);  // 调用 拷贝构造函数
-        ++new_end;
-        new_end = uninitialized_move(pos, end_, new_end);
+        new_end = deonSTL::uninitialized_move(begin_, pos, new_begin);
+        new_end = deonSTL::uninitialized_move(pos, end_, new_pos + 1);
     } catch (...) {
-        data_allocator::destroy(new_begin, new_end);
+        deonSTL::destroy(new_begin, new_end); // 只有前半段已移动完成时非空
+        deonSTL::destroy(std::addressof(*new_pos));
+        this->get_alloc().deallocate(new_begin, new_size);
+        throw;
     }
-    destroy_and_recover(begin_, end_);
+    destroy_and_recover(begin_, end_, capacity());
     begin_ = new_begin;
     end_ = new_end;
     cap_ = new_begin + new_size;
 }
 
-template <class T>
-typename vector<T>::iterator
-vector<T>::fill_insert(iterator pos, size_type n, const value_type &value)
+template <class T, class Alloc, class Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::fill_insert(iterator pos, size_type n, const value_type &value)
 {
     if(n == 0) return pos;
     const size_type xpos = pos - begin_;    // 用于返回值
-    const size_type after_elems = end_ - pos;
-    if(cap_ - end_ >= n)
+    if(relocatable::value)
+    {
+        const value_type value_copy = value; // value 可能就是被搬走的元素
+        auto construct_gap = [&](iterator p) { deonSTL::uninitialized_fill_n(p, n, value_copy); };
+        if(static_cast<size_type>(cap_ - end_) >= n)
+            relocate_insert(pos, n, construct_gap);
+        else
+            relocate_realloc(pos, n, get_new_cap(n), construct_gap);
+        return begin_ + xpos;
+    }
+    if(static_cast<size_type>(cap_ - end_) >= n)
     {// 不需要扩充空间
+        const value_type value_copy = value; // value 可能就是被移动的元素
         const size_type after_elems = end_ - pos;
+        auto old_end = end_;
         if(after_elems > n)
         {// 旧的部分一部分构造，一部分移动，新的部分全部赋值
-            deonSTL::uninitialized_copy(end_ - n, end_, end_);
-            std::move_backward(pos, end_ - n, end_ - n);
-            deonSTL::uninitialized_fill_n(pos, n, value);
+            deonSTL::uninitialized_move(end_ - n, end_, end_);
             end_ += n;
+            std::move_backward(pos, old_end - n, old_end);
+            std::fill_n(pos, n, value_copy);
         }
         else
         {// 旧的部分全部构造，新的部分一部分赋值，一部分构造
-            deonSTL::uninitialized_move(pos, end_, pos + n);
-            deonSTL::uninitialized_fill_n(pos, n, value);
-            end_ += n;
+            end_ = deonSTL::uninitialized_fill_n(end_, n - after_elems, value_copy);
+            end_ = deonSTL::uninitialized_move(pos, old_end, end_);
+            std::fill(pos, old_end, value_copy);
         }
     }
     else
     {// 需要扩充空间
         const size_type new_size = get_new_cap(n);
-        auto new_begin = data_allocator::allocate(new_size);
+        auto new_begin = this->get_alloc().allocate(new_size);
         auto new_end = new_begin;
         try {
             new_end = deonSTL::uninitialized_move(begin_, pos, new_begin);
             new_end = deonSTL::uninitialized_fill_n(new_end, n, value);
             new_end = deonSTL::uninitialized_move(pos, end_, new_end);
         } catch (...) {
-            destroy_and_recover(new_begin, new_end);
+            destroy_and_recover(new_begin, new_end, new_size);
             throw;
         }
-        data_allocator::deallocate(begin_);
+        destroy_and_recover(begin_, end_, capacity());
         begin_ = new_begin;
         end_ = new_end;
         cap_ = begin_ + new_size;
@@ -645,23 +820,33 @@ vector<T>::fill_insert(iterator pos, size_type n, const value_type &value)
     return begin_ + xpos;
 }
 
-template <class T>
+template <class T, class Alloc, class Growth>
 template <class Iter>
-void
-vector<T>::copy_insert(iterator pos, Iter first, Iter last)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::copy_insert(iterator pos, Iter first, Iter last)
 {
     if (first == last)
-      return;
-    const auto n = deonSTL::distance(first, last);
-    if ((cap_ - end_) >= n)
+      return pos;
+    const size_type xpos = pos - begin_;    // 用于返回值
+    const size_type n = static_cast<size_type>(deonSTL::distance(first, last));
+    if (relocatable::value)
+    {
+      auto construct_gap = [&](iterator p) { deonSTL::uninitialized_copy(first, last, p); };
+      if (static_cast<size_type>(cap_ - end_) >= n)
+        relocate_insert(pos, n, construct_gap);
+      else
+        relocate_realloc(pos, n, get_new_cap(n), construct_gap);
+      return begin_ + xpos;
+    }
+    if (static_cast<size_type>(cap_ - end_) >= n)
     { // 如果备用空间大小足够
-      const auto after_elems = end_ - pos;
+      const size_type after_elems = end_ - pos;
       auto old_end = end_;
       if (after_elems > n)
       {
-        end_ = deonSTL::uninitialized_copy(end_ - n, end_, end_);
+        end_ = deonSTL::uninitialized_move(end_ - n, end_, end_);
         std::move_backward(pos, old_end - n, old_end);
-        deonSTL::uninitialized_copy(first, last, pos);
+        std::copy(first, last, pos);
       }
       else
       {
@@ -669,13 +854,13 @@ vector<T>::copy_insert(iterator pos, Iter first, Iter last)
         deonSTL::advance(mid, after_elems);
         end_ = deonSTL::uninitialized_copy(mid, last, end_);
         end_ = deonSTL::uninitialized_move(pos, old_end, end_);
-        deonSTL::uninitialized_copy(first, mid, pos);
+        std::copy(first, mid, pos);
       }
     }
     else
     { // 备用空间不足
       const auto new_size = get_new_cap(n);
-      auto new_begin = data_allocator::allocate(new_size);
+      auto new_begin = this->get_alloc().allocate(new_size);
       auto new_end = new_begin;
       try
       {
@@ -688,36 +873,114 @@ vector<T>::copy_insert(iterator pos, Iter first, Iter last)
         destroy_and_recover(new_begin, new_end, new_size);
         throw;
       }
-      data_allocator::deallocate(begin_, cap_ - begin_);
+      destroy_and_recover(begin_, end_, capacity());
       begin_ = new_begin;
       end_ = new_end;
       cap_ = begin_ + new_size;
     }
+    return begin_ + xpos;
+}
+
+// relocate_realloc 申请 new_cap 大小的新空间，先在新空间的 pos 对应处构造 n 个插入的元素，
+// 成功后把旧元素按字节搬到插入元素两侧，旧空间直接释放（元素已搬走，不析构）
+// 配置器能原地扩大时先扩大空间再插入，此时 construct_gap 不能引用旧元素
+template <class T, class Alloc, class Growth>
+template <class ConstructGap>
+void
+vector<T, Alloc, Growth>::relocate_realloc(iterator pos, size_type n, size_type new_cap,
+                                   ConstructGap construct_gap)
+{
+    const size_type offset = pos - begin_;
+    if(deonSTL::has_reallocate<Alloc>::value)
+    {
+        reallocate_storage(new_cap);
+        relocate_insert(begin_ + offset, n, construct_gap);
+        return;
+    }
+    iterator new_begin = this->get_alloc().allocate(new_cap);
+    try {
+        construct_gap(new_begin + offset);
+    } catch (...) {
+        this->get_alloc().deallocate(new_begin, new_cap);
+        throw;
+    }
+    deonSTL::uninitialized_relocate(begin_, pos, new_begin);
+    iterator new_end = deonSTL::uninitialized_relocate(pos, end_, new_begin + offset + n);
+    this->get_alloc().deallocate(begin_, capacity());
+    begin_ = new_begin;
+    end_ = new_end;
+    cap_ = new_begin + new_cap;
+}
+
+// relocate_insert 备用空间足够，把 [pos, end_) 按字节后移 n 个位置，在空出的位置构造元素
+// 构造失败则把元素搬回原处
+template <class T, class Alloc, class Growth>
+template <class ConstructGap>
+void
+vector<T, Alloc, Growth>::relocate_insert(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    deonSTL::uninitialized_relocate(pos, end_, pos + n);
+    try {
+        construct_gap(pos);
+    } catch (...) {
+        deonSTL::uninitialized_relocate(pos + n, end_ + n, pos);
+        throw;
+    }
+    end_ += n;
+}
+
+// reallocate_storage 配置器原地调整空间大小（realloc / mremap），元素按字节跟随
+template <class T, class Alloc, class Growth>
+void
+vector<T, Alloc, Growth>::reallocate_storage(size_type new_cap, std::true_type)
+{
+    const size_type old_size = size();
+    begin_ = this->get_alloc().reallocate(begin_, capacity(), new_cap);
+    end_ = begin_ + old_size;
+    cap_ = begin_ + new_cap;
+}
+
+// reallocate_storage 申请新空间，元素按字节搬过去，释放旧空间
+template <class T, class Alloc, class Growth>
+void
+vector<T, Alloc, Growth>::reallocate_storage(size_type new_cap, std::false_type)
+{
+    const size_type old_size = size();
+    iterator new_begin = this->get_alloc().allocate(new_cap);
+    deonSTL::uninitialized_relocate(begin_, end_, new_begin);
+    this->get_alloc().deallocate(begin_, capacity());
+    begin_ = new_begin;
+    end_ = new_begin + old_size;
+    cap_ = new_begin + new_cap;
 }
 
 //***************************************************************************//
 //                            equal operator                                 //
 //***************************************************************************//
 
-template <class T>
-bool operator == (const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator == (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return lhs.size() == rhs.size() &&
     std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator != (const vector<T>& lhs, const vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+bool operator != (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return !(lhs == rhs);
 }
 
-template <class T>
-void swap(vector<T>& lhs, vector<T>& rhs)
+template <class T, class Alloc, class Growth>
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs)
 {
     lhs.swap(rhs);
 }
 
+// vector 只保存三个指针和配置器，没有指向自身的指针
+template <class T, class Alloc, class Growth>
+struct is_trivially_relocatable<vector<T, Alloc, Growth>> : is_trivially_relocatable<Alloc> {};
+
 
 } // namespace deonSTL
 
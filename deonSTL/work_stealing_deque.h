@@ -0,0 +1,256 @@
+//
+//  work_stealing_deque.h
+//  deonSTL
+//
+//  这个头文件包含模板类 work_stealing_deque：Chase–Lev 工作窃取双端队列，用作任务调度器中每个工作线程的任务队列
+//  拥有者线程在底部（bottom）push / pop，像一个栈；其他线程（窃取者）从顶部（top）steal，用 CAS 互相竞争
+//  push 没有读-改-写操作（x86 上全部是普通的读写），pop 只有在队列只剩一个元素时才需要 CAS
+//
+//  缓冲区满时由拥有者换成两倍大的缓冲区，窃取者可能还在读旧缓冲区，所以旧缓冲区保留到析构时才释放
+//  （每次加倍，保留的旧缓冲区之和不超过当前缓冲区的大小）
+//
+//  元素在窃取时与拥有者的写入并发地读，因此要求 T 为平凡可复制类型（通常是任务指针）
+//  内存序参照 Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"
+//
+//  Created by 郭松楠 on 2026/10/17.
+//  Copyright © 2020 郭松楠. All rights reserved.
+//
+
+#ifndef work_stealing_deque_h
+#define work_stealing_deque_h
+
+#include <cstddef>      // size_t, ptrdiff_t
+#include <atomic>
+#include <new>          // placement new
+#include <type_traits>  // is_trivially_copyable
+#include "allocator.h"
+#include "vector.h"
+#include "spsc_queue.h" // cache_line_size
+
+namespace deonSTL{
+
+// 模版类 work_stealing_deque
+// 容量向上取整为 2 的幂，top_、bottom_ 为不回绕的有符号下标，bottom_ - top_ 为元素个数
+template <class T, class Alloc = deonSTL::allocator<T>>
+class work_stealing_deque : private deonSTL::alloc_holder<Alloc>
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "work_stealing_deque requires a trivially copyable element type");
+
+public:
+
+    typedef Alloc                                       allocator_type;
+
+    typedef T                                           value_type;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+private:
+    typedef std::atomic<T>                              slot;
+
+    // 环形缓冲区，下标与 mask 相与
+    struct circular_array
+    {
+        difference_type     mask;
+        slot*               slots;
+
+        T    get(difference_type i) const noexcept
+        { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(difference_type i, T value) noexcept
+        { slots[i & mask].store(value, std::memory_order_relaxed); }
+    };
+
+    typedef deonSTL::alloc_holder<Alloc>                            alloc_base;
+    typedef typename Alloc::template rebind<slot>::other            slot_allocator;
+    typedef typename Alloc::template rebind<circular_array>::other  array_allocator;
+
+    std::atomic<difference_type>    top_;       // 窃取者竞争
+    char                            pad0_[cache_line_size];
+
+    std::atomic<difference_type>    bottom_;    // 只由拥有者写
+    std::atomic<circular_array*>    array_;     // 只由拥有者换
+    char                            pad1_[cache_line_size];
+
+    deonSTL::vector<circular_array*> retired_;  // 换下来的旧缓冲区，只由拥有者访问
+
+public:
+    // ======================构造、移动、赋值函数====================== //
+
+    explicit work_stealing_deque(size_type capacity = 256,
+                                 const allocator_type& alloc = allocator_type());
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    ~work_stealing_deque();
+
+public:
+    // ==========================成员函数============================ //
+
+    allocator_type      get_allocator() const
+    { return this->get_alloc(); }
+
+    // 其他线程同时在操作时只是一个近似值
+    size_type           size_approx() const noexcept
+    {
+        const difference_type b = bottom_.load(std::memory_order_relaxed);
+        const difference_type t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_type>(b - t) : 0;
+    }
+    bool                empty_approx() const noexcept
+    { return size_approx() == 0; }
+
+    size_type           capacity() const noexcept
+    { return static_cast<size_type>(array_.load(std::memory_order_relaxed)->mask + 1); }
+
+    // 拥有者：在底部放入，满时扩容
+    void        push(T value);
+
+    // 拥有者：从底部取出（后进先出），空时返回 false
+    bool        pop(T& value);
+
+    // 窃取者：从顶部取出（先进先出），空或者与其他线程竞争失败时返回 false
+    bool        steal(T& value);
+
+private:
+    // ==========================辅助函数============================ //
+
+    circular_array* create_array(size_type cap);
+    void            recover_array(circular_array* a) noexcept;
+
+    // 换成两倍大的缓冲区，复制 [t, b) 的元素
+    circular_array* grow(circular_array* a, difference_type b, difference_type t);
+
+};// class work_stealing_deque
+
+//***************************************************************************//
+//                           member functions                                //
+//***************************************************************************//
+
+template <class T, class Alloc>
+work_stealing_deque<T, Alloc>::work_stealing_deque(size_type capacity, const allocator_type& alloc)
+: alloc_base(alloc), top_(0), bottom_(0), array_(nullptr)
+{
+    size_type cap = 2;
+    while(cap < capacity)
+        cap <<= 1;
+    array_.store(create_array(cap), std::memory_order_relaxed);
+}
+
+// 析构函数 释放当前缓冲区和所有旧缓冲区（此时不能有其他线程在使用队列）
+template <class T, class Alloc>
+work_stealing_deque<T, Alloc>::~work_stealing_deque()
+{
+    recover_array(array_.load(std::memory_order_relaxed));
+    for(size_type i = 0; i < retired_.size(); ++i)
+        recover_array(retired_[i]);
+}
+
+// push 先写元素，再以 release 推进 bottom_，窃取者读到新的 bottom_ 时元素一定可见
+template <class T, class Alloc>
+void
+work_stealing_deque<T, Alloc>::push(T value)
+{
+    const difference_type b = bottom_.load(std::memory_order_relaxed);
+    const difference_type t = top_.load(std::memory_order_acquire);
+    circular_array* a = array_.load(std::memory_order_relaxed);
+    if(b - t > a->mask)
+        a = grow(a, b, t);
+    a->put(b, value);
+    bottom_.store(b + 1, std::memory_order_release);
+}
+
+// pop 先把 bottom_ 减一占住最后一个元素，seq_cst 栅栏后再读 top_：
+// 还剩多个元素时直接取走；只剩一个时与窃取者用 CAS 抢 top_；已经空了则把 bottom_ 还原
+template <class T, class Alloc>
+bool
+work_stealing_deque<T, Alloc>::pop(T& value)
+{
+    const difference_type b = bottom_.load(std::memory_order_relaxed) - 1;
+    circular_array* a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    difference_type t = top_.load(std::memory_order_relaxed);
+    if(t > b)
+    {// 空
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    value = a->get(b);
+    if(t == b)
+    {// 最后一个元素
+        const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+// steal 先读 top_ 再读 bottom_（中间 seq_cst 栅栏与 pop 配对），读出元素后用 CAS 推进 top_，失败说明被别人取走
+template <class T, class Alloc>
+bool
+work_stealing_deque<T, Alloc>::steal(T& value)
+{
+    difference_type t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const difference_type b = bottom_.load(std::memory_order_acquire);
+    if(t >= b)
+        return false;
+    circular_array* a = array_.load(std::memory_order_acquire);
+    const T x = a->get(t);
+    if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+        return false;
+    value = x;
+    return true;
+}
+
+//***************************************************************************//
+//                             helper functions                              //
+//***************************************************************************//
+
+// create_array 申请 cap 个槽位
+template <class T, class Alloc>
+typename work_stealing_deque<T, Alloc>::circular_array*
+work_stealing_deque<T, Alloc>::create_array(size_type cap)
+{
+    circular_array* a = array_allocator(this->get_alloc()).allocate(1);
+    try {
+        a->slots = slot_allocator(this->get_alloc()).allocate(cap);
+    } catch (...) {
+        array_allocator(this->get_alloc()).deallocate(a, 1);
+        throw;
+    }
+    a->mask = static_cast<difference_type>(cap) - 1;
+    for(size_type i = 0; i < cap; ++i)
+        ::new (static_cast<void*>(a->slots + i)) slot();
+    return a;
+}
+
+// recover_array 释放缓冲区（std::atomic<T> 的析构是平凡的）
+template <class T, class Alloc>
+void
+work_stealing_deque<T, Alloc>::recover_array(circular_array* a) noexcept
+{
+    slot_allocator(this->get_alloc()).deallocate(a->slots, static_cast<size_type>(a->mask + 1));
+    array_allocator(this->get_alloc()).deallocate(a, 1);
+}
+
+// grow 新缓冲区中的元素与旧缓冲区的逻辑下标相同，发布后旧缓冲区进入 retired_
+template <class T, class Alloc>
+typename work_stealing_deque<T, Alloc>::circular_array*
+work_stealing_deque<T, Alloc>::grow(circular_array* a, difference_type b, difference_type t)
+{
+    retired_.reserve(retired_.size() + 1);  // 先申请好位置，下面发布新缓冲区之后不会再抛出异常
+    circular_array* na = create_array(static_cast<size_type>(a->mask + 1) * 2);
+    for(difference_type i = t; i < b; ++i)
+        na->put(i, a->get(i));
+    array_.store(na, std::memory_order_release);
+    retired_.push_back(a);
+    return na;
+}
+
+}// namespace deonSTL
+
+#endif /* work_stealing_deque_h */